@@ -0,0 +1,266 @@
+#include "ky_bench.h"
+#include "tools/ky_map.h"
+#include "tools/ky_hash.h"
+#include "tools/ky_flathash.h"
+#include "tools/ky_btree.h"
+#include "tools/ky_flatmap.h"
+#include <map>
+#include <unordered_map>
+
+namespace
+{
+//!
+//! 关联容器的统一操作，key和值都是i64，key为伪随机数
+//!
+template <typename M>
+struct assoc_ky
+{
+    typedef M type;
+    static void insert(M &m, i64 k, i64 v) {m.insert(k, v);}
+    static bool find(M &m, i64 k, i64 &v)
+    {
+        typename M::iterator it = m.find(k);
+        if (it == m.end())
+            return false;
+        v = it.value();
+        return true;
+    }
+    static void erase(M &m, i64 k) {m.erase(k);}
+    static i64 sum(M &m)
+    {
+        i64 r = 0;
+        for (typename M::iterator it = m.begin(); it != m.end(); ++it)
+            r += it.value();
+        return r;
+    }
+};
+template <typename K, typename V>
+struct assoc_ky<ky_hash<K, V> >
+{
+    typedef ky_hash<K, V> type;
+    static void insert(type &m, i64 k, i64 v) {m.insert(k, v);}
+    static bool find(type &m, i64 k, i64 &v)
+    {
+        typename type::iterator it = m.find(k);
+        if (it == m.end())
+            return false;
+        v = it->value();
+        return true;
+    }
+    static void erase(type &m, i64 k) {m.erase(k);}
+    static i64 sum(type &m)
+    {
+        i64 r = 0;
+        for (typename type::iterator it = m.begin(); it != m.end(); ++it)
+            r += it->value();
+        return r;
+    }
+};
+template <typename M>
+struct assoc_std
+{
+    typedef M type;
+    static void insert(M &m, i64 k, i64 v) {m.insert(typename M::value_type(k, v));}
+    static bool find(M &m, i64 k, i64 &v)
+    {
+        typename M::iterator it = m.find(k);
+        if (it == m.end())
+            return false;
+        v = it->second;
+        return true;
+    }
+    static void erase(M &m, i64 k) {m.erase(k);}
+    static i64 sum(M &m)
+    {
+        i64 r = 0;
+        for (typename M::iterator it = m.begin(); it != m.end(); ++it)
+            r += it->second;
+        return r;
+    }
+};
+
+//! 生成n个伪随机key，miss为另一组不会命中的key
+struct assoc_keys
+{
+    ky_array<i64> hit;
+    ky_array<i64> miss;
+
+    explicit assoc_keys(int64 n)
+    {
+        bench_random rnd(n);
+        hit.resize(n);
+        miss.resize(n);
+        // 最低位区分两组，保证互不相交
+        for (int64 i = 0; i < n; ++i)
+        {
+            hit[(int)i] = i64(rnd() & ~u64(1));
+            miss[(int)i] = i64(rnd() | 1);
+        }
+    }
+};
+
+template <typename S>
+typename S::type *assoc_build(const assoc_keys &keys)
+{
+    typename S::type *m = kyNew(typename S::type);
+    for (int64 i = 0; i < keys.hit.count(); ++i)
+        S::insert(*m, keys.hit[(int)i], i64(i));
+    return m;
+}
+//! ky_flatmap 逐个插入是O(n^2)，查找类测试从无序数组批量建立
+template <>
+assoc_ky<ky_flatmap<i64, i64> >::type *assoc_build<assoc_ky<ky_flatmap<i64, i64> > >(const assoc_keys &keys)
+{
+    const int64 n = keys.hit.count();
+    ky_array<i64> values(n);
+    for (int64 i = 0; i < n; ++i)
+        values[(int)i] = i64(i);
+    return kyNew((ky_flatmap<i64, i64>)(keys.hit.data(), values.data(), n));
+}
+
+template <typename S>
+void assoc_insert(ky_bench_state &s)
+{
+    const assoc_keys keys(s.arg());
+    s.items(s.arg());
+    while (s.next())
+    {
+        typename S::type *m = assoc_build<S>(keys);
+        ky_bench::escape(m);
+        s.pause();
+        kyDelete(m);
+        s.resume();
+    }
+}
+
+template <typename S>
+void assoc_find(ky_bench_state &s)
+{
+    const assoc_keys keys(s.arg());
+    s.items(s.arg());
+    typename S::type *m = assoc_build<S>(keys);
+    while (s.next())
+    {
+        i64 sum = 0, v = 0;
+        for (int64 i = 0; i < keys.hit.count(); ++i)
+            if (S::find(*m, keys.hit[(int)i], v))
+                sum += v;
+        ky_bench::keep(sum);
+    }
+    kyDelete(m);
+}
+
+template <typename S>
+void assoc_miss(ky_bench_state &s)
+{
+    const assoc_keys keys(s.arg());
+    s.items(s.arg());
+    typename S::type *m = assoc_build<S>(keys);
+    while (s.next())
+    {
+        i64 sum = 0, v = 0;
+        for (int64 i = 0; i < keys.miss.count(); ++i)
+            sum += S::find(*m, keys.miss[(int)i], v);
+        ky_bench::keep(sum);
+    }
+    kyDelete(m);
+}
+
+template <typename S>
+void assoc_iterate(ky_bench_state &s)
+{
+    const assoc_keys keys(s.arg());
+    s.items(s.arg());
+    typename S::type *m = assoc_build<S>(keys);
+    while (s.next())
+        ky_bench::keep(S::sum(*m));
+    kyDelete(m);
+}
+
+template <typename S>
+void assoc_erase(ky_bench_state &s)
+{
+    const assoc_keys keys(s.arg());
+    s.items(s.arg());
+    while (s.next())
+    {
+        s.pause();
+        typename S::type *m = assoc_build<S>(keys);
+        s.resume();
+
+        for (int64 i = 0; i < keys.hit.count(); ++i)
+            S::erase(*m, keys.hit[(int)i]);
+        ky_bench::escape(m);
+
+        s.pause();
+        kyDelete(m);
+        s.resume();
+    }
+}
+
+//! ky_flatmap 从无序数组批量建立
+void flatmap_build(ky_bench_state &s)
+{
+    const assoc_keys keys(s.arg());
+    ky_array<i64> values(s.arg());
+    for (int64 i = 0; i < s.arg(); ++i)
+        values[(int)i] = i64(i);
+    s.items(s.arg());
+    while (s.next())
+    {
+        ky_flatmap<i64, i64> *m = kyNew((ky_flatmap<i64, i64>)(keys.hit.data(), values.data(), s.arg()));
+        ky_bench::escape(m);
+        s.pause();
+        kyDelete(m);
+        s.resume();
+    }
+}
+
+template <typename S>
+void add_assoc(const char *name, int64 n, bool insert = true, int flags = 0)
+{
+    if (insert)
+    {
+        ky_bench::add("map/insert", name, assoc_insert<S>, n, flags);
+        ky_bench::add("map/erase", name, assoc_erase<S>, n, flags);
+    }
+    ky_bench::add("map/find", name, assoc_find<S>, n, flags);
+    ky_bench::add("map/miss", name, assoc_miss<S>, n, flags);
+    ky_bench::add("map/iterate", name, assoc_iterate<S>, n, flags);
+}
+
+typedef assoc_ky<ky_map<i64, i64> >            ky_map_t;
+typedef assoc_ky<ky_hash<i64, i64> >           ky_hash_t;
+typedef assoc_ky<ky_flathash<i64, i64> >       ky_flathash_t;
+typedef assoc_ky<ky_btree_map<i64, i64> >      ky_btree_t;
+typedef assoc_ky<ky_flatmap<i64, i64> >        ky_flatmap_t;
+typedef assoc_std<std::map<i64, i64> >         std_map_t;
+typedef assoc_std<std::unordered_map<i64, i64> > std_hash_t;
+}
+
+void bench_assoc_register()
+{
+    const int64 sizes[] = {1000, 1000000};
+    for (int i = 0; i < 2; ++i)
+    {
+        const int64 n = sizes[i];
+        add_assoc<ky_map_t>("ky_map<i64,i64>", n);
+        add_assoc<ky_btree_t>("ky_btree_map<i64,i64>", n);
+        add_assoc<std_map_t>("std::map<i64,i64>", n);
+        add_assoc<ky_hash_t>("ky_hash<i64,i64>", n);
+        add_assoc<ky_flathash_t>("ky_flathash<i64,i64>", n);
+        add_assoc<std_hash_t>("std::unordered_map<i64,i64>", n);
+        // 有序数组只测批量建立和建立后的查找
+        add_assoc<ky_flatmap_t>("ky_flatmap<i64,i64>", n, false);
+        ky_bench::add("map/build", "ky_flatmap<i64,i64>", flatmap_build, n);
+    }
+
+    // 1亿项的有序表需要数GB内存，只在 --large 时运行
+    const int64 huge = 100000000;
+    ky_bench::add("map/insert", "ky_map<i64,i64>", assoc_insert<ky_map_t>, huge, ky_bench::Large);
+    ky_bench::add("map/find", "ky_map<i64,i64>", assoc_find<ky_map_t>, huge, ky_bench::Large);
+    ky_bench::add("map/insert", "ky_btree_map<i64,i64>", assoc_insert<ky_btree_t>, huge, ky_bench::Large);
+    ky_bench::add("map/find", "ky_btree_map<i64,i64>", assoc_find<ky_btree_t>, huge, ky_bench::Large);
+    ky_bench::add("map/insert", "std::map<i64,i64>", assoc_insert<std_map_t>, huge, ky_bench::Large);
+    ky_bench::add("map/find", "std::map<i64,i64>", assoc_find<std_map_t>, huge, ky_bench::Large);
+}
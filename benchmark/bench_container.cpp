@@ -0,0 +1,247 @@
+#include "ky_bench.h"
+#include "tools/ky_array.h"
+#include "tools/ky_vector.h"
+#include "tools/ky_list.h"
+#include "tools/ky_linked.h"
+#include "tools/ky_bitset.h"
+#include <vector>
+#include <deque>
+#include <list>
+#include <bitset>
+#include <iterator>
+
+namespace
+{
+//!
+//! 顺序容器的统一操作，README 中的测试条件：int32 元素，插入和访问位置取 i%1000
+//!
+template <typename C>
+struct seq_ky
+{
+    typedef C type;
+    static void append(C &c, i32 v) {c.append(v);}
+    static void prepend(C &c, i32 v) {c.prepend(v);}
+    static void insert(C &c, int64 pos, i32 v) {c.insert((int)pos, v);}
+    static i32 at(C &c, int64 pos) {return c[(int)pos];}
+    static i64 sum(C &c)
+    {
+        i64 r = 0;
+        for (typename C::iterator it = c.begin(); it != c.end(); ++it)
+            r += *it;
+        return r;
+    }
+};
+template <typename T>
+struct seq_ky<ky_array<T> >
+{
+    typedef ky_array<T> type;
+    static void append(type &c, i32 v) {c.append(v);}
+    static void prepend(type &c, i32 v) {c.prepend(v);}
+    static void insert(type &c, int64 pos, i32 v) {c.insert((int)pos, v);}
+    static i32 at(type &c, int64 pos) {return c[(int)pos];}
+    static i64 sum(type &c)
+    {
+        i64 r = 0;
+        const T *p = c.data();
+        for (i64 i = 0, n = c.count(); i < n; ++i)
+            r += p[i];
+        return r;
+    }
+};
+template <typename T>
+struct seq_ky<ky_linked<T> >
+{
+    typedef ky_linked<T> type;
+    static void append(type &c, i32 v) {c.append(v);}
+    static void prepend(type &c, i32 v) {c.prepend(v);}
+    static void insert(type &c, int64 pos, i32 v) {c.insert(pos, v);}
+    static i32 at(type &c, int64 pos) {return *(c.begin() + (int)pos);}
+    static i64 sum(type &c)
+    {
+        i64 r = 0;
+        for (typename type::iterator it = c.begin(); it != c.end(); ++it)
+            r += *it;
+        return r;
+    }
+};
+template <typename C>
+struct seq_std
+{
+    typedef C type;
+    static void append(C &c, i32 v) {c.push_back(v);}
+    static void prepend(C &c, i32 v) {c.push_front(v);}
+    static void insert(C &c, int64 pos, i32 v) {c.insert(std::next(c.begin(), pos), v);}
+    static i32 at(C &c, int64 pos) {return *std::next(c.begin(), pos);}
+    static i64 sum(C &c)
+    {
+        i64 r = 0;
+        for (typename C::iterator it = c.begin(); it != c.end(); ++it)
+            r += *it;
+        return r;
+    }
+};
+
+template <typename S>
+void seq_append(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    while (s.next())
+    {
+        typename S::type *c = kyNew(typename S::type);
+        for (int64 i = 0; i < n; ++i)
+            S::append(*c, i32(i));
+        ky_bench::escape(c);
+        s.pause();
+        kyDelete(c);
+        s.resume();
+    }
+}
+
+template <typename S>
+void seq_prepend(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    while (s.next())
+    {
+        typename S::type *c = kyNew(typename S::type);
+        for (int64 i = 0; i < n; ++i)
+            S::prepend(*c, i32(i));
+        ky_bench::escape(c);
+        s.pause();
+        kyDelete(c);
+        s.resume();
+    }
+}
+
+template <typename S>
+void seq_insert(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    while (s.next())
+    {
+        s.pause();
+        typename S::type *c = kyNew(typename S::type);
+        for (int64 i = 0; i < 1000; ++i)
+            S::append(*c, i32(i));
+        s.resume();
+
+        for (int64 i = 0; i < n; ++i)
+            S::insert(*c, i % 1000, i32(i));
+        ky_bench::escape(c);
+
+        s.pause();
+        kyDelete(c);
+        s.resume();
+    }
+}
+
+template <typename S>
+void seq_access(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    typename S::type *c = kyNew(typename S::type);
+    for (int64 i = 0; i < 1000; ++i)
+        S::append(*c, i32(i));
+    while (s.next())
+    {
+        i64 sum = 0;
+        for (int64 i = 0; i < n; ++i)
+            sum += S::at(*c, i % 1000);
+        ky_bench::keep(sum);
+    }
+    kyDelete(c);
+}
+
+template <typename S>
+void seq_iterate(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    typename S::type *c = kyNew(typename S::type);
+    for (int64 i = 0; i < n; ++i)
+        S::append(*c, i32(i));
+    while (s.next())
+        ky_bench::keep(S::sum(*c));
+    kyDelete(c);
+}
+
+//!
+//! 位集合：按伪随机位置置位、翻转并统计
+//!
+enum {BitCount = 4096};
+
+template <typename B>
+struct bits_ky
+{
+    typedef B type;
+    static void set(B &b, uint i) {b.set(i);}
+    static void flip(B &b, uint i) {b.flip(i);}
+    static int count(const B &b) {return b.count();}
+};
+template <typename B>
+struct bits_std
+{
+    typedef B type;
+    static void set(B &b, uint i) {b.set(i);}
+    static void flip(B &b, uint i) {b.flip(i);}
+    static int count(const B &b) {return (int)b.count();}
+};
+
+template <typename S>
+void bits_ops(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    bench_random rnd;
+    while (s.next())
+    {
+        typename S::type b;
+        int sum = 0;
+        for (int64 i = 0; i < n; ++i)
+        {
+            const uint r = uint(rnd());
+            S::set(b, r % BitCount);
+            S::flip(b, (r >> 16) % BitCount);
+            if ((i & 63) == 0)
+                sum += S::count(b);
+        }
+        ky_bench::keep(sum);
+    }
+}
+
+template <typename S>
+void add_seq(const char *name)
+{
+    ky_bench::add("sequence/append", name, seq_append<S>, 10000000);
+    ky_bench::add("sequence/insert", name, seq_insert<S>, 100000);
+    ky_bench::add("sequence/access", name, seq_access<S>, 1000000);
+    ky_bench::add("sequence/iterate", name, seq_iterate<S>, 10000000);
+}
+}
+
+void bench_container_register()
+{
+    add_seq<seq_ky<ky_array<i32> > >("ky_array<i32>");
+    add_seq<seq_ky<ky_vector<i32> > >("ky_vector<i32>");
+    add_seq<seq_ky<ky_list<i32> > >("ky_list<i32>");
+    add_seq<seq_ky<ky_linked<i32> > >("ky_linked<i32>");
+    add_seq<seq_std<std::vector<i32> > >("std::vector<i32>");
+    add_seq<seq_std<std::deque<i32> > >("std::deque<i32>");
+    add_seq<seq_std<std::list<i32> > >("std::list<i32>");
+
+    // std::vector 没有前向添加，逐个插入到头部是O(n^2)，不做比较
+    const int64 n = 10000000;
+    ky_bench::add("sequence/prepend", "ky_array<i32>", seq_prepend<seq_ky<ky_array<i32> > >, n);
+    ky_bench::add("sequence/prepend", "ky_vector<i32>", seq_prepend<seq_ky<ky_vector<i32> > >, n);
+    ky_bench::add("sequence/prepend", "ky_list<i32>", seq_prepend<seq_ky<ky_list<i32> > >, n);
+    ky_bench::add("sequence/prepend", "ky_linked<i32>", seq_prepend<seq_ky<ky_linked<i32> > >, n);
+    ky_bench::add("sequence/prepend", "std::deque<i32>", seq_prepend<seq_std<std::deque<i32> > >, n);
+    ky_bench::add("sequence/prepend", "std::list<i32>", seq_prepend<seq_std<std::list<i32> > >, n);
+
+    ky_bench::add("bitset/ops", "ky_bitset<4096,u64>", bits_ops<bits_ky<ky_bitset<BitCount, u64> > >, 10000000);
+    ky_bench::add("bitset/ops", "std::bitset<4096>", bits_ops<bits_std<std::bitset<BitCount> > >, 10000000);
+}
@@ -0,0 +1,189 @@
+#include "ky_bench.h"
+#include "arch/ky_memory.h"
+#include "tools/ky_map.h"
+#include "tools/ky_linked.h"
+#include <string.h>
+
+namespace
+{
+//! 每次采样处理的总字节数，小块时重复多次
+enum {SweepBytes = 64 << 20};
+
+struct sweep_buffer
+{
+    u8   *src;
+    u8   *dst;
+    int64 size;
+    int64 loops;
+
+    explicit sweep_buffer(int64 n):
+        src((u8*)kyMalloc(n + 64)),
+        dst((u8*)kyMalloc(n + 64)),
+        size(n),
+        loops(n < SweepBytes ? SweepBytes / n : 1)
+    {
+        for (int64 i = 0; i < n + 64; ++i)
+            src[i] = dst[i] = u8(i * 131);
+    }
+    ~sweep_buffer()
+    {
+        kyFree(src);
+        kyFree(dst);
+    }
+};
+
+template <typename F>
+void sweep(ky_bench_state &s, F f)
+{
+    sweep_buffer b(s.arg());
+    s.items(b.size * b.loops);
+    while (s.next())
+    {
+        for (int64 i = 0; i < b.loops; ++i)
+            f(b);
+        ky_bench::escape(b.dst);
+    }
+}
+
+struct copy_ky  {void operator ()(sweep_buffer &b)const {ky_memory::copy(b.dst, b.src, b.size);}};
+struct copy_std {void operator ()(sweep_buffer &b)const {::memcpy(b.dst, b.src, b.size);}};
+// 重叠区间向后移动一字节
+struct move_ky  {void operator ()(sweep_buffer &b)const {ky_memory::move(b.dst + 1, b.dst, b.size);}};
+struct move_std {void operator ()(sweep_buffer &b)const {::memmove(b.dst + 1, b.dst, b.size);}};
+struct zero_ky  {void operator ()(sweep_buffer &b)const {ky_memory::zero(b.dst, b.size);}};
+struct zero_std {void operator ()(sweep_buffer &b)const {::memset(b.dst, 0, b.size);}};
+
+void mem_copy_ky(ky_bench_state &s) {sweep(s, copy_ky());}
+void mem_copy_std(ky_bench_state &s) {sweep(s, copy_std());}
+void mem_move_ky(ky_bench_state &s) {sweep(s, move_ky());}
+void mem_move_std(ky_bench_state &s) {sweep(s, move_std());}
+void mem_zero_ky(ky_bench_state &s) {sweep(s, zero_ky());}
+void mem_zero_std(ky_bench_state &s) {sweep(s, zero_std());}
+
+//! 比较两块相同内容的缓冲区
+template <bool Ky>
+void mem_compare(ky_bench_state &s)
+{
+    sweep_buffer b(s.arg());
+    ::memcpy(b.dst, b.src, b.size);
+    s.items(b.size * b.loops);
+    while (s.next())
+    {
+        int r = 0;
+        for (int64 i = 0; i < b.loops; ++i)
+            r += Ky ? ky_memory::compare(b.dst, b.src, b.size) : ::memcmp(b.dst, b.src, b.size);
+        ky_bench::keep(r);
+    }
+}
+
+//!
+//! 分块分配器：成对申请释放，以及先全部申请再全部释放
+//!
+enum {SlabBlock = 48, SlabBatch = 4096};
+
+template <typename A>
+void alloc_pairs(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    while (s.next())
+    {
+        for (int64 i = 0; i < n; ++i)
+        {
+            void *p = A::alloc(SlabBlock);
+            ky_bench::escape(p);
+            A::destroy(p);
+        }
+    }
+}
+template <typename A>
+void alloc_batch(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    void **ptr = (void **)kyMalloc(sizeof(void*) * SlabBatch);
+    s.items(n);
+    while (s.next())
+    {
+        for (int64 i = 0; i < n; i += SlabBatch)
+        {
+            for (int k = 0; k < SlabBatch; ++k)
+                ptr[k] = A::alloc(SlabBlock);
+            ky_bench::escape(ptr);
+            for (int k = 0; k < SlabBatch; ++k)
+                A::destroy(ptr[k]);
+        }
+    }
+    kyFree(ptr);
+}
+struct slab_api
+{
+    static void *alloc(int64 n) {return ky_slab::alloc(n);}
+    static void destroy(void *p) {ky_slab::destroy(p);}
+};
+struct malloc_api
+{
+    static void *alloc(int64 n) {return kyMalloc(n);}
+    static void destroy(void *p) {kyFree(p);}
+};
+
+//! 节点型容器分别使用分块分配器和普通分配器
+template <typename C>
+void node_map(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    bench_random rnd;
+    while (s.next())
+    {
+        C *m = kyNew(C);
+        for (int64 i = 0; i < n; ++i)
+            m->insert(i64(rnd()), i);
+        ky_bench::escape(m);
+        kyDelete(m);
+    }
+}
+template <typename C>
+void node_linked(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    while (s.next())
+    {
+        C *l = kyNew(C);
+        for (int64 i = 0; i < n; ++i)
+            l->append(i);
+        ky_bench::escape(l);
+        kyDelete(l);
+    }
+}
+}
+
+void bench_memory_register()
+{
+    const int64 sizes[] = {16, 64, 256, 1024, 4096, 65536, 1 << 20, 16 << 20};
+    for (int i = 0; i < 8; ++i)
+    {
+        ky_bench::add("memory/copy", "ky_memory::copy", mem_copy_ky, sizes[i]);
+        ky_bench::add("memory/copy", "memcpy", mem_copy_std, sizes[i]);
+        ky_bench::add("memory/move", "ky_memory::move", mem_move_ky, sizes[i]);
+        ky_bench::add("memory/move", "memmove", mem_move_std, sizes[i]);
+        ky_bench::add("memory/zero", "ky_memory::zero", mem_zero_ky, sizes[i]);
+        ky_bench::add("memory/zero", "memset", mem_zero_std, sizes[i]);
+        ky_bench::add("memory/compare", "ky_memory::compare", mem_compare<true>, sizes[i]);
+        ky_bench::add("memory/compare", "memcmp", mem_compare<false>, sizes[i]);
+    }
+
+    ky_bench::add("alloc/pairs", "ky_slab", alloc_pairs<slab_api>, 2000000);
+    ky_bench::add("alloc/pairs", "malloc", alloc_pairs<malloc_api>, 2000000);
+    ky_bench::add("alloc/batch", "ky_slab", alloc_batch<slab_api>, 2000000);
+    ky_bench::add("alloc/batch", "malloc", alloc_batch<malloc_api>, 2000000);
+
+    typedef ky_map<i64, i64, ky_node_alloc<void> > slab_map;
+    typedef ky_map<i64, i64, ky_alloc<void> > heap_map;
+    typedef ky_linked<i64, ky_node_alloc<i64> > slab_linked;
+    typedef ky_linked<i64, ky_alloc<i64> > heap_linked;
+    ky_bench::add("alloc/node_map", "ky_map+ky_node_alloc", node_map<slab_map>, 1000000);
+    ky_bench::add("alloc/node_map", "ky_map+ky_alloc", node_map<heap_map>, 1000000);
+    ky_bench::add("alloc/node_linked", "ky_linked+ky_node_alloc", node_linked<slab_linked>, 1000000);
+    ky_bench::add("alloc/node_linked", "ky_linked+ky_alloc", node_linked<heap_linked>, 1000000);
+}
@@ -0,0 +1,78 @@
+#include "ky_bench.h"
+#include "tools/ky_algorlthm.h"
+#include "thread/ky_task.h"
+#include <algorithm>
+
+namespace
+{
+//! 输入数据的排列方式，arg为元素数
+enum sort_pattern
+{
+    Random,
+    Sorted,
+    Reversed,
+    FewUnique       ///< 只有16种取值
+};
+
+void sort_input(ky_array<i32> &a, int64 n, sort_pattern p)
+{
+    bench_random rnd(n);
+    a.resize(n);
+    i32 *d = a.data();
+    for (int64 i = 0; i < n; ++i)
+    {
+        switch (p)
+        {
+        case Random: d[i] = i32(rnd()); break;
+        case Sorted: d[i] = i32(i); break;
+        case Reversed: d[i] = i32(n - i); break;
+        case FewUnique: d[i] = i32(rnd() % 16); break;
+        }
+    }
+}
+
+struct sort_std    {static void run(i32 *a, int64 n) {std::sort(a, a + n);}};
+struct sort_stable {static void run(i32 *a, int64 n) {std::stable_sort(a, a + n);}};
+struct sort_quick  {static void run(i32 *a, int64 n) {ky_qsort(a, a + n);}};
+struct sort_merge  {static void run(i32 *a, int64 n) {ky_msort(a, n);}};
+struct sort_radix  {static void run(i32 *a, int64 n) {ky_rsort(a, n);}};
+struct sort_para   {static void run(i32 *a, int64 n) {ky_psort(a, n);}};
+
+template <typename S, sort_pattern P>
+void sort_case(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    ky_array<i32> input, work;
+    sort_input(input, n, P);
+    work.resize(n);
+    s.items(n);
+    while (s.next())
+    {
+        s.pause();
+        ky_memory::copy(work.data(), input.data(), n * sizeof(i32));
+        s.resume();
+        S::run(work.data(), n);
+        ky_bench::escape(work.data());
+    }
+}
+
+template <sort_pattern P>
+void add_pattern(const char *group, int64 n)
+{
+    ky_bench::add(group, "std::sort", sort_case<sort_std, P>, n);
+    ky_bench::add(group, "ky_qsort", sort_case<sort_quick, P>, n);
+    ky_bench::add(group, "ky_rsort", sort_case<sort_radix, P>, n);
+    ky_bench::add(group, "ky_psort", sort_case<sort_para, P>, n);
+    ky_bench::add(group, "std::stable_sort", sort_case<sort_stable, P>, n);
+    ky_bench::add(group, "ky_msort", sort_case<sort_merge, P>, n);
+}
+}
+
+void bench_sort_register()
+{
+    const int64 n = 10000000;
+    add_pattern<Random>("sort/random", n);
+    add_pattern<Sorted>("sort/sorted", n);
+    add_pattern<Reversed>("sort/reversed", n);
+    add_pattern<FewUnique>("sort/few_unique", n);
+}
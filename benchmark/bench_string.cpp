@@ -0,0 +1,250 @@
+#include "ky_bench.h"
+#include "tools/ky_string.h"
+#include <string>
+#include <functional>
+#include <algorithm>
+
+namespace
+{
+//! 生成n个字符的小写字母文本，needle取自末尾，使查找扫描几乎整个文本
+struct text_data
+{
+    std::string    latin1;
+    std::u16string utf16;
+    std::u16string needle16;
+    ky_string      text;
+    ky_string      needle;
+
+    text_data(int64 n, int64 nlen)
+    {
+        bench_random rnd(n + nlen);
+        latin1.resize(n);
+        for (int64 i = 0; i < n; ++i)
+            latin1[i] = char('a' + rnd() % 26);
+        utf16.assign(latin1.begin(), latin1.end());
+        needle16 = utf16.substr(n - nlen);
+        text = ky_string(latin1.c_str(), (int)n);
+        needle = ky_string(latin1.c_str() + n - nlen, (int)nlen);
+    }
+};
+
+void append_char_ky(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    while (s.next())
+    {
+        ky_string str;
+        for (int64 i = 0; i < n; ++i)
+            str.append(char('a' + (i & 15)));
+        ky_bench::keep(str);
+    }
+}
+void append_char_std(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    while (s.next())
+    {
+        std::u16string str;
+        for (int64 i = 0; i < n; ++i)
+            str.push_back(char16_t('a' + (i & 15)));
+        ky_bench::keep(str);
+    }
+}
+
+void append_word_ky(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    const ky_string word("hello, world ");
+    s.items(n);
+    while (s.next())
+    {
+        ky_string str;
+        for (int64 i = 0; i < n; ++i)
+            str.append(word);
+        ky_bench::keep(str);
+    }
+}
+void append_word_std(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    const std::u16string word(u"hello, world ");
+    s.items(n);
+    while (s.next())
+    {
+        std::u16string str;
+        for (int64 i = 0; i < n; ++i)
+            str.append(word);
+        ky_bench::keep(str);
+    }
+}
+
+//! 在4M字符的文本中查找arg长度的模式
+enum {SearchText = 4 << 20};
+
+void find_view(ky_bench_state &s)
+{
+    const text_data d(SearchText, s.arg());
+    const ky_string_view text(d.text), needle(d.needle);
+    s.items(SearchText);
+    while (s.next())
+        ky_bench::keep(text.find(needle));
+}
+void find_matcher(ky_bench_state &s)
+{
+    const text_data d(SearchText, s.arg());
+    const ky_string_view text(d.text);
+    const ky_string_matcher m(d.needle);
+    s.items(SearchText);
+    while (s.next())
+        ky_bench::keep(m.find(text));
+}
+void find_std(ky_bench_state &s)
+{
+    const text_data d(SearchText, s.arg());
+    s.items(SearchText);
+    while (s.next())
+        ky_bench::keep(d.utf16.find(d.needle16));
+}
+void find_std_bmh(ky_bench_state &s)
+{
+    const text_data d(SearchText, s.arg());
+    const std::boyer_moore_horspool_searcher<std::u16string::const_iterator>
+            searcher(d.needle16.begin(), d.needle16.end());
+    s.items(SearchText);
+    while (s.next())
+        ky_bench::keep(std::search(d.utf16.begin(), d.utf16.end(), searcher) - d.utf16.begin());
+}
+
+//! 两个只有最后一个字符不同的长字符串比较
+void compare_ky(ky_bench_state &s)
+{
+    const text_data d(s.arg(), 1);
+    ky_string other = d.text;
+    other[(int)s.arg() - 1] = ky_char('#');
+    const ky_string_view a(d.text), b(other);
+    s.items(s.arg());
+    while (s.next())
+        ky_bench::keep(a.compare(b));
+}
+void compare_std(ky_bench_state &s)
+{
+    const text_data d(s.arg(), 1);
+    std::u16string other = d.utf16;
+    other[s.arg() - 1] = u'#';
+    s.items(s.arg());
+    while (s.next())
+        ky_bench::keep(d.utf16.compare(other));
+}
+
+void number_ky(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    while (s.next())
+    {
+        int64 len = 0;
+        for (int64 i = 0; i < n; ++i)
+            len += ky_string::number(i * 7919).count();
+        ky_bench::keep(len);
+    }
+}
+void number_std(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    while (s.next())
+    {
+        int64 len = 0;
+        for (int64 i = 0; i < n; ++i)
+            len += std::to_string(i * 7919).size();
+        ky_bench::keep(len);
+    }
+}
+
+void hash_ky(ky_bench_state &s)
+{
+    const text_data d(s.arg(), 1);
+    const ky_string_view v(d.text);
+    s.items(s.arg());
+    while (s.next())
+        ky_bench::keep(ky_hash_f(v));
+}
+void hash_std(ky_bench_state &s)
+{
+    const text_data d(s.arg(), 1);
+    const std::hash<std::u16string> h;
+    s.items(s.arg());
+    while (s.next())
+        ky_bench::keep(h(d.utf16));
+}
+
+//!
+//! 编码转换：纯ASCII文本和中英混合文本
+//!
+ky_string unicode_text(int64 n, bool mixed)
+{
+    ky_string str;
+    const ky_string ascii("The quick brown fox jumps over the lazy dog. ");
+    const wchar_t cjk[] = L"快速的棕色狐狸";
+    while (str.count() < n)
+    {
+        str.append(ascii);
+        if (mixed)
+            str.append(cjk);
+    }
+    return str;
+}
+void to_utf8(ky_bench_state &s, bool mixed)
+{
+    const ky_string str = unicode_text(s.arg(), mixed);
+    s.items(str.count());
+    while (s.next())
+        ky_bench::keep(str.to_utf8());
+}
+void from_utf8(ky_bench_state &s, bool mixed)
+{
+    const ky_utf8 u8 = unicode_text(s.arg(), mixed).to_utf8();
+    s.items(u8.count());
+    while (s.next())
+    {
+        ky_string str;
+        str.from_utf8(u8.data(), (int)u8.count());
+        ky_bench::keep(str);
+    }
+}
+void to_utf8_ascii(ky_bench_state &s) {to_utf8(s, false);}
+void to_utf8_mixed(ky_bench_state &s) {to_utf8(s, true);}
+void from_utf8_ascii(ky_bench_state &s) {from_utf8(s, false);}
+void from_utf8_mixed(ky_bench_state &s) {from_utf8(s, true);}
+}
+
+void bench_string_register()
+{
+    ky_bench::add("string/append_char", "ky_string", append_char_ky, 10000000);
+    ky_bench::add("string/append_char", "std::u16string", append_char_std, 10000000);
+    ky_bench::add("string/append_word", "ky_string", append_word_ky, 1000000);
+    ky_bench::add("string/append_word", "std::u16string", append_word_std, 1000000);
+
+    const int64 needles[] = {4, 16, 64, 256};
+    for (int i = 0; i < 4; ++i)
+    {
+        ky_bench::add("string/find", "ky_string_view", find_view, needles[i]);
+        ky_bench::add("string/find", "ky_string_matcher", find_matcher, needles[i]);
+        ky_bench::add("string/find", "std::u16string", find_std, needles[i]);
+        ky_bench::add("string/find", "std::boyer_moore_horspool_searcher", find_std_bmh, needles[i]);
+    }
+
+    ky_bench::add("string/compare", "ky_string_view", compare_ky, 1 << 20);
+    ky_bench::add("string/compare", "std::u16string", compare_std, 1 << 20);
+    ky_bench::add("string/number", "ky_string::number", number_ky, 1000000);
+    ky_bench::add("string/number", "std::to_string", number_std, 1000000);
+    ky_bench::add("string/hash", "ky_hash_f", hash_ky, 1 << 20);
+    ky_bench::add("string/hash", "std::hash<u16string>", hash_std, 1 << 20);
+
+    ky_bench::add("unicode/to_utf8", "ascii", to_utf8_ascii, 1 << 20);
+    ky_bench::add("unicode/to_utf8", "mixed", to_utf8_mixed, 1 << 20);
+    ky_bench::add("unicode/from_utf8", "ascii", from_utf8_ascii, 1 << 20);
+    ky_bench::add("unicode/from_utf8", "mixed", from_utf8_mixed, 1 << 20);
+}
@@ -0,0 +1,211 @@
+#include "ky_bench.h"
+#include "thread/ky_mpsc.h"
+#include "thread/ky_thread.h"
+#include "thread/ky_lock.h"
+#include "thread/ky_task.h"
+
+namespace
+{
+struct mpsc_item : ky_mpsc_node
+{
+    i64 value;
+};
+
+//! 无锁队列
+struct queue_mpsc
+{
+    ky_mpsc_queue q;
+
+    void push(ky_mpsc_node *n) {q.push(n);}
+    ky_mpsc_node *pop() {return q.pop();}
+};
+//! 互斥锁保护的侵入式队列，替换前的投递队列实现方式
+struct queue_mutex
+{
+    ky_mutex      lock;
+    ky_mpsc_node *head;
+    ky_mpsc_node *tail;
+
+    queue_mutex():head(0), tail(0){}
+
+    void push(ky_mpsc_node *n)
+    {
+        n->next.store(0, Fence_Relaxed);
+        lock.lock();
+        if (tail)
+            tail->next.store(n, Fence_Relaxed);
+        else
+            head = n;
+        tail = n;
+        lock.unlock();
+    }
+    ky_mpsc_node *pop()
+    {
+        lock.lock();
+        ky_mpsc_node *n = head;
+        if (n)
+        {
+            head = n->next.load(Fence_Relaxed);
+            if (head == 0)
+                tail = 0;
+        }
+        lock.unlock();
+        return n;
+    }
+};
+
+template <typename Q>
+class mpsc_producer : public ky_thread
+{
+public:
+    Q              *queue;
+    mpsc_item      *items;
+    int64           count;
+    ky_atomic<int> *go;
+
+    virtual void run()
+    {
+        while (!go->load(Fence_Acquire))
+            ky_thread::yield();
+        for (int64 i = 0; i < count; ++i)
+            queue->push(&items[i]);
+    }
+};
+
+//! arg个节点平均分给P个生产者，主线程作为唯一消费者全部取出
+template <typename Q, int P>
+void mpsc_case(ky_bench_state &s)
+{
+    const int64 n = s.arg() / P * P;
+    mpsc_item *items = kyNew(mpsc_item[n]);
+    for (int64 i = 0; i < n; ++i)
+        items[i].value = i;
+    s.items(n);
+    while (s.next())
+    {
+        s.pause();
+        Q *q = kyNew(Q);
+        ky_atomic<int> go(0);
+        mpsc_producer<Q> producer[P];
+        for (int i = 0; i < P; ++i)
+        {
+            producer[i].queue = q;
+            producer[i].items = items + i * (n / P);
+            producer[i].count = n / P;
+            producer[i].go = &go;
+            producer[i].start();
+        }
+        s.resume();
+
+        go.store(1, Fence_Release);
+        i64 sum = 0;
+        for (int64 got = 0; got < n; )
+        {
+            ky_mpsc_node *node = q->pop();
+            if (node == 0)
+                continue;
+            sum += static_cast<mpsc_item*>(node)->value;
+            ++got;
+        }
+        ky_bench::keep(sum);
+
+        s.pause();
+        for (int i = 0; i < P; ++i)
+            producer[i].wait();
+        kyDelete(q);
+        s.resume();
+    }
+    kyDeleteArray(items);
+}
+
+//! 数组求和：串行和任务池并行
+void sum_serial(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    ky_array<i64> a(n);
+    for (int64 i = 0; i < n; ++i)
+        a[(int)i] = i;
+    s.items(n);
+    while (s.next())
+    {
+        const i64 *d = a.data();
+        i64 sum = 0;
+        for (int64 i = 0; i < n; ++i)
+            sum += d[i];
+        ky_bench::keep(sum);
+    }
+}
+
+struct sum_range
+{
+    const i64      *data;
+    ky_atomic<i64> *sum;
+
+    void operator ()(int64 first, int64 last)const
+    {
+        i64 r = 0;
+        for (int64 i = first; i < last; ++i)
+            r += data[i];
+        sum->fetch_add(r);
+    }
+};
+void sum_parallel(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    ky_array<i64> a(n);
+    for (int64 i = 0; i < n; ++i)
+        a[(int)i] = i;
+    ky_task_pool *pool = ky_task_pool::global();
+    s.items(n);
+    while (s.next())
+    {
+        ky_atomic<i64> sum(0);
+        const sum_range f = {a.data(), &sum};
+        pool->parallel_for(0, n, f);
+        ky_bench::keep(sum.load());
+    }
+}
+
+//! 提交大量小任务并等待期值
+struct small_task
+{
+    int64 v;
+    int64 operator ()()const {return v * 2;}
+};
+void task_async(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    ky_task_pool *pool = ky_task_pool::global();
+    ky_array<ky_future<int64> > futures;
+    s.items(n);
+    while (s.next())
+    {
+        futures.clear();
+        futures.reserve(n);
+        for (int64 i = 0; i < n; ++i)
+        {
+            const small_task t = {i};
+            futures.append(pool->async(t));
+        }
+        int64 sum = 0;
+        for (int64 i = 0; i < n; ++i)
+            sum += futures[(int)i].get();
+        ky_bench::keep(sum);
+    }
+}
+}
+
+void bench_thread_register()
+{
+    const int64 n = 4000000;
+    ky_bench::add("mpsc/1p", "ky_mpsc_queue", mpsc_case<queue_mpsc, 1>, n);
+    ky_bench::add("mpsc/1p", "ky_mutex+list", mpsc_case<queue_mutex, 1>, n);
+    ky_bench::add("mpsc/2p", "ky_mpsc_queue", mpsc_case<queue_mpsc, 2>, n);
+    ky_bench::add("mpsc/2p", "ky_mutex+list", mpsc_case<queue_mutex, 2>, n);
+    ky_bench::add("mpsc/4p", "ky_mpsc_queue", mpsc_case<queue_mpsc, 4>, n);
+    ky_bench::add("mpsc/4p", "ky_mutex+list", mpsc_case<queue_mutex, 4>, n);
+
+    ky_bench::add("task/sum", "serial", sum_serial, 10000000);
+    ky_bench::add("task/sum", "ky_task_pool::parallel_for", sum_parallel, 10000000);
+    ky_bench::add("task/async", "ky_task_pool::async", task_async, 100000);
+}
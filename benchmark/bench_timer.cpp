@@ -0,0 +1,197 @@
+#include "ky_bench.h"
+#include "thread/ky_timer_wheel.h"
+#include <map>
+#if kyOSIsLinux
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+//! 超时取[1, 30000]毫秒，模拟连接超时
+int64 timer_timeout(bench_random &rnd) {return int64(rnd() % 30000) + 1;}
+
+//!
+//! 时间轮和以到期时间为键的有序表(堆/红黑树定时器的常见实现)
+//!
+struct timer_wheel
+{
+    typedef ky_timer_node node;
+    ky_timer_wheel w;
+    int64          now;
+
+    timer_wheel():w(0), now(0){}
+
+    void start(node *t, int64 timeout) {w.start(t, timeout);}
+    void stop(node *t) {w.stop(t);}
+    //! 推进到所有定时器到期，返回到期数
+    int64 drain()
+    {
+        int64 fired = 0;
+        for (int64 to = w.next_timeout(now); to >= 0; to = w.next_timeout(now))
+        {
+            now += to;
+            w.advance(now);
+            while (w.fetch())
+                ++fired;
+        }
+        return fired;
+    }
+};
+
+struct timer_map
+{
+    typedef std::multimap<int64, void*> table;
+    struct node
+    {
+        table::iterator it;
+        bool            active;
+        node():active(false){}
+    };
+    table  m;
+    int64  now;
+
+    timer_map():now(0){}
+
+    void start(node *t, int64 timeout)
+    {
+        if (t->active)
+            m.erase(t->it);
+        t->it = m.insert(std::make_pair(now + timeout, (void*)t));
+        t->active = true;
+    }
+    void stop(node *t)
+    {
+        if (t->active)
+            m.erase(t->it);
+        t->active = false;
+    }
+    int64 drain()
+    {
+        int64 fired = 0;
+        while (!m.empty())
+        {
+            now = m.begin()->first;
+            while (!m.empty() && m.begin()->first <= now)
+            {
+                ((node*)m.begin()->second)->active = false;
+                m.erase(m.begin());
+                ++fired;
+            }
+        }
+        return fired;
+    }
+};
+
+//! 启动arg个定时器后全部停止
+template <typename T>
+void arm_cancel(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    typename T::node *nodes = kyNew(typename T::node[n]);
+    s.items(n);
+    while (s.next())
+    {
+        s.pause();
+        T *t = kyNew(T);
+        bench_random rnd(n);
+        s.resume();
+
+        for (int64 i = 0; i < n; ++i)
+            t->start(&nodes[i], timer_timeout(rnd));
+        for (int64 i = 0; i < n; ++i)
+            t->stop(&nodes[i]);
+        ky_bench::escape(t);
+
+        s.pause();
+        kyDelete(t);
+        s.resume();
+    }
+    kyDeleteArray(nodes);
+}
+
+//! arg个已启动的定时器各重新计时一次，如收到数据后重置连接超时
+template <typename T>
+void rearm(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    typename T::node *nodes = kyNew(typename T::node[n]);
+    T *t = kyNew(T);
+    bench_random rnd(n);
+    for (int64 i = 0; i < n; ++i)
+        t->start(&nodes[i], timer_timeout(rnd));
+    s.items(n);
+    while (s.next())
+    {
+        for (int64 i = 0; i < n; ++i)
+            t->start(&nodes[i], timer_timeout(rnd));
+        ky_bench::escape(t);
+    }
+    for (int64 i = 0; i < n; ++i)
+        t->stop(&nodes[i]);
+    kyDelete(t);
+    kyDeleteArray(nodes);
+}
+
+//! 启动arg个定时器并推进时间直到全部到期
+template <typename T>
+void arm_expire(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    typename T::node *nodes = kyNew(typename T::node[n]);
+    s.items(n);
+    while (s.next())
+    {
+        s.pause();
+        T *t = kyNew(T);
+        bench_random rnd(n);
+        s.resume();
+
+        for (int64 i = 0; i < n; ++i)
+            t->start(&nodes[i], timer_timeout(rnd));
+        ky_bench::keep(t->drain());
+
+        s.pause();
+        kyDelete(t);
+        s.resume();
+    }
+    kyDeleteArray(nodes);
+}
+
+#if kyOSIsLinux
+//! 替换前每个定时器一个timerfd: 创建、设置、停止、关闭
+void arm_cancel_timerfd(ky_bench_state &s)
+{
+    const int64 n = s.arg();
+    s.items(n);
+    while (s.next())
+    {
+        bench_random rnd(n);
+        for (int64 i = 0; i < n; ++i)
+        {
+            const int fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            const int64 ms = timer_timeout(rnd);
+            itimerspec its = {{0, 0}, {time_t(ms / 1000), long(ms % 1000) * 1000000}};
+            ::timerfd_settime(fd, 0, &its, 0);
+            its.it_value.tv_sec = its.it_value.tv_nsec = 0;
+            ::timerfd_settime(fd, 0, &its, 0);
+            ::close(fd);
+        }
+    }
+}
+#endif
+}
+
+void bench_timer_register()
+{
+    const int64 n = 1000000;
+    ky_bench::add("timer/arm_cancel", "ky_timer_wheel", arm_cancel<timer_wheel>, n);
+    ky_bench::add("timer/arm_cancel", "std::multimap", arm_cancel<timer_map>, n);
+#if kyOSIsLinux
+    ky_bench::add("timer/arm_cancel", "timerfd", arm_cancel_timerfd, n / 10);
+#endif
+    ky_bench::add("timer/rearm", "ky_timer_wheel", rearm<timer_wheel>, n);
+    ky_bench::add("timer/rearm", "std::multimap", rearm<timer_map>, n);
+    ky_bench::add("timer/arm_expire", "ky_timer_wheel", arm_expire<timer_wheel>, n);
+    ky_bench::add("timer/arm_expire", "std::multimap", arm_expire<timer_map>, n);
+}
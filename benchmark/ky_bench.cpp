@@ -0,0 +1,276 @@
+#include "ky_bench.h"
+#include "arch/ky_timer.h"
+#include "arch/ky_memory.h"
+#include "tools/ky_algorlthm.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#if kyOSIsLinux
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace
+{
+struct bench_case
+{
+    const char        *group;
+    const char        *name;
+    ky_bench::bench_fn fn;
+    int64              arg;
+    int                flags;
+};
+
+ky_array<bench_case> &cases()
+{
+    static ky_array<bench_case> list;
+    return list;
+}
+
+inline u64 now()
+{
+    return ky_timer::nanosec(ky_timer::Monotonic);
+}
+
+//! 将当前线程绑定到第cpu个处理器
+bool pin_cpu(int cpu)
+{
+#if kyOSIsLinux
+    u64 mask[16];
+    if (cpu < 0 || cpu >= int(sizeof(mask) * 8))
+        return false;
+    ky_memory::zero(mask, sizeof(mask));
+    mask[cpu / 64] |= u64(1) << (cpu % 64);
+    return ::syscall(__NR_sched_setaffinity, 0, sizeof(mask), mask) == 0;
+#elif kyOSIsWin32
+    if (cpu < 0 || cpu >= int(sizeof(DWORD_PTR) * 8))
+        return false;
+    return ::SetThreadAffinityMask(::GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+//! 在线的处理器数量
+int cpu_count()
+{
+#if kyOSIsLinux
+    const long n = ::sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? int(n) : 1;
+#elif kyOSIsWin32
+    SYSTEM_INFO si;
+    ::GetSystemInfo(&si);
+    return int(si.dwNumberOfProcessors);
+#else
+    return 1;
+#endif
+}
+
+//! 输出JSON字符串，转义引号、反斜杠和控制字符
+void json_string(FILE *fp, const char *s)
+{
+    fputc('"', fp);
+    for (; s && *s; ++s)
+    {
+        const unsigned char c = *s;
+        if (c == '"' || c == '\\')
+            fprintf(fp, "\\%c", c);
+        else if (c < 0x20)
+            fprintf(fp, "\\u%04x", c);
+        else
+            fputc(c, fp);
+    }
+    fputc('"', fp);
+}
+
+bool matches(const bench_case &bc, const char *filter)
+{
+    if (filter == 0)
+        return true;
+    char full[512];
+    snprintf(full, sizeof(full), "%s/%s/%lld", bc.group, bc.name, (long long)bc.arg);
+    return strstr(full, filter) != 0;
+}
+
+//! 百分位，samples已排序
+u64 percentile(const ky_array<u64> &s, int pct)
+{
+    const int64 n = s.count();
+    int64 i = (n * pct + 99) / 100 - 1;
+    if (i < 0)
+        i = 0;
+    return s[int(i)];
+}
+}
+
+ky_bench_state::ky_bench_state(int64 arg, int warmup, int reps):
+    _arg(arg),
+    _items(1),
+    _warmup(warmup),
+    _reps(reps),
+    _round(-1),
+    _t0(0),
+    _paused(0),
+    _pause_t0(0),
+    _skip(0),
+    _samples()
+{
+    _samples.reserve(reps);
+}
+
+bool ky_bench_state::next()
+{
+    const u64 t1 = now();
+    if (_round >= _warmup)
+        _samples.append(t1 - _t0 - _paused);
+    ++_round;
+    if (_skip || _round >= _warmup + _reps)
+        return false;
+
+    _paused = 0;
+    _t0 = now();
+    return true;
+}
+void ky_bench_state::pause()
+{
+    _pause_t0 = now();
+}
+void ky_bench_state::resume()
+{
+    _paused += now() - _pause_t0;
+}
+
+void ky_bench::add(const char *group, const char *name, bench_fn fn, int64 arg, int flags)
+{
+    const bench_case bc = {group, name, fn, arg, flags};
+    cases().append(bc);
+}
+
+int ky_bench::run(int argc, char **argv)
+{
+    const char *filter = 0;
+    const char *out = 0;
+    int reps = 5;
+    int warmup = 1;
+    int cpu = -1;
+    bool large = false;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool more = i + 1 < argc;
+        if (!strcmp(argv[i], "--filter") && more)
+            filter = argv[++i];
+        else if (!strcmp(argv[i], "--out") && more)
+            out = argv[++i];
+        else if (!strcmp(argv[i], "--reps") && more)
+            reps = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--warmup") && more)
+            warmup = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--cpu") && more)
+            cpu = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--large"))
+            large = true;
+        else if (!strcmp(argv[i], "--list"))
+            list = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [--filter s] [--reps n] [--warmup n] "
+                            "[--cpu n] [--out file] [--large] [--list]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (reps < 1)
+        reps = 1;
+    if (warmup < 0)
+        warmup = 0;
+
+    const ky_array<bench_case> &all = cases();
+    if (list)
+    {
+        for (int i = 0; i < all.count(); ++i)
+        {
+            const bench_case &bc = all[i];
+            if (matches(bc, filter) && (large || !(bc.flags & Large)))
+                printf("%s/%s/%lld\n", bc.group, bc.name, (long long)bc.arg);
+        }
+        return 0;
+    }
+
+    if (cpu >= 0 && !pin_cpu(cpu))
+    {
+        fprintf(stderr, "bench: cannot pin to cpu %d\n", cpu);
+        cpu = -1;
+    }
+
+    FILE *fp = out ? fopen(out, "w") : stdout;
+    if (fp == 0)
+    {
+        fprintf(stderr, "bench: cannot open %s\n", out);
+        return 1;
+    }
+
+    char date[32] = {0};
+    const time_t t = time(0);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&t));
+
+    fprintf(fp, "{\n  \"context\": {\"library\": \"libky2\", \"date\": \"%s\", "
+                "\"cpus\": %d, \"pinned_cpu\": %d, \"reps\": %d, \"warmup\": %d, \"compiler\": ",
+            date, cpu_count(), cpu, reps, warmup);
+#if defined(__VERSION__)
+    json_string(fp, __VERSION__);
+#else
+    json_string(fp, "unknown");
+#endif
+    fprintf(fp, "},\n  \"benchmarks\": [");
+
+    bool first = true;
+    for (int i = 0; i < all.count(); ++i)
+    {
+        const bench_case &bc = all[i];
+        if (!matches(bc, filter) || (!large && (bc.flags & Large)))
+            continue;
+
+        fprintf(stderr, "%s/%s/%lld ...\n", bc.group, bc.name, (long long)bc.arg);
+        ky_bench_state st(bc.arg, warmup, reps);
+        bc.fn(st);
+
+        fprintf(fp, "%s\n    {\"group\": ", first ? "" : ",");
+        first = false;
+        json_string(fp, bc.group);
+        fprintf(fp, ", \"name\": ");
+        json_string(fp, bc.name);
+        fprintf(fp, ", \"arg\": %lld", (long long)bc.arg);
+
+        ky_array<u64> s = st.samples();
+        const int n = (int)s.count();
+        if (st.skipped() || n == 0)
+        {
+            fprintf(fp, ", \"skipped\": ");
+            json_string(fp, st.skipped() ? st.skipped() : "no samples");
+            fprintf(fp, "}");
+            continue;
+        }
+
+        ky_qsort(s.data(), s.data() + n);
+        u64 sum = 0;
+        for (int k = 0; k < n; ++k)
+            sum += s[k];
+        const u64 median = n & 1 ? s[n / 2] : (s[n / 2 - 1] + s[n / 2]) / 2;
+        const int64 items = st.items() > 0 ? st.items() : 1;
+
+        fprintf(fp, ", \"items\": %lld, \"reps\": %d, \"min_ns\": %llu, \"median_ns\": %llu, "
+                    "\"p99_ns\": %llu, \"mean_ns\": %llu, \"ns_per_item\": %.3f}",
+                (long long)items, n, (unsigned long long)s[0],
+                (unsigned long long)median, (unsigned long long)percentile(s, 99),
+                (unsigned long long)(sum / n), double(median) / double(items));
+        fflush(fp);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+    if (out)
+        fclose(fp);
+    return 0;
+}
@@ -0,0 +1,159 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_bench.h
+ * @brief    微基准测试运行器
+ *       1.每个测试项为一个函数，在 while (s.next()) 循环内执行一次采样
+ *       2.先执行预热次数，再按重复次数采样，统计 min/median/p99/mean
+ *       3.计时使用 ky_timer::nanosec 的单调时钟，pause/resume 之间的时间不计入
+ *       4.运行前可将主线程绑定到指定 CPU，减少迁移和频率抖动
+ *       5.结果以 JSON 输出，便于按版本对比回归
+ * @note   测试项在 main 中显式注册，不使用全局静态对象自动注册(见 ky_main.h 说明)
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/17
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/17 | 1.0.0.1   | kunyang  | 创建文件
+ *
+ */
+#ifndef KY_BENCH_H
+#define KY_BENCH_H
+
+#include "ky_define.h"
+#include "tools/ky_array.h"
+
+//!
+//! \brief The ky_bench_state class 一个测试项运行时的状态
+//!
+class ky_bench_state
+{
+public:
+    ky_bench_state(int64 arg, int warmup, int reps);
+
+    //!
+    //! \brief next 结束上一次采样并开始下一次
+    //! \return 预热和采样全部完成时返回false
+    //!
+    bool next();
+    //!
+    //! \brief pause resume 暂停和恢复计时，用于排除每次采样的准备工作
+    //!
+    void pause();
+    void resume();
+
+    //!
+    //! \brief arg 测试项的规模参数
+    //!
+    int64 arg()const {return _arg;}
+    //!
+    //! \brief items 设置每次采样处理的元素数，用于计算每项耗时
+    //!
+    void items(int64 n) {_items = n;}
+    int64 items()const {return _items;}
+    //!
+    //! \brief skip 当前环境不能运行此项时调用，结果中标记为跳过
+    //!
+    void skip(const char *why) {_skip = why;}
+    const char *skipped()const {return _skip;}
+
+    //!
+    //! \brief samples 每次采样的耗时(纳秒)
+    //!
+    const ky_array<u64> &samples()const {return _samples;}
+
+private:
+    int64         _arg;
+    int64         _items;
+    int           _warmup;
+    int           _reps;
+    int           _round;
+    u64           _t0;
+    u64           _paused;
+    u64           _pause_t0;
+    const char   *_skip;
+    ky_array<u64> _samples;
+};
+
+//!
+//! \brief The ky_bench class 测试项注册和运行
+//!
+class ky_bench
+{
+public:
+    typedef void (*bench_fn)(ky_bench_state &);
+
+    enum
+    {
+        Large = 0x01    ///< 耗时或内存占用很大，只有 --large 时运行
+    };
+
+    //!
+    //! \brief add 注册测试项，结果名为 group/name/arg
+    //! \param group 测试分组，如 "map/insert"
+    //! \param name  被测实现，如 "ky_map<i32,i32>"
+    //!
+    static void add(const char *group, const char *name, bench_fn fn, int64 arg, int flags = 0);
+
+    //!
+    //! \brief run 解析命令行参数并运行所有匹配的测试项
+    //! \note 参数：
+    //!   --filter <子串>  只运行名称包含子串的测试项
+    //!   --reps <n>       采样次数，默认 5
+    //!   --warmup <n>     预热次数，默认 1
+    //!   --cpu <n>        绑定到第 n 个 CPU，默认不绑定
+    //!   --out <文件>     JSON 输出到文件，默认输出到标准输出
+    //!   --large          同时运行标记为 Large 的测试项
+    //!   --list           只列出测试项
+    //! \return 进程退出码
+    //!
+    static int run(int argc, char **argv);
+
+    //!
+    //! \brief escape 阻止编译器优化掉只写不读的结果
+    //!
+    static inline void escape(const void *p)
+    {
+#if kyCompilerIsGNUC || kyCompilerIsCLANG
+        kyInlineASM("" : : "g"(p) : "memory");
+#else
+        static const void *volatile sink;
+        sink = p;
+#endif
+    }
+    template <typename T>
+    static inline void keep(const T &v) {escape(&v);}
+};
+
+//! 各个测试文件的注册入口
+void bench_container_register();
+void bench_assoc_register();
+void bench_string_register();
+void bench_memory_register();
+void bench_sort_register();
+void bench_thread_register();
+void bench_timer_register();
+
+//!
+//! \brief The bench_random struct 测试数据用的快速伪随机数(xorshift64*)
+//!
+struct bench_random
+{
+    u64 s;
+
+    explicit bench_random(u64 seed = 0x9E3779B97F4A7C15ull):s(seed ? seed : 1){}
+    inline u64 operator ()()
+    {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return s * 0x2545F4914F6CDD1Dull;
+    }
+};
+
+#endif // KY_BENCH_H
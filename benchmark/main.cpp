@@ -0,0 +1,15 @@
+#include "ky_bench.h"
+
+int ky_main(int argc, char **argv)
+{
+#ifdef kyHasBenchFull
+    bench_container_register();
+    bench_assoc_register();
+    bench_memory_register();
+#endif
+    bench_string_register();
+    bench_sort_register();
+    bench_thread_register();
+    bench_timer_register();
+    return ky_bench::run(argc, argv);
+}
@@ -27,6 +27,9 @@ MemorySource += \
     $${ky2ArchPath}/memory/dynaddr.cpp \
     $${ky2ArchPath}/memory/dynarray.cpp \
     $${ky2ArchPath}/memory/virmemory.cpp \
+    $${ky2ArchPath}/memory/slab.cpp \
+    $${ky2ArchPath}/memory/memstats.cpp \
+    $${ky2ArchPath}/memory/memops.cpp \
 
 HEADERS += \
     $${CPUHeader} \
@@ -0,0 +1,46 @@
+#-------------------------------------------------
+#
+# 容器库和基础组件的微基准测试
+#   运行: ky2bench [--filter s] [--reps n] [--warmup n] [--cpu n] [--out file] [--large] [--list]
+#   结果为JSON，可按版本保存后对比
+#   容器、关联容器和内存的测试依赖的ky_linked/ky_map/ky_hash暂时无法编译，
+#   默认不加入，修复后以 qmake CONFIG+=bench_full 打开
+#
+#-------------------------------------------------
+
+include (../bulid_library.pri)
+include (./path.pri)
+
+ky2BenchPath = $${PWD}/../benchmark
+INCLUDEPATH += $${ky2BenchPath}
+
+CONFIG -= qt
+CONFIG += console c++17
+TARGET = ky2bench$${BuildSuffix}
+TEMPLATE = app
+
+LIBS += -lky2$${BuildSuffix}
+contains(Platform, Linux){
+    LIBS += -lpthread -ldl
+}
+
+QMAKE_CXXFLAGS += -Wno-unknown-pragmas
+
+HEADERS += \
+    $${ky2BenchPath}/ky_bench.h
+
+SOURCES += \
+    $${ky2BenchPath}/ky_bench.cpp \
+    $${ky2BenchPath}/bench_string.cpp \
+    $${ky2BenchPath}/bench_sort.cpp \
+    $${ky2BenchPath}/bench_thread.cpp \
+    $${ky2BenchPath}/bench_timer.cpp \
+    $${ky2BenchPath}/main.cpp
+
+bench_full {
+    DEFINES += kyHasBenchFull
+    SOURCES += \
+        $${ky2BenchPath}/bench_container.cpp \
+        $${ky2BenchPath}/bench_assoc.cpp \
+        $${ky2BenchPath}/bench_memory.cpp
+}
@@ -7,16 +7,22 @@ HEADERS += \
     $${ky2ThreadPath}/signal_posix.h \
     $${ky2ThreadPath}/posix_fd.h \
     $${ky2ThreadPath}/pipe_posix.h  \
+    $${ky2ThreadPath}/uring_posix.h \
+    $${ky2ThreadPath}/poll_slots.h \
     $${ky2ThreadPath}/event_poll.h \
-    $${ky2ThreadPath}/thread_dispatch.h
+    $${ky2ThreadPath}/thread_dispatch.h \
+    $${ky2ThreadPath}/task_deque.h
 
 SOURCES += \
     $${ky2ThreadPath}/timer_posix.cpp \
     $${ky2ThreadPath}/signal_posix.cpp \
     $${ky2ThreadPath}/pipe_posix.cpp \
+    $${ky2ThreadPath}/uring_posix.cpp \
     $${ky2ThreadPath}/event_windows.cpp \
     $${ky2ThreadPath}/event_win32.cpp \
     $${ky2ThreadPath}/event_posix.cpp \
     $${ky2ThreadPath}/thread_dispatch.cpp \
     $${ky2ThreadPath}/ky_lock.cpp \
-    $${ky2ThreadPath}/ky_thread.cpp
+    $${ky2ThreadPath}/ky_thread.cpp \
+    $${ky2ThreadPath}/task_pool.cpp \
+    $${ky2ThreadPath}/timer_wheel.cpp
@@ -19,6 +19,7 @@ HEADERS += \
     $${Image_Header} \
     $${ky2ToolsPath}/unicode_table.h \
     $${ky2ToolsPath}/ky_ucsprivate.h \
+    $${ky2ToolsPath}/ky_strsearch.h \
     $${ky2ToolsPath}/ky_ucs.h \
     $${ky2ToolsPath}/ky_unicode.h \
     $${ky2ToolsPath}/ky_number_integer.h \
@@ -39,6 +40,8 @@ SOURCES += \
     $${ky2ToolsPath}/ky_char.cpp \
     $${ky2ToolsPath}/ky_unicode.cpp \
     $${ky2ToolsPath}/ky_string.cpp \
+    $${ky2ToolsPath}/ky_strsearch.cpp \
+    $${ky2ToolsPath}/ky_atom.cpp \
     $${ky2ToolsPath}/ky_path.cpp \
     $${ky2ToolsPath}/ky_stream.cpp \
     $${ky2ToolsPath}/ky_color.cpp \
@@ -19,6 +19,8 @@
  * @brief    内存的操作定义
  *       1.ky_alloc 简单的内存分配器
  *       2.ky_memory 内存的拷贝及清理的快速实现，可以评估那种加速方式更高效
+ *       3.ky_slab 按尺寸分级的分块分配器，用于节点型容器
+ *       4.ky_memory_stats 按标记的内存记账，定义kyHasMemoryStats时生效
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
@@ -32,6 +34,15 @@
  * 2014/01/10 | 1.0.0.2   | kunyang  | 加入快速评估加速指令的选择
  * 2014/02/20 | 1.0.1.0   | kunyang  | 建立ky_alloc
  * 2018/03/10 | 1.0.1.1   | kunyang  | 加入内存增长计算
+ * 2026/10/17 | 1.0.2.1   | kunyang  | 加入线程缓存的分块分配器ky_slab
+ * 2026/10/17 | 1.0.2.2   | kunyang  | 虚拟内存接口改为静态函数并与实现同名
+ * 2026/10/17 | 1.0.2.3   | kunyang  | dynarray加入保留虚拟地址空间按需提交的模式
+ * 2026/10/17 | 1.0.2.4   | kunyang  | copy/move/zero/compare按cpu能力选择AVX2/AVX-512实现
+ * 2026/10/17 | 1.0.2.5   | kunyang  | 区分dynaddr和dynarray的头结构名，避免共用同一符号
+ * 2026/10/17 | 1.0.2.6   | kunyang  | 修正dynaddr头部有空闲时尾部扩充不足
+ * 2026/10/17 | 1.0.3.1   | kunyang  | 加入按标记的内存记账ky_memory_stats和记账分配器
+ * 2026/10/17 | 1.0.3.2   | kunyang  | ky_slab的大内存改为直接malloc，不再按块对齐
+ * 2026/10/17 | 1.0.3.3   | kunyang  | dynarray只在reserve_arena时使用分配区
  *
  */
 
@@ -69,6 +80,191 @@ struct ky_alloc
     }
 };
 
+//!
+//! \brief The ky_slab struct 按尺寸分级的分块分配器
+//! \note
+//!   1.小于等于MaxSmall的内存按尺寸级别从64K的块中切分
+//!   2.每个线程缓存各级别的空闲链表，分配和释放不需要加锁
+//!   3.线程缓存不足或过多时和全局链表批量交换
+//!   4.大于MaxSmall的内存直接用kyMalloc申请，前面带16字节的尺寸头
+//!
+struct ky_slab
+{
+    enum
+    {
+        SpanSize = 1 << 16,       ///< 块大小(按此对齐)
+        MaxSmall = 4096           ///< 最大的分级尺寸
+    };
+
+    static void *alloc(int64 size);
+    static void *realloc(void *mem, int64 size);
+    static void destroy(void *mem);
+
+    //!
+    //! \brief usable 返回内存实际可用的字节数
+    //! \param mem
+    //! \return
+    //!
+    static int64 usable(const void *mem);
+    //!
+    //! \brief flush 将当前线程缓存的空闲内存归还到全局链表
+    //!
+    static void flush();
+};
+
+template<typename T>
+struct ky_slab_alloc
+{
+    static T* alloc(int64 size)
+    {
+        return (T*)ky_slab::alloc (size);
+    }
+    static T* realloc(T* mem, int64 size)
+    {
+        return (T*)ky_slab::realloc((void*)mem, size);
+    }
+    static void destroy(void *mem)
+    {
+        ky_slab::destroy (mem);
+    }
+};
+
+//! 节点型容器(ky_list/ky_linked/ky_map/ky_hash/ky_rbtree)默认的分配器
+#ifdef kyHasSlabAlloc
+template<typename T>
+struct ky_node_alloc : ky_slab_alloc<T> {};
+#else
+template<typename T>
+struct ky_node_alloc : ky_alloc<T> {};
+#endif
+
+//!
+//! \brief The ky_memory_stats struct 按标记的内存记账
+//! \note
+//!   1.每个标记统计持有字节、峰值字节、申请/释放/重新分配次数和申请尺寸的直方图
+//!   2.内置容器标记，kyNew按调用点(文件:行)注册标记，也可按名称注册
+//!   3.记账只在定义kyHasMemoryStats时生效，未定义时记账宏为空，容器不附加任何开销
+//!   4.线程绑定分配区中的内存由分配区整体回收，不计入
+//!
+struct ky_memory_stats
+{
+    enum
+    {
+        Untagged = 0,       ///< 未标记或标记数已满
+        Array,              ///< ky_array及其派生的容器
+        List,               ///< ky_list
+        Hash,               ///< ky_hash
+        Map,                ///< ky_map
+        Image,              ///< ky_image
+        Builtin,            ///< 内置标记数，之后为注册的标记
+
+        MaxTags = 512,      ///< 最多的标记数
+        Histogram = 16      ///< 直方图级数: <=16B,<=32B...<=256K,>256K
+    };
+
+    //! 标记的统计快照
+    struct counter
+    {
+        const char *name;
+        int64 live;                 ///< 当前持有字节
+        int64 peak;                 ///< 峰值字节
+        int64 allocs;               ///< 申请次数
+        int64 frees;                ///< 释放次数
+        int64 reallocs;             ///< 重新分配次数
+        int64 histogram[Histogram]; ///< 申请和重新分配的尺寸分布
+    };
+
+    //!
+    //! \brief tag 按名称注册标记，同名返回同一个标记
+    //! \param name 标记名称(内部复制)
+    //! \return 标记数已满时返回Untagged
+    //!
+    static int tag(const char *name);
+    //!
+    //! \brief site 按调用点注册标记，名称为"文件名:行号"
+    //!
+    static int site(const char *file, int line);
+
+    //!
+    //! \brief alloc/destroy/realloc 记录申请、释放和重新分配的字节数
+    //!
+    static void alloc(int tag, int64 size);
+    static void destroy(int tag, int64 size);
+    static void realloc(int tag, int64 old, int64 size);
+
+    //!
+    //! \brief snapshot 取出已注册标记的统计
+    //! \param out 输出的统计
+    //! \param max out的最大个数
+    //! \return 返回写入的个数
+    //!
+    static int snapshot(counter *out, int max);
+    //!
+    //! \brief reset_peak 将峰值重置为当前持有字节
+    //!
+    static void reset_peak();
+};
+
+#ifdef kyHasMemoryStats
+#  define kyMemoryAlloc(tag, size) ky_memory_stats::alloc((tag), (size))
+#  define kyMemoryFree(tag, size) ky_memory_stats::destroy((tag), (size))
+#  define kyMemoryRealloc(tag, old, size) ky_memory_stats::realloc((tag), (old), (size))
+#else
+#  define kyMemoryAlloc(tag, size) do{}while(0)
+#  define kyMemoryFree(tag, size) do{}while(0)
+#  define kyMemoryRealloc(tag, old, size) do{}while(0)
+#endif
+
+//!
+//! \brief The ky_tag_alloc struct 记账分配器
+//! \note 在Base申请的内存前记录尺寸，释放时按Tag记账
+//!
+template<typename T, int Tag, typename Base = ky_node_alloc<T> >
+struct ky_tag_alloc
+{
+    enum {HeadSize = 16};   ///< 保持16字节对齐
+
+    static T* alloc(int64 size)
+    {
+        int64 *p = (int64*)Base::alloc(size + HeadSize);
+        if (!p)
+            return 0;
+        *p = size;
+        ky_memory_stats::alloc(Tag, size);
+        return (T*)((uint8*)p + HeadSize);
+    }
+    static T* realloc(T* mem, int64 size)
+    {
+        if (!mem)
+            return alloc(size);
+        int64 *p = (int64*)((uint8*)mem - HeadSize);
+        const int64 old = *p;
+        p = (int64*)Base::realloc((T*)p, size + HeadSize);
+        if (!p)
+            return 0;
+        *p = size;
+        ky_memory_stats::realloc(Tag, old, size);
+        return (T*)((uint8*)p + HeadSize);
+    }
+    static void destroy(void *mem)
+    {
+        if (!mem)
+            return ;
+        int64 *p = (int64*)((uint8*)mem - HeadSize);
+        ky_memory_stats::destroy(Tag, *p);
+        Base::destroy(p);
+    }
+};
+
+//! 节点型容器带标记的默认分配器，未开启记账时即ky_node_alloc
+#ifdef kyHasMemoryStats
+template<typename T, int Tag>
+struct ky_node_tag_alloc : ky_tag_alloc<T, Tag> {};
+#else
+template<typename T, int Tag>
+struct ky_node_tag_alloc : ky_node_alloc<T> {};
+#endif
+
 //!
 //! \brief The ky_memory class
 //! \note
@@ -137,7 +333,7 @@ public:
     //!
     struct dynaddr
     {
-        typedef struct header_t header_t;
+        typedef struct dynaddr_header header_t;
         typedef struct {void *value;} node_t;
         enum{NodeSize = sizeof(node_t)};
 
@@ -159,6 +355,12 @@ public:
         //! \note 不释放内存
         //!
         virtual ~dynaddr();
+#ifdef kyHasMemoryStats
+        //!
+        //! \brief tag 新建内存块的记账标记，由容器重载
+        //!
+        virtual int tag()const {return ky_memory_stats::Untagged;}
+#endif
 
         //!
         //! \brief refer 返回引用计数器
@@ -201,7 +403,7 @@ public:
 
         //!
         //! \brief expand 扩充内存块
-        //! \param growth 需要增长的值
+        //! \param growth 在尾部位置之后需要增长的值
         //! \return 是否扩充成功
         //!
         bool expand(int64 growth);
@@ -310,13 +512,19 @@ public:
     //!
     struct dynarray
     {
-        typedef struct header_t header_t;
+        typedef struct dynarray_header header_t;
 
         header_t * header;
 
         dynarray();
         explicit dynarray(const header_t *);
         virtual ~dynarray();
+#ifdef kyHasMemoryStats
+        //!
+        //! \brief tag 新建内存块的记账标记，由容器重载
+        //!
+        virtual int tag()const {return ky_memory_stats::Untagged;}
+#endif
 
         //!
         //! \brief refer 返回引用计数器
@@ -357,6 +565,24 @@ public:
         header_t *reserve(int64 size, int align);
         void resize(int64 size, int align);
 
+        //!
+        //! \brief reserve_virtual 保留size个元素的虚拟地址空间，增长时按需提交页面
+        //! \param size 保留的元素数量
+        //! \param align 对齐字节数
+        //! \return 保留失败时返回false
+        //! \note 保留空间内增长不会复制，元素地址保持不变，调用前需自行释放原内存块
+        //!
+        bool reserve_virtual(int64 size, int align);
+        //!
+        //! \brief reserve_arena 从分配区申请size个元素的内存块，增长时仍从该分配区申请
+        //! \param arena ky_allocate::arena_dynamic
+        //! \param size 元素数量
+        //! \param align 对齐字节数
+        //! \return 申请失败时返回false
+        //! \note 内存块不共享，由分配区回退时释放，调用前需自行释放原内存块
+        //!
+        bool reserve_arena(void *arena, int64 size, int align);
+
         //!
         //! \brief destroy 销毁内存块
         //!
@@ -438,7 +664,7 @@ public:
     };
 
 
-    struct virtual_memory
+    struct virtual_mem
     {
         //!
         //! \brief ReserveAddressSpace 保留地址空间并为以后的任何按需提交设置参数
@@ -451,7 +677,7 @@ public:
         //!         除非pageType == kSmall，否则必须为largePageSize的倍数
         //!       2.必须通过ReleaseAddressSpace释放
         //!
-        void* ReserveAddressSpace(uint64 size, uint64 commit = kyMmuLargePageSize,
+        static void* ReserveAddressSpace(uint64 size, uint64 commit = kyMmuLargePageSize,
                                   PageType type = Default, int prot = Read | Write);
 
         /**
@@ -460,7 +686,7 @@ public:
          * @param p 一个先前由ReserveAddressSpace返回的指针
          * @param size 是POSIX实现所必需的，而在Windows上则被忽略。 它还确保与UniqueRange兼容
          **/
-        void ReleaseAddressSpace(void* p, uint64 size = 0);
+        static void ReleaseAddressSpace(void* p, uint64 size = 0);
 
         //!
         //! \brief Commit 将物理内存映射到以前保留的地址空间
@@ -472,7 +698,7 @@ public:
         //! \note 仅提交会映射虚拟页面，实际上不会分配页面框架。
         //!
         //!
-        bool Commit(uintptr address, uint64 size, PageType type = Default,
+        static bool Commit(uintptr address, uint64 size, PageType type = Default,
                     int prot = Read | Write);
 
         //!
@@ -481,7 +707,7 @@ public:
         //! \param size
         //! \return  操作是否成功
         //!
-        bool Decommit(uintptr address, uint64 size);
+        static bool Decommit(uintptr address, uint64 size);
 
         //!
         //! \brief Protect 为与给定间隔相交的所有页面设置内存保护标志
@@ -491,7 +717,7 @@ public:
         //! \return
         //! \note 这些页面当前必须已提交
         //!
-        bool Protect(uintptr address, uint64 size, int prot);
+        static bool Protect(uintptr address, uint64 size, int prot);
 
         //!
         //! \brief Allocate 保留地址空间并提交内存
@@ -500,7 +726,7 @@ public:
         //! \param prot
         //! \return 零初始化的内存与相应的页面大小对齐
         //!
-        void* Allocate(uint64 size, PageType type = Default, int prot = Read | Write);
+        static void* Allocate(uint64 size, PageType type = Default, int prot = Read | Write);
 
         //!
         //! \brief Free 取消内存并释放地址空间
@@ -508,19 +734,19 @@ public:
         //! \param size 是POSIX实现所必需的，而在Windows上则被忽略。 它还确保与UniqueRange兼容
         //! \note 这与ReleaseAddressSpace不同，后者必须考虑对largePageSize进行额外的填充/对齐
         //!
-        void Free(void* p, uint64 size = 0);
+        static void Free(void* p, uint64 size = 0);
 
         //!
         //! \brief BeginOnDemandCommits 安装一个处理程序，该处理程序在遇到读/写页面错误时尝试提交内存。 线程安全的
         //!
-        void BeginOnDemandCommits();
+        static void BeginOnDemandCommits();
 
         //!
         //! \brief EndOnDemandCommits 减少由BeginOnDemandCommit开始的引用计数，并在页面错误处理程序达到0时将其移除。线程安全
         //!
-        void EndOnDemandCommits();
+        static void EndOnDemandCommits();
 
-        void DumpStatistics();
+        static void DumpStatistics();
     };
 private:
     friend class ky_singleton<ky_memory>;
@@ -529,7 +755,7 @@ private:
 
 public:
     //!
-    //! \brief copy 快速内存拷贝
+    //! \brief copy 快速内存拷贝，长数据按cpu能力使用AVX2/AVX-512，超大数据使用非临时存储
     //! \param dst
     //! \param src
     //! \param len
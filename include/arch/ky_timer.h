@@ -15,6 +15,7 @@
  * Change History :
  *    Date    |  Version  |  Author  |   Description
  * 2016/07/02 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/17 | 1.0.0.2   | kunyang  | 修正nanosec单调时钟和线程时钟取错时钟源
  */
 
 #ifndef ky_TIMER_H
@@ -6,6 +6,9 @@
  * @file     ky_alloc.h
  * @brief    关于内存分配器模板实现
  *       1.根据体系架构选择对齐模式
+ *       2.arena/arena_dynamic 顺序分配器，支持标记回退和整体释放
+ *       3.arena_bind 将分配区绑定到当前线程，使用ky_arena_alloc的容器从中分配
+ *       4.ky_array/ky_string以reserve_arena显式使用分配区，不受线程绑定影响
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
@@ -16,17 +19,21 @@
  * Change History :
  *    Date    |  Version  |  Author  |   Description
  * 2020/02/10 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/17 | 1.1.0.1   | kunyang  | 完善顺序分配器，加入回退标记和线程绑定的分配区
+ * 2026/10/17 | 1.1.0.2   | kunyang  | ky_array不再隐式使用线程绑定的分配区
  */
 
 #ifndef ky_ALLOC_H
 #define ky_ALLOC_H
 #include "ky_define.h"
 #include "arch/ky_memory.h"
+#include "tools/ky_algorlthm.h"
 
-template <typename T, typename Allocator>
+//!
+//! \brief The ky_allocate_proxy struct 底层内存的申请策略
+//!
 struct ky_allocate_proxy
 {
-public:
     struct heap
     {
         void* allocate(uint64 size)
@@ -60,7 +67,7 @@ public:
     {
         void* allocate(uint64 size)
         {
-            return ky_memory::virtual_mem::Allocate(size, pageType, prot);
+            return ky_memory::virtual_mem::Allocate(size, type, prot);
         }
 
         void deallocate(void* p, uint64 size)
@@ -84,88 +91,93 @@ public:
         }
     };
 
-public:
-    typedef T value_type;
-    typedef T* pointer;
-    typedef const T* const_pointer;
-    typedef T& reference;
-    typedef const T& const_reference;
-    typedef uint64 size_type;
-    typedef intptr difference_type;
-
-    template<typename U>
-    struct rebind
+    //!
+    //! \brief The stl struct 将策略包装为STL风格的分配器
+    //!
+    template <typename T, typename Allocator>
+    struct stl
     {
-        typedef ky_allocate_proxy<U, Allocator> other;
-    };
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef uint64 size_type;
+        typedef intptr difference_type;
 
-    // (required to be declared by boost::unordered_map, but should never be called)
-    explicit ky_allocate_proxy();
+        template<typename U>
+        struct rebind
+        {
+            typedef stl<U, Allocator> other;
+        };
 
-    explicit ky_allocate_proxy(Allocator& allocator)
-        : allocator(&allocator)
-    {
-    }
+        stl():allocator(0){}
 
-    template<typename U, class A>
-    ky_allocate_proxy(const ky_allocate_proxy<U, A>& rhs)
-        : allocator(rhs.allocator)
-    {
-    }
+        explicit stl(Allocator& allocator)
+            : allocator(&allocator)
+        {
+        }
 
-    bool operator==(const ky_allocate_proxy& rhs) const
-    {
-        return allocator == rhs.allocator;
-    }
-    bool operator!=(const ky_allocate_proxy& rhs) const
-    {
-        return !operator==(rhs);
-    }
+        template<typename U, class A>
+        stl(const stl<U, A>& rhs)
+            : allocator(rhs.allocator)
+        {
+        }
 
-    pointer address(reference r)
-    {
-        return &r;
-    }
+        bool operator==(const stl& rhs) const
+        {
+            return allocator == rhs.allocator;
+        }
+        bool operator!=(const stl& rhs) const
+        {
+            return !operator==(rhs);
+        }
 
-    const_pointer address(const_reference s)
-    {
-        return &s;
-    }
+        pointer address(reference r)
+        {
+            return &r;
+        }
 
-    size_type max_size() const throw ()
-    {
-        return UINT64_MAX / sizeof(T);
-    }
+        const_pointer address(const_reference s)
+        {
+            return &s;
+        }
 
-    void construct(const pointer ptr, const value_type& t)
-    {
-        new(ptr) T(t);
-    }
+        size_type max_size() const throw ()
+        {
+            return UINT64_MAX / sizeof(T);
+        }
 
-    void destroy(pointer ptr)
-    {
-        ptr->~T();
-        kyUnused2(ptr);
-    }
+        void construct(const pointer ptr, const value_type& t)
+        {
+            new(ptr) T(t);
+        }
 
-    pointer allocate(size_type n)
-    {
-        if(n == 0)
-            n = 1;
-        return (pointer)allocator->allocate(n*sizeof(T));
-    }
+        void destroy(pointer ptr)
+        {
+            ptr->~T();
+            kyUnused2(ptr);
+        }
 
-    pointer allocate(size_type n, const void* const)
-    {
-        return allocate(n);
-    }
+        pointer allocate(size_type n)
+        {
+            if(n == 0)
+                n = 1;
+            return (pointer)allocator->allocate(n*sizeof(T));
+        }
 
-    void deallocate(const pointer ptr, const size_type n)
-    {
-        return allocator->deallocate(ptr, n*sizeof(T));
-    }
+        pointer allocate(size_type n, const void* const)
+        {
+            return allocate(n);
+        }
 
-    Allocator* allocator;
+        void deallocate(const pointer ptr, const size_type n)
+        {
+            return allocator->deallocate(ptr, n*sizeof(T));
+        }
+
+        Allocator* allocator;
+    };
 };
 
 struct ky_storage
@@ -252,9 +264,9 @@ public:
             if(!newStorage)
                 return false;
             ky_memory::copy(newStorage, storage, capacity);
-            ky_swap(capacity, newCapacity);
-            ky_swap(storage, newStorage);
-            allocator.deallocate(newStorage, newCapacity);
+            allocator.deallocate(storage, capacity);
+            capacity = newCapacity;
+            storage = newStorage;
             return true;
         }
 
@@ -365,17 +377,6 @@ public:
     };
 
 public:
-    // @return 起始地址（对齐方式取决于分配器）
-    uintptr Address() const;
-
-    // @return 当前可访问内存的大小
-    uint64 Capacity() const;
-
-    // @return 最大可能的容量
-    uint64 MaxCapacity() const;
-    // 扩展到至少 reqCapacity,可能更多，具体取决于 GrowthPolicy
-    bool Expand(uint64 reqCapacity);
-
     //!
     //! \brief StorageAppend 保留并在存储末尾返回指向空间的指针，如果需要的话可以扩展它
     //! \param storage
@@ -386,37 +387,37 @@ public:
     template<class Storage>
     static inline uintptr StorageAppend(Storage& storage, uint64& end, uint64 size)
     {
-        uint64 newEnd = end + size;
+        const uint64 newEnd = end + size;
         if(newEnd > storage.Capacity())
         {
             if(!storage.Expand(newEnd))
                 return 0;
         }
 
-        ky_swap(end, newEnd);
-        return storage.Address() + newEnd;
+        const uint64 oldEnd = end;
+        end = newEnd;
+        return storage.Address() + oldEnd;
     }
 
     // 在默认构造的Functor实例上调用operator（）以实现Storage及其参数的合理组合
     template<template<class Storage> class Functor>
     static void ForEachStorage()
     {
-        Functor<Storage::fixed<ky_allocate_proxy::heap> >()();
-        Functor<Storage::fixed<ky_allocate_proxy::aligned<> > >()();
+        Functor<fixed<ky_allocate_proxy::heap> >()();
+        Functor<fixed<ky_allocate_proxy::aligned<> > >()();
 
-        Functor<Storage::reallocate<ky_allocate_proxy::heap, ky_memory::growth_linear<> > >()();
-        Functor<Storage::reallocate<ky_allocate_proxy::heap, ky_memory::growth_exp<> > >()();
-        Functor<Storage::reallocate<ky_allocate_proxy::aligned<>, ky_memory::growth_linear<> > >()();
-        Functor<Storage::reallocate<ky_allocate_proxy::aligned<>, ky_memory::growth_exp<> > >()();
+        Functor<reallocate<ky_allocate_proxy::heap, ky_memory::growth_linear<> > >()();
+        Functor<reallocate<ky_allocate_proxy::heap, ky_memory::growth_exp<> > >()();
+        Functor<reallocate<ky_allocate_proxy::aligned<>, ky_memory::growth_linear<> > >()();
+        Functor<reallocate<ky_allocate_proxy::aligned<>, ky_memory::growth_exp<> > >()();
 
-        Functor<Storage::commit<ky_allocate_proxy::address_space<>, ky_memory::growth_linear<> > >()();
-        Functor<Storage::commit<ky_allocate_proxy::address_space<>, ky_memory::growth_exp<> > >()();
+        Functor<commit<ky_allocate_proxy::address_space<>, ky_memory::growth_linear<> > >()();
+        Functor<commit<ky_allocate_proxy::address_space<>, ky_memory::growth_exp<> > >()();
 
-        Functor<Storage::commit_auto<> >()();
+        Functor<commit_auto<> >()();
     }
 };
 
-template <typename T>
 struct ky_allocate
 {
     template<class T>
@@ -475,8 +476,8 @@ struct ky_allocate
         // allocate uninitialized storage
         pointer allocate(size_type numElements)
         {
-            const size_type alignment = x86_x64::Caches(x86_x64::L1D)->entrySize;
-            const size_type elementSize = ky_round_up(sizeof(T), alignment);
+            const size_type alignment = kyCpuCacheLineSize;
+            const size_type elementSize = (sizeof(T) + alignment -1) & ~(alignment -1);
             const size_type size = numElements * elementSize;
             pointer p = (pointer)ky_memory::aligned_alloc(size, alignment);
             return p;
@@ -498,20 +499,20 @@ struct ky_allocate
             p->~T();
             kyUnused2(p);
         }
-    };
 
-    // indicate that all specializations of this allocator are interchangeable
-    template <class T1, class T2>
-    bool operator==(const aligned<T1>&, const aligned<T2>&)
-    {
-        return true;
-    }
+        // indicate that all specializations of this allocator are interchangeable
+        template <class U>
+        bool operator==(const aligned<U>&) const
+        {
+            return true;
+        }
 
-    template <class T1, class T2>
-    bool operator!=(const aligned<T1>&, const aligned<T2>&)
-    {
-        return false;
-    }
+        template <class U>
+        bool operator!=(const aligned<U>&) const
+        {
+            return false;
+        }
+    };
 
 
     /**
@@ -519,27 +520,47 @@ struct ky_allocate
      * - O(1) 分配;
      * - 可变大小的块;
      * - 支持取消分配所有对象;
-     * - 连续分配是连续的;
-     * - 没有额外的对齐也没有填充.
+     * - 可以记录位置并回退到该位置;
+     * - 连续分配是连续的(按对齐填充).
      **/
     template<class Storage = ky_storage::fixed<> >
     class arena : public ky_noncopy
     {
     public:
+        //! 回退标记
+        typedef uint64 marker;
+
         arena(uint64 maxSize):
             storage(maxSize)
         {
-            DeallocateAll();
+            reset();
         }
 
         uint64 remaining() const
         {
             return storage.MaxCapacity() - end;
         }
+        uint64 used() const
+        {
+            return end;
+        }
 
-        void* allocate(uint64 size)
+        //!
+        //! \brief allocate 分配内存
+        //! \param size
+        //! \param align 对齐字节数(2的幂)
+        //! \return 空间不足时返回0
+        //!
+        void* allocate(uint64 size, uint64 align = kyAllocateAlign)
         {
-            return (void*)StorageAppend(storage, end, size);
+            const uint64 base = storage.Address();
+            const uint64 pad = ((base + end + align -1) & ~(align -1)) - (base + end);
+            uint64 at = end;
+            if (!ky_storage::StorageAppend(storage, at, pad + size))
+                return 0;
+            const uint64 offset = end + pad;
+            end = at;
+            return (void*)(storage.Address() + offset);
         }
 
         void deallocate(void* kyUnused(p), uint64 kyUnused(size))
@@ -547,15 +568,37 @@ struct ky_allocate
             // ignored
         }
 
-        void DeallocateAll()
+        //!
+        //! \brief mark 记录当前位置
+        //!
+        marker mark() const
+        {
+            return end;
+        }
+        //!
+        //! \brief rewind 回退到标记位置，之后分配的内存全部失效
+        //!
+        void rewind(marker m)
+        {
+            if (m < end)
+                end = m;
+        }
+        //!
+        //! \brief reset 释放全部分配
+        //!
+        void reset()
         {
             end = 0;
         }
+        void DeallocateAll()
+        {
+            reset();
+        }
 
         // 返回地址是否在先前分配的范围内
-        bool Contains(uintptr address) const
+        bool contains(const void *p) const
         {
-            return (address - storage.Address()) < end;
+            return (uintptr(p) - storage.Address()) < end;
         }
 
     private:
@@ -566,86 +609,191 @@ struct ky_allocate
     /**
      * 分配器设计的参数
      * - 以固定的chunkSize动态增长;
-     * - 用于频繁分配大小 << chunkSize;
-     * - 没有重新分配，指针仍然有效
+     * - 用于频繁分配大小 << chunkSize, 超出chunkSize时单独分配一块;
+     * - 没有重新分配，指针仍然有效;
+     * - 可以记录位置并回退到该位置，回退时释放之后申请的块.
      **/
     class arena_dynamic : public ky_noncopy
     {
-        struct ArenaChunk
+        struct chunk
         {
-            bool Available(uint64 size) const
-            {
-                return size <= (capacity - end);
-            }
-
-            uintptr Allocate(uint64 size)
-            {
-                uintptr ptr = storage + end;
-                end += size;
-                return ptr;
-            }
-
-            uintptr storage;
             uint64 end;
             uint64 capacity;
-            ArenaChunk* next;
+            chunk *next;        ///< 更早申请的块
+
+            uint8 *storage() {return (uint8*)(this +1);}
         };
 
     public:
-        arena_dynamic(uint64 chunkSize) :
-            chunkSize(chunkSize),
-            head(0)
+        //! 回退标记
+        struct marker
         {
-            AllocateNewChunk();
-        }
+            chunk *head;
+            uint64 end;
+        };
+
+        explicit arena_dynamic(uint64 chunkSize = 64 * kyKiB);
+        ~arena_dynamic();
 
-        ~arena_dynamic()
+        //!
+        //! \brief allocate 分配内存
+        //! \param size
+        //! \param align 对齐字节数(2的幂)
+        //! \return 系统内存不足时返回0
+        //!
+        void* allocate(uint64 size, uint64 align = kyAllocateAlign)
         {
-            ArenaChunk* chunk = head;
-            while (chunk != 0)
+            if (kyLikely(head != 0))
             {
-                ArenaChunk* next = chunk->next;
-                ::free(chunk);
-                chunk = next;
+                const uintptr cur = uintptr(head->storage()) + head->end;
+                const uint64 pad = ((cur + align -1) & ~uintptr(align -1)) - cur;
+                if (pad + size <= head->capacity - head->end)
+                {
+                    head->end += pad + size;
+                    return (void*)(cur + pad);
+                }
             }
+            return allocate_chunk(size, align);
         }
 
-        void AllocateNewChunk()
+        void deallocate(void* kyUnused(p), uint64 kyUnused(size))
         {
-            // For efficiency, do a single allocation with the ArenaChunk and its storage
-            ArenaChunk* next = head;
-            head = (ArenaChunk*)::malloc(sizeof(ArenaChunk) + chunkSize);
-            //ENSURE(head);
-            head->storage = sizeof(ArenaChunk) + uintptr(head);
-            head->end = 0;
-            head->capacity = chunkSize;
-            head->next = next;
+            // ignored
         }
 
-        void* allocate(uint64 size)
-        {
-            if (size > chunkSize)
-            {
-                //debug_warn(L"DynamicArena cannot allocate more than chunk size");
-                //throw std::bad_alloc();
-            }
-            else if (!head->Available(size))
-                AllocateNewChunk();
+        //!
+        //! \brief mark 记录当前位置
+        //!
+        marker mark() const
+        {
+            marker m = {head, head ? head->end : 0};
+            return m;
+        }
+        //!
+        //! \brief rewind 回退到标记位置，之后分配的内存全部失效
+        //!
+        void rewind(const marker &m);
+        //!
+        //! \brief reset 释放全部分配，只保留第一块以便重用
+        //!
+        void reset();
+
+        //!
+        //! \brief used 已分配的字节数(含对齐填充)
+        //!
+        uint64 used() const;
+        //!
+        //! \brief contains 地址是否在分配区内
+        //!
+        bool contains(const void *p) const;
 
-            return (void*)head->Allocate(size);
-        }
+    private:
+        void *allocate_chunk(uint64 size, uint64 align);
 
-        void deallocate(void* kyUnused(p), uint64 kyUnused(size))
+    private:
+        const uint64 chunkSize;
+        chunk       *head;
+        chunk       *spare;     ///< 回退时保留一块，避免反复申请
+    };
+
+    //!
+    //! \brief The scope class 作用域标记，析构时回退到构造时的位置
+    //!
+    template<class Arena>
+    class scope : public ky_noncopy
+    {
+    public:
+        explicit scope(Arena &a):
+            owner(a),
+            where(a.mark())
         {
-            // ignored
+        }
+        ~scope()
+        {
+            owner.rewind(where);
         }
 
     private:
+        Arena                  &owner;
+        typename Arena::marker  where;
+    };
 
-        const uint64 chunkSize;
-        ArenaChunk  *head;
+    //!
+    //! \brief current 当前线程绑定的分配区
+    //! \return 未绑定时返回0
+    //!
+    static arena_dynamic *current();
+
+    //!
+    //! \brief The arena_bind class 将分配区绑定到当前线程
+    //! \note 作用域内使用ky_arena_alloc的容器从分配区申请内存，
+    //!       析构时回退分配区，这些内存不能在作用域外使用
+    //!
+    class arena_bind : public ky_noncopy
+    {
+    public:
+        explicit arena_bind(arena_dynamic &a, bool rewind = true);
+        ~arena_bind();
+
+    private:
+        arena_dynamic        *owner;
+        arena_dynamic        *prev;
+        arena_dynamic::marker where;
+        bool                  is_rewind;
     };
+};
+
+//!
+//! \brief The ky_arena_alloc struct 从当前线程分配区申请内存的分配器
+//! \note 用于ky_map/ky_hash等容器的Alloc参数，未绑定分配区时使用堆
+//!       每块内存前有16字节记录来源和大小
+//!
+template<typename T>
+struct ky_arena_alloc
+{
+    enum {TagSize = 16};
+
+    static T* alloc(int64 size)
+    {
+        ky_allocate::arena_dynamic *a = ky_allocate::current();
+        int64 *tag = a ? (int64*)a->allocate(size + TagSize) :
+                         (int64*)kyMalloc(size + TagSize);
+        if (tag == 0)
+            return 0;
+        tag[0] = size;
+        tag[1] = a != 0;
+        return (T*)(tag +2);
+    }
+    static T* realloc(T* mem, int64 size)
+    {
+        if (mem == 0)
+            return alloc(size);
+        int64 *tag = (int64*)mem -2;
+        if (tag[1] == 0)
+        {
+            tag = (int64*)kyRealloc((void*)tag, size + TagSize);
+            if (tag == 0)
+                return 0;
+            tag[0] = size;
+            return (T*)(tag +2);
+        }
 
+        T *n = alloc(size);
+        if (n)
+        {
+            ky_memory::copy(n, mem, tag[0] < size ? tag[0] : size);
+            destroy(mem);
+        }
+        return n;
+    }
+    static void destroy(void *mem)
+    {
+        if (mem == 0)
+            return;
+        int64 *tag = (int64*)mem -2;
+        if (tag[1] == 0)
+            kyFree (tag);
+    }
 };
 
 #endif
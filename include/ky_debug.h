@@ -25,6 +25,7 @@
  * 2015/06/06 | 1.1.2.0   | kunyang  | 修改日志打印函数并加入日志等级过滤
  * 2018/11/23 | 1.1.3.0   | kunyang  | 修改debug定义
  * 2020/02/11 | 1.2.0.1   | kunyang  | 加入hook功能，并剥离调试和日志功能
+ * 2026/10/17 | 1.2.1.1   | kunyang  | 加入内存记账的打印和定时打印
  *
  */
 #ifndef KY_DEBUG_H
@@ -117,6 +118,19 @@ public:
     //!
     static bool recreate(const char* fn = 0, bool clr = true);
 
+    //!
+    //! \brief memory 打印各标记的内存记账(ky_memory_stats)
+    //! \param level 日志级别
+    //! \note 未定义kyHasMemoryStats时只打印提示
+    //!
+    static void memory(eLogLevels level = Log_Info);
+    //!
+    //! \brief memory_periodic 后台线程每隔ms毫秒打印一次内存记账
+    //! \param ms 间隔毫秒，为0时停止
+    //! \param level 日志级别
+    //!
+    static void memory_periodic(int64 ms, eLogLevels level = Log_Info);
+
 public:
     kyPrintfArgs(7)
     static void formats(const char *file, int line, const char *func,
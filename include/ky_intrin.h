@@ -15,6 +15,7 @@
  *    Date    |  Version  |  Author  |   Description
  * 2011/05/02 | 1.0.0.1   | kunyang  | 创建文件
  * 2015/03/26 | 1.1.0.1   | kunyang  | 修改以体系架构选择加速指令
+ * 2026/10/17 | 1.1.1.1   | kunyang  | 加入ARM NEON加速指令
  */
 #ifndef KY_INTRIN
 #define KY_INTRIN
@@ -154,6 +155,11 @@
 ///< ARM架构加速指令
 #elif kyArchIsARM
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) ///< -mfpu=neon	NEON
+#define kyHAS_NEON 1
+#include <arm_neon.h>
+#endif
+
 #endif
 
 #endif // KY_INTRIN
@@ -16,6 +16,10 @@
  *    Date    |  Version  |  Author  |   Description
  * 2018/01/20 | 1.0.0.1   | kunyang  | 创建文件
  * 2018/03/06 | 1.0.1.1   | kunyang  | 加入STL模板宏kyHasSTL
+ * 2026/10/17 | 1.0.2.1   | kunyang  | 加入节点容器分配器宏kyHasSlabAlloc
+ * 2026/10/17 | 1.0.2.2   | kunyang  | 加入内存记账宏kyHasMemoryStats
+ * 2026/10/17 | 1.0.2.3   | kunyang  | 加入io_uring轮询宏kyHasIoUring
+ * 2026/10/17 | 1.0.2.4   | kunyang  | kyHasIoUring默认关闭
  */
 #ifndef KY_MACRO_H
 #define KY_MACRO_H
@@ -51,6 +55,12 @@
 //! 开启STL模板库
 #define kyHasSTL
 
+//! 节点型容器使用线程缓存的分块分配器(ky_slab)
+#define kyHasSlabAlloc
+
+//! 按容器和kyNew调用点统计内存(ky_memory_stats)，关闭时不产生开销
+//#define kyHasMemoryStats
+
 //! 设置颜色位数
 //#define kyColor16Bit
 #define kyColor32Bit
@@ -74,6 +84,9 @@
 #define kyHasPoll
 //! 是否支持EPoll (暂时取消，因为内部不能响应)
 //#define kyHasEPoll
+//! 是否支持io_uring (Linux 5.1以上，运行时不可用则退回EPoll或PPoll)
+//! 默认关闭，需要时手动打开
+//#define kyHasIoUring
 //! 是否支持PSelect
 #define kyHasPSelect
 //! 是否支持Select
@@ -39,6 +39,7 @@
  * 2016/09/20 | 1.2.2.1   | kunyang  | 修改编译器兼容信息
  * 2018/06/28 | 1.2.2.2   | kunyang  | 添加明确当前系统的特有宏
  * 2018/07/03 | 1.2.2.2   | kunyang  | 添加预处理对象
+ * 2026/10/17 | 1.2.3.1   | kunyang  | 开启内存记账时kyNew按调用点统计，加入kyDeleteArray
  */
 #ifndef __KY_MAIN__
 #define __KY_MAIN__
@@ -400,6 +401,38 @@ static inline int _ArchEndian_()
 #  define kyExternC extern "C"
 #endif
 
+// 开启内存记账时kyNew按调用点(文件:行)记录对象，kyDelete/kyDeleteArray时取消记录
+// 数组按单个元素的尺寸记录，未经kyNew申请的指针取消记录时忽略
+#if defined(kyHasMemoryStats) && (kyLanguage >= kyLanguage11)
+int  ky_memory_site(const char *file, int line);
+void ky_memory_track(void *p, long long size, int site);
+void ky_memory_untrack(void *p);
+
+template <typename T>
+inline T *ky_memory_track_new(T *p, int site)
+{
+    ky_memory_track((void*)p, (long long)sizeof(T), site);
+    return p;
+}
+template <typename T>
+inline T *ky_memory_untrack_delete(T *p)
+{
+    ky_memory_untrack((void*)p);
+    return p;
+}
+
+#  ifndef kyNew
+#    define kyNew(t) ky_memory_track_new(new t, \
+            []{static const int __site = ky_memory_site(__FILE__, __LINE__); return __site;}())
+#  endif
+#  ifndef kyDelete
+#    define kyDelete(oj) delete ky_memory_untrack_delete(oj)
+#  endif
+#  ifndef kyDeleteArray
+#    define kyDeleteArray(oj) delete [] ky_memory_untrack_delete(oj)
+#  endif
+#endif
+
 // 对象新建
 #ifndef kyNew
 #  define kyNew(t) new t
@@ -410,6 +443,11 @@ static inline int _ArchEndian_()
 #  define kyDelete(oj) delete oj
 #endif
 
+// 对象数组删除
+#ifndef kyDeleteArray
+#  define kyDeleteArray(oj) delete [] oj
+#endif
+
 // 内存堆分配
 #ifndef kyMalloc
 #  define kyMalloc(size) ::malloc(size)
@@ -610,8 +648,8 @@ extern "C" int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR , int )\
     __PretreatReverse__(__ps__, __end__); \
     __PretreatUnload__(__ps__, __end__); \
     for (int i = 0; i < argc; ++i)\
-        kyDelete ([] argv[i]);\
-    kyDelete ([] argv);\
+        kyDeleteArray (argv[i]);\
+    kyDeleteArray (argv);\
     return exitCode;\
 } \
     int ky_main
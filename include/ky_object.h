@@ -31,6 +31,10 @@
  * 2018/06/17 | 1.3.3.0   | kunyang  | 修改对象线程安全继承
  * 2018/11/08 | 1.4.0.1   | kunyang  | 加入线程底层事件派遣接口
  * 2019/04/20 | 1.4.0.2   | kunyang  | 将模板对象实现写入inl文件中
+ * 2026/10/17 | 1.4.0.3   | kunyang  | 信号表改为ky_flatmap
+ * 2026/10/17 | 1.4.1.0   | kunyang  | 加入线程时间轮定时器接口
+ * 2026/10/17 | 1.4.2.0   | kunyang  | 加入异步IO提交接口
+ * 2026/10/17 | 1.4.2.1   | kunyang  | 析构时停止定时器并取消异步IO
  */
 #ifndef KY_OBJECT_H
 #define KY_OBJECT_H
@@ -40,7 +44,7 @@
 #include "tools/ky_typeinfo.h"
 #include "tools/ky_string.h"
 #include "tools/ky_list.h"
-#include "tools/ky_map.h"
+#include "tools/ky_flatmap.h"
 #include "tools/ky_signal.h"
 #include "thread/ky_thread.h"
 #include "interface/ievent.h"
@@ -69,6 +73,76 @@ typedef enum
 }eIoNotifys;
 kyDeclareFlags(eIoNotifys, eNotifyFlags);
 
+//!
+//! \brief The ky_timer_event struct 时间轮定时器的超时事件
+//!
+struct ky_timer_event : ievent
+{
+    explicit ky_timer_event(int tid = -1, i64 stamp = 0):
+        ievent(iNotifyEventMacro(Notify_Timer)),
+        id(tid)
+    {
+        timestamp() = stamp;
+    }
+
+    int id;   ///< start_timer返回的定时器id
+};
+
+//!
+//! \brief The eIoOps enum 异步IO操作
+//!
+typedef enum
+{
+    IoOp_Read,     ///< 读文件(偏移为-1时从当前位置)
+    IoOp_Write,    ///< 写文件(偏移为-1时从当前位置)
+    IoOp_Recv,     ///< 套接字接收
+    IoOp_Send,     ///< 套接字发送
+    IoOp_Accept,   ///< 接受连接，结果为新的句柄
+    IoOp_Fsync     ///< 同步到磁盘
+}eIoOps;
+
+//!
+//! \brief The ky_io_request struct 异步IO请求
+//! \note 数据缓冲区在完成前需要保持有效
+//!
+struct ky_io_request
+{
+    eIoOps  op;
+    intptr  fd;         ///< 句柄，fixed时为注册句柄的序号
+    void   *data;       ///< 数据缓冲区
+    int64   length;     ///< 数据长度
+    int64   offset;     ///< 文件偏移[-1 当前位置]
+    int     buffer;     ///< 注册缓冲区的序号[-1 未注册]
+    int     group;      ///< Recv从提供的缓冲区组中选取[-1 使用data]
+    bool    fixed;      ///< fd为注册句柄的序号
+    bool    multishot;  ///< Accept/Recv一次提交多次完成(Recv需要group)
+
+    explicit ky_io_request(eIoOps o = IoOp_Read, intptr h = -1, void *d = 0, int64 len = 0):
+        op(o), fd(h), data(d), length(len), offset(-1),
+        buffer(-1), group(-1), fixed(false), multishot(false)
+    {
+    }
+};
+
+//!
+//! \brief The ky_io_event struct 异步IO的完成事件
+//!
+struct ky_io_event : ievent
+{
+    explicit ky_io_event(int rid = -1, eIoOps o = IoOp_Read):
+        ievent(iNotifyEventMacro(Notify_Io)),
+        id(rid), op(o), result(0), buffer(-1), more(false)
+    {
+        timestamp() = 0;
+    }
+
+    int    id;      ///< submit_io返回的id
+    eIoOps op;
+    int64  result;  ///< 成功为字节数或新的句柄，失败为-errno
+    int    buffer;  ///< Recv选取的缓冲区序号[-1 未选取]
+    bool   more;    ///< 多次完成的请求之后是否还有完成，为false时id被回收
+};
+
 #define kyObject(type) public:\
     virtual ky_string name() const{return ky_typeinfo<type>();} \
     virtual bool is(ky_object *rhs)const \
@@ -144,6 +218,43 @@ public:
     //!
     void modify(intptr fd, eNotifyFlags flag, bool active);
 
+    //!
+    //! \brief start_timer 在对象所在线程的时间轮上启动定时器
+    //! \param ms 超时时间(毫秒)
+    //! \param repeat 是否周期触发
+    //! \return 定时器id，失败返回-1
+    //! \note 超时后向本对象派遣 ky_timer_event，单次定时器触发后id被回收，
+    //!       对象析构时自动停止
+    //!
+    int start_timer(int64 ms, bool repeat = true);
+    //!
+    //! \brief restart_timer 从当前重新计时
+    //! \param id start_timer返回的id
+    //! \param ms 新的超时时间[<0 使用原来的超时]
+    //! \return
+    //!
+    bool restart_timer(int id, int64 ms = -1);
+    //!
+    //! \brief stop_timer 停止定时器并回收id
+    //! \param id 不属于本对象的id被忽略
+    //!
+    void stop_timer(int id);
+
+    //!
+    //! \brief submit_io 向所在线程提交异步IO，与其他请求一起批量提交
+    //! \param req
+    //! \return 请求id，失败或线程不支持异步IO时返回-1
+    //! \note 完成后向本对象派遣 ky_io_event，不支持时使用registered等待就绪后自行读写，
+    //!       对象析构时取消未完成的请求，此后不再派遣
+    //!
+    int submit_io(const ky_io_request &req);
+    //!
+    //! \brief cancel_io 取消未完成的异步IO，取消的请求以-ECANCELED完成
+    //! \param id 不属于本对象的id返回false
+    //! \return
+    //!
+    bool cancel_io(int id);
+
 public:
     typedef ky_list <ky_object*>::iterator child;
 
@@ -195,8 +306,8 @@ private:
     impl::object *impl;
 
 private:
-    typedef typename ky_map<intptr, int>::iterator slot;
-    ky_map<intptr, int> slot_map;
+    typedef ky_flatmap<intptr, int>::iterator slot;
+    ky_flatmap<intptr, int> slot_map;   ///< 已连接的信号，数量很少，使用有序数组
 
 public:
 #include "ky_object.inl"
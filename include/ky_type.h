@@ -32,6 +32,7 @@
  * 2017/05/01 | 1.2.0.1   | kunyang  | 加入数据类型的判断
  * 2017/07/23 | 1.2.1.1   | kunyang  | 加入编译阶段断言宏
  * 2018/01/15 | 1.2.2.1   | kunyang  | 去除long double,修改boolean_t为bool_t,加入half_float
+ * 2026/10/17 | 1.2.2.2   | kunyang  | 加入移动构造和可复制判断，用于容器的移动语义
  */
 #ifndef KY_TYPE_H
 #define KY_TYPE_H
@@ -152,7 +152,7 @@ template <typename T> struct is_complex:
 /// complex_destroy
 template <typename T>
 static typename enif_t<is_complex<T>::value>::type
-complex_destruct(T &o) { kyUnused2(o); o.~T(); }
+complex_destruct(T &o) { o.~T(); }
 template <typename T>
 static typename enif_t<!is_complex<T>::value>::type
 complex_destruct(T &) {}
@@ -162,4 +162,33 @@ complex_construct(T &x, const T &o) {new (&x) T(o);}
 template <typename T>
 static typename enif_t<!is_complex<T>::value>::type
 complex_construct(T &x, const T &o) {x = o;}
+/// complex_construct 移动构造
+template <typename T>
+static typename enif_t<is_complex<T>::value>::type
+complex_construct(T &x, T &&o) {new (&x) T(static_cast<T &&>(o));}
+template <typename T>
+static typename enif_t<!is_complex<T>::value>::type
+complex_construct(T &x, T &&o) {x = o;}
+
+/// is_copyable
+template <typename T>
+struct _helper_is_copyable_
+{
+    template <typename U, typename = decltype(::new U(*(const U *)0))>
+    static true_type_t test(int);
+    template <typename U>
+    static false_type_t test(...);
+    typedef decltype(test<T>(0)) type;
+};
+template <typename T> struct is_copyable: public _helper_is_copyable_<T>::type {};
+
+/// complex_copy 容器分离时复制元素，源块可能仍被其他容器使用，只能复制
+/// 只能移动的类型的容器禁止复制(operator=中静态断言)，块不会被共享也就不会分离，
+/// 此处只为满足实例化
+template <typename T>
+static typename enif_t<is_copyable<T>::value>::type
+complex_copy(T &x, const T &o) {complex_construct(x, o);}
+template <typename T>
+static typename enif_t<!is_copyable<T>::value>::type
+complex_copy(T &, const T &) {abort();}
 #endif
@@ -376,7 +376,7 @@ void ky_plane<T>::clip_polygon(const ky_vector3<T>* vin, int64 numIn,
     }
 
     // clean up
-    kyDelete([] vd);
+    kyDeleteArray(vd);
 }
 
 template<typename T>
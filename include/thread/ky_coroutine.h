@@ -0,0 +1,391 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_coroutine.h
+ * @brief    线程事件循环上的协程(C++20)
+ *       1.ky_coro::task<T> 惰性启动，被co_await时开始执行，完成后恢复等待者
+ *       2.等待句柄就绪、定时、切换线程都由所在线程的事件循环(exec)恢复，不创建线程
+ *       3.等待对象在协程帧内，不额外分配；协程帧由线程缓存的ky_slab分配
+ *       4.编译器不支持C++20协程时此文件为空，库本身不需要C++20
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.2
+ * @date     2026/10/17
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/17 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/17 | 1.0.0.2   | kunyang  | resume_on寄送失败时终止，不在当前线程继续执行
+ *
+ */
+#ifndef KY_COROUTINE_H
+#define KY_COROUTINE_H
+#include "ky_define.h"
+
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+#include <coroutine>
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "ky_object.h"
+#include "ky_debug.h"
+#include "arch/ky_memory.h"
+
+namespace ky_coro
+{
+template <typename T = void>
+class task;
+
+namespace impl
+{
+//! 协程帧从当前线程缓存的分块分配器中分配
+struct frame
+{
+    static void *operator new(size_t size) {return ky_slab::alloc((int64)size);}
+    static void operator delete(void *mem) {ky_slab::destroy(mem);}
+};
+
+struct promise_base : frame
+{
+    std::coroutine_handle<> continuation; ///< co_await本协程的等待者
+    bool                    detached;     ///< 由spawn启动，完成后自行释放
+
+    promise_base():continuation(), detached(false){}
+
+    std::suspend_always initial_suspend() noexcept {return {};}
+
+    struct final_awaiter
+    {
+        bool await_ready() noexcept {return false;}
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+        {
+            promise_base &p = h.promise();
+            if (p.detached)
+            {
+                h.destroy();
+                return std::noop_coroutine();
+            }
+            // 直接转到等待者，不经过事件循环
+            return p.continuation ? p.continuation : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+    final_awaiter final_suspend() noexcept {return {};}
+    void unhandled_exception() {std::terminate();}
+};
+
+template <typename T>
+struct promise : promise_base
+{
+    alignas(T) unsigned char storage[sizeof(T)];
+    bool                     has;
+
+    promise():has(false){}
+    ~promise()
+    {
+        if (has)
+            value().~T();
+    }
+
+    task<T> get_return_object();
+    template <typename U>
+    void return_value(U &&v)
+    {
+        ::new ((void*)storage) T(std::forward<U>(v));
+        has = true;
+    }
+    T &value() {return *std::launder(reinterpret_cast<T*>(storage));}
+};
+
+template <>
+struct promise<void> : promise_base
+{
+    task<void> get_return_object();
+    void return_void() {}
+};
+}
+
+//!
+//! \brief The task class 惰性启动的协程
+//! \note 协程在task销毁时释放，被co_await前不会执行；脱离task运行使用spawn
+//!       在sleep_for/wait_ready中挂起的协程只能在其所在线程销毁
+//!
+template <typename T>
+class task
+{
+public:
+    typedef impl::promise<T> promise_type;
+    typedef std::coroutine_handle<promise_type> handle;
+
+public:
+    task():h(){}
+    task(task &&rhs) noexcept:h(rhs.h) {rhs.h = handle();}
+    ~task()
+    {
+        if (h)
+            h.destroy();
+    }
+    task &operator = (task &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            if (h)
+                h.destroy();
+            h = rhs.h;
+            rhs.h = handle();
+        }
+        return *this;
+    }
+    task(const task &) = delete;
+    task &operator = (const task &) = delete;
+
+    bool is_valid()const {return (bool)h;}
+    bool is_done()const {return !h || h.done();}
+
+    bool await_ready()const noexcept {return !h || h.done();}
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> waiter) noexcept
+    {
+        h.promise().continuation = waiter;
+        return h;
+    }
+    T await_resume()
+    {
+        if constexpr (!std::is_void_v<T>)
+            return std::move(h.promise().value());
+    }
+
+    //!
+    //! \brief detach 脱离task在当前线程开始执行，完成后自行释放
+    //!
+    void detach()
+    {
+        handle t = h;
+        h = handle();
+        if (t)
+        {
+            t.promise().detached = true;
+            t.resume();
+        }
+    }
+
+private:
+    explicit task(handle x):h(x){}
+    friend struct impl::promise<T>;
+
+    handle h;
+};
+
+namespace impl
+{
+template <typename T>
+task<T> promise<T>::get_return_object()
+{
+    return task<T>(std::coroutine_handle<promise<T> >::from_promise(*this));
+}
+inline task<void> promise<void>::get_return_object()
+{
+    return task<void>(std::coroutine_handle<promise<void> >::from_promise(*this));
+}
+}
+
+//!
+//! \brief The sleep_for class 等待ms毫秒，由本线程的时间轮恢复
+//! \note ms为0时让出到下一次事件循环，<0不等待
+//!       定时器登记在挂起时的线程，析构(协程被销毁)必须在该线程执行，
+//!       在其他线程析构时stop_call只记录错误，定时器到期后会恢复已释放的协程
+//!
+class sleep_for : ky_thread_call
+{
+public:
+    explicit sleep_for(int64 ms):
+        ky_thread_call(&sleep_for::fire),
+        thread(0),
+        timeout(ms),
+        id(-1)
+    {
+    }
+    ~sleep_for()
+    {
+        // 协程在等待中被销毁
+        if (id >= 0)
+            thread->stop_call(id);
+    }
+
+    bool await_ready()const noexcept {return timeout < 0;}
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+        waiter = h;
+        thread = ky_thread::current();
+        id = thread->start_call(timeout, this);
+        return id >= 0;
+    }
+    void await_resume() noexcept {}
+
+private:
+    static void fire(ky_thread_call *c)
+    {
+        sleep_for *s = static_cast<sleep_for*>(c);
+        s->id = -1;
+        s->waiter.resume();
+    }
+
+    std::coroutine_handle<> waiter;
+    ky_thread              *thread;
+    int64                   timeout;
+    int                     id;
+};
+
+//!
+//! \brief The wait_ready class 等待句柄就绪一次，由本线程的事件循环恢复
+//! \note co_await的结果为false时注册失败(同一句柄已有等待者或已用registered注册)
+//!       等待登记在挂起时的线程，析构(协程被销毁)必须在该线程执行，
+//!       在其他线程析构时cancel_wait只记录错误，句柄就绪后会恢复已释放的协程
+//!
+class wait_ready : ky_thread_call
+{
+public:
+    wait_ready(intptr fd, int ion):
+        ky_thread_call(&wait_ready::fire),
+        thread(0),
+        hd(fd),
+        notify(ion),
+        pending(false),
+        ok(false)
+    {
+    }
+    ~wait_ready()
+    {
+        if (pending)
+            thread->cancel_wait(hd);
+    }
+
+    bool await_ready()const noexcept {return false;}
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+        waiter = h;
+        thread = ky_thread::current();
+        ok = thread->wait_call(hd, notify, this);
+        pending = ok;
+        return ok;
+    }
+    bool await_resume() noexcept {return ok;}
+
+private:
+    static void fire(ky_thread_call *c)
+    {
+        wait_ready *w = static_cast<wait_ready*>(c);
+        w->pending = false;
+        w->waiter.resume();
+    }
+
+    std::coroutine_handle<> waiter;
+    ky_thread              *thread;
+    intptr                  hd;
+    int                     notify;
+    bool                    pending;
+    bool                    ok;
+};
+
+//! 套接字可读(含对端关闭和接受连接)
+inline wait_ready readable(intptr fd)
+{
+    return wait_ready(fd, (int)Notify_Socket | (int)Notify_Read | (int)Notify_Accept | (int)Notify_Close);
+}
+//! 套接字可写
+inline wait_ready writable(intptr fd)
+{
+    return wait_ready(fd, (int)Notify_Socket | (int)Notify_Write);
+}
+
+//!
+//! \brief The resume_on class 切换到目标线程的事件循环继续执行
+//! \note 目标为当前线程时不切换，目标线程需要在run中执行exec。
+//!       寄送失败(目标线程没有事件循环)时记录错误并终止，不会在当前线程继续执行
+//!
+class resume_on : ky_thread_call
+{
+public:
+    explicit resume_on(ky_thread *t):
+        ky_thread_call(&resume_on::fire),
+        target(t)
+    {
+    }
+
+    bool await_ready()const noexcept {return !target || target == ky_thread::current();}
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+        waiter = h;
+        // 入队后可能立即在目标线程恢复，之后不能再访问本对象
+        if (target->post_call(this))
+            return true;
+
+        // 返回false会在当前线程继续执行，run_on的工作会跑在错误的线程上
+        log_fatal("ky_coro::resume_on: post_call failed, target thread has no event loop");
+        abort();
+    }
+    void await_resume() noexcept {}
+
+private:
+    static void fire(ky_thread_call *c)
+    {
+        static_cast<resume_on*>(c)->waiter.resume();
+    }
+
+    std::coroutine_handle<> waiter;
+    ky_thread              *target;
+};
+
+//!
+//! \brief run_on 在线程t中执行work，完成后回到当前线程
+//! \param t
+//! \param work
+//! \return work的结果
+//!
+template <typename T>
+task<T> run_on(ky_thread *t, task<T> work)
+{
+    ky_thread *home = ky_thread::current();
+    co_await resume_on(t);
+    if constexpr (std::is_void_v<T>)
+    {
+        co_await work;
+        co_await resume_on(home);
+    }
+    else
+    {
+        T v = co_await work;
+        co_await resume_on(home);
+        co_return v;
+    }
+}
+
+namespace impl
+{
+inline task<void> spawn_on(ky_thread *t, task<void> work)
+{
+    co_await resume_on(t);
+    co_await work;
+}
+}
+
+//!
+//! \brief spawn 启动协程，完成后自行释放
+//! \param work
+//! \param t 执行的线程[0 当前线程，在第一次等待前同步执行]
+//!
+inline void spawn(task<void> work, ky_thread *t = 0)
+{
+    if (t && t != ky_thread::current())
+        impl::spawn_on(t, std::move(work)).detach();
+    else
+        work.detach();
+}
+}
+
+#endif
+#endif // KY_COROUTINE_H
@@ -0,0 +1,133 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_mpsc.h
+ * @brief    无锁多生产者单消费者队列(侵入式)
+ *       1.节点由使用者分配，队列只链接节点，不分配内存
+ *       2.生产者入队只有一次原子交换，可在任意线程调用
+ *       3.出队只能在唯一的消费者线程调用，不需要原子读改写
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/17
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/17 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/17 | 1.0.0.2   | kunyang  | 加入last用于按批取出
+ * 2026/10/17 | 1.0.0.3   | kunyang  | 修正last返回0时队列可能不为空的说明
+ *
+ */
+#ifndef KY_MPSC_H
+#define KY_MPSC_H
+#include "ky_define.h"
+#include "arch/ky_atomic.h"
+
+//!
+//! \brief The ky_mpsc_node struct 队列节点，需要入队的对象继承此结构
+//!
+struct ky_mpsc_node
+{
+    ky_atomic<ky_mpsc_node*> next;
+};
+
+//!
+//! \brief The ky_mpsc_queue class 侵入式无锁队列(Vyukov算法)
+//! \note head为生产者写入端，tail为消费者读取端，两端分开在不同的缓存行
+//!
+class ky_mpsc_queue
+{
+public:
+    ky_mpsc_queue():
+        head(&stub),
+        tail(&stub)
+    {
+        stub.next.store(0);
+    }
+
+    //!
+    //! \brief push 入队(多生产者安全)
+    //! \param n
+    //! \return 入队前队列是否为空
+    //!
+    inline bool push(ky_mpsc_node *n)
+    {
+        n->next.store(0, Fence_Relaxed);
+        ky_mpsc_node *prev = head.fetch_store(n);
+        prev->next.store(n, Fence_Release);
+        return prev == &stub;
+    }
+
+    //!
+    //! \brief pop 出队(只能在消费者线程调用)
+    //! \return 队列为空或生产者正在入队时返回0
+    //!
+    inline ky_mpsc_node *pop()
+    {
+        ky_mpsc_node *t = tail;
+        ky_mpsc_node *n = t->next.load(Fence_Acquire);
+        if (t == &stub)
+        {
+            if (n == 0)
+                return 0;
+            tail = n;
+            t = n;
+            n = n->next.load(Fence_Acquire);
+        }
+        if (n)
+        {
+            tail = n;
+            return t;
+        }
+
+        // 生产者已交换head但还未链接，稍后再取
+        if (t != head.load(Fence_Acquire))
+            return 0;
+
+        push(&stub);
+        n = t->next.load(Fence_Acquire);
+        if (n)
+        {
+            tail = n;
+            return t;
+        }
+        return 0;
+    }
+
+    //!
+    //! \brief last 最后入队的节点(只能在消费者线程调用)
+    //! \return 最后入队的是哨兵时返回0
+    //! \note 按批取出时取到此节点为止，之后入队的节点留给下一批
+    //!       返回0不表示队列为空: pop重新放入哨兵时若有生产者同时入队，
+    //!       哨兵之前仍有节点，此时没有批的边界，调用者需按数量限制取出
+    //!
+    inline ky_mpsc_node *last()
+    {
+        ky_mpsc_node *h = head.load(Fence_Acquire);
+        return h == &stub ? 0 : h;
+    }
+
+    //!
+    //! \brief is_empty 队列是否为空(只能在消费者线程调用)
+    //!
+    inline bool is_empty()
+    {
+        return tail == &stub && stub.next.load(Fence_Acquire) == 0;
+    }
+
+private:
+    ky_mpsc_queue(const ky_mpsc_queue &);
+    ky_mpsc_queue &operator = (const ky_mpsc_queue &);
+
+private:
+    ky_atomic<ky_mpsc_node*> head;                          ///< 生产者端
+    char pad0[kyCpuCacheLineSize - sizeof(ky_atomic<ky_mpsc_node*>)];
+    ky_mpsc_node            *tail;                          ///< 消费者端
+    ky_mpsc_node             stub;                          ///< 哨兵节点
+    char pad1[kyCpuCacheLineSize - sizeof(ky_mpsc_node*) - sizeof(ky_mpsc_node)];
+};
+
+#endif // KY_MPSC_H
@@ -0,0 +1,497 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_task.h
+ * @brief    工作窃取任务池
+ *       1.每个工作线程有自己的双端队列(Chase-Lev)，空闲时从其他线程窃取任务
+ *       2.submit/async提交任务并返回期值，等待期值时当前线程会协助执行任务
+ *       3.parallel_for将索引范围切分后在所有工作线程上并行执行
+ *       4.工作线程可选择绑定到CPU(ky_thread::set_affinity)
+ *       5.ky_psort 并行排序：分段排序后逐层并行合并
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/17
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/17 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/17 | 1.0.0.2   | kunyang  | 加入并行排序ky_psort
+ *
+ */
+#ifndef KY_TASK_H
+#define KY_TASK_H
+#include "ky_define.h"
+#include "arch/ky_atomic.h"
+#include "tools/ky_algorlthm.h"
+
+class ky_task_pool;
+
+//!
+//! \brief The ky_task struct 任务节点，投递到任务池后由任务池执行并释放
+//!
+struct ky_task
+{
+    ky_task *next;                          ///< 任务池外部队列使用
+
+    ky_task():next(0){}
+    virtual ~ky_task(){}
+
+    //!
+    //! \brief run 执行任务
+    //!
+    virtual void run() = 0;
+};
+
+//!
+//! \brief The _task_done struct 任务的共享状态，任务和期值各持有一个引用
+//!
+struct _task_done
+{
+    ky_atomic<int> ref;
+    ky_atomic<int> done;
+    ky_task_pool  *pool;
+
+    explicit _task_done(ky_task_pool *p):ref(2), done(0), pool(p){}
+};
+template <typename T>
+struct _task_state : _task_done
+{
+    T value;
+    explicit _task_state(ky_task_pool *p):_task_done(p), value(){}
+};
+template <>
+struct _task_state<void> : _task_done
+{
+    explicit _task_state(ky_task_pool *p):_task_done(p){}
+};
+template <typename T>
+inline void _task_release(_task_state<T> *s)
+{
+    if (s && s->ref.fetch_add(-1) == 1)
+        kyDelete(s);
+}
+
+//!
+//! \brief The _task_fn struct 包装可调用对象的任务
+//!
+template <typename F, typename R>
+struct _task_fn : ky_task
+{
+    F               fn;
+    _task_state<R> *state;
+
+    _task_fn(const F &f, _task_state<R> *s):fn(f), state(s){}
+    virtual void run()
+    {
+        state->value = fn();
+        state->done.store(1, Fence_Release);
+        _task_release(state);
+    }
+};
+template <typename F>
+struct _task_fn<F, void> : ky_task
+{
+    F                  fn;
+    _task_state<void> *state;
+
+    _task_fn(const F &f, _task_state<void> *s):fn(f), state(s){}
+    virtual void run()
+    {
+        fn();
+        state->done.store(1, Fence_Release);
+        _task_release(state);
+    }
+};
+
+//!
+//! \brief The _future_base class 期值的公共部分
+//!
+template <typename T>
+class _future_base
+{
+public:
+    _future_base():state(0){}
+    explicit _future_base(_task_state<T> *s):state(s){}
+    _future_base(const _future_base &rhs):state(rhs.state)
+    {
+        if (state)
+            state->ref.fetch_add(1);
+    }
+    ~_future_base(){_task_release(state);}
+
+    _future_base &operator = (const _future_base &rhs)
+    {
+        if (rhs.state)
+            rhs.state->ref.fetch_add(1);
+        _task_release(state);
+        state = rhs.state;
+        return *this;
+    }
+
+    //!
+    //! \brief is_valid 是否关联了任务
+    //!
+    bool is_valid()const {return state != 0;}
+    //!
+    //! \brief is_ready 任务是否执行完成
+    //!
+    bool is_ready()const {return state && state->done.load(Fence_Acquire);}
+    //!
+    //! \brief wait 等待任务完成，等待期间当前线程协助执行任务池内的任务
+    //!
+    void wait()const;
+
+protected:
+    _task_state<T> *state;
+};
+
+//!
+//! \brief The ky_future class 任务结果
+//!
+template <typename T>
+class ky_future : public _future_base<T>
+{
+public:
+    ky_future(){}
+    explicit ky_future(_task_state<T> *s):_future_base<T>(s){}
+
+    //!
+    //! \brief get 等待并返回任务结果
+    //! \return
+    //!
+    T get()const
+    {
+        this->wait();
+        return this->state ? this->state->value : T();
+    }
+};
+template <>
+class ky_future<void> : public _future_base<void>
+{
+public:
+    ky_future(){}
+    explicit ky_future(_task_state<void> *s):_future_base<void>(s){}
+
+    void get()const {this->wait();}
+};
+
+//!
+//! \brief The ky_task_pool class 工作窃取任务池
+//!
+class ky_task_pool
+{
+public:
+    //!
+    //! \brief ky_task_pool
+    //! \param workers 工作线程数，0时使用ky_cpu::count()
+    //! \param pinned 是否将工作线程绑定到CPU
+    //!
+    explicit ky_task_pool(int workers = 0, bool pinned = false);
+    ~ky_task_pool();
+
+    //!
+    //! \brief global 全局任务池
+    //! \return
+    //!
+    static ky_task_pool *global();
+
+    //!
+    //! \brief count 工作线程数
+    //! \return
+    //!
+    int count()const;
+
+    //!
+    //! \brief post 投递任务，执行完成后由任务池释放
+    //! \param t
+    //! \note 在工作线程内投递时进入自己的队列，否则进入外部队列
+    //!
+    void post(ky_task *t);
+
+    //!
+    //! \brief run_one 在当前线程执行一个待执行的任务
+    //! \return 没有可执行任务时返回false
+    //!
+    bool run_one();
+
+    //!
+    //! \brief wait_until 等待flag变为value，期间协助执行任务
+    //! \param flag
+    //! \param value
+    //!
+    void wait_until(ky_atomic<int> &flag, int value);
+
+    //!
+    //! \brief submit 提交不关心返回值的任务
+    //! \param f 可调用对象
+    //! \return
+    //!
+    template <typename F>
+    ky_future<void> submit(const F &f)
+    {
+        typedef _task_fn<F, void> task_t;
+        _task_state<void> *s = kyNew(_task_state<void>(this));
+        post(kyNew(task_t(f, s)));
+        return ky_future<void>(s);
+    }
+
+    //!
+    //! \brief async 提交任务，通过期值获取返回值
+    //! \param f 可调用对象
+    //! \return
+    //!
+    template <typename F>
+    ky_future<decltype(((F*)0)->operator()())> async(const F &f)
+    {
+        typedef decltype(((F*)0)->operator()()) R;
+        typedef _task_fn<F, R> task_t;
+        _task_state<R> *s = kyNew(_task_state<R>(this));
+        post(kyNew(task_t(f, s)));
+        return ky_future<R>(s);
+    }
+
+    //!
+    //! \brief parallel_for 并行执行[begin, end)
+    //! \param begin
+    //! \param end
+    //! \param f 以f(first, last)的方式调用，每次处理一段[first, last)
+    //! \param grain 每段的最小长度，0时自动选择
+    //! \note 调用线程也参与执行，函数返回时所有段已执行完成
+    //!
+    template <typename F>
+    void parallel_for(int64 begin, int64 end, const F &f, int64 grain = 0);
+
+private:
+    ky_task_pool(const ky_task_pool &);
+    ky_task_pool &operator = (const ky_task_pool &);
+
+private:
+    struct task_pool_priv *impl;
+};
+
+template <typename T>
+void _future_base<T>::wait()const
+{
+    if (state && !state->done.load(Fence_Acquire))
+        state->pool->wait_until(state->done, 1);
+}
+
+//!
+//! \brief The _task_range struct parallel_for的控制块，各个任务从中领取索引段
+//!
+template <typename F>
+struct _task_range
+{
+    ky_atomic<int64> next;
+    ky_atomic<int>   active;
+    int64            end;
+    int64            grain;
+    const F         *fn;
+
+    void consume()
+    {
+        forever (true)
+        {
+            const int64 b = next.fetch_add(grain);
+            if (b >= end)
+                break;
+            (*fn)(b, b + grain < end ? b + grain : end);
+        }
+    }
+};
+template <typename F>
+struct _task_range_fn : ky_task
+{
+    _task_range<F> *range;
+
+    explicit _task_range_fn(_task_range<F> *r):range(r){}
+    virtual void run()
+    {
+        range->consume();
+        range->active.fetch_add(-1);
+    }
+};
+
+template <typename F>
+void ky_task_pool::parallel_for(int64 begin, int64 end, const F &f, int64 grain)
+{
+    const int64 len = end - begin;
+    if (len <= 0)
+        return;
+
+    const int64 part = (int64)count() * 4;
+    if (grain <= 0)
+        grain = len / part > 0 ? len / part : 1;
+
+    int64 helpers = (len + grain - 1) / grain - 1;
+    if (helpers > count())
+        helpers = count();
+    if (helpers <= 0)
+    {
+        f(begin, end);
+        return;
+    }
+
+    _task_range<F> range;
+    range.next.store(begin);
+    range.active.store((int)helpers);
+    range.end = end;
+    range.grain = grain;
+    range.fn = &f;
+    for (int64 i = 0; i < helpers; ++i)
+        post(kyNew(_task_range_fn<F>(&range)));
+
+    range.consume();
+    // 控制块在栈上，需等待所有辅助任务退出
+    wait_until(range.active, 0);
+}
+
+//!
+//! \brief The _psort_sort struct 并行排序的第一步，各段分别排序
+//!
+template <typename T>
+struct _psort_sort
+{
+    T    *a;
+    int64 n;
+    int64 step;
+
+    void operator()(int64 first, int64 last)const
+    {
+        for (int64 i = first; i < last; ++i)
+        {
+            const int64 b = i * step;
+            const int64 e = b + step < n ? b + step : n;
+            if (b < e)
+                ky_qsort(a + b, a + e);
+        }
+    }
+};
+//!
+//! \brief The _psort_merge struct 一层合并，每次合并按输出位置切分成pieces段并行执行
+//!
+template <typename T>
+struct _psort_merge
+{
+    const T *src;
+    T       *dst;
+    int64    n;
+    int64    width;
+    int64    pieces;
+
+    void operator()(int64 first, int64 last)const
+    {
+        for (int64 t = first; t < last; ++t)
+        {
+            const int64 lo = (t / pieces) * 2 * width;
+            if (lo >= n)
+                continue;
+            const int64 mid = lo + width < n ? lo + width : n;
+            const int64 hi = lo + 2 * width < n ? lo + 2 * width : n;
+            const int64 k = t % pieces;
+            const int64 d0 = (hi - lo) * k / pieces;
+            const int64 d1 = (hi - lo) * (k + 1) / pieces;
+
+            const T *x = src + lo;
+            const T *y = src + mid;
+            const int64 i0 = __sort__::merge_split(x, mid - lo, y, hi - mid, d0);
+            const int64 i1 = __sort__::merge_split(x, mid - lo, y, hi - mid, d1);
+            __sort__::merge_runs(x + i0, i1 - i0, y + (d0 - i0), (d1 - i1) - (d0 - i0),
+                                 dst + lo + d0);
+        }
+    }
+};
+//!
+//! \brief The _psort_copy struct 缓冲区的构造、复制和析构
+//!
+template <typename T>
+struct _psort_copy
+{
+    enum {Construct, Assign, Destruct};
+
+    T       *dst;
+    const T *src;
+    int      mode;
+
+    void operator()(int64 first, int64 last)const
+    {
+        for (int64 i = first; i < last; ++i)
+        {
+            if (mode == Construct)
+                complex_construct(dst[i], src[i]);
+            else if (mode == Assign)
+                dst[i] = src[i];
+            else
+                complex_destruct(dst[i]);
+        }
+    }
+};
+
+//!
+//! \brief ky_psort 并行排序，不稳定
+//! \param a
+//! \param n
+//! \param pool 执行排序的任务池，0时使用全局任务池
+//! \note 1.按工作线程数分段，各段使用ky_qsort排序
+//!       2.之后逐层两两合并，每次合并切分成互不重叠的几段，最后一层也能并行
+//!       3.需要一块与数组同样大小的缓冲区，元素较少时直接使用ky_qsort
+//!
+template <typename T>
+void ky_psort(T *a, int64 n, ky_task_pool *pool = 0)
+{
+    enum {SerialLimit = 1 << 15};
+    if (pool == 0)
+        pool = ky_task_pool::global();
+    const int64 workers = (int64)pool->count() + 1;
+    if (n < SerialLimit || workers < 2)
+    {
+        ky_qsort(a, a + n);
+        return;
+    }
+
+    int64 parts = 1;
+    while (parts < workers)
+        parts <<= 1;
+    const int64 step = (n + parts - 1) / parts;
+    const _psort_sort<T> sorter = {a, n, step};
+    pool->parallel_for(0, parts, sorter, 1);
+
+    T *buf = (T*)kyMalloc(sizeof(T) * n);
+    if (is_complex<T>::value)
+    {
+        const _psort_copy<T> init = {buf, a, _psort_copy<T>::Construct};
+        pool->parallel_for(0, n, init);
+    }
+
+    T *src = a;
+    T *dst = buf;
+    for (int64 width = step; width < n; width *= 2)
+    {
+        const int64 pairs = (n + 2 * width - 1) / (2 * width);
+        const int64 pieces = (parts + pairs - 1) / pairs;
+        const _psort_merge<T> merger = {src, dst, n, width, pieces};
+        pool->parallel_for(0, pairs * pieces, merger, 1);
+
+        T *t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != a)
+    {
+        const _psort_copy<T> back = {a, src, _psort_copy<T>::Assign};
+        pool->parallel_for(0, n, back);
+    }
+
+    if (is_complex<T>::value)
+    {
+        const _psort_copy<T> fini = {buf, 0, _psort_copy<T>::Destruct};
+        pool->parallel_for(0, n, fini);
+    }
+    kyFree(buf);
+}
+
+#endif // KY_TASK_H
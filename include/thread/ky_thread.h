@@ -31,10 +31,15 @@
  * 2016/11/18 | 1.1.2.1   | kunyang  | 修改线程实现并加入TLS和睡眠机制，内部加入全局线程管理
  * 2017/08/26 | 1.2.0.1   | kunyang  | 加入线程安全和非安全类
  * 2018/07/01 | 1.2.1.1   | kunyang  | 修改线程安全类使用原子操作
+ * 2026/10/17 | 1.2.2.1   | kunyang  | 加入每批寄送事件数的设置
+ * 2026/10/17 | 1.2.3.1   | kunyang  | 加入异步IO的注册接口
+ * 2026/10/17 | 1.2.4.1   | kunyang  | 加入事件循环的回调接口(协程恢复)
+ * 2026/10/17 | 1.2.4.2   | kunyang  | 事件循环未运行时post_call失败
  */
 #ifndef KY_THREADS_H
 #define KY_THREADS_H
 #include "ky_define.h"
+#include "thread/ky_mpsc.h"
 
 #ifndef kyTimeoutIndefinite
 #define kyTimeoutIndefinite (-1)
@@ -78,6 +83,18 @@ struct tThreadLocalStorages :public ky_ref
     virtual void destroy() = 0;
 };
 
+//!
+//! \brief The ky_thread_call struct 在线程事件循环中执行的回调节点
+//! \note 节点由调用者持有(如协程帧内的等待对象)，执行前需要保持有效，
+//!       执行时线程已不再引用节点，回调内可以释放或重新提交
+//!
+struct ky_thread_call : ky_mpsc_node
+{
+    void (*call)(ky_thread_call *self);
+
+    explicit ky_thread_call(void (*fn)(ky_thread_call *) = 0):call(fn){}
+};
+
 /*!
  * @brief The ky_thread class Thread
  * @class ky_thread
@@ -192,6 +209,76 @@ public:
     //!
     void quit();
 
+    //!
+    //! \brief set_post_budget 设置exec每批最多寄送的事件数，超过后先检查一次IO
+    //! \param n 事件数[<=0 每批寄送全部已入队的事件]
+    //!
+    void set_post_budget(int n);
+    int post_budget()const;
+
+    //!
+    //! \brief is_async_io 事件循环是否支持异步IO(Linux下为io_uring)
+    //! \return false时 ky_object::submit_io 总是失败
+    //!
+    bool is_async_io()const;
+    //!
+    //! \brief register_io_files 注册固定句柄，以fixed提交时fd为序号
+    //! \param fds 句柄列表[count <= 0 注销]
+    //! \param count
+    //! \note 以下注册接口只能在本线程内调用
+    //!
+    bool register_io_files(const int *fds, int count);
+    //!
+    //! \brief register_io_buffers 注册固定缓冲区，提交时以buffer指定序号
+    //! \param data 缓冲区地址列表[count <= 0 注销]
+    //! \param size 缓冲区大小列表
+    //! \param count
+    //!
+    bool register_io_buffers(void *const *data, const int64 *size, int count);
+    //!
+    //! \brief provide_io_buffers 向缓冲区组提供count个连续的size大小缓冲区
+    //! \param group 缓冲区组，Recv以group提交时由内核选取
+    //! \param base 首个缓冲区的地址
+    //! \param size 每个缓冲区的大小
+    //! \param count
+    //! \param first 首个缓冲区的序号
+    //! \note 选取的缓冲区用完后需要重新提供
+    //!
+    bool provide_io_buffers(int group, void *base, int64 size, int count, int first = 0);
+
+    //!
+    //! \brief post_call 在本线程的事件循环中执行回调，可在任意线程调用
+    //! \param c
+    //! \return false事件循环未运行，回调不会执行
+    //! \note 与寄送的事件按顺序执行，线程需要在run中执行exec
+    //!
+    bool post_call(ky_thread_call *c);
+    //!
+    //! \brief start_call 在ms毫秒后执行一次回调，只能在本线程内调用
+    //! \param ms
+    //! \param c
+    //! \return 定时器id，失败返回-1
+    //!
+    int start_call(int64 ms, ky_thread_call *c);
+    //!
+    //! \brief stop_call 停止未执行的定时回调
+    //! \param id start_call返回的id
+    //!
+    void stop_call(int id);
+    //!
+    //! \brief wait_call 句柄就绪一次后注销并执行回调，只能在本线程内调用
+    //! \param fd 套接字句柄
+    //! \param ion 等待的通知[eNotifyFlags]
+    //! \param c
+    //! \return 句柄已注册或注册失败返回false
+    //!
+    bool wait_call(intptr fd, int ion, ky_thread_call *c);
+    //!
+    //! \brief cancel_wait 取消未就绪的wait_call，回调不会执行
+    //! \param fd
+    //!
+    void cancel_wait(intptr fd);
+
 public:
     //!
     //! \brief sleep 睡眠s秒
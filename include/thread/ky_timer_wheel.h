@@ -0,0 +1,125 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_timer_wheel.h
+ * @brief    分层时间轮定时器(侵入式)
+ *       1.节点由使用者分配，时间轮只链接节点，不分配内存
+ *       2.启动、停止、重新计时都是O(1)的链表操作
+ *       3.精度为毫秒，根轮256格，其上4层各64格，超过约49天的按最远一格放置
+ *       4.由轮询的超时驱动，不占用内核定时器和句柄
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/17
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/17 | 1.0.0.1   | kunyang  | 创建文件
+ *
+ */
+#ifndef KY_TIMER_WHEEL_H
+#define KY_TIMER_WHEEL_H
+#include "ky_define.h"
+
+//!
+//! \brief The ky_timer_node struct 时间轮节点，需要定时的对象继承此结构
+//!
+struct ky_timer_node
+{
+    ky_timer_node *prev;
+    ky_timer_node *next;
+    int64          expire;   ///< 到期的时间点(毫秒)
+    int64          interval; ///< 周期[<=0 单次]
+    int            slot;     ///< 所在的格[-1 未启动]
+
+    ky_timer_node():prev(0), next(0), expire(0), interval(0), slot(-1){}
+};
+
+//!
+//! \brief The ky_timer_wheel class 分层时间轮
+//! \note 只能在一个线程内使用，时间由调用者传入，通常为 ky_timer_wheel::now
+//!
+class ky_timer_wheel
+{
+public:
+    enum
+    {
+        RootBits = 8,
+        RootSize = 1 << RootBits,
+        LevelBits = 6,
+        LevelSize = 1 << LevelBits,
+        Levels = 4,
+        Slots = RootSize + Levels * LevelSize
+    };
+
+public:
+    explicit ky_timer_wheel(int64 now = ky_timer_wheel::now());
+    ~ky_timer_wheel();
+
+    //!
+    //! \brief start 启动或重新计时
+    //! \param t 节点，已启动的节点先停止
+    //! \param timeout 从当前时间起的超时(毫秒)
+    //! \param interval 周期[<=0 单次]
+    //!
+    void start(ky_timer_node *t, int64 timeout, int64 interval = 0);
+    //!
+    //! \brief stop 停止节点，未启动或已停止的节点不做处理
+    //! \param t
+    //!
+    void stop(ky_timer_node *t);
+    //!
+    //! \brief is_active 节点是否在时间轮或到期列表内
+    //!
+    static bool is_active(const ky_timer_node *t) {return t->slot >= 0;}
+
+    //!
+    //! \brief advance 推进到now，并把到期节点移入到期列表
+    //! \param now
+    //! \return 到期列表内的节点数
+    //!
+    int advance(int64 now);
+    //!
+    //! \brief fetch 取出一个到期的节点，周期节点在取出时重新启动
+    //! \return 0无可用
+    //!
+    ky_timer_node *fetch();
+
+    //!
+    //! \brief next_timeout 距离下一次需要推进的时间，用作轮询的超时
+    //! \param now
+    //! \return 毫秒，-1无定时
+    //! \note 高层的格在下放时唤醒，所以返回值可能早于真正的到期
+    //!
+    int64 next_timeout(int64 now)const;
+
+    //! 启动的节点数(含到期未取出的)
+    int count()const {return counts;}
+    bool is_empty()const {return counts == 0;}
+
+    //!
+    //! \brief now 单调时钟的当前时间(毫秒)
+    //!
+    static int64 now();
+
+private:
+    void place(ky_timer_node *t);
+    void unlink(ky_timer_node *t);
+    void cascade(int level, int index);
+    void expire_root(int index);
+    int64 next_tick()const;
+
+private:
+    ky_timer_node  wheel[Slots];   ///< 各格的哨兵
+    ky_timer_node  expired;        ///< 到期列表的哨兵
+    uint64         root_map[RootSize / 64];
+    uint64         level_map[Levels];
+    int64          base;           ///< 下一个需要处理的时间点
+    int            counts;
+    int            wheel_counts;   ///< 在轮内的节点数
+};
+
+#endif // KY_TIMER_WHEEL_H
@@ -36,6 +36,8 @@
  * 2016/02/11 | 1.1.0.1   | kunyang  | 加入散列计算算法
  * 2016/06/04 | 1.2.0.1   | kunyang  | 加入排序算法
  * 2016/11/22 | 1.2.1.1   | kunyang  | 修改排序算法并加入归并排序算法
+ * 2026/10/17 | 1.3.0.1   | kunyang  | 加入64位带种子的WY散列，ky_hash_f修改为返回64位
+ * 2026/10/17 | 1.3.1.1   | kunyang  | 快速排序改为pdqsort，加入基数排序，归并排序只分配一次缓冲区
  */
 #ifndef ky_ALGORLTHM_H
 #define ky_ALGORLTHM_H
@@ -181,7 +183,17 @@ namespace __sort__
     void insert2(T* a, int64 alength);
 
     //!
-    //! @brief quick 数组型快速排序
+    //! @brief pdq 模式消除快速排序(pdqsort)，不稳定
+    //!
+    //! @param begin 是开始地址或容器开始迭代
+    //! @param end 是结束地址或容器结束迭代
+    //! @note 平均和最差都是O(nlogn)，已有序、逆序和大量重复的数据接近线性时间
+    //!
+    template<typename I>
+    void pdq(I begin, I end);
+
+    //!
+    //! @brief quick 数组型快速排序，使用pdq实现
     //!
     //! @param begin 是数组的开始地址
     //! @param end 是数组的结束地址
@@ -223,6 +235,66 @@ namespace __sort__
     //!
     template <typename T>
     void merge(T *arr, int64 length);
+
+    //!
+    //! @brief radix LSD基数排序，只用于整数和浮点数
+    //!
+    //! @param a 是数组的开始地址
+    //! @param n 是数组的长度
+    //!
+    template <typename T>
+    void radix(T *a, int64 n);
+
+    //!
+    //! \brief The _radix_key_ struct 基数排序的key
+    //! \note 转换后按无符号数比较与原值的顺序一致：有符号数翻转符号位，
+    //!       浮点数为负时全部取反，否则翻转符号位
+    //!
+    template <typename T> struct _radix_key_;
+
+#define __RadixUnsignedKey(T, U) \
+    template <> struct _radix_key_<T> \
+    { \
+        typedef U type; \
+        static inline U get(T v) {return (U)v;} \
+    };
+#define __RadixSignedKey(T, U) \
+    template <> struct _radix_key_<T> \
+    { \
+        typedef U type; \
+        static inline U get(T v) {return (U)v ^ ((U)1 << (sizeof(U) * 8 - 1));} \
+    };
+    __RadixSignedKey(i8, u8)
+    __RadixSignedKey(i16, u16)
+    __RadixSignedKey(i32, u32)
+    __RadixSignedKey(i64, u64)
+    __RadixUnsignedKey(u8, u8)
+    __RadixUnsignedKey(u16, u16)
+    __RadixUnsignedKey(u32, u32)
+    __RadixUnsignedKey(u64, u64)
+#undef __RadixSignedKey
+#undef __RadixUnsignedKey
+
+    template <> struct _radix_key_<f32>
+    {
+        typedef u32 type;
+        static inline u32 get(f32 v)
+        {
+            union {f32 fv; u32 uv;};
+            fv = v;
+            return (uv & 0x80000000u) ? ~uv : (uv | 0x80000000u);
+        }
+    };
+    template <> struct _radix_key_<f64>
+    {
+        typedef u64 type;
+        static inline u64 get(f64 v)
+        {
+            union {f64 fv; u64 uv;};
+            fv = v;
+            return (uv & 0x8000000000000000ull) ? ~uv : (uv | 0x8000000000000000ull);
+        }
+    };
 }
 
 //!
@@ -289,6 +361,14 @@ inline void ky_bsort(T *H, int64 length){__sort__::bubble(H, length);}
 template<typename T>
 inline void ky_msort(T *H, int64 length){__sort__::merge(H, length);}
 
+//!
+//! \brief ky_rsort 基数排序，只用于整数和浮点数
+//! \param a
+//! \param length
+//!
+template<typename T>
+inline void ky_rsort(T *a, int64 length){__sort__::radix(a, length);}
+
 namespace __hash__
 {
     // RS Hash Function
@@ -313,22 +393,40 @@ namespace __hash__
     u32 BP(char *str, i64 len);
     /*FNVHash*/
     u32 FNV(char *str, i64 len);
-    u32 FNV64(char *str, i64 len);
-    u32 H64(u64 v);
+    u64 FNV64(char *str, i64 len);
+    u64 H64(u64 v);
+
+    //!
+    //! \brief WY 64位带种子的散列(wyhash算法)
+    //!        短数据使用64x64->128位乘法混合，每次处理48字节；
+    //!        长数据(>=256字节)使用SSE2/NEON并行累加8路64位通道
+    //! \param data
+    //! \param len
+    //! \param seed
+    //! \return
+    //!
+    u64 WY(const void *data, i64 len, u64 seed);
+    //!
+    //! \brief seed 返回进程的散列种子
+    //! \note 每个进程启动时随机生成，防止散列洪水攻击
+    //! \return
+    //!
+    u64 seed();
 }
 
-inline u32 ky_hash_f(const i8 & v){return (u32)v;}
-inline u32 ky_hash_f(const u8 & v){return (u32)v;}
-inline u32 ky_hash_f(const i16 & v){return (u32)v;}
-inline u32 ky_hash_f(const u16 & v){return (u32)v;}
-inline u32 ky_hash_f(const i32 & v){return (u32)v;}
-inline u32 ky_hash_f(const u32 & v){return (u32)v;}
-inline u32 ky_hash_f(const wchar_t & v){return (u32)v;}
-inline u32 ky_hash_f(const i64 & v){return __hash__::H64 (v);}
-inline u32 ky_hash_f(const u64 & v){return __hash__::H64 (v);}
-inline u32 ky_hash_f(f32 v){union{f32 tv;u64 v64;};tv = v; return __hash__::H64(v64);}
-inline u32 ky_hash_f(f64 v){union{f64 tv;u64 v64;};tv = v; return __hash__::H64(v64);}
-inline u32 ky_hash_f(char *v, int len = -1){if (len < 0) len = ::strlen (v);return __hash__::DJB(v, len);}
+inline u64 ky_hash_f(const i8 & v){return (u32)v;}
+inline u64 ky_hash_f(const u8 & v){return (u32)v;}
+inline u64 ky_hash_f(const i16 & v){return (u32)v;}
+inline u64 ky_hash_f(const u16 & v){return (u32)v;}
+inline u64 ky_hash_f(const i32 & v){return (u32)v;}
+inline u64 ky_hash_f(const u32 & v){return (u32)v;}
+inline u64 ky_hash_f(const wchar_t & v){return (u32)v;}
+inline u64 ky_hash_f(const i64 & v){return __hash__::H64 (v);}
+inline u64 ky_hash_f(const u64 & v){return __hash__::H64 (v);}
+inline u64 ky_hash_f(f32 v){union{f32 tv;u64 v64;};v64 = 0; tv = v; return __hash__::H64(v64);}
+inline u64 ky_hash_f(f64 v){union{f64 tv;u64 v64;};tv = v; return __hash__::H64(v64);}
+inline u64 ky_hash_f(const void *v, i64 len){return __hash__::WY(v, len, __hash__::seed());}
+inline u64 ky_hash_f(const char *v, i64 len = -1){if (len < 0) len = ::strlen (v);return __hash__::WY(v, len, __hash__::seed());}
 
 #include "ky_algorlthm.inl"
 
@@ -61,144 +61,313 @@ void insert2(T* a, int64 alength)
         a[i] = b[(i + first) % alength];
 }
 
-template<typename T>
-void quick(T *begin, T *end)
+enum
 {
-top:
-    int length = end - begin;
-    if (length < 2)
-        return;
+    InsertionThreshold = 24,     ///< 小于此长度时使用插入排序
+    NintherThreshold = 128,      ///< 大于此长度时使用九数取中选择基准
+    PartialInsertionLimit = 8,   ///< 检测已有序时插入排序最多移动的元素数
+    MergeRun = 16                ///< 归并排序初始有序段的长度
+};
 
-    --end;
-    T *low = begin, *high = end-1;
-    T *pivot = begin + length / 2 ;
+inline int _log2_(int64 n)
+{
+    int log = 0;
+    while (n >>= 1)
+        ++log;
+    return log;
+}
 
-    if (*end < *begin)
-        ky_swap(*end, *begin);
-    if (length == 2)
-        return ;
+//!
+//! \brief The _pdq_ struct 模式消除快速排序(pattern-defeating quicksort)
+//! \note 1.小区间使用插入排序，大区间使用九数取中选择基准
+//!       2.与前一个基准相等时把相等的元素集中到左侧，大量重复的数据为线性时间
+//!       3.划分没有交换元素时尝试有限的插入排序，已有序的数据为线性时间
+//!       4.划分极不平衡时打乱部分元素，次数超过log(n)后改用堆排序，最差O(nlogn)
+//!       5.元素只需要operator <
+//!
+template <typename I, typename T>
+struct _pdq_
+{
+    static inline void swap(I a, I b)
+    {
+        T tmp = *a;
+        *a = *b;
+        *b = tmp;
+    }
+    static inline void sort2(I a, I b)
+    {
+        if (*b < *a)
+            swap(a, b);
+    }
+    static inline void sort3(I a, I b, I c)
+    {
+        sort2(a, b);
+        sort2(b, c);
+        sort2(a, b);
+    }
 
-    if (*pivot < *begin)
-        ky_swap(*pivot, *begin);
-    if (*end < *pivot)
-        ky_swap(*end, *pivot);
-    if (length == 3)
-        return ;
+    static void insertion(I begin, I end)
+    {
+        if (begin == end)
+            return;
+        for (I cur = begin + 1; cur != end; ++cur)
+        {
+            I sift = cur;
+            I sift_1 = cur - 1;
+            if (*sift < *sift_1)
+            {
+                T tmp = *sift;
+                do
+                    *sift-- = *sift_1;
+                while (sift != begin && tmp < *--sift_1);
+                *sift = tmp;
+            }
+        }
+    }
+    //! begin左侧的元素不大于区间内的任何元素，不需要检查边界
+    static void unguarded_insertion(I begin, I end)
+    {
+        if (begin == end)
+            return;
+        for (I cur = begin + 1; cur != end; ++cur)
+        {
+            I sift = cur;
+            I sift_1 = cur - 1;
+            if (*sift < *sift_1)
+            {
+                T tmp = *sift;
+                do
+                    *sift-- = *sift_1;
+                while (tmp < *--sift_1);
+                *sift = tmp;
+            }
+        }
+    }
+    //! 移动的元素超过限制时放弃并返回false
+    static bool partial_insertion(I begin, I end)
+    {
+        if (begin == end)
+            return true;
+        int64 moved = 0;
+        for (I cur = begin + 1; cur != end; ++cur)
+        {
+            I sift = cur;
+            I sift_1 = cur - 1;
+            if (*sift < *sift_1)
+            {
+                T tmp = *sift;
+                do
+                    *sift-- = *sift_1;
+                while (sift != begin && tmp < *--sift_1);
+                *sift = tmp;
+                moved += cur - sift;
+            }
+            if (moved > PartialInsertionLimit)
+                return false;
+        }
+        return true;
+    }
 
-    ky_swap(*pivot, *end);
+    static void sift_down(I first, int64 root, int64 n)
+    {
+        T tmp = *(first + root);
+        int64 child;
+        while ((child = 2 * root + 1) < n)
+        {
+            if (child + 1 < n && *(first + child) < *(first + (child + 1)))
+                ++child;
+            if (!(tmp < *(first + child)))
+                break;
+            *(first + root) = *(first + child);
+            root = child;
+        }
+        *(first + root) = tmp;
+    }
+    static void heap(I begin, I end)
+    {
+        const int64 n = end - begin;
+        for (int64 i = n / 2 - 1; i >= 0; --i)
+            sift_down(begin, i, n);
+        for (int64 i = n - 1; i > 0; --i)
+        {
+            swap(begin, begin + i);
+            sift_down(begin, 0, i);
+        }
+    }
 
-    while (low < high)
+    //!
+    //! \brief partition_right 以*begin为基准划分，等于基准的元素放在右侧
+    //! \param already 划分前是否已经是划分好的
+    //! \return 基准的位置
+    //!
+    static I partition_right(I begin, I end, bool &already)
     {
-        while (low < high && *low < *end)
-            ++low;
-        while (high > low && *end < *high)
-            --high;
+        T pivot = *begin;
+        I first = begin;
+        I last = end;
 
-        if (low < high)
+        // 中位数选择保证了左侧有不小于基准的元素，右侧有小于基准的元素
+        while (*++first < pivot);
+        if (first - 1 == begin)
+            while (first < last && !(*--last < pivot));
+        else
+            while (!(*--last < pivot));
+
+        already = first >= last;
+        while (first < last)
         {
-            ky_swap(*low, *high);
-            ++low;
-            --high;
-        } else
-            break;
-    }
+            swap(first, last);
+            while (*++first < pivot);
+            while (!(*--last < pivot));
+        }
 
-    if (*low < *end)
-        ++low;
+        I pivot_pos = first - 1;
+        *begin = *pivot_pos;
+        *pivot_pos = pivot;
+        return pivot_pos;
+    }
+    //!
+    //! \brief partition_left 以*begin为基准划分，等于基准的元素放在左侧
+    //! \note 基准与前一次的基准相等时使用，左侧的元素之后不再需要排序
+    //!
+    static I partition_left(I begin, I end)
+    {
+        T pivot = *begin;
+        I first = begin;
+        I last = end;
 
-    ky_swap(*end, *low);
-    quick(begin, low);
+        while (pivot < *--last);
+        if (last + 1 == end)
+            while (first < last && !(pivot < *++first));
+        else
+            while (!(pivot < *++first));
 
-    begin = low + 1;
-    ++end;
-    goto top;
-}
+        while (first < last)
+        {
+            swap(first, last);
+            while (pivot < *--last);
+            while (!(pivot < *++first));
+        }
 
-template<typename container_iterator>
-void quick(container_iterator begin, container_iterator end)
-{
-top:
-    int span = int(end - begin);
-    if (span < 2)
-        return;
+        I pivot_pos = last;
+        *begin = *pivot_pos;
+        *pivot_pos = pivot;
+        return pivot_pos;
+    }
 
-    --end;
-    container_iterator low = begin, high = end - 1;
-    container_iterator pivot = begin + span / 2;
+    static void loop(I begin, I end, int bad_allowed, bool leftmost)
+    {
+        forever (true)
+        {
+            const int64 size = end - begin;
+            if (size < InsertionThreshold)
+            {
+                if (leftmost)
+                    insertion(begin, end);
+                else
+                    unguarded_insertion(begin, end);
+                return;
+            }
 
-    if (*end < *begin)
-        ky_swap(*end, *begin);
-    if (span == 2)
-        return;
+            const int64 s2 = size / 2;
+            if (size > NintherThreshold)
+            {
+                sort3(begin, begin + s2, end - 1);
+                sort3(begin + 1, begin + (s2 - 1), end - 2);
+                sort3(begin + 2, begin + (s2 + 1), end - 3);
+                sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1));
+                swap(begin, begin + s2);
+            }
+            else
+                sort3(begin + s2, begin, end - 1);
 
-    if (*pivot < *begin)
-        ky_swap(*pivot, *begin);
-    if (*end < *pivot)
-        ky_swap(*end, *pivot);
-    if (span == 3)
-        return;
+            // 基准等于左侧区间的最大值，区间内等于基准的元素都已就位
+            if (!leftmost && !(*(begin - 1) < *begin))
+            {
+                begin = partition_left(begin, end) + 1;
+                continue;
+            }
 
-    ky_swap(*pivot, *end);
+            bool already = false;
+            I pivot_pos = partition_right(begin, end, already);
+            const int64 l_size = pivot_pos - begin;
+            const int64 r_size = end - (pivot_pos + 1);
 
-    while (low < high)
-    {
-        while (low < high && *low < *end)
-            ++low;
-        while (high > low && *end < *high)
-            --high;
+            if (l_size < size / 8 || r_size < size / 8)
+            {
+                if (--bad_allowed == 0)
+                {
+                    heap(begin, end);
+                    return;
+                }
+                // 打乱两侧的部分元素，破坏导致划分不平衡的模式
+                if (l_size >= InsertionThreshold)
+                {
+                    swap(begin, begin + l_size / 4);
+                    swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                    if (l_size > NintherThreshold)
+                    {
+                        swap(begin + 1, begin + (l_size / 4 + 1));
+                        swap(begin + 2, begin + (l_size / 4 + 2));
+                        swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                        swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                    }
+                }
+                if (r_size >= InsertionThreshold)
+                {
+                    swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                    swap(end - 1, end - r_size / 4);
+                    if (r_size > NintherThreshold)
+                    {
+                        swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                        swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                        swap(end - 2, end - (1 + r_size / 4));
+                        swap(end - 3, end - (2 + r_size / 4));
+                    }
+                }
+            }
+            else if (already && partial_insertion(begin, pivot_pos) &&
+                     partial_insertion(pivot_pos + 1, end))
+                return;
 
-        if (low < high)
-        {
-            ky_swap(*low, *high);
-            ++low;
-            --high;
-        } else
-            break;
+            loop(begin, pivot_pos, bad_allowed, leftmost);
+            begin = pivot_pos + 1;
+            leftmost = false;
+        }
     }
+};
 
-    if (*low < *end)
-        ++low;
+template <typename I, typename T>
+inline void _pdq_sort_(I begin, I end, T *)
+{
+    _pdq_<I, T>::loop(begin, end, _log2_(end - begin), true);
+}
 
-    ky_swap(*end, *low);
-    quick(begin, low);
+template <typename I>
+void pdq(I begin, I end)
+{
+    if (end - begin < 2)
+        return;
+    // 通过元素地址推导元素类型，指针和容器迭代器都可以使用
+    _pdq_sort_(begin, end, &*begin);
+}
 
-    begin = low + 1;
-    ++end;
-    goto top;
+template<typename T>
+void quick(T *begin, T *end)
+{
+    pdq(begin, end);
 }
 
-template <typename T>
-inline void _HeapAdjust_(T *H, T s, int64 length)
+template<typename container_iterator>
+void quick(container_iterator begin, container_iterator end)
 {
-    T tmp  = H[s];
-    int64 child = 2 * s+1;
-    while (child < length)
-    {
-        if (child+1 < length && H[child] < H[child+1])
-            ++child ;
-        if (H[s] < H[child])
-        {
-            H[s] = H[child];
-            s = child;
-            child = 2*s+1;
-        }
-        else
-            break;
-        H[s] = tmp;
-    }
+    pdq(begin, end);
 }
 
 template <typename T>
 void heap(T *H, int64 length)
 {
-    for (int64 i = (length -1) / 2 ; i > 0; --i)
-        _HeapAdjust_<T>(H, i, length);
-    _HeapAdjust_<T>(H, 0, length);
-    for (int64 i = length - 1; i > 0; --i)
-    {
-        bs_swap(H[i], H[0]);
-        _HeapAdjust_<T>(H, 0, i);
-    }
+    _pdq_<T*, T>::heap(H, H + length);
 }
 
 template <typename T>
@@ -219,49 +388,144 @@ void bubble (T *r, int64 length)
     }
 }
 
+//!
+//! \brief merge_runs 稳定合并两个有序序列到dst
+//!
 template <typename T>
-inline void _merge_( T *arr, int low, int mid, int high)
+inline void merge_runs(const T *a, int64 na, const T *b, int64 nb, T *dst)
 {
-    int i = low, j = mid+1, k=0;
-    T temp[high-low+1]= {T()};
-    while (i <= mid && j <= high)
+    int64 i = 0, j = 0;
+    while (i < na && j < nb)
     {
-        if (arr[i] <= arr[j])
-            temp[k++] = arr[i++];
+        if (b[j] < a[i])
+            *dst++ = b[j++];
         else
-            temp[k++] = arr[j++];
+            *dst++ = a[i++];
     }
-    while (i <= mid)
-        temp[k++] = arr[i++];
-    while (j <= high)
-        temp[k++] = arr[j++];
-    for(i = low, k = 0; i <= high; i++, k++)
-        arr[i] = temp[k];
+    while (i < na)
+        *dst++ = a[i++];
+    while (j < nb)
+        *dst++ = b[j++];
 }
+
+//!
+//! \brief merge_split 合并结果的前d个元素中来自a的个数
+//! \note 用于把一次合并切分成互不重叠的几段并行执行，相等的元素a在前
+//!
+template <typename T>
+int64 merge_split(const T *a, int64 na, const T *b, int64 nb, int64 d)
+{
+    int64 lo = d > nb ? d - nb : 0;
+    int64 hi = d < na ? d : na;
+    while (lo < hi)
+    {
+        const int64 i = lo + (hi - lo) / 2;
+        const int64 j = d - i;
+        if (j > 0 && !(b[j - 1] < a[i]))
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
 //!
 //! @brief bs_msort 归并排序算法
 //!
 //! @param arr 是待调整的堆数组
 //! @param length是数组的长度
+//! @note 稳定排序，先用插入排序生成短的有序段，再在数组和一块缓冲区之间逐层合并，
+//!       每次调用只分配一次缓冲区
 //!
 template <typename T>
 void merge(T *arr, int64 length)
 {
-    int size = 1, low, mid, high;
-    while(size <= (int)length-1)
+    for (int64 i = 0; i < length; i += MergeRun)
+        _pdq_<T*, T>::insertion(arr + i, arr + (i + MergeRun < length ? i + MergeRun : length));
+    if (length <= MergeRun)
+        return;
+
+    T *buf = (T*)kyMalloc(sizeof(T) * length);
+    for (int64 i = 0; i < length; ++i)
+        complex_construct(buf[i], arr[i]);
+
+    T *src = arr;
+    T *dst = buf;
+    for (int64 width = MergeRun; width < length; width *= 2)
+    {
+        for (int64 lo = 0; lo < length; lo += 2 * width)
+        {
+            const int64 mid = lo + width < length ? lo + width : length;
+            const int64 hi = lo + 2 * width < length ? lo + 2 * width : length;
+            merge_runs(src + lo, mid - lo, src + mid, hi - mid, dst + lo);
+        }
+        T *t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != arr)
+    {
+        for (int64 i = 0; i < length; ++i)
+            arr[i] = src[i];
+    }
+
+    for (int64 i = 0; i < length; ++i)
+        complex_destruct(buf[i]);
+    kyFree(buf);
+}
+
+//!
+//! \brief radix LSD基数排序，每趟处理key的一个字节
+//! \note 1.一次遍历统计所有字节的分布，所有元素某个字节都相同时跳过这一趟
+//!       2.元素较少时比较排序更快，直接使用pdq
+//!
+template <typename T>
+void radix(T *a, int64 n)
+{
+    typedef _radix_key_<T> key;
+    enum {Passes = sizeof(typename key::type), Small = 64};
+    if (n < Small)
+    {
+        pdq(a, a + n);
+        return;
+    }
+
+    int64 hist[Passes][256];
+    ::memset(hist, 0, sizeof(hist));
+    for (int64 i = 0; i < n; ++i)
+    {
+        typename key::type k = key::get(a[i]);
+        for (int p = 0; p < Passes; ++p, k >>= 8)
+            ++hist[p][k & 0xff];
+    }
+
+    T *buf = (T*)kyMalloc(sizeof(T) * n);
+    T *src = a;
+    T *dst = buf;
+    for (int p = 0; p < Passes; ++p)
     {
-        low = 0;
-        while(low + size <= (int)length-1)
+        int64 *h = hist[p];
+        const int shift = p * 8;
+        if (h[(key::get(src[0]) >> shift) & 0xff] == n)
+            continue;
+
+        int64 sum = 0;
+        for (int b = 0; b < 256; ++b)
         {
-            mid = low + size-1;
-            high = mid + size;
-            if(high > (int)length-1)
-                high = length-1;
-            _merge_<T>(arr, low, mid, high);
-            low = high+1;
+            const int64 c = h[b];
+            h[b] = sum;
+            sum += c;
         }
-        size *= 2;
+        for (int64 i = 0; i < n; ++i)
+            dst[h[(key::get(src[i]) >> shift) & 0xff]++] = src[i];
+
+        T *t = src;
+        src = dst;
+        dst = t;
     }
+    if (src != a)
+        ::memcpy(a, src, sizeof(T) * n);
+    kyFree(buf);
 }
 
 }
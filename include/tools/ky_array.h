@@ -39,6 +39,13 @@
  * 2016/06/29 | 1.0.2.3   | kunyang  | 修改引用计数的可复制对象
  * 2019/02/16 | 1.0.3.1   | kunyang  | 加入expand函数用于扩充内存
  * 2019/02/17 | 1.0.3.2   | kunyang  | 修改内存增长方式
+ * 2026/10/17 | 1.0.3.3   | kunyang  | 加入reserve_virtual保留虚拟地址空间
+ * 2026/10/17 | 1.0.3.4   | kunyang  | 修正按字节数当作元素数的操作和析构的越界
+ * 2026/10/17 | 1.0.3.5   | kunyang  | 加入右值添加、就地构造和迭代器区间批量添加
+ * 2026/10/17 | 1.0.3.6   | kunyang  | 内存按ky_memory_stats::Array标记记账
+ * 2026/10/17 | 1.0.3.7   | kunyang  | 加入reserve_arena显式从分配区申请
+ * 2026/10/17 | 1.0.3.8   | kunyang  | 只能移动的元素禁止复制容器，分离时不再移出共享块的元素
+ * 2026/10/17 | 1.0.3.9   | kunyang  | 赋值和reserve不再写入仍被共享的块
  */
 
 #ifndef KY_ARRAY_H
@@ -47,6 +54,8 @@
 #include "ky_define.h"
 #include "ky_typeinfo.h"
 #include "arch/ky_memory.h"
+#include "ky_allocate.h"
+#include <iterator>
 
 template<typename T>
 class ky_array : protected ky_memory::dynarray
@@ -66,6 +75,40 @@ public:
 #  ifdef kyHasSTL
     ky_array(const std::initializer_list<Type> & il);
 #  endif
+
+    //!
+    //! \brief prepend append insert 移动添加元素，不产生复制
+    //! \param c
+    //! \return
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    ky_array &prepend(Type &&c);
+    ky_array &append(Type &&c);
+    ky_array &insert(int i, Type &&c);
+    //!
+    //! \brief append 附加a的全部元素，a未被共享时移动元素，a被置空
+    //! \param a
+    //! \return
+    //!
+    ky_array &append(ky_array &&a);
+    //!
+    //! \brief emplace 在指定i位置用args就地构造元素
+    //! \param i 小于等于0时在头部，大于等于count时在尾部
+    //! \param args 元素的构造参数
+    //! \return 返回新构造的元素
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    template <typename... Args>
+    Type &emplace(int i, Args&&... args);
+    //!
+    //! \brief append 附加[first, last)区间的元素
+    //! \param first
+    //! \param last
+    //! \return
+    //! \note 先求出区间长度一次分配空间，迭代器需可多次遍历
+    //!
+    template <typename Iterator>
+    ky_array &append(Iterator first, Iterator last);
 #endif
 
 public:
@@ -120,6 +163,23 @@ public:
     //!
     void reserve(i64 size);
     //!
+    //! \brief reserve_virtual 保留可容纳size个元素的虚拟地址空间，随增长提交物理内存
+    //! \param size 最大元素数量，超出时迁移到加倍的保留空间
+    //! \return 保留失败时返回false
+    //! \note 用于增长到GB级的数组，保留空间内增长不会重新分配和复制，
+    //!       data()返回的地址保持不变(在头部插入除外)
+    //!
+    bool reserve_virtual(i64 size);
+    //!
+    //! \brief reserve_arena 从分配区a申请可容纳size个元素的空间，之后的增长也从a申请
+    //! \param a
+    //! \param size
+    //! \return 申请失败时返回false
+    //! \note 只有调用此函数的数组使用分配区，数组不能在分配区回退后使用；
+    //!       复制此数组时按元素复制到堆上(不共享)，reserve会重新回到堆上
+    //!
+    bool reserve_arena(ky_allocate::arena_dynamic &a, i64 size);
+    //!
     //! \brief resize 申请数据空间
     //! \param s
     //! \note 当内部有数据时并且也被引用此时会将数据分离
@@ -314,8 +374,12 @@ public:
     friend void ky_swap(ky_array &a, ky_array &b) {a.swap(b);}
 
 protected:
+#ifdef kyHasMemoryStats
+    virtual int tag()const {return ky_memory_stats::Array;}
+#endif
     void __detach_helper();
     T*   __detach_insert(int i, int c);
+    T*   __insert_helper(int i, i64 c);
     void __destroy_helper();
 };
 
@@ -17,7 +17,7 @@ T* ky_array<T>::__detach_insert(int i, int c)
         T* to = (b+(i));
         while(cur != to)
         {
-            complex_construct(*cur, *t);
+            complex_copy(*cur, *t);
             cur ++;
             t  ++;
         }
@@ -27,7 +27,7 @@ T* ky_array<T>::__detach_insert(int i, int c)
         t = n + i;
         while(cur != to)
         {
-            complex_construct(*cur, *t);
+            complex_copy(*cur, *t);
             cur ++;
             t ++;
         }
@@ -40,8 +40,8 @@ T* ky_array<T>::__detach_insert(int i, int c)
         {
             T * cur = (T*)old.begin();
             T * e = (T*)old.end ();
-            while (cur++ != e)
-                complex_destruct(*cur);
+            while (cur != e)
+                complex_destruct(*cur++);
         }
         old.destroy ();
     }
@@ -49,6 +49,14 @@ T* ky_array<T>::__detach_insert(int i, int c)
     return (T*)Layout::at (i);
 }
 
+template <typename T>
+T* ky_array<T>::__insert_helper(int i, int64 c)
+{
+    if (refer ().is_shared ())
+        return __detach_insert (i, c);
+    return (T*)Layout::insert (i, c);
+}
+
 template <typename T>
 void ky_array<T>::__destroy_helper()
 {
@@ -58,8 +66,8 @@ void ky_array<T>::__destroy_helper()
         {
             T* cur = (T*)Layout::begin();
             T* e = (T*)Layout::end ();
-            while (cur++ != e)
-                complex_destruct(*cur);
+            while (cur != e)
+                complex_destruct(*cur++);
         }
         Layout::destroy ();
     }
@@ -112,9 +120,26 @@ template<typename T>
 void ky_array<T>::reserve(int64 size)
 {
     __destroy_helper ();
+    Layout::header = Layout::nul ();
     Layout::reserve (size, sizeOf);
 }
 
+template<typename T>
+bool ky_array<T>::reserve_virtual(int64 size)
+{
+    __destroy_helper ();
+    Layout::header = Layout::nul ();
+    return Layout::reserve_virtual (size, sizeOf);
+}
+
+template<typename T>
+bool ky_array<T>::reserve_arena(ky_allocate::arena_dynamic &a, int64 size)
+{
+    __destroy_helper ();
+    Layout::header = Layout::nul ();
+    return Layout::reserve_arena (&a, size, sizeOf);
+}
+
 template<typename T>
 void ky_array<T>::resize(int64 s)
 {
@@ -184,17 +209,26 @@ const T *ky_array<T>::offset(int inx)const
 template<typename T>
 void ky_array<T>::clear()
 {
+    if (is_empty ())
+        return;
     __detach_helper ();
-    Layout::remove (0, size());
+    if (kyLikely(tComplex))
+    {
+        T* cur = (T*)Layout::begin();
+        T* e = (T*)Layout::end ();
+        while (cur != e)
+            complex_destruct(*cur++);
+    }
+    Layout::remove (0, count());
 }
 
 template<typename T>
 void ky_array<T>::fill(const Type &c, int64 len, int pos)
 {
-    if (size())
+    if (count())
     {
         __detach_helper ();
-        len = ((len + pos) > size() ? size() - pos : len);
+        len = ((len + pos) > count() ? count() - pos : len);
         T* ptr = (T*)Layout::begin ();
         do
             *(ptr + pos++) = c;
@@ -269,7 +303,7 @@ ky_array<T> &ky_array<T>::prepend(const T *s, int len)
 template<typename T>
 ky_array<T> &ky_array<T>::prepend(const ky_array<T> &a)
 {
-    return prepend(a.data (), a.size ());
+    return prepend(a.data (), a.count ());
 }
 
 template<typename T>
@@ -305,17 +339,21 @@ ky_array<T> &ky_array<T>::append(const T *s, int64 len)
 template<typename T>
 ky_array<T> &ky_array<T>::append(const ky_array<T> &a)
 {
-    return append(a.data (), a.size ());
+    return append(a.data (), a.count ());
 }
 
 template<typename T>
 ky_array<T> &ky_array<T>::operator = (const ky_array<T> &rhs)
 {
+    // 共享或复制都会让两个容器看到同一组元素，只能移动的元素无法分离
+    kyCompilerAssert(is_copyable<T>::value);
     if (header == rhs.header)
         return *this;
 
+    // 共享的块只减少了引用，不能再写入
     __destroy_helper ();
-    if (!rhs.is_null())
+    header = nul();
+    if (!rhs.is_nul())
     {
         Layout *x = (Layout *)&rhs;
         if (x->refer ().has_shareable ())
@@ -325,13 +363,13 @@ ky_array<T> &ky_array<T>::operator = (const ky_array<T> &rhs)
         }
         else
         {
-            resize (rhs.size ());
+            resize (rhs.count ());
             T* cur = (T*)Layout::begin ();
             T* t = (T*)x->begin ();
             T* to = (T*)Layout::end ();
             while(cur != to)
             {
-                complex_construct(*cur, *t++);
+                complex_construct(*cur, *t);
                 cur ++;
                 t  ++;
             }
@@ -373,17 +411,17 @@ ky_array<T> &ky_array<T>::insert(int i, const T *s, int64 len)
 template<typename T>
 ky_array<T> &ky_array<T>::insert(int i, const ky_array<T> &a)
 {
-    return insert(i, a.data(), a.size());
+    return insert(i, a.data(), a.count());
 }
 
 template<typename T>
 void ky_array<T>::remove(int i, int64 len)
 {
-    if (i >= size() || i < 0)
+    if (i >= count() || i < 0)
         return ;
     __detach_helper ();
 
-    len = ((len +i) > size() ? size() -i : len);
+    len = ((len +i) > count() ? count() -i : len);
     if (kyLikely(tComplex))
     {
         for (int64 j = 0; j < len; ++j)
@@ -401,7 +439,7 @@ ky_array<T> &ky_array<T>::replace(int index, const T&c)
 template<typename T>
 ky_array<T> &ky_array<T>::replace(int index, int64 len, const T *s, int64 alen)
 {
-    if (index < size() && index >= 0)
+    if (index < count() && index >= 0)
     {
         __detach_helper ();
         if (len > alen)
@@ -415,7 +453,7 @@ ky_array<T> &ky_array<T>::replace(int index, int64 len, const T *s, int64 alen)
             len = alen;
         }
 
-        len = ((len+index) > size() ? size()-index : len);
+        len = ((len+index) > count() ? count()-index : len);
         T* ptr = (T*)Layout::at(index);
         do
             *ptr++ = *s++;
@@ -428,7 +466,7 @@ ky_array<T> &ky_array<T>::replace(int index, int64 len, const T *s, int64 alen)
 template<typename T>
 ky_array<T> &ky_array<T>::replace(int index, int64 len, const ky_array<T> &s)
 {
-    return replace(index, len, s.data(), s.size());
+    return replace(index, len, s.data(), s.count());
 }
 
 template<typename T>
@@ -451,8 +489,7 @@ template<typename T>
 ky_array<T>::ky_array(ky_array&& rhs):
     Layout()
 {
-    __destroy_helper ();
-    if (rhs.is_null())
+    if (rhs.is_nul())
         return ;
 
     header = rhs.header;
@@ -462,14 +499,92 @@ ky_array<T>::ky_array(ky_array&& rhs):
 template<typename T>
 ky_array<T>& ky_array<T>::operator =(ky_array&& rhs)
 {
+    if (header == rhs.header)
+        return *this;
+
     __destroy_helper ();
-    if (rhs.is_null())
+    header = nul();
+    if (rhs.is_nul())
         return *this;
 
     header = rhs.header;
     rhs.header = nul();
     return *this;
 }
+
+template<typename T>
+ky_array<T> &ky_array<T>::prepend(T &&c)
+{
+    emplace (0, static_cast<T &&>(c));
+    return *this;
+}
+
+template<typename T>
+ky_array<T> &ky_array<T>::append(T &&c)
+{
+    emplace (INT_MAX, static_cast<T &&>(c));
+    return *this;
+}
+
+template<typename T>
+ky_array<T> &ky_array<T>::insert(int i, T &&c)
+{
+    emplace (i, static_cast<T &&>(c));
+    return *this;
+}
+
+template<typename T>
+ky_array<T> &ky_array<T>::append(ky_array<T> &&a)
+{
+    if (is_empty ())
+    {
+        swap (a);
+        return *this;
+    }
+    if (a.is_empty ())
+        return *this;
+
+    const int64 len = a.count ();
+    T* n = __insert_helper (INT_MAX, len);
+    T* s = (T*)a.Layout::begin ();
+    // 被共享时其他引用仍在使用元素，只能复制
+    if (a.refer ().is_shared ())
+    {
+        for (int64 j = 0; j < len; ++j)
+            complex_copy(n[j], s[j]);
+        ky_array<T>().swap (a);
+    }
+    else
+    {
+        for (int64 j = 0; j < len; ++j)
+            complex_construct(n[j], static_cast<T &&>(s[j]));
+        a.clear ();
+    }
+    return *this;
+}
+
+template<typename T>
+template <typename... Args>
+T &ky_array<T>::emplace(int i, Args&&... args)
+{
+    T* n = __insert_helper (i, 1);
+    new (n) T(std::forward<Args>(args)...);
+    return *n;
+}
+
+template<typename T>
+template <typename Iterator>
+ky_array<T> &ky_array<T>::append(Iterator first, Iterator last)
+{
+    const int64 len = std::distance (first, last);
+    if (len <= 0)
+        return *this;
+
+    T* n = __insert_helper (INT_MAX, len);
+    for (; first != last; ++first, ++n)
+        new (n) T(*first);
+    return *this;
+}
 #  ifdef kyHasSTL
 template<typename T>
 ky_array<T>::ky_array(const std::initializer_list<T> & il):
@@ -492,7 +607,7 @@ void ky_array<T>::swap(ky_array<T> &rhs)
 template<typename T>
 ky_array<T> ky_array<T>::extract( int pos, int count)const
 {
-    ky_array<T> tmp(this->data(), this->size());
+    ky_array<T> tmp(this->data(), this->count());
     if (count > 0)
         tmp.remove(pos, count);
     else
@@ -503,7 +618,7 @@ ky_array<T> ky_array<T>::extract( int pos, int count)const
 template<typename T>
 ky_array<T> ky_array<T>::extract( int pos )const
 {
-    ky_array<T> tmp(this->data(), this->size());
+    ky_array<T> tmp(this->data(), this->count());
     tmp.remove(0, pos);
     return tmp;
 }
@@ -511,16 +626,16 @@ ky_array<T> ky_array<T>::extract( int pos )const
 template<typename T>
 ky_array<T> ky_array<T>::start( int count)const
 {
-    ky_array<T> tmp(this->data(), this->size());
-    tmp.remove(count, this->size() - count);
+    ky_array<T> tmp(this->data(), this->count());
+    tmp.remove(count, this->count() - count);
     return tmp;
 }
 
 template<typename T>
 ky_array<T> ky_array<T>::ending( int count)const
 {
-    ky_array<T> tmp(this->data(), this->size());
-    tmp.remove(0, this->size() - count);
+    ky_array<T> tmp(this->data(), this->count());
+    tmp.remove(0, this->count() - count);
     return tmp;
 }
 
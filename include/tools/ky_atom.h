@@ -0,0 +1,108 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * You should have received a copy of the GNU General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file     ky_atom.h
+ * @brief    字符串驻留(原子)
+ *       1.相同内容的字符串在全局驻留池中只保存一份，ky_atom只记录其地址
+ *       2.相等比较只比较地址，散列值在驻留时计算一次并缓存
+ *       3.驻留池按散列分为多个分片，每个分片使用自旋锁，锁内不申请内存
+ *       4.驻留的字符串在进程结束前不会释放
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/17
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/17 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/17 | 1.0.0.2   | kunyang  | 驻留项和扩容的内存在锁外申请
+ *
+ */
+#ifndef KY_ATOM_H
+#define KY_ATOM_H
+
+#include "ky_define.h"
+#include "tools/ky_string.h"
+
+//!
+//! \brief The ky_atom class 驻留字符串的句柄
+//! \note 1.大小与指针相同，可以直接按值传递
+//!       2.operator < 按地址排序，只保证在同一进程内稳定，不是字典序
+//!
+class ky_atom
+{
+public:
+    //! 驻留池中的一项
+    struct entry
+    {
+        u64       hash;
+        ky_string str;
+    };
+
+public:
+    ky_atom():d(0){}
+    explicit ky_atom(const ky_string_view &s);
+    explicit ky_atom(const ky_string &s);
+    explicit ky_atom(const char *latin1);
+
+    //!
+    //! \brief intern 驻留字符串，已驻留时返回原有的原子
+    //!
+    static ky_atom intern(const ky_string_view &s);
+    //!
+    //! \brief find 只查找不驻留
+    //! \return 未驻留时返回空原子
+    //!
+    static ky_atom find(const ky_string_view &s);
+    //!
+    //! \brief count 驻留池中的字符串数
+    //!
+    static int64 count();
+
+    bool is_null()const {return d == 0;}
+    //!
+    //! \brief to_string 驻留的字符串，不复制
+    //!
+    const ky_string &to_string()const;
+    ky_string_view view()const {return d ? d->str.view() : ky_string_view();}
+    u64 hash()const {return d ? d->hash : 0;}
+
+    bool operator == (const ky_atom &rhs)const {return d == rhs.d;}
+    bool operator != (const ky_atom &rhs)const {return d != rhs.d;}
+    bool operator < (const ky_atom &rhs)const {return d < rhs.d;}
+
+private:
+    explicit ky_atom(const entry *e):d(e){}
+
+private:
+    const entry *d;
+};
+
+//! 原子只是一个指针，容器中直接存放不需要单独构造
+template <> struct is_complex<ky_atom>: public const_int<bool, false> {};
+
+//!
+//! \brief ky_hash_f 原子的散列直接使用缓存值，ky_hash/ky_flathash以原子为key时不再计算字符串散列
+//!
+inline u64 ky_hash_f(const ky_atom &v)
+{
+    return v.hash();
+}
+
+#endif // KY_ATOM_H
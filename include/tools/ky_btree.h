@@ -0,0 +1,436 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * You should have received a copy of the GNU General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file     ky_btree.h
+ * @brief    B+树实现的有序关联容器
+ *       1.节点宽度按缓存行计算，key约占4个缓存行，key和值分别连续存放
+ *       2.元素只存放在叶子节点，叶子节点组成双向链表，顺序遍历不需要回溯
+ *       3.节点内查找对32/64位整数key使用SSE2/AVX2一次比较多个key，
+ *         其它类型使用二分查找
+ *       4.删除时不做合并，只回收空节点，因此大量删除后节点可能不满
+ *       5.与ky_map不同，不使用写时复制，复制时深拷贝
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/17
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/17 | 1.0.0.1   | kunyang  | 创建文件
+ *
+ */
+#ifndef ky_BTREE_H
+#define ky_BTREE_H
+
+#include "ky_define.h"
+#include "tools/ky_list.h"
+#include "arch/ky_memory.h"
+#include <new>
+
+//!
+//! \brief The _btree_node struct 节点公共头部
+//!
+struct _btree_node
+{
+    i32 count;      ///< 节点内的key数
+    i32 leaf;       ///< 是否为叶子节点
+};
+
+//!
+//! \brief _btree_trailing 掩码低位连续1的个数
+//!
+inline i32 _btree_trailing(u32 mask)
+{
+#if kyCompilerIsGNUC || kyCompilerIsCLANG
+    return (i32)__builtin_ctz(~mask);
+#else
+    i32 n = 0;
+    for (; mask & 1; mask >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+//!
+//! \brief The _btree_search struct 节点内查找
+//! \note lower 返回小于key的个数，upper 返回小于等于key的个数
+//!
+template <typename K>
+struct _btree_search
+{
+    static inline i32 lower(const K *keys, i32 n, const K &k)
+    {
+        i32 lo = 0;
+        while (n > 0)
+        {
+            const i32 half = n >> 1;
+            if (keys[lo + half] < k)
+            {
+                lo += half + 1;
+                n -= half + 1;
+            }
+            else
+                n = half;
+        }
+        return lo;
+    }
+    static inline i32 upper(const K *keys, i32 n, const K &k)
+    {
+        i32 lo = 0;
+        while (n > 0)
+        {
+            const i32 half = n >> 1;
+            if (!(k < keys[lo + half]))
+            {
+                lo += half + 1;
+                n -= half + 1;
+            }
+            else
+                n = half;
+        }
+        return lo;
+    }
+};
+
+//!
+//! \brief The _btree_search_simd struct 整数key的向量查找
+//! \note 节点内key有序，比较结果是低位连续的掩码，遇到不全满足的组即可结束。
+//!       无符号数翻转符号位后按有符号比较
+//!
+#if kyHAS_SSE2
+template <typename K, bool Unsigned>
+struct _btree_search_i32
+{
+    static inline __m128i bias(__m128i v)
+    {
+        return Unsigned ? _mm_xor_si128(v, _mm_set1_epi32((int)0x80000000)) : v;
+    }
+    template <bool Equal>
+    static inline i32 count(const K *keys, i32 n, const K &k)
+    {
+        const __m128i kv = bias(_mm_set1_epi32((int)k));
+        i32 i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128i v = bias(_mm_loadu_si128((const __m128i*)(keys + i)));
+            const __m128i gt = Equal ? _mm_cmpgt_epi32(v, kv) : _mm_cmpgt_epi32(kv, v);
+            u32 mask = (u32)_mm_movemask_ps(_mm_castsi128_ps(gt));
+            if (Equal)
+                mask = ~mask & 0xf;
+            if (mask != 0xf)
+                return i + _btree_trailing(mask);
+        }
+        for (; i < n; ++i)
+        {
+            if (Equal ? k < keys[i] : !(keys[i] < k))
+                break;
+        }
+        return i;
+    }
+    static inline i32 lower(const K *keys, i32 n, const K &k) {return count<false>(keys, n, k);}
+    static inline i32 upper(const K *keys, i32 n, const K &k) {return count<true>(keys, n, k);}
+};
+template <> struct _btree_search<i32> : _btree_search_i32<i32, false> {};
+template <> struct _btree_search<u32> : _btree_search_i32<u32, true> {};
+#endif
+
+#if kyHAS_AVX2
+template <typename K, bool Unsigned>
+struct _btree_search_i64
+{
+    static inline __m256i bias(__m256i v)
+    {
+        return Unsigned ? _mm256_xor_si256(v, _mm256_set1_epi64x((long long)0x8000000000000000ull)) : v;
+    }
+    template <bool Equal>
+    static inline i32 count(const K *keys, i32 n, const K &k)
+    {
+        const __m256i kv = bias(_mm256_set1_epi64x((long long)k));
+        i32 i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256i v = bias(_mm256_loadu_si256((const __m256i*)(keys + i)));
+            const __m256i gt = Equal ? _mm256_cmpgt_epi64(v, kv) : _mm256_cmpgt_epi64(kv, v);
+            u32 mask = (u32)_mm256_movemask_pd(_mm256_castsi256_pd(gt));
+            if (Equal)
+                mask = ~mask & 0xf;
+            if (mask != 0xf)
+                return i + _btree_trailing(mask);
+        }
+        for (; i < n; ++i)
+        {
+            if (Equal ? k < keys[i] : !(keys[i] < k))
+                break;
+        }
+        return i;
+    }
+    static inline i32 lower(const K *keys, i32 n, const K &k) {return count<false>(keys, n, k);}
+    static inline i32 upper(const K *keys, i32 n, const K &k) {return count<true>(keys, n, k);}
+};
+template <> struct _btree_search<i64> : _btree_search_i64<i64, false> {};
+template <> struct _btree_search<u64> : _btree_search_i64<u64, true> {};
+#endif
+
+template <typename K, typename V, typename Alloc = ky_node_alloc<void> >
+class ky_btree_map : public Alloc
+{
+public:
+    typedef K key_t;
+    typedef V value_t;
+
+    enum
+    {
+        //! 节点的最大key数，key部分约占4个缓存行
+        Order = (kyCpuCacheLineSize * 4) / sizeof(K) < 8 ? 8 :
+                (kyCpuCacheLineSize * 4) / sizeof(K),
+        MaxDepth = 32
+    };
+
+    //!
+    //! \brief The leaf_t struct 叶子节点，key和值分开连续存放
+    //!
+    struct leaf_t : _btree_node
+    {
+        leaf_t *prev;
+        leaf_t *next;
+        K       keys[Order];
+        V       values[Order];
+    };
+    //!
+    //! \brief The inner_t struct 内部节点，child[i]中的key都小于keys[i]
+    //!
+    struct inner_t : _btree_node
+    {
+        K            keys[Order];
+        _btree_node *child[Order + 1];
+    };
+    typedef _btree_search<K> search;
+
+    //!
+    //! \brief The iterator class 叶子节点和节点内的位置
+    //!
+    class iterator
+    {
+        friend class ky_btree_map;
+    private:
+        leaf_t *node;
+        i32     index;
+
+        iterator(leaf_t *n, i32 idx):node(n), index(idx){}
+
+    public:
+        iterator():node(0), index(0){}
+
+        bool is_finished(void) const {return node == 0 || (index >= node->count && node->next == 0);}
+        friend bool operator == (const iterator& it1,const iterator& it2)
+        {
+            return it1.node == it2.node && it1.index == it2.index;
+        }
+        friend bool operator!=(const iterator& it1,const iterator& it2)
+        {
+            return !(it1 == it2);
+        }
+        V& operator*(void) const {return node->values[index];}
+        V* operator->(void) const {return node->values + index;}
+        const K &key() const {return node->keys[index];}
+        V &value() const {return node->values[index];}
+
+        iterator& operator++(void)
+        {
+            if (++index >= node->count && node->next)
+            {
+                node = node->next;
+                index = 0;
+            }
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+        iterator& operator--(void)
+        {
+            if (index == 0 && node->prev)
+            {
+                node = node->prev;
+                index = node->count;
+            }
+            --index;
+            return *this;
+        }
+        iterator operator--(int)
+        {
+            iterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+    };
+    typedef const iterator const_iterator;
+
+    /// STL style
+public:
+    ky_btree_map();
+    ky_btree_map(const ky_btree_map &rhs);
+    ~ky_btree_map();
+
+    iterator begin();
+    const_iterator begin() const;
+    iterator end(void);
+    const_iterator end(void) const;
+
+    ky_btree_map<K, V, Alloc> &operator = (const ky_btree_map<K, V, Alloc> &rhs);
+    //!
+    //! \brief find 查找key并返回一个迭代器，未找到返回end()
+    //! \param key
+    //! \return
+    //!
+    iterator find(const K &key);
+    const_iterator find(const K &key) const;
+    //!
+    //! \brief lower_bound 返回第一个不小于key的元素
+    //! \param key
+    //! \return
+    //!
+    iterator lower_bound(const K &key);
+    const_iterator lower_bound(const K &key) const;
+    //!
+    //! \brief upper_bound 返回第一个大于key的元素
+    //! \param key
+    //! \return
+    //!
+    iterator upper_bound(const K &key);
+    const_iterator upper_bound(const K &key) const;
+    //!
+    //! \brief operator [] 返回key的值，不存在时插入默认值
+    //! \param key
+    //! \return
+    //!
+    V &operator [](const K &key);
+    //!
+    //! \brief at 返回key的值，不存在时插入默认值
+    //! \param key
+    //! \return
+    //!
+    V &at(const K &key) {return (*this)[key];}
+    //!
+    //! \brief insert 插入key并返回迭代器
+    //! \param key
+    //! \return
+    //!
+    iterator insert(const K& key);
+    //!
+    //! \brief insert 插入key，val并返回迭代器，key已存在时不修改值
+    //! \param key
+    //! \param val
+    //! \return
+    //!
+    iterator insert(const K& key, const V& val);
+    //!
+    //! \brief erase 擦除指定pos的元素，返回下一个元素的迭代器
+    //! \param pos
+    //!
+    iterator erase(iterator pos);
+    //!
+    //! \brief erase 擦除key，返回擦除的元素数
+    //! \param key
+    //!
+    i64 erase(const K& key);
+
+    void swap(ky_btree_map<K, V, Alloc> &rhs);
+    friend void ky_swap (ky_btree_map<K, V, Alloc> &a, ky_btree_map<K, V, Alloc> &b){a.swap (b);}
+    //!
+    //! \brief clear 清空并释放全部节点
+    //!
+    void clear();
+    bool empty() const{return is_empty ();}
+    i64 size() const{return count();}
+
+#if kyLanguage >= kyLanguage11
+public:
+    ky_btree_map(ky_btree_map<K, V, Alloc> &&rhs);
+    ky_btree_map<K, V, Alloc> &operator = (ky_btree_map<K, V, Alloc> &&rhs);
+    const_iterator cbegin() const {return begin();}
+    const_iterator cend() const {return end();}
+#endif
+
+    // base
+public:
+    //!
+    //! \brief append 添加关联，key已存在时替换值
+    //! \param k
+    //! \param v
+    //!
+    void append(const K& k, const V& v);
+    bool contains(const K& k) const;
+    //!
+    //! \brief value 返回指定key的值，不存在时返回默认值
+    //! \param key
+    //!
+    V value(const K& key, const V &def = V()) const;
+    void remove(const K& key) {erase(key);}
+    void remove(const iterator& it) {erase(it);}
+
+    //!
+    //! \brief first_key last_key 最小和最大的key，容器不能为空
+    //!
+    const K &first_key() const {return head->keys[0];}
+    const K &last_key() const {return tail->keys[tail->count - 1];}
+    //!
+    //! \brief keys values 按key顺序返回全部key或值
+    //!
+    ky_list<K> keys() const;
+    ky_list<V> values() const;
+
+    bool is_empty() const {return count() == 0;}
+    i64 count()const {return elements;}
+    //!
+    //! \brief depth 树的层数，空树为0
+    //!
+    i32 depth()const;
+
+private:
+    //!
+    //! \brief descend 从根查找key所在的叶子，记录经过的内部节点和子节点位置
+    //!
+    leaf_t *descend(const K &k, _btree_node **path, i32 *slot, i32 &level) const;
+    leaf_t *descend(const K &k) const;
+    //! 叶子内位置到迭代器，位于叶子末尾时移到下一个叶子的开始
+    iterator make(leaf_t *l, i32 pos) const;
+
+    iterator insert_helper(const K &k, const V *v, bool assign);
+    void insert_parent(_btree_node **path, i32 *slot, i32 level,
+                       const K &sep, _btree_node *right);
+    void erase_parent(_btree_node **path, i32 *slot, i32 level);
+
+    leaf_t *create_leaf();
+    inner_t *create_inner();
+    void destroy(_btree_node *n);
+    void destroy_inner(_btree_node *n);
+
+private:
+    _btree_node *root;
+    leaf_t      *head;
+    leaf_t      *tail;
+    i64          elements;
+};
+
+#include "ky_btree.inl"
+#endif // ky_BTREE_H
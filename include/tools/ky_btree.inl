@@ -0,0 +1,507 @@
+template <typename K, typename V, typename Alloc>
+ky_btree_map<K, V, Alloc>::ky_btree_map():
+    root(0), head(0), tail(0), elements(0)
+{
+}
+template <typename K, typename V, typename Alloc>
+ky_btree_map<K, V, Alloc>::ky_btree_map(const ky_btree_map & rhs):
+    root(0), head(0), tail(0), elements(0)
+{
+    for (iterator it = rhs.begin(); it != rhs.end(); ++it)
+        insert(it.key(), it.value());
+}
+template <typename K, typename V, typename Alloc>
+ky_btree_map<K, V, Alloc>::~ky_btree_map()
+{
+    clear();
+}
+
+template <typename K, typename V, typename Alloc>
+ky_btree_map<K, V, Alloc> &ky_btree_map<K, V, Alloc>::operator = (const ky_btree_map<K, V, Alloc> &rhs)
+{
+    if (this == &rhs)
+        return *this;
+    ky_btree_map<K, V, Alloc> tmp(rhs);
+    swap(tmp);
+    return *this;
+}
+
+#if kyLanguage >= kyLanguage11
+template <typename K, typename V, typename Alloc>
+ky_btree_map<K, V, Alloc>::ky_btree_map(ky_btree_map<K, V, Alloc> &&rhs):
+    root(rhs.root), head(rhs.head), tail(rhs.tail), elements(rhs.elements)
+{
+    rhs.root = 0;
+    rhs.head = rhs.tail = 0;
+    rhs.elements = 0;
+}
+template <typename K, typename V, typename Alloc>
+ky_btree_map<K, V, Alloc> &ky_btree_map<K, V, Alloc>::operator = (ky_btree_map<K, V, Alloc> &&rhs)
+{
+    if (this != &rhs)
+    {
+        clear();
+        swap(rhs);
+    }
+    return *this;
+}
+#endif
+
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::iterator ky_btree_map<K, V, Alloc>::begin()
+{
+    return iterator(head, 0);
+}
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::const_iterator ky_btree_map<K, V, Alloc>::begin() const
+{
+    return iterator(head, 0);
+}
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::iterator ky_btree_map<K, V, Alloc>::end()
+{
+    return iterator(tail, tail ? tail->count : 0);
+}
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::const_iterator ky_btree_map<K, V, Alloc>::end() const
+{
+    return iterator(tail, tail ? tail->count : 0);
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::leaf_t *
+ky_btree_map<K, V, Alloc>::descend(const K &k, _btree_node **path, i32 *slot, i32 &level) const
+{
+    _btree_node *n = root;
+    level = 0;
+    while (!n->leaf)
+    {
+        inner_t *in = (inner_t*)n;
+        const i32 c = search::upper(in->keys, in->count, k);
+        path[level] = n;
+        slot[level] = c;
+        ++level;
+        n = in->child[c];
+    }
+    return (leaf_t*)n;
+}
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::leaf_t *ky_btree_map<K, V, Alloc>::descend(const K &k) const
+{
+    _btree_node *n = root;
+    while (!n->leaf)
+    {
+        inner_t *in = (inner_t*)n;
+        n = in->child[search::upper(in->keys, in->count, k)];
+    }
+    return (leaf_t*)n;
+}
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::iterator ky_btree_map<K, V, Alloc>::make(leaf_t *l, i32 pos) const
+{
+    // 叶子内的key都小于下一个叶子的分隔key，末尾位置就是下一个叶子的开始
+    if (pos >= l->count && l->next)
+        return iterator(l->next, 0);
+    return iterator(l, pos);
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::iterator ky_btree_map<K, V, Alloc>::lower_bound(const K &key)
+{
+    if (root == 0)
+        return end();
+    leaf_t *l = descend(key);
+    return make(l, search::lower(l->keys, l->count, key));
+}
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::const_iterator ky_btree_map<K, V, Alloc>::lower_bound(const K &key) const
+{
+    return const_cast<ky_btree_map<K, V, Alloc>*>(this)->lower_bound(key);
+}
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::iterator ky_btree_map<K, V, Alloc>::upper_bound(const K &key)
+{
+    if (root == 0)
+        return end();
+    leaf_t *l = descend(key);
+    return make(l, search::upper(l->keys, l->count, key));
+}
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::const_iterator ky_btree_map<K, V, Alloc>::upper_bound(const K &key) const
+{
+    return const_cast<ky_btree_map<K, V, Alloc>*>(this)->upper_bound(key);
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::iterator ky_btree_map<K, V, Alloc>::find(const K &key)
+{
+    if (root == 0)
+        return end();
+    leaf_t *l = descend(key);
+    const i32 pos = search::lower(l->keys, l->count, key);
+    if (pos < l->count && !(key < l->keys[pos]))
+        return iterator(l, pos);
+    return end();
+}
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::const_iterator ky_btree_map<K, V, Alloc>::find(const K &key) const
+{
+    return const_cast<ky_btree_map<K, V, Alloc>*>(this)->find(key);
+}
+
+template <typename K, typename V, typename Alloc>
+bool ky_btree_map<K, V, Alloc>::contains(const K &k) const
+{
+    return find(k) != end();
+}
+template <typename K, typename V, typename Alloc>
+V ky_btree_map<K, V, Alloc>::value(const K &key, const V &def) const
+{
+    const_iterator it = find(key);
+    if (it != end())
+        return it.value();
+    return def;
+}
+template <typename K, typename V, typename Alloc>
+V &ky_btree_map<K, V, Alloc>::operator [](const K &key)
+{
+    return insert_helper(key, 0, false).value();
+}
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::iterator ky_btree_map<K, V, Alloc>::insert(const K &key)
+{
+    return insert_helper(key, 0, false);
+}
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::iterator ky_btree_map<K, V, Alloc>::insert(const K &key, const V &val)
+{
+    return insert_helper(key, &val, false);
+}
+template <typename K, typename V, typename Alloc>
+void ky_btree_map<K, V, Alloc>::append(const K &k, const V &v)
+{
+    insert_helper(k, &v, true);
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::iterator
+ky_btree_map<K, V, Alloc>::insert_helper(const K &k, const V *v, bool assign)
+{
+    if (root == 0)
+        root = head = tail = create_leaf();
+
+    _btree_node *path[MaxDepth];
+    i32 slot[MaxDepth];
+    i32 level = 0;
+    leaf_t *l = descend(k, path, slot, level);
+    i32 pos = search::lower(l->keys, l->count, k);
+    if (pos < l->count && !(k < l->keys[pos]))
+    {
+        if (assign)
+            l->values[pos] = *v;
+        return iterator(l, pos);
+    }
+
+    if (l->count == Order)
+    {
+        // 叶子已满，后一半移到新叶子，新叶子的首个key作为分隔key插入父节点
+        leaf_t *r = create_leaf();
+        const i32 mid = Order / 2;
+        for (i32 i = mid; i < Order; ++i)
+        {
+            r->keys[i - mid] = l->keys[i];
+            r->values[i - mid] = l->values[i];
+            l->values[i] = V();
+        }
+        r->count = Order - mid;
+        l->count = mid;
+
+        r->prev = l;
+        r->next = l->next;
+        if (l->next)
+            l->next->prev = r;
+        else
+            tail = r;
+        l->next = r;
+
+        insert_parent(path, slot, level, r->keys[0], r);
+        if (pos > mid)
+        {
+            l = r;
+            pos -= mid;
+        }
+    }
+
+    for (i32 i = l->count; i > pos; --i)
+    {
+        l->keys[i] = l->keys[i - 1];
+        l->values[i] = l->values[i - 1];
+    }
+    l->keys[pos] = k;
+    l->values[pos] = v ? *v : V();
+    ++l->count;
+    ++elements;
+    return iterator(l, pos);
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_btree_map<K, V, Alloc>::insert_parent(_btree_node **path, i32 *slot, i32 level,
+                                              const K &sep, _btree_node *right)
+{
+    K key = sep;
+    while (level > 0)
+    {
+        --level;
+        inner_t *in = (inner_t*)path[level];
+        i32 s = slot[level];
+        if (in->count < Order)
+        {
+            for (i32 i = in->count; i > s; --i)
+            {
+                in->keys[i] = in->keys[i - 1];
+                in->child[i + 1] = in->child[i];
+            }
+            in->keys[s] = key;
+            in->child[s + 1] = right;
+            ++in->count;
+            return;
+        }
+
+        // 内部节点已满，中间的key上移，右半部分移到新节点
+        const i32 mid = Order / 2;
+        inner_t *r = create_inner();
+        const K up = in->keys[mid];
+        for (i32 i = mid + 1; i < Order; ++i)
+            r->keys[i - mid - 1] = in->keys[i];
+        for (i32 i = mid + 1; i <= Order; ++i)
+            r->child[i - mid - 1] = in->child[i];
+        r->count = Order - mid - 1;
+        in->count = mid;
+
+        inner_t *t = in;
+        if (s > mid)
+        {
+            t = r;
+            s -= mid + 1;
+        }
+        for (i32 i = t->count; i > s; --i)
+        {
+            t->keys[i] = t->keys[i - 1];
+            t->child[i + 1] = t->child[i];
+        }
+        t->keys[s] = key;
+        t->child[s + 1] = right;
+        ++t->count;
+
+        key = up;
+        right = r;
+    }
+
+    // 根节点分裂，树增高一层
+    inner_t *nr = create_inner();
+    nr->keys[0] = key;
+    nr->child[0] = root;
+    nr->child[1] = right;
+    nr->count = 1;
+    root = nr;
+}
+
+template <typename K, typename V, typename Alloc>
+i64 ky_btree_map<K, V, Alloc>::erase(const K &key)
+{
+    if (root == 0)
+        return 0;
+
+    _btree_node *path[MaxDepth];
+    i32 slot[MaxDepth];
+    i32 level = 0;
+    leaf_t *l = descend(key, path, slot, level);
+    const i32 pos = search::lower(l->keys, l->count, key);
+    if (pos >= l->count || key < l->keys[pos])
+        return 0;
+
+    for (i32 i = pos + 1; i < l->count; ++i)
+    {
+        l->keys[i - 1] = l->keys[i];
+        l->values[i - 1] = l->values[i];
+    }
+    --l->count;
+    l->values[l->count] = V();
+    --elements;
+
+    if (l->count > 0)
+        return 1;
+
+    // 叶子为空时从链表和父节点中移除
+    if (l->prev)
+        l->prev->next = l->next;
+    else
+        head = l->next;
+    if (l->next)
+        l->next->prev = l->prev;
+    else
+        tail = l->prev;
+    destroy(l);
+
+    if (level == 0)
+        root = 0;
+    else
+        erase_parent(path, slot, level);
+    return 1;
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_btree_map<K, V, Alloc>::erase_parent(_btree_node **path, i32 *slot, i32 level)
+{
+    while (level > 0)
+    {
+        --level;
+        inner_t *in = (inner_t*)path[level];
+        const i32 s = slot[level];
+        if (in->count > 0)
+        {
+            // 删除子节点s及其一侧的分隔key
+            const i32 ks = s > 0 ? s - 1 : 0;
+            for (i32 i = ks + 1; i < in->count; ++i)
+                in->keys[i - 1] = in->keys[i];
+            for (i32 i = s + 1; i <= in->count; ++i)
+                in->child[i - 1] = in->child[i];
+            --in->count;
+            break;
+        }
+        // 只有一个子节点的内部节点也成为空节点
+        destroy(in);
+        if (level == 0)
+        {
+            root = 0;
+            return;
+        }
+    }
+
+    // 根只剩一个子节点时降低一层
+    while (root && !root->leaf && root->count == 0)
+    {
+        inner_t *in = (inner_t*)root;
+        root = in->child[0];
+        destroy(in);
+    }
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::iterator ky_btree_map<K, V, Alloc>::erase(iterator pos)
+{
+    if (pos.node == 0 || pos.index >= pos.node->count)
+        return end();
+    const K key = pos.key();
+    erase(key);
+    return lower_bound(key);
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_btree_map<K, V, Alloc>::swap(ky_btree_map<K, V, Alloc> &rhs)
+{
+    _btree_node *r = rhs.root;
+    leaf_t *hd = rhs.head;
+    leaf_t *tl = rhs.tail;
+    const i64 n = rhs.elements;
+    rhs.root = root;
+    rhs.head = head;
+    rhs.tail = tail;
+    rhs.elements = elements;
+    root = r;
+    head = hd;
+    tail = tl;
+    elements = n;
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_btree_map<K, V, Alloc>::clear()
+{
+    if (root == 0)
+        return;
+    // 叶子通过链表释放，内部节点递归释放
+    if (!root->leaf)
+        destroy_inner(root);
+    for (leaf_t *l = head; l; )
+    {
+        leaf_t *next = l->next;
+        destroy(l);
+        l = next;
+    }
+    root = 0;
+    head = tail = 0;
+    elements = 0;
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_btree_map<K, V, Alloc>::destroy_inner(_btree_node *n)
+{
+    inner_t *in = (inner_t*)n;
+    if (!in->child[0]->leaf)
+    {
+        for (i32 i = 0; i <= in->count; ++i)
+            destroy_inner(in->child[i]);
+    }
+    destroy(in);
+}
+
+template <typename K, typename V, typename Alloc>
+i32 ky_btree_map<K, V, Alloc>::depth() const
+{
+    i32 d = 0;
+    for (_btree_node *n = root; n; ++d)
+        n = n->leaf ? 0 : ((inner_t*)n)->child[0];
+    return d;
+}
+
+template <typename K, typename V, typename Alloc>
+ky_list<K> ky_btree_map<K, V, Alloc>::keys() const
+{
+    ky_list<K> out;
+    for (leaf_t *l = head; l; l = l->next)
+    {
+        for (i32 i = 0; i < l->count; ++i)
+            out.append(l->keys[i]);
+    }
+    return out;
+}
+template <typename K, typename V, typename Alloc>
+ky_list<V> ky_btree_map<K, V, Alloc>::values() const
+{
+    ky_list<V> out;
+    for (leaf_t *l = head; l; l = l->next)
+    {
+        for (i32 i = 0; i < l->count; ++i)
+            out.append(l->values[i]);
+    }
+    return out;
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::leaf_t *ky_btree_map<K, V, Alloc>::create_leaf()
+{
+    leaf_t *l = (leaf_t*)Alloc::alloc(sizeof(leaf_t));
+    new (l) leaf_t();
+    l->count = 0;
+    l->leaf = 1;
+    l->prev = l->next = 0;
+    return l;
+}
+template <typename K, typename V, typename Alloc>
+typename ky_btree_map<K, V, Alloc>::inner_t *ky_btree_map<K, V, Alloc>::create_inner()
+{
+    inner_t *in = (inner_t*)Alloc::alloc(sizeof(inner_t));
+    new (in) inner_t();
+    in->count = 0;
+    in->leaf = 0;
+    return in;
+}
+template <typename K, typename V, typename Alloc>
+void ky_btree_map<K, V, Alloc>::destroy(_btree_node *n)
+{
+    if (n->leaf)
+        ((leaf_t*)n)->~leaf_t();
+    else
+        ((inner_t*)n)->~inner_t();
+    Alloc::destroy(n);
+}
@@ -28,6 +28,7 @@
  * Change History :
  *    Date    |  Version  |  Author  |   Description
  * 2018/09/10 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/17 | 1.0.1.1   | kunyang  | 加入字节数组的散列
  */
 
 #ifndef KY_BYTE_H
@@ -36,4 +37,12 @@
 #include "ky_array.h"
 typedef ky_array<u8> ky_byte;
 
+//!
+//! \brief ky_hash_f 字节数组的散列(进程种子)
+//!
+inline u64 ky_hash_f(const ky_byte &v)
+{
+    return __hash__::WY(v.data(), v.size(), __hash__::seed());
+}
+
 #endif
@@ -0,0 +1,510 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * You should have received a copy of the GNU General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file     ky_flathash.h
+ * @brief    开放寻址(扁平)模式实现的关联容器
+ *       1.元素直接存放在连续的槽数组内，插入时不会为单个元素分配内存
+ *       2.每个槽对应一个控制字节(空/已删除/哈希低7位)，查找时按组(16或8字节)
+ *         使用SSE2/NEON一次比较整组控制字节，只有匹配的槽才比较key
+ *       3.容量为2的幂，最大装载率7/8，使用三角数序列按组探测
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/17
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/17 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/17 | 1.0.0.2   | kunyang  | 修复共享后按迭代器擦除作用在旧表上
+ * 2026/10/17 | 1.0.0.3   | kunyang  | 加入只读迭代器const_iterator
+ *
+ */
+#ifndef ky_FLATHASH_H
+#define ky_FLATHASH_H
+
+#include "ky_define.h"
+#include "tools/ky_typeinfo.h"
+#include "tools/ky_algorlthm.h"
+#include "tools/ky_list.h"
+#include "arch/ky_memory.h"
+#include <new>
+
+//!
+//! \brief The _flathash_ctrl struct 控制字节定义
+//!
+struct _flathash_ctrl
+{
+    enum
+    {
+        Empty   = -128,  ///< 0b10000000 空槽
+        Deleted = -2,    ///< 0b11111110 已删除的槽
+        Sentinel = -1    ///< 0b11111111 分界
+        // 0b0xxxxxxx 已使用的槽，xxxxxxx为哈希值的高7位
+    };
+
+    //!
+    //! \brief is_full 槽是否已使用
+    //!
+    static inline bool is_full(i8 c) {return c >= 0;}
+};
+
+//!
+//! \brief The _flathash_mask struct 组匹配结果的位掩码
+//! \note SSE2时每个槽占1位，NEON及通用实现时每个槽占1字节(Shift=3)
+//!
+template <int Shift>
+struct _flathash_mask
+{
+    u64 mask;
+
+    explicit _flathash_mask(u64 m):mask(m){}
+
+    inline operator bool()const {return mask != 0;}
+    //!
+    //! \brief lowest 最低位的匹配槽在组内的偏移
+    //!
+    inline u32 lowest()const
+    {
+#if kyCompilerIsGNUC || kyCompilerIsCLANG
+        return (u32)__builtin_ctzll(mask) >> Shift;
+#else
+        u32 n = 0;
+        for (u64 m = mask; !(m & 1); m >>= 1)
+            ++n;
+        return n >> Shift;
+#endif
+    }
+    //!
+    //! \brief next 清除最低位的匹配槽
+    //!
+    inline void next() {mask &= mask - 1;}
+};
+
+//!
+//! \brief The _flathash_group struct 控制字节组的并行匹配
+//!
+#if kyHAS_SSE2
+struct _flathash_group
+{
+    enum {Width = 16};
+    typedef _flathash_mask<0> bitmask;
+
+    __m128i ctrl;
+
+    explicit _flathash_group(const i8 *pos):
+        ctrl(_mm_loadu_si128((const __m128i*)pos)){}
+
+    //!
+    //! \brief match 返回控制字节等于h2的槽
+    //!
+    inline bitmask match(i8 h2)const
+    {
+        const __m128i m = _mm_set1_epi8(h2);
+        return bitmask((u32)_mm_movemask_epi8(_mm_cmpeq_epi8(m, ctrl)));
+    }
+    //!
+    //! \brief match_empty 返回空槽
+    //!
+    inline bitmask match_empty()const
+    {
+        const __m128i m = _mm_set1_epi8((char)_flathash_ctrl::Empty);
+        return bitmask((u32)_mm_movemask_epi8(_mm_cmpeq_epi8(m, ctrl)));
+    }
+    //!
+    //! \brief match_empty_or_deleted 返回空槽或已删除的槽
+    //!
+    inline bitmask match_empty_or_deleted()const
+    {
+        const __m128i m = _mm_set1_epi8((char)_flathash_ctrl::Sentinel);
+        return bitmask((u32)_mm_movemask_epi8(_mm_cmpgt_epi8(m, ctrl)));
+    }
+};
+#elif kyHAS_NEON
+struct _flathash_group
+{
+    enum {Width = 8};
+    typedef _flathash_mask<3> bitmask;
+
+    int8x8_t ctrl;
+
+    explicit _flathash_group(const i8 *pos):
+        ctrl(vld1_s8((const int8_t*)pos)){}
+
+    inline bitmask match(i8 h2)const
+    {
+        const uint8x8_t m = vceq_s8(vdup_n_s8(h2), ctrl);
+        return bitmask(vget_lane_u64(vreinterpret_u64_u8(m), 0) & 0x8080808080808080ull);
+    }
+    inline bitmask match_empty()const
+    {
+        const uint8x8_t m = vceq_s8(vdup_n_s8((i8)_flathash_ctrl::Empty), ctrl);
+        return bitmask(vget_lane_u64(vreinterpret_u64_u8(m), 0) & 0x8080808080808080ull);
+    }
+    inline bitmask match_empty_or_deleted()const
+    {
+        const uint8x8_t m = vcgt_s8(vdup_n_s8((i8)_flathash_ctrl::Sentinel), ctrl);
+        return bitmask(vget_lane_u64(vreinterpret_u64_u8(m), 0) & 0x8080808080808080ull);
+    }
+};
+#else
+struct _flathash_group
+{
+    enum {Width = 8};
+    typedef _flathash_mask<3> bitmask;
+
+    static const u64 kLsbs = 0x0101010101010101ull;
+    static const u64 kMsbs = 0x8080808080808080ull;
+
+    u64 ctrl;
+
+    explicit _flathash_group(const i8 *pos)
+    {
+        ky_memory::copy(&ctrl, pos, sizeof(ctrl));
+    }
+
+    //! \note 可能出现假阳性匹配，调用者需要再比较key
+    inline bitmask match(i8 h2)const
+    {
+        const u64 x = ctrl ^ (kLsbs * (u8)h2);
+        return bitmask((x - kLsbs) & ~x & kMsbs);
+    }
+    inline bitmask match_empty()const
+    {
+        return bitmask((ctrl & (~ctrl << 6)) & kMsbs);
+    }
+    inline bitmask match_empty_or_deleted()const
+    {
+        return bitmask((ctrl & (~ctrl << 7)) & kMsbs);
+    }
+};
+#endif
+
+struct _flathash_header : public ky_ref
+{
+    i64 capacity;        ///< 槽数(2的幂)
+    i64 count;           ///< 已使用的槽数
+    i64 growth_left;     ///< 不需要扩容时还能插入的元素数
+
+    static _flathash_header shared_nul;
+};
+
+template <typename K, typename V, typename Alloc = ky_alloc<void> >
+class ky_flathash : public Alloc
+{
+public:
+    typedef _flathash_group group;
+    typedef K key_t;
+    typedef V value_t;
+
+    //!
+    //! \brief The entry struct 槽内存放的元素
+    //!
+    struct entry
+    {
+        entry(const K& k, const V& v):_key(k), _value(v){}
+
+        const K& key() const {return _key;}
+        const V& value() const {return _value;}
+        V& value()  {return _value;}
+        entry& operator =(const V& nv){_value = nv; return *this;}
+
+        K _key;
+        V _value;
+    };
+
+    class const_iterator;
+    //!
+    //! \brief The iterator class
+    //!
+    class iterator
+    {
+        friend class ky_flathash;
+        friend class const_iterator;
+    private:
+        _flathash_header *h;
+        i64               index;
+
+        iterator(_flathash_header *hd, i64 idx):h(hd), index(idx){}
+        void skip()
+        {
+            const i8 *c = ctrl_of(h);
+            while (index < h->capacity && !_flathash_ctrl::is_full(c[index]))
+                ++index;
+        }
+
+    public:
+        iterator():h(0), index(0){}
+
+        bool is_finished(void) const {return index >= h->capacity;}
+        friend bool operator == (const iterator& it1,const iterator& it2)
+        {
+            return it1.h == it2.h && it1.index == it2.index;
+        }
+        friend bool operator!=(const iterator& it1,const iterator& it2)
+        {
+            return !(it1 == it2);
+        }
+        entry& operator*(void) const {return slots_of(h)[index];}
+        entry* operator->(void) const {return slots_of(h) + index;}
+        const K &key() const {return slots_of(h)[index].key();}
+        V &value() const {return slots_of(h)[index].value();}
+
+        iterator& operator++(void)
+        {
+            ++index;
+            skip();
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+    };
+    //!
+    //! \brief The const_iterator class 只读迭代器，const容器只能通过它访问值
+    //!
+    class const_iterator
+    {
+        friend class ky_flathash;
+    private:
+        const _flathash_header *h;
+        i64                     index;
+
+        const_iterator(const _flathash_header *hd, i64 idx):h(hd), index(idx){}
+        void skip()
+        {
+            const i8 *c = ctrl_of(h);
+            while (index < h->capacity && !_flathash_ctrl::is_full(c[index]))
+                ++index;
+        }
+
+    public:
+        const_iterator():h(0), index(0){}
+        const_iterator(const iterator &rhs):h(rhs.h), index(rhs.index){}
+
+        bool is_finished(void) const {return index >= h->capacity;}
+        friend bool operator == (const const_iterator& it1,const const_iterator& it2)
+        {
+            return it1.h == it2.h && it1.index == it2.index;
+        }
+        friend bool operator!=(const const_iterator& it1,const const_iterator& it2)
+        {
+            return !(it1 == it2);
+        }
+        const entry& operator*(void) const {return slots_of(h)[index];}
+        const entry* operator->(void) const {return slots_of(h) + index;}
+        const K &key() const {return slots_of(h)[index].key();}
+        const V &value() const {return slots_of(h)[index].value();}
+
+        const_iterator& operator++(void)
+        {
+            ++index;
+            skip();
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+    };
+
+    /// STL style
+public:
+    ky_flathash();
+    ky_flathash(const ky_flathash &rhs);
+    ~ky_flathash();
+
+    iterator begin();
+    const_iterator begin() const;
+    iterator end(void);
+    const_iterator end(void) const;
+
+    //!
+    //! \brief operator = 默认赋值
+    //! \param rhs
+    //! \return
+    //!
+    ky_flathash<K, V, Alloc> &operator = (const ky_flathash<K, V, Alloc> &rhs);
+    //!
+    //! \brief find 查找key并返回一个迭代器，未找到返回end()
+    //! \param key
+    //! \return
+    //!
+    iterator find(const K &key);
+    const_iterator find(const K &key) const;
+    //!
+    //! \brief at 返回key的值
+    //! \param key
+    //! \return
+    //!
+    V &at(const K &key);
+    const V &at(const K &key)const;
+    //!
+    //! \brief operator [] 返回key的值，不存在时插入默认值
+    //! \param key
+    //! \return
+    //!
+    V &operator [](const K &key);
+    const V &operator [](const K &key)const;
+    //!
+    //! \brief insert 插入key并返回迭代器
+    //! \param key
+    //! \return
+    //!
+    iterator insert(const K& key);
+    //!
+    //! \brief insert 插入key，val并返回迭代器，key已存在时不修改值
+    //! \param key
+    //! \param val
+    //! \return
+    //!
+    iterator insert(const K& key, const V& val);
+
+    //!
+    //! \brief erase 擦除指定pos的元素，返回下一个元素的迭代器
+    //! \param pos
+    //! \note 表被共享时先分离，pos按下标定位到分离后的表(分离不改变槽位)
+    //!
+    iterator erase(iterator pos);
+    //!
+    //! \brief erase 擦除key，返回擦除的元素数
+    //! \param key
+    //!
+    i64 erase(const K& key);
+
+    //!
+    //! \brief swap 交换两个hash
+    //! \param rhs
+    //!
+    void swap(ky_flathash<K, V, Alloc> &rhs);
+    friend void ky_swap (ky_flathash<K, V, Alloc> &a, ky_flathash<K, V, Alloc> &b){a.swap (b);}
+    //!
+    //! \brief clear 清空hash，保留已分配的槽
+    //!
+    void clear();
+    bool empty() const{return is_empty ();}
+    i64 size() const{return count();}
+
+#if kyLanguage >= kyLanguage11
+public:
+    ky_flathash(ky_flathash<K, V, Alloc> &&rhs);
+    ky_flathash<K, V, Alloc> &operator = (ky_flathash<K, V, Alloc> &&rhs);
+    const_iterator cbegin() const {return begin();}
+    const_iterator cend() const {return end();}
+#endif
+
+    // base
+public:
+    explicit ky_flathash(i64 capacity);
+
+    //!
+    //! \brief append 添加关联，key已存在时替换值
+    //! \param k
+    //! \param v
+    //!
+    void append(const K& k, const V& v);
+    void append(const entry& x) {append(x.key(), x.value());}
+    bool contains(const K& k) const;
+    //!
+    //! \brief value 返回指定key的值，不存在时返回默认值
+    //! \param key
+    //!
+    V value(const K& key) const;
+    //!
+    //! \brief remove 删除指定key
+    //! \param key
+    //!
+    void remove(const K& key);
+    void remove(const iterator& it);
+
+    //!
+    //! \brief reserve 分配可容纳size个元素的槽
+    //! \param size
+    //!
+    void reserve(i64 size);
+    //!
+    //! \brief keys values 返回全部key或值
+    //!
+    ky_list<K> keys() const;
+    ky_list<V> values() const;
+
+    bool is_empty() const {return count() == 0;}
+    bool is_nul()const {return h == &_flathash_header::shared_nul;}
+
+    i64 capacity()const {return h->capacity;}
+    i64 count()const {return h->count;}
+
+private:
+    //!
+    //! \brief hash_of 计算key的哈希值，低位用于探测起点，高7位用于控制字节
+    //!
+    static inline u64 hash_of(const K &k)
+    {
+        return (u64)ky_hash_f(k) * 0x9E3779B97F4A7C15ull;
+    }
+    static inline i8 h2_of(u64 hv) {return (i8)(hv >> 57);}
+
+    static inline i64 slot_offset(i64 cap)
+    {
+        const i64 align = alignof(entry) > sizeof(i64) ? alignof(entry) : sizeof(i64);
+        const i64 n = sizeof(_flathash_header) + cap + group::Width;
+        return (n + align - 1) & ~(align - 1);
+    }
+    static inline i8 *ctrl_of(_flathash_header *hd) {return (i8*)(hd + 1);}
+    static inline const i8 *ctrl_of(const _flathash_header *hd) {return (const i8*)(hd + 1);}
+    static inline entry *slots_of(_flathash_header *hd)
+    {
+        return (entry*)((u8*)hd + slot_offset(hd->capacity));
+    }
+    static inline const entry *slots_of(const _flathash_header *hd)
+    {
+        return (const entry*)((const u8*)hd + slot_offset(hd->capacity));
+    }
+    static inline i64 growth_of(i64 cap) {return cap - cap / 8;}
+
+    //!
+    //! \brief set_ctrl 设置控制字节，同时维护尾部的镜像组
+    //!
+    static inline void set_ctrl(_flathash_header *hd, i64 i, i8 c)
+    {
+        i8 *ctrl = ctrl_of(hd);
+        ctrl[i] = c;
+        if (i < group::Width)
+            ctrl[hd->capacity + i] = c;
+    }
+
+    i64 search(const K &k, u64 hv) const;
+    i64 find_non_full(_flathash_header *hd, u64 hv) const;
+    i64 prepare_insert(u64 hv);
+
+    _flathash_header *create(i64 cap);
+    void destroy(_flathash_header *hd);
+    void rehash(i64 cap);
+    void detach();
+
+private:
+    _flathash_header *h;
+};
+
+#include "ky_flathash.inl"
+#endif // ky_FLATHASH_H
@@ -0,0 +1,441 @@
+
+template <typename K, typename V, typename Alloc>
+ky_flathash<K, V, Alloc>::ky_flathash():
+    h(&_flathash_header::shared_nul)
+{
+}
+template <typename K, typename V, typename Alloc>
+ky_flathash<K, V, Alloc>::ky_flathash(const ky_flathash & rhs):
+    h(rhs.h)
+{
+    if (!is_nul ())
+    {
+        if (h->has_shareable())
+            h->addref ();
+        else
+        {
+            h = &_flathash_header::shared_nul;
+            for (const_iterator it = rhs.begin(); it != rhs.end(); ++it)
+                insert(it.key(), it.value());
+        }
+    }
+}
+template <typename K, typename V, typename Alloc>
+ky_flathash<K, V, Alloc>::ky_flathash(i64 capacity):
+    h(&_flathash_header::shared_nul)
+{
+    reserve(capacity);
+}
+template <typename K, typename V, typename Alloc>
+ky_flathash<K, V, Alloc>::~ky_flathash()
+{
+    if (!is_nul() && h->lessref())
+        destroy(h);
+}
+
+template <typename K, typename V, typename Alloc>
+ky_flathash<K, V, Alloc> &ky_flathash<K, V, Alloc>::operator = (const ky_flathash<K, V, Alloc> &rhs)
+{
+    if (h == rhs.h)
+        return *this;
+
+    ky_flathash<K, V, Alloc> tmp(rhs);
+    swap(tmp);
+    return *this;
+}
+
+#if kyLanguage >= kyLanguage11
+template <typename K, typename V, typename Alloc>
+ky_flathash<K, V, Alloc>::ky_flathash(ky_flathash<K, V, Alloc> &&rhs):
+    h(rhs.h)
+{
+    rhs.h = &_flathash_header::shared_nul;
+}
+template <typename K, typename V, typename Alloc>
+ky_flathash<K, V, Alloc> &ky_flathash<K, V, Alloc>::operator = (ky_flathash<K, V, Alloc> &&rhs)
+{
+    swap(rhs);
+    return *this;
+}
+#endif
+
+template <typename K, typename V, typename Alloc>
+void ky_flathash<K, V, Alloc>::swap(ky_flathash<K, V, Alloc> &rhs)
+{
+    _flathash_header *tmp = rhs.h;
+    rhs.h = h;
+    h = tmp;
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_flathash<K, V, Alloc>::iterator ky_flathash<K, V, Alloc>::begin()
+{
+    detach();
+    iterator it(h, 0);
+    it.skip();
+    return it;
+}
+template <typename K, typename V, typename Alloc>
+typename ky_flathash<K, V, Alloc>::const_iterator ky_flathash<K, V, Alloc>::begin() const
+{
+    const_iterator it(h, 0);
+    it.skip();
+    return it;
+}
+template <typename K, typename V, typename Alloc>
+typename ky_flathash<K, V, Alloc>::iterator ky_flathash<K, V, Alloc>::end(void)
+{
+    detach();
+    return iterator(h, capacity ());
+}
+template <typename K, typename V, typename Alloc>
+typename ky_flathash<K, V, Alloc>::const_iterator ky_flathash<K, V, Alloc>::end(void) const
+{
+    return const_iterator(h, capacity ());
+}
+
+template <typename K, typename V, typename Alloc>
+i64 ky_flathash<K, V, Alloc>::search(const K &k, u64 hv) const
+{
+    if (is_nul ())
+        return -1;
+
+    const i8 *ctrl = ctrl_of(h);
+    const entry *slots = slots_of(h);
+    const i64 mask = capacity () - 1;
+    const i8 h2 = h2_of(hv);
+    i64 pos = (i64)hv & mask;
+    i64 step = 0;
+
+    forever (true)
+    {
+        const group g(ctrl + pos);
+        for (typename group::bitmask m = g.match(h2); m; m.next())
+        {
+            const i64 idx = (pos + m.lowest()) & mask;
+            if (kyLikely(slots[idx].key() == k))
+                return idx;
+        }
+        if (kyLikely(g.match_empty()))
+            return -1;
+
+        step += group::Width;
+        pos = (pos + step) & mask;
+    }
+}
+
+template <typename K, typename V, typename Alloc>
+i64 ky_flathash<K, V, Alloc>::find_non_full(_flathash_header *hd, u64 hv) const
+{
+    const i8 *ctrl = ctrl_of(hd);
+    const i64 mask = hd->capacity - 1;
+    i64 pos = (i64)hv & mask;
+    i64 step = 0;
+
+    forever (true)
+    {
+        const typename group::bitmask m = group(ctrl + pos).match_empty_or_deleted();
+        if (m)
+            return (pos + m.lowest()) & mask;
+
+        step += group::Width;
+        pos = (pos + step) & mask;
+    }
+}
+
+template <typename K, typename V, typename Alloc>
+i64 ky_flathash<K, V, Alloc>::prepare_insert(u64 hv)
+{
+    i64 idx = find_non_full(h, hv);
+    if (kyUnLikely(h->growth_left == 0 && ctrl_of(h)[idx] != (i8)_flathash_ctrl::Deleted))
+    {
+        // 已删除的槽过多时原容量重建即可回收，否则扩容一倍
+        if (capacity () > group::Width && count () * 32 <= capacity () * 25)
+            rehash(capacity ());
+        else
+            rehash(capacity () * 2);
+        idx = find_non_full(h, hv);
+    }
+
+    if (ctrl_of(h)[idx] == (i8)_flathash_ctrl::Empty)
+        --h->growth_left;
+    ++h->count;
+    set_ctrl(h, idx, h2_of(hv));
+    return idx;
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_flathash<K, V, Alloc>::iterator ky_flathash<K, V, Alloc>::find(const K& k)
+{
+    detach ();
+    const i64 idx = search(k, hash_of(k));
+    return idx < 0 ? end() : iterator(h, idx);
+}
+template <typename K, typename V, typename Alloc>
+typename ky_flathash<K, V, Alloc>::const_iterator ky_flathash<K, V, Alloc>::find(const K& k) const
+{
+    const i64 idx = search(k, hash_of(k));
+    return idx < 0 ? end() : const_iterator(h, idx);
+}
+
+template <typename K, typename V, typename Alloc>
+bool ky_flathash<K, V, Alloc>::contains(const K& k) const
+{
+    return search(k, hash_of(k)) >= 0;
+}
+
+template <typename K, typename V, typename Alloc>
+V &ky_flathash<K, V, Alloc>::at(const K &key)
+{
+    return this->operator [] (key);
+}
+template <typename K, typename V, typename Alloc>
+const V &ky_flathash<K, V, Alloc>::at(const K &key)const
+{
+    return this->operator [] (key);
+}
+
+template <typename K, typename V, typename Alloc>
+V& ky_flathash<K, V, Alloc>::operator[](const K& k)
+{
+    return insert(k).value();
+}
+template <typename K, typename V, typename Alloc>
+const V& ky_flathash<K, V, Alloc>::operator[](const K& k) const
+{
+    const i64 idx = search(k, hash_of(k));
+    kyASSERT(idx < 0);
+    return slots_of(h)[idx].value();
+}
+
+template <typename K, typename V, typename Alloc>
+V ky_flathash<K, V, Alloc>::value(const K& k) const
+{
+    const i64 idx = search(k, hash_of(k));
+    if (idx < 0)
+        return V();
+    return slots_of(h)[idx].value();
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_flathash<K, V, Alloc>::iterator ky_flathash<K, V, Alloc>::insert(const K& key)
+{
+    return insert(key, V());
+}
+template <typename K, typename V, typename Alloc>
+typename ky_flathash<K, V, Alloc>::iterator ky_flathash<K, V, Alloc>::insert(const K& k, const V& val)
+{
+    detach ();
+    const u64 hv = hash_of(k);
+    i64 idx = search(k, hv);
+    if (idx < 0)
+    {
+        idx = prepare_insert(hv);
+        new (slots_of(h) + idx) entry(k, val);
+    }
+    return iterator(h, idx);
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flathash<K, V, Alloc>::append(const K& k, const V& v)
+{
+    detach ();
+    const u64 hv = hash_of(k);
+    i64 idx = search(k, hv);
+    if (idx < 0)
+    {
+        idx = prepare_insert(hv);
+        new (slots_of(h) + idx) entry(k, v);
+    }
+    else
+        slots_of(h)[idx] = v;
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flathash<K, V, Alloc>::remove(const iterator& it)
+{
+    if (is_nul () || it.h != h)
+        return ;
+
+    // 分离后槽位不变，以下标在自己的表中删除
+    const i64 idx = it.index;
+    detach ();
+    if (idx >= capacity () || !_flathash_ctrl::is_full(ctrl_of(h)[idx]))
+        return ;
+
+    slots_of(h)[idx].~entry();
+    set_ctrl(h, idx, (i8)_flathash_ctrl::Deleted);
+    --h->count;
+}
+template <typename K, typename V, typename Alloc>
+void ky_flathash<K, V, Alloc>::remove(const K& k)
+{
+    detach ();
+    const i64 idx = search(k, hash_of(k));
+    if (idx >= 0)
+        remove(iterator(h, idx));
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_flathash<K, V, Alloc>::iterator ky_flathash<K, V, Alloc>::erase(iterator pos)
+{
+    if (is_nul () || pos.h != h)
+        return pos;
+
+    remove(pos);
+    pos.h = h;
+    ++pos;
+    return pos;
+}
+template <typename K, typename V, typename Alloc>
+i64 ky_flathash<K, V, Alloc>::erase(const K& k)
+{
+    const i64 n = count ();
+    remove(k);
+    return n - count ();
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flathash<K, V, Alloc>::clear()
+{
+    if (is_nul ())
+        return ;
+    if (h->is_shared ())
+    {
+        ky_flathash<K, V, Alloc> tmp;
+        swap(tmp);
+        return ;
+    }
+
+    i8 *ctrl = ctrl_of(h);
+    entry *slots = slots_of(h);
+    for (i64 i = 0; i < capacity (); ++i)
+    {
+        if (_flathash_ctrl::is_full(ctrl[i]))
+            slots[i].~entry();
+    }
+    ky_memory::zero(ctrl, capacity () + group::Width, _flathash_ctrl::Empty);
+    h->count = 0;
+    h->growth_left = growth_of(capacity ());
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flathash<K, V, Alloc>::reserve(i64 size)
+{
+    i64 cap = group::Width;
+    while (growth_of(cap) < size)
+        cap <<= 1;
+    if (cap > capacity ())
+    {
+        detach ();
+        rehash(cap);
+    }
+}
+
+template <typename K, typename V, typename Alloc >
+ky_list<K> ky_flathash<K, V, Alloc>::keys() const
+{
+    ky_list<K> out;
+    for (const_iterator it = begin(); it != end(); ++it)
+        out.append (it.key ());
+    return out;
+}
+template <typename K, typename V, typename Alloc >
+ky_list<V> ky_flathash<K, V, Alloc>::values() const
+{
+    ky_list<V> out;
+    for (const_iterator it = begin(); it != end(); ++it)
+        out.append (it.value ());
+    return out;
+}
+
+template <typename K, typename V, typename Alloc>
+_flathash_header *ky_flathash<K, V, Alloc>::create(i64 cap)
+{
+    _flathash_header *hd = (_flathash_header*)Alloc::alloc
+            (slot_offset(cap) + sizeof(entry) * cap);
+    new (hd) _flathash_header();
+    hd->set (ky_ref::ShareableDetach);
+    hd->capacity = cap;
+    hd->count = 0;
+    hd->growth_left = growth_of(cap);
+    ky_memory::zero(ctrl_of(hd), cap + group::Width, _flathash_ctrl::Empty);
+    return hd;
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flathash<K, V, Alloc>::destroy(_flathash_header *hd)
+{
+    const i8 *ctrl = ctrl_of(hd);
+    entry *slots = slots_of(hd);
+    for (i64 i = 0; i < hd->capacity; ++i)
+    {
+        if (_flathash_ctrl::is_full(ctrl[i]))
+            slots[i].~entry();
+    }
+    hd->~_flathash_header();
+    Alloc::destroy (hd);
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flathash<K, V, Alloc>::rehash(i64 cap)
+{
+    _flathash_header *old = h;
+    _flathash_header *nhd = create(cap);
+
+    if (!is_nul ())
+    {
+        const i8 *ctrl = ctrl_of(old);
+        entry *slots = slots_of(old);
+        entry *nslots = slots_of(nhd);
+        for (i64 i = 0; i < old->capacity; ++i)
+        {
+            if (!_flathash_ctrl::is_full(ctrl[i]))
+                continue;
+
+            const u64 hv = hash_of(slots[i].key());
+            const i64 idx = find_non_full(nhd, hv);
+            set_ctrl(nhd, idx, h2_of(hv));
+#if kyLanguage >= kyLanguage11
+            new (nslots + idx) entry(std::move(slots[i]));
+#else
+            new (nslots + idx) entry(slots[i]);
+#endif
+            slots[i].~entry();
+        }
+        nhd->count = old->count;
+        nhd->growth_left -= old->count;
+
+        old->~_flathash_header();
+        Alloc::destroy (old);
+    }
+    h = nhd;
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flathash<K, V, Alloc>::detach()
+{
+    if (is_nul())
+        h = create(group::Width);
+    else if (h->is_shared () && h->has_detach ())
+    {
+        _flathash_header *old = h;
+        _flathash_header *nhd = create(old->capacity);
+        const i8 *ctrl = ctrl_of(old);
+        entry *slots = slots_of(old);
+        entry *nslots = slots_of(nhd);
+
+        ky_memory::copy(ctrl_of(nhd), ctrl, old->capacity + group::Width);
+        for (i64 i = 0; i < old->capacity; ++i)
+        {
+            if (_flathash_ctrl::is_full(ctrl[i]))
+                new (nslots + i) entry(slots[i]);
+        }
+        nhd->count = old->count;
+        nhd->growth_left = old->growth_left;
+
+        if (old->lessref ())
+            destroy (old);
+        h = nhd;
+    }
+}
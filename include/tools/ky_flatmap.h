@@ -0,0 +1,336 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * You should have received a copy of the GNU General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file     ky_flatmap.h
+ * @brief    有序数组实现的关联容器和集合
+ *       1.ky_flatmap 的key和值分别存放在两个ky_array中，按key有序
+ *       2.ky_flatset 只有一个有序的ky_array
+ *       3.查找使用无分支二分查找，插入和删除需要移动之后的元素，
+ *         适合元素较少(几十个)或建立后很少修改的表
+ *       4.可以从无序的数据批量建立(排序后去重，重复的key保留第一个)
+ *       5.迭代器直接指向数组元素，容器修改后迭代器失效
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/17
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/17 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/17 | 1.0.0.2   | kunyang  | 加入只读迭代器const_iterator
+ *
+ */
+#ifndef ky_FLATMAP_H
+#define ky_FLATMAP_H
+
+#include "ky_define.h"
+#include "tools/ky_array.h"
+#include "tools/ky_algorlthm.h"
+
+//!
+//! \brief _flat_lower 返回第一个不小于k的位置
+//! \note 每次比较只决定基址是否前进，编译后为条件传送，没有难以预测的分支
+//!
+template <typename K>
+inline i64 _flat_lower(const K *first, i64 n, const K &k)
+{
+    if (n <= 0)
+        return 0;
+    const K *base = first;
+    while (n > 1)
+    {
+        const i64 half = n >> 1;
+        base = (base[half] < k) ? base + half : base;
+        n -= half;
+    }
+    return (base - first) + (*base < k);
+}
+//!
+//! \brief _flat_upper 返回第一个大于k的位置
+//!
+template <typename K>
+inline i64 _flat_upper(const K *first, i64 n, const K &k)
+{
+    if (n <= 0)
+        return 0;
+    const K *base = first;
+    while (n > 1)
+    {
+        const i64 half = n >> 1;
+        base = (k < base[half]) ? base : base + half;
+        n -= half;
+    }
+    return (base - first) + !(k < *base);
+}
+
+//!
+//! \brief The _flat_order struct 批量建立时的排序项
+//! \note 只排序key的地址和原始位置，相同的key按原始位置排序，去重时保留第一个
+//!
+template <typename K>
+struct _flat_order
+{
+    const K *key;
+    i64      index;
+
+    bool operator < (const _flat_order &rhs)const
+    {
+        if (*key < *rhs.key)
+            return true;
+        if (*rhs.key < *key)
+            return false;
+        return index < rhs.index;
+    }
+    friend void ky_swap(_flat_order &a, _flat_order &b)
+    {
+        const _flat_order t = a;
+        a = b;
+        b = t;
+    }
+};
+
+template <typename K, typename V>
+class ky_flatmap
+{
+public:
+    typedef K key_t;
+    typedef V value_t;
+
+    class const_iterator;
+    //!
+    //! \brief The iterator class 同时指向key数组和值数组的对应元素
+    //!
+    class iterator
+    {
+        friend class ky_flatmap;
+        friend class const_iterator;
+    private:
+        const K *k;
+        V       *v;
+
+        iterator(const K *kp, V *vp):k(kp), v(vp){}
+
+    public:
+        iterator():k(0), v(0){}
+
+        friend bool operator == (const iterator& it1,const iterator& it2)
+        {
+            return it1.k == it2.k;
+        }
+        friend bool operator!=(const iterator& it1,const iterator& it2)
+        {
+            return !(it1 == it2);
+        }
+        V& operator*(void) const {return *v;}
+        V* operator->(void) const {return v;}
+        const K &key() const {return *k;}
+        V &value() const {return *v;}
+
+        iterator& operator++(void) {++k; ++v; return *this;}
+        iterator operator++(int) {iterator tmp = *this; ++k; ++v; return tmp;}
+        iterator& operator--(void) {--k; --v; return *this;}
+        iterator operator--(int) {iterator tmp = *this; --k; --v; return tmp;}
+        iterator operator + (i64 n)const {return iterator(k + n, v + n);}
+        iterator operator - (i64 n)const {return iterator(k - n, v - n);}
+        i64 operator - (const iterator &rhs)const {return k - rhs.k;}
+    };
+    //!
+    //! \brief The const_iterator class 只读迭代器，const容器只能通过它访问值
+    //!
+    class const_iterator
+    {
+        friend class ky_flatmap;
+    private:
+        const K *k;
+        const V *v;
+
+        const_iterator(const K *kp, const V *vp):k(kp), v(vp){}
+
+    public:
+        const_iterator():k(0), v(0){}
+        const_iterator(const iterator &rhs):k(rhs.k), v(rhs.v){}
+
+        friend bool operator == (const const_iterator& it1,const const_iterator& it2)
+        {
+            return it1.k == it2.k;
+        }
+        friend bool operator!=(const const_iterator& it1,const const_iterator& it2)
+        {
+            return !(it1 == it2);
+        }
+        const V& operator*(void) const {return *v;}
+        const V* operator->(void) const {return v;}
+        const K &key() const {return *k;}
+        const V &value() const {return *v;}
+
+        const_iterator& operator++(void) {++k; ++v; return *this;}
+        const_iterator operator++(int) {const_iterator tmp = *this; ++k; ++v; return tmp;}
+        const_iterator& operator--(void) {--k; --v; return *this;}
+        const_iterator operator--(int) {const_iterator tmp = *this; --k; --v; return tmp;}
+        const_iterator operator + (i64 n)const {return const_iterator(k + n, v + n);}
+        const_iterator operator - (i64 n)const {return const_iterator(k - n, v - n);}
+        i64 operator - (const const_iterator &rhs)const {return k - rhs.k;}
+    };
+
+    /// STL style
+public:
+    ky_flatmap();
+    ky_flatmap(const ky_flatmap &rhs);
+    //!
+    //! \brief ky_flatmap 从无序的数据批量建立，重复的key保留第一个
+    //! \param keys
+    //! \param values
+    //! \param n
+    //!
+    ky_flatmap(const K *keys, const V *values, i64 n);
+    ~ky_flatmap();
+
+    iterator begin();
+    const_iterator begin() const;
+    iterator end(void);
+    const_iterator end(void) const;
+
+    ky_flatmap<K, V> &operator = (const ky_flatmap<K, V> &rhs);
+
+    iterator find(const K &key);
+    const_iterator find(const K &key) const;
+    //!
+    //! \brief lower_bound 返回第一个不小于key的元素
+    //!
+    iterator lower_bound(const K &key);
+    const_iterator lower_bound(const K &key) const;
+    //!
+    //! \brief upper_bound 返回第一个大于key的元素
+    //!
+    iterator upper_bound(const K &key);
+    const_iterator upper_bound(const K &key) const;
+    //!
+    //! \brief operator [] 返回key的值，不存在时插入默认值
+    //!
+    V &operator [](const K &key);
+    //!
+    //! \brief insert 插入key，val并返回迭代器，key已存在时不修改值
+    //!
+    iterator insert(const K& key, const V& val = V());
+    //!
+    //! \brief erase 擦除指定pos的元素，返回下一个元素的迭代器
+    //!
+    iterator erase(iterator pos);
+    //!
+    //! \brief erase 擦除key，返回擦除的元素数
+    //!
+    i64 erase(const K& key);
+
+    void swap(ky_flatmap<K, V> &rhs);
+    friend void ky_swap (ky_flatmap<K, V> &a, ky_flatmap<K, V> &b){a.swap (b);}
+    void clear();
+    bool empty() const{return is_empty ();}
+    i64 size() const{return count();}
+
+    // base
+public:
+    //!
+    //! \brief assign 用无序的数据替换全部内容，重复的key保留第一个
+    //!
+    void assign(const K *keys, const V *values, i64 n);
+    //!
+    //! \brief append 添加关联，key已存在时替换值
+    //!
+    void append(const K& k, const V& v);
+    bool contains(const K& k) const;
+    //!
+    //! \brief value 返回指定key的值，不存在时返回默认值
+    //!
+    V value(const K& key, const V &def = V()) const;
+    void remove(const K& key) {erase(key);}
+    void reserve(i64 size);
+
+    //!
+    //! \brief keys values 有序的key数组和对应的值数组
+    //!
+    const ky_array<K> &keys() const {return _keys;}
+    const ky_array<V> &values() const {return _values;}
+
+    bool is_empty() const {return count() == 0;}
+    i64 count()const {return _keys.count();}
+
+private:
+    //! 查找key的位置，不存在时返回-1
+    i64 index_of(const K &key)const;
+
+private:
+    ky_array<K> _keys;
+    ky_array<V> _values;
+};
+
+template <typename K>
+class ky_flatset
+{
+public:
+    typedef K key_t;
+    typedef const K *iterator;
+    typedef const K *const_iterator;
+
+public:
+    ky_flatset();
+    ky_flatset(const ky_flatset &rhs);
+    //!
+    //! \brief ky_flatset 从无序的数据批量建立
+    //!
+    ky_flatset(const K *keys, i64 n);
+    ~ky_flatset();
+
+    const_iterator begin() const {return _keys.data();}
+    const_iterator end(void) const {return _keys.data() + _keys.count();}
+
+    ky_flatset<K> &operator = (const ky_flatset<K> &rhs);
+
+    const_iterator find(const K &key) const;
+    const_iterator lower_bound(const K &key) const;
+    const_iterator upper_bound(const K &key) const;
+    //!
+    //! \brief insert 插入key并返回迭代器，key已存在时返回原有的元素
+    //!
+    const_iterator insert(const K& key);
+    const_iterator erase(const_iterator pos);
+    i64 erase(const K& key);
+
+    void swap(ky_flatset<K> &rhs) {_keys.swap(rhs._keys);}
+    friend void ky_swap (ky_flatset<K> &a, ky_flatset<K> &b){a.swap (b);}
+    void clear() {_keys.clear();}
+    bool empty() const{return is_empty ();}
+    i64 size() const{return count();}
+
+    // base
+public:
+    void assign(const K *keys, i64 n);
+    bool contains(const K& k) const;
+    void remove(const K& key) {erase(key);}
+    void reserve(i64 size);
+    const ky_array<K> &keys() const {return _keys;}
+
+    bool is_empty() const {return count() == 0;}
+    i64 count()const {return _keys.count();}
+
+private:
+    ky_array<K> _keys;
+};
+
+#include "ky_flatmap.inl"
+#endif // ky_FLATMAP_H
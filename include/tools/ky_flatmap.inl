@@ -0,0 +1,311 @@
+//!
+//! \brief _flat_sorted 按key排序并去重，返回保留的项数
+//! \param order 输出n项排序后的结果，重复的key只保留原始位置最小的一项
+//!
+template <typename K>
+i64 _flat_sorted(const K *keys, i64 n, _flat_order<K> *order)
+{
+    for (i64 i = 0; i < n; ++i)
+    {
+        order[i].key = keys + i;
+        order[i].index = i;
+    }
+    ky_qsort(order, order + n);
+
+    i64 out = 0;
+    for (i64 i = 0; i < n; ++i)
+    {
+        if (out > 0 && !(*order[out - 1].key < *order[i].key))
+            continue;
+        order[out++] = order[i];
+    }
+    return out;
+}
+
+template <typename K, typename V>
+ky_flatmap<K, V>::ky_flatmap():
+    _keys(), _values()
+{
+}
+template <typename K, typename V>
+ky_flatmap<K, V>::ky_flatmap(const ky_flatmap & rhs):
+    _keys(rhs._keys), _values(rhs._values)
+{
+}
+template <typename K, typename V>
+ky_flatmap<K, V>::ky_flatmap(const K *keys, const V *values, i64 n):
+    _keys(), _values()
+{
+    assign(keys, values, n);
+}
+template <typename K, typename V>
+ky_flatmap<K, V>::~ky_flatmap()
+{
+}
+
+template <typename K, typename V>
+ky_flatmap<K, V> &ky_flatmap<K, V>::operator = (const ky_flatmap<K, V> &rhs)
+{
+    _keys = rhs._keys;
+    _values = rhs._values;
+    return *this;
+}
+
+template <typename K, typename V>
+void ky_flatmap<K, V>::assign(const K *keys, const V *values, i64 n)
+{
+    clear();
+    if (n <= 0)
+        return;
+
+    _flat_order<K> *order = (_flat_order<K> *)kyMalloc(sizeof(_flat_order<K>) * n);
+    const i64 c = _flat_sorted(keys, n, order);
+    reserve(c);
+    for (i64 i = 0; i < c; ++i)
+    {
+        _keys.append(*order[i].key);
+        _values.append(values[order[i].index]);
+    }
+    kyFree(order);
+}
+
+template <typename K, typename V>
+typename ky_flatmap<K, V>::iterator ky_flatmap<K, V>::begin()
+{
+    return iterator(_keys.data(), _values.data());
+}
+template <typename K, typename V>
+typename ky_flatmap<K, V>::const_iterator ky_flatmap<K, V>::begin() const
+{
+    return const_iterator(_keys.data(), _values.data());
+}
+template <typename K, typename V>
+typename ky_flatmap<K, V>::iterator ky_flatmap<K, V>::end()
+{
+    return begin() + count();
+}
+template <typename K, typename V>
+typename ky_flatmap<K, V>::const_iterator ky_flatmap<K, V>::end() const
+{
+    return begin() + count();
+}
+
+template <typename K, typename V>
+i64 ky_flatmap<K, V>::index_of(const K &key)const
+{
+    const K *k = _keys.data();
+    const i64 i = _flat_lower(k, count(), key);
+    if (i < count() && !(key < k[i]))
+        return i;
+    return -1;
+}
+
+template <typename K, typename V>
+typename ky_flatmap<K, V>::iterator ky_flatmap<K, V>::find(const K &key)
+{
+    const i64 i = index_of(key);
+    return i < 0 ? end() : begin() + i;
+}
+template <typename K, typename V>
+typename ky_flatmap<K, V>::const_iterator ky_flatmap<K, V>::find(const K &key) const
+{
+    const i64 i = index_of(key);
+    return i < 0 ? end() : begin() + i;
+}
+template <typename K, typename V>
+typename ky_flatmap<K, V>::iterator ky_flatmap<K, V>::lower_bound(const K &key)
+{
+    return begin() + _flat_lower(_keys.data(), count(), key);
+}
+template <typename K, typename V>
+typename ky_flatmap<K, V>::const_iterator ky_flatmap<K, V>::lower_bound(const K &key) const
+{
+    return begin() + _flat_lower(_keys.data(), count(), key);
+}
+template <typename K, typename V>
+typename ky_flatmap<K, V>::iterator ky_flatmap<K, V>::upper_bound(const K &key)
+{
+    return begin() + _flat_upper(_keys.data(), count(), key);
+}
+template <typename K, typename V>
+typename ky_flatmap<K, V>::const_iterator ky_flatmap<K, V>::upper_bound(const K &key) const
+{
+    return begin() + _flat_upper(_keys.data(), count(), key);
+}
+
+template <typename K, typename V>
+bool ky_flatmap<K, V>::contains(const K &k) const
+{
+    return index_of(k) >= 0;
+}
+template <typename K, typename V>
+V ky_flatmap<K, V>::value(const K &key, const V &def) const
+{
+    const i64 i = index_of(key);
+    return i < 0 ? def : _values.data()[i];
+}
+
+template <typename K, typename V>
+typename ky_flatmap<K, V>::iterator ky_flatmap<K, V>::insert(const K &key, const V &val)
+{
+    const i64 i = _flat_lower(_keys.data(), count(), key);
+    if (i < count() && !(key < _keys.data()[i]))
+        return begin() + i;
+    _keys.insert((int)i, key);
+    _values.insert((int)i, val);
+    return begin() + i;
+}
+template <typename K, typename V>
+V &ky_flatmap<K, V>::operator [](const K &key)
+{
+    return insert(key).value();
+}
+template <typename K, typename V>
+void ky_flatmap<K, V>::append(const K &k, const V &v)
+{
+    iterator it = insert(k, v);
+    it.value() = v;
+}
+
+template <typename K, typename V>
+typename ky_flatmap<K, V>::iterator ky_flatmap<K, V>::erase(iterator pos)
+{
+    const i64 i = pos - begin();
+    if (i < 0 || i >= count())
+        return end();
+    _keys.remove((int)i);
+    _values.remove((int)i);
+    return begin() + i;
+}
+template <typename K, typename V>
+i64 ky_flatmap<K, V>::erase(const K &key)
+{
+    const i64 i = index_of(key);
+    if (i < 0)
+        return 0;
+    _keys.remove((int)i);
+    _values.remove((int)i);
+    return 1;
+}
+
+template <typename K, typename V>
+void ky_flatmap<K, V>::swap(ky_flatmap<K, V> &rhs)
+{
+    _keys.swap(rhs._keys);
+    _values.swap(rhs._values);
+}
+template <typename K, typename V>
+void ky_flatmap<K, V>::clear()
+{
+    _keys.clear();
+    _values.clear();
+}
+template <typename K, typename V>
+void ky_flatmap<K, V>::reserve(i64 size)
+{
+    if (is_empty())
+    {
+        _keys.reserve(size);
+        _values.reserve(size);
+    }
+}
+
+template <typename K>
+ky_flatset<K>::ky_flatset():
+    _keys()
+{
+}
+template <typename K>
+ky_flatset<K>::ky_flatset(const ky_flatset & rhs):
+    _keys(rhs._keys)
+{
+}
+template <typename K>
+ky_flatset<K>::ky_flatset(const K *keys, i64 n):
+    _keys()
+{
+    assign(keys, n);
+}
+template <typename K>
+ky_flatset<K>::~ky_flatset()
+{
+}
+
+template <typename K>
+ky_flatset<K> &ky_flatset<K>::operator = (const ky_flatset<K> &rhs)
+{
+    _keys = rhs._keys;
+    return *this;
+}
+
+template <typename K>
+void ky_flatset<K>::assign(const K *keys, i64 n)
+{
+    clear();
+    if (n <= 0)
+        return;
+
+    _flat_order<K> *order = (_flat_order<K> *)kyMalloc(sizeof(_flat_order<K>) * n);
+    const i64 c = _flat_sorted(keys, n, order);
+    reserve(c);
+    for (i64 i = 0; i < c; ++i)
+        _keys.append(*order[i].key);
+    kyFree(order);
+}
+
+template <typename K>
+typename ky_flatset<K>::const_iterator ky_flatset<K>::find(const K &key) const
+{
+    const_iterator it = lower_bound(key);
+    if (it != end() && !(key < *it))
+        return it;
+    return end();
+}
+template <typename K>
+typename ky_flatset<K>::const_iterator ky_flatset<K>::lower_bound(const K &key) const
+{
+    return begin() + _flat_lower(_keys.data(), count(), key);
+}
+template <typename K>
+typename ky_flatset<K>::const_iterator ky_flatset<K>::upper_bound(const K &key) const
+{
+    return begin() + _flat_upper(_keys.data(), count(), key);
+}
+template <typename K>
+bool ky_flatset<K>::contains(const K &k) const
+{
+    return find(k) != end();
+}
+
+template <typename K>
+typename ky_flatset<K>::const_iterator ky_flatset<K>::insert(const K &key)
+{
+    const i64 i = _flat_lower(_keys.data(), count(), key);
+    if (i >= count() || key < _keys.data()[i])
+        _keys.insert((int)i, key);
+    return begin() + i;
+}
+template <typename K>
+typename ky_flatset<K>::const_iterator ky_flatset<K>::erase(const_iterator pos)
+{
+    const i64 i = pos - begin();
+    if (i < 0 || i >= count())
+        return end();
+    _keys.remove((int)i);
+    return begin() + i;
+}
+template <typename K>
+i64 ky_flatset<K>::erase(const K &key)
+{
+    const_iterator it = find(key);
+    if (it == end())
+        return 0;
+    erase(it);
+    return 1;
+}
+template <typename K>
+void ky_flatset<K>::reserve(i64 size)
+{
+    if (is_empty())
+        _keys.reserve(size);
+}
@@ -28,6 +28,8 @@
  * Change History :
  *    Date    |  Version  |  Author  |   Description
  * 2016/11/10 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/17 | 1.0.1.1   | kunyang  | 默认使用节点分配器ky_node_alloc
+ * 2026/10/17 | 1.0.1.2   | kunyang  | 默认分配器按ky_memory_stats::Hash标记记账
  *
  */
 #ifndef ky_hash_H
@@ -51,7 +53,7 @@ struct _hash_header : public ky_ref
     static const _hash_header shared_nul;
 };
 
-template <typename K, typename V, typename Alloc = ky_alloc<void> >
+template <typename K, typename V, typename Alloc = ky_node_tag_alloc<void, ky_memory_stats::Hash> >
 class ky_hash : public Alloc
 {
 public:
@@ -29,6 +29,7 @@
  * Change History :
  *    Date    |  Version  |  Author  |   Description
  * 2018/03/09 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/17 | 1.0.1.1   | kunyang  | 默认使用节点分配器ky_node_alloc
  */
 
 #ifndef KY_LINKED_H
@@ -52,7 +53,7 @@ struct _ky_linked_ : public ky_ref
 
 };
 
-template <typename T, typename Alloc = ky_alloc<T> >
+template <typename T, typename Alloc = ky_node_alloc<T> >
 class ky_linked : public Alloc
 {
 public:
@@ -37,6 +37,13 @@
  * 2017/06/12 | 1.1.0.1   | kunyang  | 将原有指针型链表修改为ky_linked类，采样连续地址指针模式
  * 2018/02/27 | 1.2.0.1   | kunyang  | 将连续地址指针思想重构并移入ky_memory::array_addr
  * 2018/03/18 | 1.2.1.1   | kunyang  | 将模板对象分为可构造来优化速度
+ * 2026/10/17 | 1.2.2.1   | kunyang  | 元素内存使用节点分配器ky_node_alloc
+ * 2026/10/17 | 1.2.2.2   | kunyang  | 修正复杂或大于节点的对象被直接构造在节点内
+ * 2026/10/17 | 1.2.2.3   | kunyang  | 加入移动构造、右值添加、就地构造和区间添加
+ * 2026/10/17 | 1.2.2.4   | kunyang  | 地址和元素内存按ky_memory_stats::List标记记账
+ * 2026/10/17 | 1.2.2.5   | kunyang  | 修正clear后地址未清空，遍历仍访问已释放的元素
+ * 2026/10/17 | 1.2.2.6   | kunyang  | 只能移动的元素禁止复制容器，分离时不再移出共享块的元素，
+ *            |           |          | 修正分离时释放了仍被共享的旧块
  */
 
 #ifndef KY_LIST
@@ -46,6 +53,7 @@
 #include "ky_algorlthm.h"
 #include "arch/ky_memory.h"
 #include "ky_typeinfo.h"
+#include <iterator>
 
 #ifdef kyHasSTL
 #include <list>
@@ -67,9 +75,9 @@ class ky_list : protected ky_memory::dynaddr
     {
         T &v()
         {
-            if (kyUnLikely(tComplex))
-                return *(Type*)(this);
-            return *(Type*)(value);
+            if (kyLikely(tComplex))
+                return *(Type*)(value);
+            return *(Type*)(this);
         }
     };
 
@@ -131,6 +139,34 @@ public:
     void insert(int pos, const Type& val) ;
     void insert(int pos, const ky_list& val);
 
+#if kyLanguage >= kyLanguage11
+    ky_list(ky_list &&rhs);
+    ky_list& operator = (ky_list &&rhs);
+
+    //!
+    //! \brief prepend append insert 移动添加元素，不产生复制
+    //! \param val
+    //!
+    void prepend(Type &&val);
+    void append(Type &&val);
+    void insert(int pos, Type &&val);
+    //!
+    //! \brief emplace 在pos位置用args就地构造元素
+    //! \param pos 小于等于0时在头部，大于等于count时在尾部
+    //! \param args 元素的构造参数
+    //! \return 返回新构造的元素
+    //!
+    template <typename... Args>
+    Type &emplace(int pos, Args&&... args);
+    //!
+    //! \brief append 附加[first, last)区间的元素，节点一次分配
+    //! \param first
+    //! \param last
+    //!
+    template <typename Iterator>
+    void append(Iterator first, Iterator last);
+#endif
+
     //!
     //! \brief replace 根据位置替换元素
     //! \param i
@@ -421,6 +457,19 @@ public:
     //!
     inline void push_front(const Type &x){prepend(x);}
     inline void push_back(const Type &x){append(x);}
+    inline void push_front(Type &&x){prepend(static_cast<Type &&>(x));}
+    inline void push_back(Type &&x){append(static_cast<Type &&>(x));}
+
+    //!
+    //! \brief emplace_front emplace_back 在头和尾就地构造元素
+    //! \param args
+    //!
+    template <typename... Args>
+    inline Type &emplace_front(Args&&... args)
+    {return emplace(0, std::forward<Args>(args)...);}
+    template <typename... Args>
+    inline Type &emplace_back(Args&&... args)
+    {return emplace(INT_MAX, std::forward<Args>(args)...);}
 
     //!
     //! \brief pop_front 在头和尾删掉一个元素
@@ -440,7 +489,12 @@ public:
 #endif
 
 protected:
+#ifdef kyHasMemoryStats
+    virtual int tag()const {return ky_memory_stats::List;}
+#endif
+    typedef ky_node_tag_alloc<Type, ky_memory_stats::List> ValueAlloc;
 
+    Type*   __slot(node_t *n);
     void    __construct(node_t *n, const Type &p);
     void    __destruct(node_t *n);
     void    __destruct(node_t *from, node_t *to);
@@ -452,16 +506,20 @@ protected:
 
 
 template <typename T>
-void ky_list<T>::__construct(node_t *n, const Type &p)
+T *ky_list<T>::__slot(node_t *n)
 {
-    if (kyUnLikely (tComplex))
-        new (n) Type(p);
-    else
+    // 复杂对象或大于节点的对象单独分配，否则直接构造在节点内
+    if (kyLikely (tComplex))
     {
-        Type *vd = (Type*)kyMalloc(sizeOf);
-        complex_construct(*vd, p);
-        n->value = vd;
+        n->value = ValueAlloc::alloc(sizeOf);
+        return (Type*)n->value;
     }
+    return (Type*)n;
+}
+template <typename T>
+void ky_list<T>::__construct(node_t *n, const Type &p)
+{
+    new (__slot(n)) Type(p);
 }
 template <typename T>
 void ky_list<T>::__destruct(node_t *n)
@@ -469,7 +527,7 @@ void ky_list<T>::__destruct(node_t *n)
     if (kyLikely(tComplex))
     {
         ((Type*)n->value)->~Type();
-        kyFree(n->value);
+        ValueAlloc::destroy(n->value);
     }
 }
 template <typename T>
@@ -478,7 +536,7 @@ void ky_list<T>::__copy(node_t *from, node_t *to, node_t *src)
     node_t *cur = from;
     while(cur != to)
     {
-        __construct(cur, src->v ());
+        complex_copy(*__slot(cur), src->v ());
         ++cur;
         ++src;
     }
@@ -523,9 +581,13 @@ ky_list<T>::~ky_list()
 template <typename T>
 ky_list<T>& ky_list<T>::operator = (const ky_list<T> &rhs)
 {
+    // 共享或复制都会让两个容器看到同一组元素，只能移动的元素无法分离
+    kyCompilerAssert(is_copyable<T>::value);
+    if (header == rhs.header)
+        return *this;
     __destroy_helper();
 
-    if (!rhs.is_null ())
+    if (!rhs.is_nul ())
     {
         Layout *x = (Layout*)&rhs;
         if (x->refer ().has_shareable ())
@@ -618,6 +680,76 @@ void ky_list<T>::insert(int pos, const T& val)
     }
 }
 
+#if kyLanguage >= kyLanguage11
+template <typename T>
+ky_list<T>::ky_list(ky_list<T> &&rhs):
+    Layout()
+{
+    header = rhs.header;
+    rhs.header = rhs.nul();
+}
+
+template <typename T>
+ky_list<T>& ky_list<T>::operator = (ky_list<T> &&rhs)
+{
+    if (header != rhs.header)
+    {
+        __destroy_helper();
+        header = rhs.header;
+        rhs.header = rhs.nul();
+    }
+    return *this;
+}
+
+template <typename T>
+void ky_list<T>::prepend(T &&val)
+{
+    emplace(0, static_cast<T &&>(val));
+}
+
+template <typename T>
+void ky_list<T>::append(T &&val)
+{
+    emplace(INT_MAX, static_cast<T &&>(val));
+}
+
+template <typename T>
+void ky_list<T>::insert(int pos, T &&val)
+{
+    emplace(pos, static_cast<T &&>(val));
+}
+
+template <typename T>
+template <typename... Args>
+T &ky_list<T>::emplace(int pos, Args&&... args)
+{
+    node_t *n = 0;
+    if (Layout::refer ().is_shared ())
+        n = __detach_insert(pos, 1);
+    else
+        n = (node_t*)Layout::insert(pos, 1);
+    new (__slot(n)) Type(std::forward<Args>(args)...);
+    return n->v();
+}
+
+template <typename T>
+template <typename Iterator>
+void ky_list<T>::append(Iterator first, Iterator last)
+{
+    const int64 len = std::distance(first, last);
+    if (len <= 0)
+        return ;
+
+    node_t *n = 0;
+    if (Layout::refer ().is_shared ())
+        n = __detach_insert(INT_MAX, (int)len);
+    else
+        n = (node_t*)Layout::append((int)len);
+    for (; first != last; ++first, ++n)
+        new (__slot(n)) Type(*first);
+}
+#endif
+
 template <typename T>
 void ky_list<T>::replace(int i, const T &val)
 {
@@ -752,6 +884,7 @@ void ky_list<T>::clear()
         return ;
     __detach_helper ();
     __destruct((node_t*)Layout::begin (), (node_t*)Layout::end ());
+    Layout::remove(0, (int)count ());
 }
 
 template <typename T>
@@ -799,11 +932,14 @@ typename ky_list<T>::node_t *ky_list<T>::__detach_insert(int i, int c)
     }
 
     Layout old(oldh);
-    if (!old.is_nul () && !old.refer ().lessref ())
+    // 其他容器仍引用旧块时只减少引用
+    if (!old.is_nul () && old.refer ().lessref ())
     {
         __destruct((node_t*)old.begin(), (node_t*)old.end ());
         old.destroy ();
     }
+    // old析构时会释放内存块
+    old.header = old.nul ();
 
     return (node_t *)(Layout::begin() + i);
 }
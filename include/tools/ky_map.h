@@ -33,6 +33,8 @@
  * 2014/08/10 | 1.0.2.0   | kunyang  | 加入对象引用计数，同时加入C++11支持
  * 2015/03/06 | 1.0.2.2   | kunyang  | 修改将头信息和实际类数据分开
  * 2016/06/29 | 1.0.2.3   | kunyang  | 修改引用计数的可复制对象
+ * 2026/10/17 | 1.0.3.1   | kunyang  | 默认使用节点分配器ky_node_alloc
+ * 2026/10/17 | 1.0.3.2   | kunyang  | 默认分配器按ky_memory_stats::Map标记记账
  */
 #ifndef ky_MAP
 #define ky_MAP
@@ -52,7 +54,7 @@ struct _map_header : protected rb_tree, public ky_ref
     static const _map_header *shared_nul;
 };
 
-template <typename K, typename V, typename Alloc = ky_alloc<void>>
+template <typename K, typename V, typename Alloc = ky_node_tag_alloc<void, ky_memory_stats::Map> >
 class ky_map : Alloc
 {
 public:
@@ -28,6 +28,7 @@
  * Change History :
  *    Date    |  Version  |  Author  |   Description
  * 2014/05/02 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/17 | 1.0.0.2   | kunyang  | 右值入队改为移动，加入就地构造入队和移动出队
  */
 #ifndef ky_QUEUE
 #define ky_QUEUE
@@ -58,12 +59,22 @@ public:
 
     void push(const T& val) {sequence.push_back (val);}
 #if kyLanguage >= kyLanguage11
-    void push(T && v){sequence.push_back (v);}
+    ky_queue(ky_queue &&v) :sequence(static_cast<ky_list<T> &&>(v.sequence)) {}
+    void push(T && v){sequence.push_back (static_cast<T &&>(v));}
+    //!
+    //! \brief emplace 在队尾用args就地构造元素
+    //!
+    template <typename... Args>
+    T &emplace(Args&&... args) {return sequence.emplace_back (std::forward<Args>(args)...);}
 #endif
 
     void remove() {sequence.pop_front ();}
     void clear() {sequence.clear ();}
+#if kyLanguage >= kyLanguage11
+    T pop() {T out = static_cast<T &&>(sequence.front ()); remove (); return out;}
+#else
     T pop() {T out = sequence.front (); remove (); return out;}
+#endif
     int64 size()const {return sequence.size ();}
     int64 count()const {return size();}
 
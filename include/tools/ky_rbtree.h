@@ -37,6 +37,7 @@
  * 2017/06/12 | 1.1.0.1   | kunyang  | 将原有指针型链表修改为ky_linked类，采样连续地址指针模式
  * 2018/02/27 | 1.2.0.1   | kunyang  | 将连续地址指针思想重构并移入ky_memory::array_addr
  * 2018/03/18 | 1.2.1.1   | kunyang  | 将模板对象分为可构造来优化速度
+ * 2026/10/17 | 1.2.2.1   | kunyang  | 默认使用节点分配器ky_node_alloc
  */
 
 #ifndef KY_RBTREE_H
@@ -135,7 +136,7 @@ struct rb_tree
     void insert (rb_node *z);
  };
 
-template<typename T, typename Alloc = ky_alloc<T>>
+template<typename T, typename Alloc = ky_node_alloc<T>>
 class ky_rbtree : protected rb_tree, private Alloc
 {
 private:
@@ -21,6 +21,8 @@
  *           1.国际字符集存储
  *           2.数字-字符串转换
  *           3.字符集转换
+ *           4.ky_string_view 字符串视图，查找/分割/比较不申请内存
+ *           5.ky_string_matcher 预编译的查找模式
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
@@ -40,6 +42,9 @@
  * 2017/02/25 | 1.3.1.1   | kunyang  | 加入字符串包含功能函数，和字符串修剪功能
  * 2018/05/17 | 1.3.2.1   | kunyang  | 修复linux系统下宽字符集转换错误
  * 2019/05/07 | 1.3.3.1   | kunyang  | 修复trimmed函数错误
+ * 2026/10/17 | 1.3.4.1   | kunyang  | 加入字符串的64位散列
+ * 2026/10/17 | 1.3.5.1   | kunyang  | 加入不持有数据的ky_string_view，latin1查找和比较不再转换
+ * 2026/10/17 | 1.3.6.1   | kunyang  | 子串查找使用向量指令，加入预编译查找模式ky_string_matcher
  */
 #ifndef KY_STRING_H
 #define KY_STRING_H
@@ -249,6 +254,97 @@ typedef ky_array<u8> ky_utf8;
 typedef ky_array<u16> ky_utf16;
 typedef ky_array<u32> ky_utf32;
 
+class ky_string_view;
+typedef ky_list<ky_string_view> ky_string_view_list;
+
+//!
+//! \brief The ky_string_view class 不持有数据的UTF-16字符串视图
+//! \note 1.视图只记录地址和长度，原字符串修改或释放后视图失效
+//!       2.const char*参数按latin1处理，查找和比较时直接按字节比较，不转换
+//!
+class ky_string_view
+{
+public:
+    ky_string_view():str(0), len(0){}
+    ky_string_view(const ky_char *s, int64 n):str(s), len(n){}
+    ky_string_view(const ky_string &s);
+
+    //!
+    //! \brief data 字符地址，不以'\0'结尾
+    //!
+    const ky_char *data()const {return str;}
+    const ky_char *begin()const {return str;}
+    const ky_char *end()const {return str + len;}
+    //!
+    //! \brief length 字符数
+    //!
+    int64 length()const {return len;}
+    bool is_empty()const {return len == 0;}
+
+    ky_char at(int64 i)const {return str[i];}
+    ky_char operator[](int64 i)const {return str[i];}
+
+    //!
+    //! \brief extract 提取子视图
+    //! \param pos
+    //! \param count 小于0时提取到结尾
+    //! \return 超出范围的部分被截断
+    //!
+    ky_string_view extract(int64 pos, int64 count = -1)const;
+    //!
+    //! \brief trimmed 去掉首尾空白的子视图
+    //!
+    ky_string_view trimmed()const;
+    //!
+    //! \brief to_string 复制为字符串
+    //!
+    ky_string to_string()const;
+
+public:
+    //!
+    //! \brief find 从from开始查找
+    //! \return 未找到时返回-1
+    //!
+    int64 find(const ky_string_view &s, int64 from = 0)const;
+    int64 find(const char *latin1, int64 from = 0)const;
+    int64 find(const char *latin1, int64 n, int64 from)const;
+    int64 find(ky_char c, int64 from = 0)const;
+
+    bool contains(const ky_string_view &s)const {return find(s) >= 0;}
+    bool contains(const char *latin1)const {return find(latin1) >= 0;}
+
+    bool starts_with(const ky_string_view &s)const;
+    bool starts_with(const char *latin1)const;
+    bool ends_with(const ky_string_view &s)const;
+    bool ends_with(const char *latin1)const;
+
+    //!
+    //! \brief split 分割，返回的子视图指向原字符串
+    //!
+    ky_string_view_list split(const ky_string_view &sep)const;
+    ky_string_view_list split(const char *latin1, int64 n = -1)const;
+
+    //!
+    //! \brief compare 按UTF-16码元比较
+    //!
+    int compare(const ky_string_view &s)const;
+    int compare(const char *latin1, int64 n = -1)const;
+
+    bool operator == (const ky_string_view &s)const {return compare(s) == 0;}
+    bool operator != (const ky_string_view &s)const {return compare(s) != 0;}
+    bool operator < (const ky_string_view &s)const {return compare(s) < 0;}
+    bool operator == (const char *latin1)const {return compare(latin1) == 0;}
+    bool operator != (const char *latin1)const {return compare(latin1) != 0;}
+
+private:
+    template <typename C>
+    ky_string_view_list split_helper(const C *sep, int64 n)const;
+
+private:
+    const ky_char *str;
+    int64          len;
+};
+
 class ky_string : public ky_utf16
 {
 public:
@@ -268,6 +364,11 @@ public:
     std::string to_std()const;
     std::wstring to_wstd()const;
 
+    //!
+    //! \brief view 返回整个字符串的视图
+    //!
+    ky_string_view view()const {return ky_string_view(*this);}
+
 public:
     //!
     //! \brief data  作为字符串
@@ -677,10 +778,47 @@ private:
    ky_array<wchar_t> s_unicode;
 };
 
+//!
+//! \brief The ky_string_matcher class 预编译的查找模式
+//! \note 构造时复制模式，长模式同时建立跳转表，对同一模式反复查找时省去准备工作
+//!
+class ky_string_matcher
+{
+public:
+    ky_string_matcher();
+    explicit ky_string_matcher(const ky_string_view &pattern);
+
+    void set_pattern(const ky_string_view &pattern);
+    ky_string_view pattern()const {return needle.view();}
+
+    //!
+    //! \brief find 从from开始查找模式
+    //! \return 未找到时返回-1
+    //!
+    int64 find(const ky_string_view &s, int64 from = 0)const;
+    bool contains(const ky_string_view &s)const {return find(s) >= 0;}
+
+private:
+    ky_string needle;
+    int32     skip[256];    ///< Horspool跳转表，只用于长模式
+};
+
 const fourwd_t kyStringCode = kyFourWord(strx);
 #include "ky_stream.h"
 ky_stream &operator << (ky_stream &in, const ky_string &v);
 ky_stream &operator >> (ky_stream &out, ky_string &v);
 
+//!
+//! \brief ky_hash_f 字符串的散列，ky_hash等以字符串为key的容器均使用此函数
+//!
+inline u64 ky_hash_f(const ky_string &v)
+{
+    return __hash__::WY(v.data(), v.size(), __hash__::seed());
+}
+inline u64 ky_hash_f(const ky_string_view &v)
+{
+    return __hash__::WY(v.data(), v.length() * sizeof(ky_char), __hash__::seed());
+}
+
 #endif
 
@@ -19,6 +19,8 @@
  * 2016/03/08 | 1.0.2.1   | kunyang  | 修改>>、<<符号操作
  * 2018/02/18 | 1.1.0.1   | kunyang  | 重构类并独立
  * 2019/04/28 | 1.2.0.1   | kunyang  | 添加基础类型和四字码标注
+ * 2026/10/17 | 1.2.1.1   | kunyang  | 小数据内联存储，大数据才使用共享布局
+ * 2026/10/17 | 1.2.1.2   | kunyang  | 数据指针参数改为const void*
  */
 #ifndef KY_VARIANT_H
 #define KY_VARIANT_H
@@ -45,13 +47,39 @@ typedef ky_array<char> fourwd_str;
  */
 typedef struct ky_variant
 {
+    //! 内联存储的最大字节数，超出时使用共享布局
+    enum {InlineByte = 24};
+
+    //!
+    //! \brief The layout struct 大数据的共享布局(写时复制)，数据紧跟在计数之后
+    //!
     struct layout : ky_ref
     {
-        fourwd_t                code;
-        struct ky_variant_math* math;
-        uint8                 * data;
-        int                     byte;
-    } *mem;
+        fourwd_int              align;     ///< 数据起始位置(按8字节对齐)
+        uint8 *data() {return (uint8*)&align;}
+    };
+
+    fourwd_t                code;          ///< 四字码
+    int                     byte;          ///< 数据长度，小于0为无效数据
+    struct ky_variant_math* math;          ///< 运算对象
+    union
+    {
+        layout            * mem;           ///< byte > InlineByte 时的共享布局
+        uint8               local[InlineByte]; ///< 小数据直接存储
+        fourwd_int          local_align;
+    };
+
+    //!
+    //! \brief data 数据指针
+    //! \return
+    //!
+    inline uint8 *data()const
+    {return is_inline() ? (uint8*)local : mem->data();}
+    //!
+    //! \brief is_inline 数据是否存储在对象内
+    //! \return
+    //!
+    inline bool is_inline()const {return byte <= InlineByte;}
 
     virtual ~ky_variant();
     ky_variant();
@@ -59,7 +87,7 @@ typedef struct ky_variant
     ky_variant(const ky_variant &pd);
     ky_variant &operator = (const ky_variant &pd);
 
-    void swap(ky_variant &b){layout *tmp = mem; mem = b.mem; b.mem = tmp;}
+    void swap(ky_variant &b);
     friend void ky_swap(ky_variant &a, ky_variant &b) {a.swap(b);}
 
     // 基础类型
@@ -114,11 +142,11 @@ typedef struct ky_variant
     explicit ky_variant(const fourwd_veci &v);
     explicit ky_variant(const fourwd_vecf &v);
 
-    explicit ky_variant(bool_t v):mem(0){*this = ky_variant(fourwd_int(v));}
-    explicit ky_variant(bool v):mem(0){*this = ky_variant(fourwd_int(v));}
-    explicit ky_variant(int32 v):mem(0){*this = ky_variant(fourwd_int(v));}
-    explicit ky_variant(flt16 v):mem(0){*this = ky_variant(fourwd_flt(v));}
-    explicit ky_variant(flt32 v):mem(0){*this = ky_variant(fourwd_flt(v));}
+    explicit ky_variant(bool_t v):code(0), byte(-1), math(0){*this = ky_variant(fourwd_int(v));}
+    explicit ky_variant(bool v):code(0), byte(-1), math(0){*this = ky_variant(fourwd_int(v));}
+    explicit ky_variant(int32 v):code(0), byte(-1), math(0){*this = ky_variant(fourwd_int(v));}
+    explicit ky_variant(flt16 v):code(0), byte(-1), math(0){*this = ky_variant(fourwd_flt(v));}
+    explicit ky_variant(flt32 v):code(0), byte(-1), math(0){*this = ky_variant(fourwd_flt(v));}
 
     //!
     //! \brief ky_variant 构造变种类型数据
@@ -127,7 +155,7 @@ typedef struct ky_variant
     //! \param data 数据指针
     //! \param byte 数据长度
     //!
-    ky_variant(const fourwd_t code, struct ky_variant_math *math, void *data, int byte);
+    ky_variant(const fourwd_t code, struct ky_variant_math *math, const void *data, int byte);
 
     //!
     //! \brief set 设置变种类型数据
@@ -136,7 +164,7 @@ typedef struct ky_variant
     //! \param data 数据指针
     //! \param byte 数字字节
     //!
-    void set(const fourwd_t code, struct ky_variant_math *math, void *data, int byte);
+    void set(const fourwd_t code, struct ky_variant_math *math, const void *data, int byte);
     //!
     //! \brief is_set 是否被设置为特定类型
     //! \param code
@@ -158,7 +186,7 @@ typedef struct ky_variant
     T get(fourwd_t code)const
     {
         if (is_set(code) && (kyStrCode != code))
-            return T(*((T*)mem->data));
+            return T(*((T*)data()));
         return T();
     }
     template<typename T> T to(int code)const{return get<T>(code);}
@@ -8,7 +8,7 @@
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.0.1.5
+ * @version  1.0.1.7
  * @date     2010/05/08
  * @license  GNU General Public License (GPL)
  *
@@ -18,6 +18,9 @@
  * 2010/08/10 | 1.0.1.0   | kunyang  | 将原有继承std::vector完成类修改为ky_array
  * 2012/04/02 | 1.0.1.2   | kunyang  | 将迭代接口进行重新编写
  * 2014/03/09 | 1.0.1.5   | kunyang  | 加入C++11支持
+ * 2026/10/17 | 1.0.1.6   | kunyang  | 修正迭代尾部和元素数误用字节数
+ * 2026/10/17 | 1.0.1.7   | kunyang  | 右值添加改为移动，加入就地构造和区间添加
+ * 2026/10/17 | 1.0.1.8   | kunyang  | 修正remove递归调用自身
  */
 
 #ifndef VECTOR_H
@@ -85,7 +88,29 @@ public:
 public:
     ky_vector(ky_vector&& rhs);
     ky_vector(const std::initializer_list<T> & il);
+    ky_vector& operator =(ky_vector&& rhs);
     void push_back(T&& v);
+    inline void push_front(T&& v){VecBase::prepend(static_cast<T &&>(v));}
+
+    //!
+    //! \brief emplace_back emplace 用args就地构造元素
+    //! \param args
+    //! \return
+    //!
+    template <typename... Args>
+    inline T &emplace_back(Args&&... args)
+    {return VecBase::emplace(INT_MAX, std::forward<Args>(args)...);}
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args);
+
+    //!
+    //! \brief append 移动附加a的元素和附加[first, last)区间的元素
+    //!
+    inline ky_vector<T> &append(ky_vector<T> &&a)
+    {VecBase::append(static_cast<VecBase &&>(a)); return *this;}
+    template <typename Iterator>
+    inline ky_vector<T> &append(Iterator first, Iterator last)
+    {VecBase::append(first, last); return *this;}
 
     iterator insert(const_iterator pos, const T& v);
     iterator insert(const_iterator pos, T&& v);
@@ -107,7 +132,7 @@ public:
     bool operator==(const ky_vector<T> &v) const;
     bool contains(const T &t) const;
 
-    inline ky_vector<T> &operator +=(const ky_vector<T> &l) {return append(l.data(), l.size());}
+    inline ky_vector<T> &operator +=(const ky_vector<T> &l) {return append(l.data(), l.count());}
     inline ky_vector<T> operator +(const ky_vector<T> &l) const { ky_vector n = *this; n += l; return n; }
     inline ky_vector<T> &operator +=(const T &t) { append(t); return *this; }
     inline ky_vector<T> &operator << (const T &t) { append(t); return *this; }
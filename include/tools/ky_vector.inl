@@ -38,7 +38,7 @@ typename ky_vector<T>::iterator ky_vector<T>::begin()
 template <typename T >
 typename ky_vector<T>::iterator ky_vector<T>::end()
 {
-    return iterator(VecBase::data()+VecBase::size());
+    return iterator(VecBase::data()+VecBase::count());
 }
 template <typename T >
 typename ky_vector<T>::const_iterator ky_vector<T>::begin()const
@@ -48,7 +48,7 @@ typename ky_vector<T>::const_iterator ky_vector<T>::begin()const
 template <typename T >
 typename ky_vector<T>::const_iterator ky_vector<T>::end()const
 {
-    return const_iterator(VecBase::data()+VecBase::size());
+    return const_iterator(VecBase::data()+VecBase::count());
 }
 
 template <typename T >
@@ -87,7 +87,7 @@ void ky_vector<T>::push_back(const T& v)
 template <typename T >
 void ky_vector<T>::pop_back()
 {
-    VecBase::remove(VecBase::size()-1);
+    VecBase::remove(int(VecBase::count()-1));
 }
 
 #if kyLanguage < kyLanguage11
@@ -128,9 +128,15 @@ typename ky_vector<T>::iterator ky_vector<T>::erase(iterator first, iterator las
 
 template <typename T >
 ky_vector<T>::ky_vector(ky_vector&& rhs):
-    VecBase(rhs)
+    VecBase(static_cast<VecBase &&>(rhs))
 {
 
+}
+template <typename T >
+ky_vector<T>& ky_vector<T>::operator =(ky_vector&& rhs)
+{
+    VecBase::operator =(static_cast<VecBase &&>(rhs));
+    return *this;
 }
 template <typename T >
 ky_vector<T>::ky_vector(const std::initializer_list<T> & il):
@@ -141,7 +147,7 @@ ky_vector<T>::ky_vector(const std::initializer_list<T> & il):
 template <typename T >
 void ky_vector<T>::push_back(T&& v)
 {
-    VecBase::append(v);
+    VecBase::append(static_cast<T &&>(v));
 }
 template <typename T >
 typename ky_vector<T>::iterator ky_vector<T>::insert(const_iterator pos, const T& v)
@@ -152,8 +158,14 @@ typename ky_vector<T>::iterator ky_vector<T>::insert(const_iterator pos, const T
 template <typename T >
 typename ky_vector<T>::iterator ky_vector<T>::insert(const_iterator pos, T&& v)
 {
-    VecBase::insert(pos.ope - begin().ope, v);
-    return iterator(pos.ope+1);
+    return emplace(pos, static_cast<T &&>(v));
+}
+template <typename T >
+template <typename... Args>
+typename ky_vector<T>::iterator ky_vector<T>::emplace(const_iterator pos, Args&&... args)
+{
+    const int offset = int(pos.ope - VecBase::data());
+    return iterator(&VecBase::emplace(offset, std::forward<Args>(args)...));
 }
 template <typename T >
 typename ky_vector<T>::iterator ky_vector<T>::insert(const_iterator pos, int64 count, const T& v)
@@ -193,7 +205,7 @@ template <typename T >
 std::vector<T> ky_vector<T>::to_std()
 {
     std::vector<T> dat;
-    dat.resize(VecBase::size());
+    dat.resize(VecBase::count());
     ky_memory::copy(dat.data(), VecBase::data(), VecBase::bytecount());
     return dat;
 }
@@ -226,13 +238,17 @@ bool ky_vector<T>::contains(const T &t) const
 template <typename T >
 int64 ky_vector<T>::count()const
 {
-    return VecBase::size();
+    return VecBase::count();
 }
 
 template <typename T >
 ky_vector<T> &ky_vector<T>::prepend(T c)
 {
+#if kyLanguage >= kyLanguage11
+    return *(ky_vector<T>*)&VecBase::prepend(static_cast<T &&>(c));
+#else
     return *(ky_vector<T>*)&VecBase::prepend(c);
+#endif
 }
 template <typename T >
 ky_vector<T> &ky_vector<T>::prepend(const T *s, int len)
@@ -248,7 +264,11 @@ ky_vector<T> &ky_vector<T>::prepend(const ky_vector<T> &a)
 template <typename T >
 ky_vector<T> &ky_vector<T>::append(T c)
 {
+#if kyLanguage >= kyLanguage11
+    return *(ky_vector<T>*)&VecBase::append(static_cast<T &&>(c));
+#else
     return *(ky_vector<T>*)&VecBase::append(c);
+#endif
 }
 template <typename T >
 ky_vector<T> &ky_vector<T>::append(const T *s, int64 len)
@@ -264,7 +284,11 @@ ky_vector<T> &ky_vector<T>::append(const ky_vector<T> &a)
 template <typename T >
 ky_vector<T> &ky_vector<T>::insert(int64 i, T c)
 {
+#if kyLanguage >= kyLanguage11
+    return *(ky_vector<T>*)&VecBase::insert(int(i), static_cast<T &&>(c));
+#else
     return *(ky_vector<T>*)&VecBase::insert(i, c);
+#endif
 }
 template <typename T >
 ky_vector<T> &ky_vector<T>::insert(int64 i, const T *s, int64 len)
@@ -280,7 +304,7 @@ ky_vector<T> &ky_vector<T>::insert(int64 i, const ky_vector<T> &a)
 template <typename T >
 void ky_vector<T>::remove(int64 index, int64 len)
 {
-    remove(index, len);
+    VecBase::remove(index, len);
 }
 
 template <typename T >
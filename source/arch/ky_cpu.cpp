@@ -10,6 +10,9 @@ static cpu_ability *__ability = cpu_ability::instance();
 
 bool ky_cpu::has(eCPUFeatures cap)
 {
+    // 其他模块的静态初始化可能先于__ability
+    if (kyUnLikely(__ability == 0))
+        __ability = cpu_ability::instance();
     return __ability->feature & cap;
 }
 
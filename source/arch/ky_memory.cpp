@@ -624,23 +624,7 @@ ky_memory::ky_memory(){}
 
 ky_memory::~ky_memory(){}
 
-void *ky_memory::copy(void *dst, const void* src, int64 len)
-{
-    return memcpy (dst, src, len);
-}
-void *ky_memory::move(void *dst, const void* src, int64 len)
-{
-    return memmove (dst, src, len);
-}
-void ky_memory::zero(void *dst, int64 len, int fill)
-{
-    memset (dst, fill, len);
-}
-
-int ky_memory::compare(const void *dst, const void* src, int64 len)
-{
-    return memcmp (dst, src, len);
-}
+// copy/move/zero/compare 在 memory/memops.cpp 中按cpu能力选择实现
 
 
 #if kyArchIsX86
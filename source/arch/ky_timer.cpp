@@ -41,7 +41,7 @@ u64 ky_timer::nanosec(eTypes t)
     int clk = CLOCK_REALTIME;
     switch ((int)t)
     {
-    case Monotonic: clk = CLOCK_MONOTONIC;
+    case Monotonic: clk = CLOCK_MONOTONIC; break;
     case Process:
 #  if defined(CLOCK_PROCESS_CPUTIME_ID)
         clk = CLOCK_PROCESS_CPUTIME_ID;
@@ -51,13 +51,15 @@ u64 ky_timer::nanosec(eTypes t)
         errno = ENOSYS;
         return 0;
 #  endif
+        break;
     case Thread:
-#  ifdef CLOCK_PROCESS_CPUTIME_ID
-        clk = CLOCK_PROCESS_CPUTIME_ID;
+#  ifdef CLOCK_THREAD_CPUTIME_ID
+        clk = CLOCK_THREAD_CPUTIME_ID;
 #  else
         errno = ENOSYS;
         return 0;
 #  endif
+        break;
     }
 
     if (::clock_gettime(clk, &time) != 0)
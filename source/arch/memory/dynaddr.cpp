@@ -3,15 +3,20 @@
 #include "ky_define.h"
 #include "ky_memory.h"
 
-struct header_t : ky_ref
+struct dynaddr_header : ky_ref
 {
     int32 count;
     int32 begin;
     int32 end;
+#ifdef kyHasMemoryStats
+    int32 tag;      ///< 记账标记
+    int64 bytes;    ///< 内存块的字节数
+#endif
     void *addr[1];
 
-    static const header_t shared_nul;
+    static const dynaddr_header shared_nul;
 };
+typedef dynaddr_header header_t;
 const header_t header_t::shared_nul = {};
 
 enum
@@ -19,6 +24,28 @@ enum
     HeaderSize = sizeof(header_t) - ky_memory::dynaddr::NodeSize
 };
 
+#ifdef kyHasMemoryStats
+inline void block_alloced(header_t *h, int tag, int64 byte)
+{
+    h->tag = tag;
+    h->bytes = byte;
+    kyMemoryAlloc(tag, byte);
+}
+inline void block_realloced(header_t *h, int64 old, int64 byte)
+{
+    h->bytes = byte;
+    kyMemoryRealloc(h->tag, old, byte);
+}
+#  define block_tag() tag()
+#  define block_bytes(h) ((h)->bytes)
+#  define block_freed(h) kyMemoryFree((h)->tag, (h)->bytes)
+#else
+#  define block_alloced(h, tag, byte) do{}while(0)
+#  define block_realloced(h, old, byte) do{}while(0)
+#  define block_bytes(h) 0
+#  define block_freed(h) do{}while(0)
+#endif
+
 
 ky_memory::dynaddr::dynaddr():
     header(nul())
@@ -59,6 +86,7 @@ header_t* ky_memory::dynaddr::reserve(int64 size)
         if (!t)
             return 0;
 
+        block_alloced(t, block_tag(), mem_byte);
         t->set(ky_ref::ShareableDetach);
         t->count = size;
         t->begin = 0;
@@ -68,10 +96,13 @@ header_t* ky_memory::dynaddr::reserve(int64 size)
     // realloc
     else
     {
+        const int64 old_byte = block_bytes(old);
         header_t *t = (header_t *)kyRealloc(old, mem_byte);
-        if(t)
+        if (!t)
             return 0;
 
+        block_realloced(t, old_byte, mem_byte);
+        kyUnused2(old_byte);
         header = t;
         header->count = size;
         if (!size)
@@ -84,7 +115,10 @@ header_t* ky_memory::dynaddr::reserve(int64 size)
 void ky_memory::dynaddr::destroy()
 {
     if (!is_nul())
+    {
+        block_freed(header);
         kyFree(header);
+    }
     header = nul();
 }
 
@@ -92,13 +126,17 @@ void ky_memory::dynaddr::destroy()
 bool ky_memory::dynaddr::expand(int64 growth)
 {
     int64 elem_count = 0;
+    // 头部有空闲时尾部位置大于元素数，按尾部位置计算
     const int64 mem_byte =
-            ky_memory::block_growing(count() + growth,
+            ky_memory::block_growing(header->end + growth,
                                     NodeSize, HeaderSize, &elem_count);
 
+    const int64 old_byte = block_bytes(header);
     header_t *t = (header_t *)kyRealloc(header, mem_byte);
     if (!t)
         return false;
+    block_realloced(t, old_byte, mem_byte);
+    kyUnused2(old_byte);
     header = t;
     header->count = elem_count;
     return true;
@@ -116,6 +154,7 @@ header_t* ky_memory::dynaddr::detach(int *idx, int count)
     if (!t)
         return 0;
 
+    block_alloced(t, block_tag(), mem_byte);
     t->count = elem_count;
     t->set(ky_ref::ShareableDetach);
 
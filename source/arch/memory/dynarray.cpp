@@ -1,27 +1,210 @@
 
 #include "ky_define.h"
 #include "ky_memory.h"
+#include "ky_allocate.h"
 
 //#define dbg(...) do{fprintf (stderr, __VA_ARGS__);fprintf (stderr, "\n");}while(0)
 
-struct header_t : ky_ref
+struct dynarray_header : ky_ref
 {
     int64 count;
     int64 begin;
     int64 end;
     int   align;
+    int   mode;     ///< 内存块来源
+#ifdef kyHasMemoryStats
+    int   tag;      ///< 记账标记
+    int64 bytes;    ///< 堆内存块的字节数
+#endif
 
-    static const header_t shared_nul;
+    static const dynarray_header shared_nul;
 };
+typedef dynarray_header header_t;
 const header_t header_t::shared_nul = {};
 
 enum
 {
-    HeaderSize = sizeof(header_t)
+    HeaderSize = sizeof(header_t),
+    VirtualHead = kyCpuCacheLineSize,   ///< 虚拟内存块头之前记录保留信息的空间
+    ArenaHead = 16                      ///< 分配区内存块头之前记录所属分配区的空间
+};
+enum
+{
+    HeapBlock = 0,      ///< 堆
+    ArenaBlock,         ///< reserve_arena指定的分配区
+    VirtualBlock        ///< 保留的虚拟地址空间，按需提交
+};
+
+//! 虚拟内存块的保留信息，位于保留空间的起始处，之后是header_t
+struct virtual_t
+{
+    int64 reserved;     ///< 保留的字节数
+    int64 committed;    ///< 已提交的字节数
 };
 
 #define hOffset(h, c) ((uint8 *)(h) + HeaderSize + ((c)* (h)->align))
 
+#ifdef kyHasMemoryStats
+#  define block_tag() tag()
+#  define header_tag(h) ((h)->tag)
+#else
+#  define block_tag() ky_memory_stats::Untagged
+#  define header_tag(h) ky_memory_stats::Untagged
+#endif
+
+inline virtual_t *virtual_of(header_t *h)
+{
+    return (virtual_t *)((uint8 *)h - VirtualHead);
+}
+inline int64 virtual_capacity(header_t *h)
+{
+    return (virtual_of(h)->committed - VirtualHead - HeaderSize) / h->align;
+}
+
+//!
+//! \brief virtual_alloc 保留reserve字节的地址空间并提交前commit字节
+//!
+static header_t *virtual_alloc(int64 reserve, int64 commit, int tag)
+{
+    reserve = (int64)kyAlign<kyMmuPageSize>(reserve + VirtualHead);
+    commit = (int64)kyAlign<kyMmuPageSize>(commit + VirtualHead);
+    if (commit > reserve)
+        commit = reserve;
+
+    uint8 *base = (uint8 *)ky_memory::virtual_mem::ReserveAddressSpace(reserve);
+    if (!base)
+        return 0;
+    if (!ky_memory::virtual_mem::Commit(uintptr(base), commit))
+    {
+        ky_memory::virtual_mem::ReleaseAddressSpace(base, reserve);
+        return 0;
+    }
+
+    virtual_t *v = (virtual_t *)base;
+    v->reserved = reserve;
+    v->committed = commit;
+    header_t *h = (header_t *)(base + VirtualHead);
+    h->mode = VirtualBlock;
+#ifdef kyHasMemoryStats
+    h->tag = tag;
+#endif
+    kyMemoryAlloc(tag, commit);
+    kyUnused2(tag);
+    return h;
+}
+static void virtual_free(header_t *h)
+{
+    virtual_t *v = virtual_of(h);
+    kyMemoryFree(header_tag(h), v->committed);
+    ky_memory::virtual_mem::ReleaseAddressSpace(v, v->reserved);
+}
+
+//!
+//! \brief virtual_grow 将虚拟内存块提交到至少byte字节
+//! \note 保留空间内只提交新的页面，地址不变；超出保留空间时迁移到加倍的保留空间
+//!
+static header_t *virtual_grow(header_t *h, int64 byte)
+{
+    virtual_t *v = virtual_of(h);
+    const int64 need = byte + VirtualHead;
+    if (need <= v->committed)
+        return h;
+
+    if (need <= v->reserved)
+    {
+        // 成倍提交，减少系统调用次数
+        int64 want = (int64)kyAlign<kyMmuPageSize>(ky_max(need, v->committed * 2));
+        if (want > v->reserved)
+            want = v->reserved;
+        if (!ky_memory::virtual_mem::Commit(uintptr(v) + v->committed, want - v->committed))
+            return 0;
+        kyMemoryRealloc(header_tag(h), v->committed, want);
+        v->committed = want;
+        return h;
+    }
+
+    header_t *t = virtual_alloc(ky_max(byte, v->reserved * 2), byte, header_tag(h));
+    if (!t)
+        return 0;
+    ky_memory::copy(t, h, HeaderSize + h->end * h->align);
+    virtual_free(h);
+    return t;
+}
+
+inline ky_allocate::arena_dynamic *&arena_of(header_t *h)
+{
+    return *(ky_allocate::arena_dynamic **)((uint8 *)h - ArenaHead);
+}
+
+//!
+//! \brief arena_alloc 从分配区申请内存块，由分配区回退时统一释放，不记账
+//!
+static header_t *arena_alloc(ky_allocate::arena_dynamic *a, int64 byte)
+{
+    uint8 *base = (uint8 *)a->allocate(byte + ArenaHead);
+    if (!base)
+        return 0;
+    header_t *h = (header_t *)(base + ArenaHead);
+    arena_of(h) = a;
+    h->mode = ArenaBlock;
+    return h;
+}
+
+// 新的内存块总是在堆上，只有reserve_arena指定的数组使用分配区
+static header_t *block_alloc(int64 byte, int tag)
+{
+    header_t *h = (header_t *)kyMalloc(byte);
+    if (h)
+    {
+        h->mode = HeapBlock;
+#ifdef kyHasMemoryStats
+        h->tag = tag;
+        h->bytes = byte;
+        kyMemoryAlloc(tag, byte);
+#endif
+    }
+    kyUnused2(tag);
+    return h;
+}
+static header_t *block_realloc(header_t *h, int64 byte)
+{
+    if (h->mode == HeapBlock)
+    {
+#ifdef kyHasMemoryStats
+        const int64 old = h->bytes;
+        header_t *t = (header_t *)kyRealloc(h, byte);
+        if (t)
+        {
+            kyMemoryRealloc(t->tag, old, byte);
+            t->bytes = byte;
+        }
+        return t;
+#else
+        return (header_t *)kyRealloc(h, byte);
+#endif
+    }
+    if (h->mode == VirtualBlock)
+        return virtual_grow(h, byte);
+
+    // 分配区的内存块在同一分配区内增长
+    header_t *t = arena_alloc(arena_of(h), byte);
+    if (!t)
+        return 0;
+    const int64 has = HeaderSize + h->count * h->align;
+    ky_memory::copy(t, h, has < byte ? has : byte);
+    return t;
+}
+static void block_free(header_t *h)
+{
+    if (h->mode == HeapBlock)
+    {
+        kyMemoryFree(header_tag(h), h->bytes);
+        kyFree(h);
+    }
+    else if (h->mode == VirtualBlock)
+        virtual_free(h);
+}
+
 ky_memory::dynarray::dynarray():
     header(nul())
 {
@@ -71,27 +254,61 @@ header_t* ky_memory::dynarray::reserve(int64 size, int align)
 
     if (!is_nul () && (align != old->align))
     {
-        kyFree(old);
+        block_free(old);
         header = nul ();
     }
     // detach
     if (is_nul ())
-        lod = (header_t *)kyMalloc(mem_byte);
+        lod = block_alloc(mem_byte, block_tag());
     else
-        lod = (header_t *)kyRealloc(old, mem_byte);
+        lod = block_realloc(old, mem_byte);
     if (!lod)
         return 0;
 
-    // 初始化内存块头
-    lod->set(ky_ref::ShareableDetach);
-    lod->count = size;
+    // 初始化内存块头，分配区的内存块不共享
+    lod->set(lod->mode == ArenaBlock ? ky_ref::Static : ky_ref::ShareableDetach);
     lod->align = align;
+    lod->count = lod->mode == VirtualBlock ? virtual_capacity(lod) : size;
     lod->begin = lod->end = 0;//(size / 3);
 
     header = lod;
     return old;
 }
 
+bool ky_memory::dynarray::reserve_virtual(int64 size, int align)
+{
+    // 先提交一个较小的初始区，其余页面随增长提交
+    const int64 mem_byte = HeaderSize + size * align;
+    header_t *lod = virtual_alloc(mem_byte, ky_min(mem_byte, (int64)(64 * kyKiB)), block_tag());
+    if (!lod)
+        return false;
+
+    lod->set(ky_ref::ShareableDetach);
+    lod->align = align;
+    lod->count = virtual_capacity(lod);
+    lod->begin = lod->end = 0;
+
+    header = lod;
+    return true;
+}
+
+bool ky_memory::dynarray::reserve_arena(void *arena, int64 size, int align)
+{
+    header_t *lod = arena_alloc((ky_allocate::arena_dynamic *)arena,
+                                ky_memory::block_size(size, align, HeaderSize));
+    if (!lod)
+        return false;
+
+    // 不共享: 复制时按元素复制到堆上，分配区回退后复制品仍然有效
+    lod->set(ky_ref::Static);
+    lod->align = align;
+    lod->count = size;
+    lod->begin = lod->end = 0;
+
+    header = lod;
+    return true;
+}
+
 void ky_memory::dynarray::resize(int64 size, int align)
 {
     if (is_nul ())
@@ -107,7 +324,7 @@ void ky_memory::dynarray::destroy()
 {
     if (!is_nul())
     {
-        kyFree(header);
+        block_free(header);
     }
     header = nul();
 }
@@ -115,12 +332,22 @@ void ky_memory::dynarray::destroy()
 // realloc_grow
 bool ky_memory::dynarray::expand(int64 growth)
 {
+    if (header->mode == VirtualBlock)
+    {
+        header_t *t = virtual_grow(header, HeaderSize + (header->count + growth) * header->align);
+        if (!t)
+            return false;
+        header = t;
+        header->count = virtual_capacity(t);
+        return true;
+    }
+
     int64 elem_count = 0;
     const int64 mem_byte =
             ky_memory::block_growing(header->count + growth,
                                     header->align, HeaderSize, &elem_count);
 
-    header_t *t = (header_t *)kyRealloc(header, mem_byte);
+    header_t *t = block_realloc(header, mem_byte);
     if (!t)
         return false;
     header = t;
@@ -134,18 +361,33 @@ header_t* ky_memory::dynarray::detach(int *idx, int count, int align)
     int64 len = old->end - old->begin;
     int64 new_len = len + count;
     int64 elem_count = 0;
-    int64 mem_byte = ky_memory::block_growing (new_len, align,
-                                               HeaderSize, &elem_count);
+    header_t* t = 0;
 
-    header_t* t = (header_t *)(kyMalloc(mem_byte));
-    if (!t)
-        return 0;
+    // 虚拟内存块分离后仍使用同样大小的保留空间
+    if (old->mode == VirtualBlock)
+    {
+        const int64 mem_byte = HeaderSize + new_len * align;
+        t = virtual_alloc(ky_max(mem_byte, virtual_of(old)->reserved - (int64)VirtualHead),
+                          mem_byte, block_tag());
+        if (!t)
+            return 0;
+        t->align = align;
+        elem_count = virtual_capacity(t);
+    }
+    else
+    {
+        const int64 mem_byte = ky_memory::block_growing (new_len, align,
+                                                         HeaderSize, &elem_count);
+        t = block_alloc(mem_byte, block_tag());
+        if (!t)
+            return 0;
+    }
 
     t->count = elem_count;
     t->set(ky_ref::ShareableDetach);
     t->align = align;
 
-    int begin = 0;
+    int64 begin = 0;
     if (*idx < 0)
     {
         *idx = 0;
@@ -167,11 +409,11 @@ header_t* ky_memory::dynarray::detach(int *idx, int count, int align)
 
 void *ky_memory::dynarray::append(int n)
 {
-    int e = header->end;
+    int64 e = header->end;
     if (e + n > header->count)
     {
-        int b = header->begin;
-        if (b - (int)n >= 2 * (int)header->count / 3)
+        const int64 b = header->begin;
+        if (b - n >= 2 * header->count / 3)
         {
             e -= b;
             ky_memory::copy (hOffset(header, 0), hOffset(header, b),
@@ -188,19 +430,18 @@ void *ky_memory::dynarray::append(int n)
 
 void *ky_memory::dynarray::prepend(int n)
 {
-    if (header->begin == 0 || header->begin < n)
+    if (header->begin < n)
     {
-        if ((header->end +n) >= (header->count / 3))
-            expand(n);
-
-        if ((header->end +n) < (header->count / 3))
-            header->begin = header->count - 2 * (header->end -n);
-        else
-            header->begin = header->count - header->end;
-
-        ky_memory::move (hOffset(header, header->begin), hOffset(header, 0),
-                         header->end * header->align);
-        header->end += header->begin;
+        // 前部空间不足时把元素移到中间，前后各留一半空闲
+        const int64 len = header->end - header->begin;
+        if (len + n > header->count)
+            expand(len + n - header->count);
+
+        const int64 begin = n + ((header->count - len - n) >> 1);
+        ky_memory::move (hOffset(header, begin), hOffset(header, header->begin),
+                         len * header->align);
+        header->begin = begin;
+        header->end = begin + len;
     }
 
     return hOffset(header, (header->begin -= n));
@@ -215,20 +456,11 @@ void *ky_memory::dynarray::insert(int i, int n)
     if (i >= size)
         return append(n);
 
-    bool leftward = false;
-
-    if (header->begin == 0)
-    {
-        if (header->end == header->count)
-            expand(n);
-    }
-    else
-    {
-        if (header->end == header->count)
-            leftward = true;
-        else
-            leftward = (i < size - i);
-    }
+    // 前部空间足够时移动较短的一侧，否则向后移动并在需要时扩容
+    const bool leftward = header->begin >= n &&
+            (header->end + n > header->count || i < size - i);
+    if (!leftward && header->end + n > header->count)
+        expand(header->end + n - header->count);
 
     if (leftward)
     {
@@ -0,0 +1,331 @@
+
+#include "ky_define.h"
+#include "arch/ky_memory.h"
+#include "arch/ky_cpu.h"
+#include <string.h>
+
+#define Have_VectorMemops (kyArchIsX86 && kyArchIs64Bit && (kyCompilerIsGNUC || kyCompilerIsCLANG))
+
+// 阻止编译器在已知长度上限时把libc调用展开成逐字节拷贝
+#if kyCompilerIsGNUC || kyCompilerIsCLANG
+#  define kyNoInline __attribute__((noinline))
+#else
+#  define kyNoInline
+#endif
+
+#if Have_VectorMemops
+#  include <immintrin.h>
+#  define kyTargetAVX2    __attribute__((target("avx2")))
+#  define kyTargetAVX512  __attribute__((target("avx512f")))
+#endif
+
+namespace
+{
+enum
+{
+    NonTemporal = 4 * kyMiB,    ///< 超过此长度使用非临时存储，避免冲刷缓存
+    ShortLength = 1024,         ///< 短于此长度时libc的小块路径更快
+    WideLength = 2048           ///< AVX-512 只用于较长的数据，短数据降频不划算
+};
+
+//! 内存操作函数表，启动后按cpu能力选择一次
+struct mem_ops
+{
+    void *(*copy)(void *dst, const void* src, int64 len);
+    void *(*move)(void *dst, const void* src, int64 len);
+    void  (*zero)(void *dst, int64 len, int fill);
+    int   (*compare)(const void *dst, const void* src, int64 len);
+};
+
+kyNoInline void *libc_copy(void *dst, const void* src, int64 len){return ::memcpy(dst, src, len);}
+kyNoInline void *libc_move(void *dst, const void* src, int64 len){return ::memmove(dst, src, len);}
+kyNoInline void libc_zero(void *dst, int64 len, int fill){::memset(dst, fill, len);}
+kyNoInline int libc_compare(const void *dst, const void* src, int64 len){return ::memcmp(dst, src, len);}
+
+const mem_ops libc_ops = {libc_copy, libc_move, libc_zero, libc_compare};
+
+#if Have_VectorMemops
+//!
+//! \brief avx2_copy 拷贝(允许重叠)
+//! \note 首尾各32字节先读入寄存器最后写出，中间按目标地址对齐后成块拷贝，
+//!       目标在源之后并且重叠时从尾部向前拷贝，短数据直接使用libc
+//!
+kyTargetAVX2 void *avx2_copy(void *dst, const void* src, int64 len)
+{
+    uint8 *d = (uint8 *)dst;
+    const uint8 *s = (const uint8 *)src;
+
+    if (len < ShortLength)
+        return ::memmove(dst, src, len);
+
+    const __m256i head = _mm256_loadu_si256((const __m256i *)s);
+    const __m256i tail = _mm256_loadu_si256((const __m256i *)(s + len - 32));
+    const bool overlap = uint64(d - s) < uint64(len) || uint64(s - d) < uint64(len);
+
+    if (uint64(d - s) < uint64(len))
+    {
+        // 目标在源之后，从尾部向前
+        uint8 *de = d + len;
+        const uint8 *se = s + len;
+        const int64 skip = int64(uintptr(de) & 31);
+        int64 n = len - skip;
+        de -= skip;
+        se -= skip;
+        for (; n > 128; n -= 128)
+        {
+            se -= 128;
+            de -= 128;
+            const __m256i v0 = _mm256_loadu_si256((const __m256i *)(se + 96));
+            const __m256i v1 = _mm256_loadu_si256((const __m256i *)(se + 64));
+            const __m256i v2 = _mm256_loadu_si256((const __m256i *)(se + 32));
+            const __m256i v3 = _mm256_loadu_si256((const __m256i *)se);
+            _mm256_store_si256((__m256i *)(de + 96), v0);
+            _mm256_store_si256((__m256i *)(de + 64), v1);
+            _mm256_store_si256((__m256i *)(de + 32), v2);
+            _mm256_store_si256((__m256i *)de, v3);
+        }
+        for (; n > 32; n -= 32)
+        {
+            se -= 32;
+            de -= 32;
+            _mm256_store_si256((__m256i *)de, _mm256_loadu_si256((const __m256i *)se));
+        }
+    }
+    else
+    {
+        const int64 skip = 32 - int64(uintptr(d) & 31);
+        int64 n = len - skip;
+        uint8 *dp = d + skip;
+        const uint8 *sp = s + skip;
+        if (n >= NonTemporal && !overlap)
+        {
+            for (; n > 128; n -= 128, sp += 128, dp += 128)
+            {
+                const __m256i v0 = _mm256_loadu_si256((const __m256i *)sp);
+                const __m256i v1 = _mm256_loadu_si256((const __m256i *)(sp + 32));
+                const __m256i v2 = _mm256_loadu_si256((const __m256i *)(sp + 64));
+                const __m256i v3 = _mm256_loadu_si256((const __m256i *)(sp + 96));
+                _mm256_stream_si256((__m256i *)dp, v0);
+                _mm256_stream_si256((__m256i *)(dp + 32), v1);
+                _mm256_stream_si256((__m256i *)(dp + 64), v2);
+                _mm256_stream_si256((__m256i *)(dp + 96), v3);
+            }
+            _mm_sfence();
+        }
+        for (; n > 128; n -= 128, sp += 128, dp += 128)
+        {
+            const __m256i v0 = _mm256_loadu_si256((const __m256i *)sp);
+            const __m256i v1 = _mm256_loadu_si256((const __m256i *)(sp + 32));
+            const __m256i v2 = _mm256_loadu_si256((const __m256i *)(sp + 64));
+            const __m256i v3 = _mm256_loadu_si256((const __m256i *)(sp + 96));
+            _mm256_store_si256((__m256i *)dp, v0);
+            _mm256_store_si256((__m256i *)(dp + 32), v1);
+            _mm256_store_si256((__m256i *)(dp + 64), v2);
+            _mm256_store_si256((__m256i *)(dp + 96), v3);
+        }
+        for (; n > 32; n -= 32, sp += 32, dp += 32)
+            _mm256_store_si256((__m256i *)dp, _mm256_loadu_si256((const __m256i *)sp));
+    }
+
+    _mm256_storeu_si256((__m256i *)(d + len - 32), tail);
+    _mm256_storeu_si256((__m256i *)d, head);
+    return dst;
+}
+
+kyTargetAVX2 void avx2_zero(void *dst, int64 len, int fill)
+{
+    if (len < ShortLength)
+    {
+        ::memset(dst, fill, len);
+        return;
+    }
+
+    uint8 *d = (uint8 *)dst;
+    const __m256i v = _mm256_set1_epi8((char)fill);
+    _mm256_storeu_si256((__m256i *)d, v);
+    _mm256_storeu_si256((__m256i *)(d + len - 32), v);
+
+    const int64 skip = 32 - int64(uintptr(d) & 31);
+    int64 n = len - skip;
+    uint8 *dp = d + skip;
+    if (n >= NonTemporal)
+    {
+        for (; n > 128; n -= 128, dp += 128)
+        {
+            _mm256_stream_si256((__m256i *)dp, v);
+            _mm256_stream_si256((__m256i *)(dp + 32), v);
+            _mm256_stream_si256((__m256i *)(dp + 64), v);
+            _mm256_stream_si256((__m256i *)(dp + 96), v);
+        }
+        _mm_sfence();
+    }
+    for (; n > 32; n -= 32, dp += 32)
+        _mm256_store_si256((__m256i *)dp, v);
+}
+
+kyTargetAVX2 int avx2_compare(const void *dst, const void* src, int64 len)
+{
+    if (len < ShortLength)
+        return ::memcmp(dst, src, len);
+
+    const uint8 *a = (const uint8 *)dst;
+    const uint8 *b = (const uint8 *)src;
+    for (; len >= 32; len -= 32, a += 32, b += 32)
+    {
+        const __m256i va = _mm256_loadu_si256((const __m256i *)a);
+        const __m256i vb = _mm256_loadu_si256((const __m256i *)b);
+        const uint mask = (uint)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+        if (mask != 0xffffffffu)
+        {
+            const int i = __builtin_ctz(~mask);
+            return int(a[i]) - int(b[i]);
+        }
+    }
+    return len ? ::memcmp(a, b, len) : 0;
+}
+
+//!
+//! \brief avx512_copy 长数据的拷贝(允许重叠)，短数据和重叠时使用avx2_copy
+//!
+kyTargetAVX512 void *avx512_copy(void *dst, const void* src, int64 len)
+{
+    uint8 *d = (uint8 *)dst;
+    const uint8 *s = (const uint8 *)src;
+    if (len < WideLength || uint64(d - s) < uint64(len) || uint64(s - d) < uint64(len))
+        return avx2_copy(dst, src, len);
+
+    const __m512i head = _mm512_loadu_si512(s);
+    const __m512i tail = _mm512_loadu_si512(s + len - 64);
+    const int64 skip = 64 - int64(uintptr(d) & 63);
+    int64 n = len - skip;
+    uint8 *dp = d + skip;
+    const uint8 *sp = s + skip;
+    if (n >= NonTemporal)
+    {
+        for (; n > 256; n -= 256, sp += 256, dp += 256)
+        {
+            const __m512i v0 = _mm512_loadu_si512(sp);
+            const __m512i v1 = _mm512_loadu_si512(sp + 64);
+            const __m512i v2 = _mm512_loadu_si512(sp + 128);
+            const __m512i v3 = _mm512_loadu_si512(sp + 192);
+            _mm512_stream_si512((__m512i *)dp, v0);
+            _mm512_stream_si512((__m512i *)(dp + 64), v1);
+            _mm512_stream_si512((__m512i *)(dp + 128), v2);
+            _mm512_stream_si512((__m512i *)(dp + 192), v3);
+        }
+        _mm_sfence();
+    }
+    for (; n > 256; n -= 256, sp += 256, dp += 256)
+    {
+        const __m512i v0 = _mm512_loadu_si512(sp);
+        const __m512i v1 = _mm512_loadu_si512(sp + 64);
+        const __m512i v2 = _mm512_loadu_si512(sp + 128);
+        const __m512i v3 = _mm512_loadu_si512(sp + 192);
+        _mm512_store_si512(dp, v0);
+        _mm512_store_si512(dp + 64, v1);
+        _mm512_store_si512(dp + 128, v2);
+        _mm512_store_si512(dp + 192, v3);
+    }
+    for (; n > 64; n -= 64, sp += 64, dp += 64)
+        _mm512_store_si512(dp, _mm512_loadu_si512(sp));
+
+    _mm512_storeu_si512(d + len - 64, tail);
+    _mm512_storeu_si512(d, head);
+    return dst;
+}
+
+kyTargetAVX512 void avx512_zero(void *dst, int64 len, int fill)
+{
+    if (len < WideLength)
+    {
+        avx2_zero(dst, len, fill);
+        return;
+    }
+
+    uint8 *d = (uint8 *)dst;
+    // 无符号相乘，fill>=0x80时int相乘会溢出
+    const __m512i v = _mm512_set1_epi32(int(uint32(uint8(fill)) * 0x01010101u));
+    _mm512_storeu_si512(d, v);
+    _mm512_storeu_si512(d + len - 64, v);
+
+    const int64 skip = 64 - int64(uintptr(d) & 63);
+    int64 n = len - skip;
+    uint8 *dp = d + skip;
+    if (n >= NonTemporal)
+    {
+        for (; n > 256; n -= 256, dp += 256)
+        {
+            _mm512_stream_si512((__m512i *)dp, v);
+            _mm512_stream_si512((__m512i *)(dp + 64), v);
+            _mm512_stream_si512((__m512i *)(dp + 128), v);
+            _mm512_stream_si512((__m512i *)(dp + 192), v);
+        }
+        _mm_sfence();
+    }
+    for (; n > 64; n -= 64, dp += 64)
+        _mm512_store_si512(dp, v);
+}
+
+// 比较需要AVX512BW，使用AVX2版本
+const mem_ops avx2_ops = {avx2_copy, avx2_copy, avx2_zero, avx2_compare};
+const mem_ops avx512_ops = {avx512_copy, avx512_copy, avx512_zero, avx2_compare};
+#endif
+
+const mem_ops *current_ops = 0;
+
+//!
+//! \brief select_ops 根据cpu能力选择函数表
+//! \note ky_cpu初始化时可能再次调用ky_memory，此时先使用libc
+//!
+const mem_ops *select_ops()
+{
+    static bool busy = false;
+    if (busy)
+        return &libc_ops;
+    busy = true;
+
+    const mem_ops *ops = &libc_ops;
+#if Have_VectorMemops
+    if (ky_cpu::has(CPU_OSE) && ky_cpu::has(CPU_AVX2))
+        ops = ky_cpu::has(CPU_AVX512F) ? &avx512_ops : &avx2_ops;
+#endif
+    current_ops = ops;
+    busy = false;
+    return ops;
+}
+
+inline const mem_ops *ops()
+{
+    const mem_ops *o = current_ops;
+    return kyLikely(o != 0) ? o : select_ops();
+}
+
+}
+
+// 短数据不经过函数表，避免间接调用的开销
+void *ky_memory::copy(void *dst, const void* src, int64 len)
+{
+    if (len < ShortLength)
+        return libc_copy(dst, src, len);
+    return ops()->copy(dst, src, len);
+}
+void *ky_memory::move(void *dst, const void* src, int64 len)
+{
+    if (len < ShortLength)
+        return libc_move(dst, src, len);
+    return ops()->move(dst, src, len);
+}
+void ky_memory::zero(void *dst, int64 len, int fill)
+{
+    if (len < ShortLength)
+        libc_zero(dst, len, fill);
+    else
+        ops()->zero(dst, len, fill);
+}
+
+int ky_memory::compare(const void *dst, const void* src, int64 len)
+{
+    if (len < ShortLength)
+        return libc_compare(dst, src, len);
+    return ops()->compare(dst, src, len);
+}
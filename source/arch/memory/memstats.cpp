@@ -0,0 +1,270 @@
+#include "ky_define.h"
+#include "ky_memory.h"
+#include "arch/ky_atomic.h"
+#include <sched.h>
+#include <string.h>
+
+namespace
+{
+//! 标记的计数
+struct stats_tag
+{
+    const char       *name;
+    ky_atomic<int64>  live;
+    ky_atomic<int64>  peak;
+    ky_atomic<int64>  allocs;
+    ky_atomic<int64>  frees;
+    ky_atomic<int64>  reallocs;
+    ky_atomic<int64>  histogram[ky_memory_stats::Histogram];
+};
+
+const char *const builtin_name[ky_memory_stats::Builtin] =
+{
+    "untagged",
+    "ky_array",
+    "ky_list",
+    "ky_hash",
+    "ky_map",
+    "ky_image"
+};
+
+stats_tag        tags[ky_memory_stats::MaxTags];
+volatile int     tag_count = ky_memory_stats::Builtin;
+ky_atomic<int>   tag_lock;
+
+inline void tag_acquire()
+{
+    while (!tag_lock.compare_exchange(0, 1))
+        ::sched_yield();
+}
+inline void tag_release(){tag_lock.store(0, Fence_Release);}
+
+inline stats_tag &tag_of(int tag)
+{
+    return tags[(tag < 0 || tag >= ky_memory_stats::MaxTags) ? 0 : tag];
+}
+
+//! 尺寸所在的直方图级别: <=16为0级，之后每倍增一级
+inline int histogram_of(int64 size)
+{
+    if (size <= 16)
+        return 0;
+    const uint64 s = uint64(size -1);
+#if kyCompilerIsGNUC || kyCompilerIsCLANG
+    const int lg = 64 - __builtin_clzll(s);
+#else
+    int lg = 0;
+    while ((s >> lg) != 0)
+        ++lg;
+#endif
+    return lg - 4 < ky_memory_stats::Histogram ? lg - 4 : ky_memory_stats::Histogram -1;
+}
+
+inline void raise_peak(stats_tag &t, int64 live)
+{
+    int64 p = t.peak.load();
+    while (live > p && !t.peak.compare_exchange(p, live))
+        p = t.peak.load();
+}
+}
+
+int ky_memory_stats::tag(const char *name)
+{
+    if (!name)
+        return Untagged;
+
+    tag_acquire();
+    for (int i = 0; i < tag_count; ++i)
+    {
+        const char *n = i < Builtin ? builtin_name[i] : tags[i].name;
+        if (::strcmp(n, name) == 0)
+        {
+            tag_release();
+            return i;
+        }
+    }
+
+    int id = Untagged;
+    if (tag_count < MaxTags)
+    {
+        id = tag_count;
+        tags[id].name = kyStrdup(name);
+        atomic_base::store(tag_count, id +1, Fence_Release);
+    }
+    tag_release();
+    return id;
+}
+
+int ky_memory_stats::site(const char *file, int line)
+{
+    char name[256];
+    const char *base = file ? ::strrchr(file, '/') : 0;
+    ::snprintf(name, sizeof(name), "%s:%d", base ? base +1 : (file ? file : "?"), line);
+    return tag(name);
+}
+
+void ky_memory_stats::alloc(int tag, int64 size)
+{
+    stats_tag &t = tag_of(tag);
+    t.allocs.fetch_add(1);
+    t.histogram[histogram_of(size)].fetch_add(1);
+    raise_peak(t, t.live.fetch_add(size) + size);
+}
+
+void ky_memory_stats::destroy(int tag, int64 size)
+{
+    stats_tag &t = tag_of(tag);
+    t.frees.fetch_add(1);
+    t.live.fetch_add(-size);
+}
+
+void ky_memory_stats::realloc(int tag, int64 old, int64 size)
+{
+    stats_tag &t = tag_of(tag);
+    t.reallocs.fetch_add(1);
+    t.histogram[histogram_of(size)].fetch_add(1);
+    raise_peak(t, t.live.fetch_add(size - old) + size - old);
+}
+
+int ky_memory_stats::snapshot(counter *out, int max)
+{
+    const int count = atomic_base::load(tag_count, Fence_Acquire);
+    const int n = max < count ? max : count;
+    for (int i = 0; i < n; ++i)
+    {
+        stats_tag &t = tags[i];
+        counter &c = out[i];
+        c.name = i < Builtin ? builtin_name[i] : t.name;
+        c.live = t.live.load();
+        c.peak = t.peak.load();
+        c.allocs = t.allocs.load();
+        c.frees = t.frees.load();
+        c.reallocs = t.reallocs.load();
+        for (int k = 0; k < Histogram; ++k)
+            c.histogram[k] = t.histogram[k].load();
+    }
+    return n;
+}
+
+void ky_memory_stats::reset_peak()
+{
+    const int n = atomic_base::load(tag_count, Fence_Acquire);
+    for (int i = 0; i < n; ++i)
+        tags[i].peak.store(tags[i].live.load());
+}
+
+#if defined(kyHasMemoryStats) && (kyLanguage >= kyLanguage11)
+//!
+//! kyNew申请的对象记录表，按地址分片加锁
+//!
+namespace
+{
+enum
+{
+    SiteShards = 64,
+    SiteBuckets = 1024
+};
+
+struct site_entry
+{
+    void       *ptr;
+    int64       size;
+    int         site;
+    site_entry *next;
+};
+
+struct site_shard
+{
+    ky_atomic<int> lock;
+    site_entry    *bucket[SiteBuckets];
+
+    void acquire()
+    {
+        while (!lock.compare_exchange(0, 1))
+            ::sched_yield();
+    }
+    void release(){lock.store(0, Fence_Release);}
+};
+
+site_shard shards[SiteShards];
+
+inline uint64 site_hash(const void *p)
+{
+    return uint64(uintptr(p) >> 4) * 0x9E3779B97F4A7C15ull;
+}
+}
+
+int ky_memory_site(const char *file, int line)
+{
+    return ky_memory_stats::site(file, line);
+}
+
+void ky_memory_track(void *p, long long size, int site)
+{
+    if (!p)
+        return ;
+
+    const uint64 h = site_hash(p);
+    site_shard &s = shards[(h >> 32) % SiteShards];
+    site_entry *&head = s.bucket[(h >> 16) % SiteBuckets];
+    site_entry *stale = 0;
+
+    s.acquire();
+    // 同一地址仍在表中说明上次释放没有经过kyDelete，按已释放处理
+    for (site_entry *e = head; e; e = e->next)
+        if (e->ptr == p)
+        {
+            stale = e;
+            break;
+        }
+    site_entry old = {};
+    if (stale)
+        old = *stale;
+    else
+    {
+        stale = (site_entry *)::malloc(sizeof(site_entry));
+        if (!stale)
+        {
+            s.release();
+            return ;
+        }
+        stale->ptr = p;
+        stale->next = head;
+        head = stale;
+    }
+    stale->size = size;
+    stale->site = site;
+    s.release();
+
+    if (old.ptr)
+        ky_memory_stats::destroy(old.site, old.size);
+    ky_memory_stats::alloc(site, size);
+}
+
+void ky_memory_untrack(void *p)
+{
+    if (!p)
+        return ;
+
+    const uint64 h = site_hash(p);
+    site_shard &s = shards[(h >> 32) % SiteShards];
+    site_entry **link = &s.bucket[(h >> 16) % SiteBuckets];
+    site_entry *found = 0;
+
+    s.acquire();
+    for (; *link; link = &(*link)->next)
+        if ((*link)->ptr == p)
+        {
+            found = *link;
+            *link = found->next;
+            break;
+        }
+    s.release();
+
+    if (found)
+    {
+        ky_memory_stats::destroy(found->site, found->size);
+        ::free(found);
+    }
+}
+#endif
@@ -0,0 +1,368 @@
+
+#include "ky_define.h"
+#include "ky_memory.h"
+#include "arch/ky_atomic.h"
+#include <pthread.h>
+#include <sched.h>
+
+namespace
+{
+enum
+{
+    HeaderSize = 64,                ///< 块头大小，保证块内数据按缓存行对齐
+    ClassCount = 28,                ///< 尺寸级别数: 16-128每16一级，之后每倍增4级
+    BatchCount = 32,                ///< 线程缓存和全局链表每次交换的个数
+    CacheLimit = BatchCount * 2,    ///< 线程缓存每级最多保留的个数
+    LargeHeader = 16,               ///< 大内存头大小，保持malloc的16字节对齐
+    MapLeafBits = 16,               ///< 登记表每个叶子覆盖的块数(4G地址)
+    MapRootBits = 16                ///< 登记表根的项数，共覆盖48位地址
+};
+
+//! 块头，位于64K对齐的块起始处
+struct slab_span
+{
+    int32 cls;                      ///< 尺寸级别
+    int64 size;                     ///< 级别尺寸
+};
+
+//! 大内存头，位于返回地址之前
+struct slab_large
+{
+    int64 size;                     ///< 申请尺寸
+    int64 pad;
+};
+
+//! 全局空闲链表(每级一个)
+struct slab_central
+{
+    ky_atomic<int> lock;
+    void          *head;
+    int64          count;
+    char           pad[kyCpuCacheLineSize - sizeof(ky_atomic<int>) - sizeof(void*) - sizeof(int64)];
+
+    void acquire()
+    {
+        while (!lock.compare_exchange(0, 1))
+            ::sched_yield();
+    }
+    void release(){lock.store(0, Fence_Release);}
+};
+
+//! 线程缓存
+struct slab_cache
+{
+    void *head[ClassCount];
+    int   count[ClassCount];
+};
+
+slab_central      central[ClassCount];
+__thread slab_cache *tls_cache = 0;
+pthread_key_t     cache_key;
+pthread_once_t    cache_once = PTHREAD_ONCE_INIT;
+
+inline void *&next_of(void *p){return *(void**)p;}
+
+//! 分级块登记表: 以块序号为下标的两级位图，块不会归还系统所以只置位
+uint64 *volatile span_map[1 << MapRootBits];
+
+bool span_register(const void *span)
+{
+    const uint64 n = uint64(uintptr(span)) / ky_slab::SpanSize;
+    if (n >> (MapLeafBits + MapRootBits))
+        return false;
+
+    uint64 *volatile &slot = span_map[n >> MapLeafBits];
+    uint64 *leaf = atomic_base::load(slot, Fence_Acquire);
+    if (leaf == 0)
+    {
+        leaf = (uint64 *)::calloc(1, (1 << MapLeafBits) / 8);
+        if (leaf == 0)
+            return false;
+        if (!atomic_base::compare_exchange(slot, (uint64 *)0, leaf))
+        {
+            ::free(leaf);
+            leaf = atomic_base::load(slot, Fence_Acquire);
+        }
+    }
+
+    const uint64 bit = n & ((1 << MapLeafBits) -1);
+    volatile uint64 &word = leaf[bit >> 6];
+    uint64 old;
+    do
+        old = word;
+    while (!atomic_base::compare_exchange(word, old, old | (uint64(1) << (bit & 63))));
+    return true;
+}
+
+//! 是否为分级块中的内存，否则为大内存
+inline bool is_span(const void *p)
+{
+    const uint64 n = uint64(uintptr(p)) / ky_slab::SpanSize;
+    if (n >> (MapLeafBits + MapRootBits))
+        return false;
+    const uint64 *leaf = span_map[n >> MapLeafBits];
+    const uint64 bit = n & ((1 << MapLeafBits) -1);
+    return leaf && ((leaf[bit >> 6] >> (bit & 63)) & 1);
+}
+
+inline slab_large *large_of(const void *p)
+{
+    return (slab_large *)((uint8 *)p - LargeHeader);
+}
+
+inline int size_class(int64 size)
+{
+    if (size <= 128)
+        return size <= 16 ? 0 : int((size + 15) >> 4) -1;
+
+    const uint64 s = uint64(size -1);
+#if kyCompilerIsGNUC || kyCompilerIsCLANG
+    const int lg = 63 - __builtin_clzll(s);
+#else
+    int lg = 0;
+    while ((s >> (lg +1)) != 0)
+        ++lg;
+#endif
+    return 8 + (lg - 7) * 4 + int((s >> (lg -2)) & 3);
+}
+
+inline int64 class_size(int cls)
+{
+    if (cls < 8)
+        return int64(cls +1) * 16;
+    const int64 base = int64(128) << ((cls - 8) >> 2);
+    return base + int64(((cls - 8) & 3) +1) * (base >> 2);
+}
+
+inline slab_span *span_of(const void *p)
+{
+    return (slab_span *)(uintptr(p) & ~uintptr(ky_slab::SpanSize -1));
+}
+
+//!
+//! \brief give_back 将链表中的n个节点归还到全局链表
+//!
+void give_back(int cls, void *head, void *tail, int64 n)
+{
+    slab_central &c = central[cls];
+    c.acquire();
+    next_of(tail) = c.head;
+    c.head = head;
+    c.count += n;
+    c.release();
+}
+
+//!
+//! \brief carve 申请新块并切分为空闲链表
+//!
+void *carve(int cls, void **tail, int64 *n)
+{
+    slab_span *span = (slab_span *)ky_memory::aligned_alloc(ky_slab::SpanSize, ky_slab::SpanSize);
+    if (span == 0)
+        return 0;
+    if (!span_register(span))
+    {
+        ky_memory::aligned_free(span);
+        return 0;
+    }
+
+    const int64 size = class_size(cls);
+    span->cls = cls;
+    span->size = size;
+
+    uint8 *first = (uint8*)span + HeaderSize;
+    const int64 cnt = (ky_slab::SpanSize - HeaderSize) / size;
+    uint8 *cur = first;
+    for (int64 i = 0; i < cnt -1; ++i, cur += size)
+        next_of(cur) = cur + size;
+    next_of(cur) = 0;
+    *tail = cur;
+    *n = cnt;
+    return first;
+}
+
+void refill(slab_cache *cache, int cls)
+{
+    slab_central &c = central[cls];
+    void *head = 0;
+    int64 n = 0;
+
+    c.acquire();
+    if (c.count > 0)
+    {
+        head = c.head;
+        void *cur = head;
+        for (n = 1; n < BatchCount && next_of(cur); ++n)
+            cur = next_of(cur);
+        c.head = next_of(cur);
+        c.count -= n;
+        next_of(cur) = 0;
+    }
+    c.release();
+
+    if (head == 0)
+    {
+        void *tail = 0;
+        int64 total = 0;
+        head = carve(cls, &tail, &total);
+        if (head == 0)
+            return;
+
+        // 多余的部分放入全局链表
+        n = total;
+        if (total > BatchCount)
+        {
+            void *cur = head;
+            for (int64 i = 1; i < BatchCount; ++i)
+                cur = next_of(cur);
+            void *rest = next_of(cur);
+            next_of(cur) = 0;
+            give_back(cls, rest, tail, total - BatchCount);
+            n = BatchCount;
+        }
+    }
+
+    cache->head[cls] = head;
+    cache->count[cls] = (int)n;
+}
+
+//!
+//! \brief drain 将线程缓存的cls级保留keep个，其余归还
+//!
+void drain(slab_cache *cache, int cls, int keep)
+{
+    const int n = cache->count[cls] - keep;
+    if (n <= 0)
+        return;
+
+    void *head = cache->head[cls];
+    void *tail = head;
+    for (int i = 1; i < n; ++i)
+        tail = next_of(tail);
+    cache->head[cls] = next_of(tail);
+    cache->count[cls] = keep;
+    give_back(cls, head, tail, n);
+}
+
+void cache_release(void *p)
+{
+    slab_cache *cache = (slab_cache *)p;
+    for (int i = 0; i < ClassCount; ++i)
+        drain(cache, i, 0);
+    tls_cache = 0;
+    ::free(cache);
+}
+
+void cache_key_init()
+{
+    ::pthread_key_create(&cache_key, cache_release);
+}
+
+inline slab_cache *cache_get()
+{
+    slab_cache *cache = tls_cache;
+    if (kyLikely(cache))
+        return cache;
+
+    ::pthread_once(&cache_once, cache_key_init);
+    cache = (slab_cache *)::calloc(1, sizeof(slab_cache));
+    if (cache == 0)
+        return 0;
+    ::pthread_setspecific(cache_key, cache);
+    tls_cache = cache;
+    return cache;
+}
+
+}
+
+void *ky_slab::alloc(int64 size)
+{
+    if (kyUnLikely(size > MaxSmall))
+    {
+        // 大内存不需要块对齐，直接申请并在前面记录尺寸
+        slab_large *large = (slab_large *)kyMalloc(size + LargeHeader);
+        if (large == 0)
+            return 0;
+        large->size = size;
+        return (uint8*)large + LargeHeader;
+    }
+
+    slab_cache *cache = cache_get();
+    if (kyUnLikely(cache == 0))
+        return 0;
+
+    const int cls = size_class(size);
+    void *p = cache->head[cls];
+    if (kyUnLikely(p == 0))
+    {
+        refill(cache, cls);
+        p = cache->head[cls];
+        if (p == 0)
+            return 0;
+    }
+    cache->head[cls] = next_of(p);
+    --cache->count[cls];
+    return p;
+}
+
+void ky_slab::destroy(void *mem)
+{
+    if (mem == 0)
+        return;
+
+    if (kyUnLikely(!is_span(mem)))
+    {
+        kyFree(large_of(mem));
+        return;
+    }
+
+    slab_span *span = span_of(mem);
+
+    slab_cache *cache = cache_get();
+    const int cls = span->cls;
+    if (kyUnLikely(cache == 0))
+    {
+        give_back(cls, mem, mem, 1);
+        return;
+    }
+
+    next_of(mem) = cache->head[cls];
+    cache->head[cls] = mem;
+    if (kyUnLikely(++cache->count[cls] > CacheLimit))
+        drain(cache, cls, BatchCount);
+}
+
+void *ky_slab::realloc(void *mem, int64 size)
+{
+    if (mem == 0)
+        return alloc(size);
+
+    const int64 has = usable(mem);
+    if (size <= has)
+        return mem;
+
+    void *p = alloc(size);
+    if (p == 0)
+        return 0;
+    ky_memory::copy(p, mem, has);
+    destroy(mem);
+    return p;
+}
+
+int64 ky_slab::usable(const void *mem)
+{
+    if (mem == 0)
+        return 0;
+    if (kyUnLikely(!is_span(mem)))
+        return large_of(mem)->size;
+    return span_of(mem)->size;
+}
+
+void ky_slab::flush()
+{
+    slab_cache *cache = tls_cache;
+    if (cache == 0)
+        return;
+    for (int i = 0; i < ClassCount; ++i)
+        drain(cache, i, 0);
+}
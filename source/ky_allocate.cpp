@@ -1,2 +1,121 @@
 
 #include "ky_allocate.h"
+#include <stdlib.h>
+
+namespace
+{
+__thread ky_allocate::arena_dynamic *tls_arena = 0;
+}
+
+ky_allocate::arena_dynamic *ky_allocate::current()
+{
+    return tls_arena;
+}
+
+ky_allocate::arena_bind::arena_bind(arena_dynamic &a, bool rewind):
+    owner(&a),
+    prev(tls_arena),
+    where(a.mark()),
+    is_rewind(rewind)
+{
+    tls_arena = owner;
+}
+ky_allocate::arena_bind::~arena_bind()
+{
+    tls_arena = prev;
+    if (is_rewind)
+        owner->rewind(where);
+}
+
+ky_allocate::arena_dynamic::arena_dynamic(uint64 size):
+    chunkSize(size),
+    head(0),
+    spare(0)
+{
+}
+
+ky_allocate::arena_dynamic::~arena_dynamic()
+{
+    while (head)
+    {
+        chunk *n = head->next;
+        ::free(head);
+        head = n;
+    }
+    ::free(spare);
+}
+
+void *ky_allocate::arena_dynamic::allocate_chunk(uint64 size, uint64 align)
+{
+    const uint64 cap = ky_max(chunkSize, size + align);
+    chunk *c = 0;
+    if (spare && spare->capacity >= cap)
+    {
+        c = spare;
+        spare = 0;
+    }
+    else
+    {
+        c = (chunk *)::malloc(sizeof(chunk) + cap);
+        if (c == 0)
+            return 0;
+        c->capacity = cap;
+    }
+    c->end = 0;
+    c->next = head;
+    head = c;
+
+    const uintptr cur = uintptr(c->storage());
+    const uint64 pad = ((cur + align -1) & ~uintptr(align -1)) - cur;
+    c->end = pad + size;
+    return (void*)(cur + pad);
+}
+
+void ky_allocate::arena_dynamic::rewind(const marker &m)
+{
+    // 释放标记之后申请的块，保留一块以便下次使用
+    while (head && head != m.head)
+    {
+        chunk *n = head->next;
+        if (spare == 0 || spare->capacity < head->capacity)
+        {
+            ::free(spare);
+            spare = head;
+        }
+        else
+            ::free(head);
+        head = n;
+    }
+    if (head && m.end < head->end)
+        head->end = m.end;
+}
+
+void ky_allocate::arena_dynamic::reset()
+{
+    while (head && head->next)
+    {
+        chunk *n = head->next;
+        ::free(head);
+        head = n;
+    }
+    if (head)
+        head->end = 0;
+}
+
+uint64 ky_allocate::arena_dynamic::used() const
+{
+    uint64 n = 0;
+    for (chunk *c = head; c; c = c->next)
+        n += c->end;
+    return n;
+}
+
+bool ky_allocate::arena_dynamic::contains(const void *p) const
+{
+    for (chunk *c = head; c; c = c->next)
+    {
+        if ((uintptr(p) - uintptr(c->storage())) < c->end)
+            return true;
+    }
+    return false;
+}
@@ -2,6 +2,7 @@
 #include "tools/ky_datetime.h"
 #include "io/generic_io.h"
 #include "ky_hooks.h"
+#include "arch/ky_memory.h"
 
 #include <errno.h>
 #include <pthread.h>
@@ -951,3 +952,111 @@ void ky_debug::formats(const char *file, int line, const char *func,
 
     errno = saved_errno;
 }
+
+void ky_debug::memory(eLogLevels level)
+{
+#ifdef kyHasMemoryStats
+    ky_memory_stats::counter *c = (ky_memory_stats::counter *)
+            kyMalloc(sizeof(ky_memory_stats::counter) * ky_memory_stats::MaxTags);
+    if (!c)
+        return ;
+    const int n = ky_memory_stats::snapshot(c, ky_memory_stats::MaxTags);
+    int64 live = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        if (!c[i].allocs && !c[i].reallocs)
+            continue;
+        live += c[i].live;
+        ky_log_printf(level, "memory %-24s live %lld peak %lld allocs %lld frees %lld reallocs %lld",
+                      c[i].name, (long long)c[i].live, (long long)c[i].peak,
+                      (long long)c[i].allocs, (long long)c[i].frees, (long long)c[i].reallocs);
+
+        // 直方图只打印非零的级别，最后一级为大于256K
+        char line[512];
+        int len = 0;
+        for (int k = 0; k < ky_memory_stats::Histogram && len < (int)sizeof(line); ++k)
+        {
+            if (!c[i].histogram[k])
+                continue;
+            if (k == ky_memory_stats::Histogram -1)
+                len += ::snprintf(line + len, sizeof(line) - len, " >%lld:%lld",
+                                  (long long)(int64(16) << (k -1)), (long long)c[i].histogram[k]);
+            else
+                len += ::snprintf(line + len, sizeof(line) - len, " <=%lld:%lld",
+                                  (long long)(int64(16) << k), (long long)c[i].histogram[k]);
+        }
+        if (len)
+            ky_log_printf(level, "memory %-24s histogram%s", c[i].name, line);
+    }
+    ky_log_printf(level, "memory total live %lld", (long long)live);
+    kyFree(c);
+#else
+    ky_log_printf(level, "memory stats disabled, define kyHasMemoryStats to enable");
+#endif
+}
+
+//! 定时打印内存记账的后台线程
+static struct memory_dump
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    pthread_t       thread;
+    bool            running;
+    int64           interval;
+    eLogLevels      level;
+
+    memory_dump():
+        running(false), interval(0), level(Log_Info)
+    {
+        pthread_mutex_init(&mutex, 0);
+        pthread_cond_init(&cond, 0);
+    }
+
+    static void *run(void *p)
+    {
+        memory_dump *md = (memory_dump *)p;
+        pthread_mutex_lock(&md->mutex);
+        while (md->interval > 0)
+        {
+            struct timespec ts;
+            ::clock_gettime(CLOCK_REALTIME, &ts);
+            const int64 ns = ts.tv_nsec + (md->interval % 1000) * 1000000;
+            ts.tv_sec += md->interval / 1000 + ns / 1000000000;
+            ts.tv_nsec = ns % 1000000000;
+            if (pthread_cond_timedwait(&md->cond, &md->mutex, &ts) != ETIMEDOUT)
+                continue;
+
+            const eLogLevels lv = md->level;
+            pthread_mutex_unlock(&md->mutex);
+            ky_debug::memory(lv);
+            pthread_mutex_lock(&md->mutex);
+        }
+        pthread_mutex_unlock(&md->mutex);
+        return 0;
+    }
+
+    void stop()
+    {
+        pthread_mutex_lock(&mutex);
+        interval = 0;
+        pthread_cond_signal(&cond);
+        pthread_mutex_unlock(&mutex);
+        if (running)
+            pthread_join(thread, 0);
+        running = false;
+    }
+    void start(int64 ms, eLogLevels lv)
+    {
+        stop();
+        if (ms <= 0)
+            return ;
+        interval = ms;
+        level = lv;
+        running = pthread_create(&thread, 0, run, this) == 0;
+    }
+}__memory_dump;
+
+void ky_debug::memory_periodic(int64 ms, eLogLevels level)
+{
+    __memory_dump.start(ms, level);
+}
@@ -31,6 +31,10 @@ ky_object::ky_object(ky_object *parent):
 }
 ky_object::~ky_object()
 {
+    // 时间轮和异步IO中不能再留有本对象
+    ky_thread *cur = impl->thread;
+    if (cur && cur->dispatch)
+        cur->dispatch->release(this);
     if (impl->parent)
         impl->parent->remove (this);
     kyDelete(impl);
@@ -77,6 +81,33 @@ void ky_object::modify(intptr fd, eNotifyFlags flag, bool active)
     cur->dispatch->modify (fd, flag, active);
 }
 
+int ky_object::start_timer(int64 ms, bool repeat)
+{
+    ky_thread *cur = impl->thread;
+    return cur->dispatch->timer_start(this, ms, repeat);
+}
+bool ky_object::restart_timer(int id, int64 ms)
+{
+    ky_thread *cur = impl->thread;
+    return cur->dispatch->timer_restart(this, id, ms);
+}
+void ky_object::stop_timer(int id)
+{
+    ky_thread *cur = impl->thread;
+    cur->dispatch->timer_stop(this, id);
+}
+
+int ky_object::submit_io(const ky_io_request &req)
+{
+    ky_thread *cur = impl->thread;
+    return cur->dispatch->io_submit(this, req);
+}
+bool ky_object::cancel_io(int id)
+{
+    ky_thread *cur = impl->thread;
+    return cur->dispatch->io_cancel(this, id);
+}
+
 void ky_object::addref()
 {
     impl->addref();
@@ -24,6 +24,9 @@
  * 2019/02/03 | 1.2.1.1   | kunyang  | 加入事件通知枚举
  * 2019/04/21 | 1.2.2.1   | kunyang  | 修复类unix的epoll模式出现无响应
  * 2019/04/29 | 1.3.0.1   | kunyang  | 加入定时器实现
+ * 2026/10/17 | 1.4.0.1   | kunyang  | 加入io_uring模式及异步IO提交
+ * 2026/10/17 | 1.4.0.2   | kunyang  | 注册id改为带代数的句柄下标
+ * 2026/10/17 | 1.4.0.3   | kunyang  | 注册、修改、注销逐个提交到epoll/io_uring，套接字存放在注册表内
  */
 #ifndef KY_EVENT_POLL_H
 #define KY_EVENT_POLL_H
@@ -44,7 +47,7 @@ public:
     //! \brief registered 注册需要轮询的对象(消息、事件、套接字、异步IO)
     //! \param fd 句柄
     //! \param im 能被唤醒的标签-eIoNotifys
-    //! \return 返回注册的id
+    //! \return 返回注册的id，posix下为 代数 << 22 | 句柄，注销后旧id不再匹配
     //! \note
     //!     1.(im == Io_NotifyMsg) fd = HANDLE(windows)
     //!     2.(im == Io_NotifyIo)  fd = HANDLE(windows)
@@ -95,7 +98,7 @@ public:
     //! \param timeout 以毫秒为单位的超时。
     //! \note 此函数只能是一次从一个线程调用
     //! \return -1 error(flushing), -2 从多个线程调用.
-    //!        返回活动的数量
+    //!        返回活动和异步IO完成的数量
     //!
     int wait (int64 timeout = - 1);
 
@@ -128,6 +131,51 @@ public:
     //!
     bool is_wakeup();
 
+    //!
+    //! \brief is_async 是否为io_uring模式，可以提交异步IO
+    //! \return
+    //!
+    bool is_async()const;
+    //!
+    //! \brief submit 提交异步IO，在下一次wait时与就绪检测一起进入内核
+    //! \param id 完成时返回的id[0, 0x7fffffff)
+    //! \param req
+    //! \return 非io_uring模式返回false(errno = ENOSYS)
+    //!
+    bool submit(int id, const ky_io_request &req);
+    //!
+    //! \brief cancel 取消未完成的异步IO
+    //! \param id 提交时的id
+    //! \return
+    //!
+    bool cancel(int id);
+    //!
+    //! \brief register_files 注册固定句柄，请求中fixed为true时fd为句柄序号
+    //! \param fds 句柄数组[count <= 0 注销]
+    //! \param count
+    //! \return
+    //!
+    bool register_files(const int *fds, int count);
+    //!
+    //! \brief register_buffers 注册固定缓冲区，请求中buffer为缓冲区序号
+    //! \param data 缓冲区地址数组[count <= 0 注销]
+    //! \param size 缓冲区长度数组
+    //! \param count
+    //! \return
+    //!
+    bool register_buffers(void *const *data, const int64 *size, int count);
+    //!
+    //! \brief provide_buffers 向缓冲区组提供count个连续的size字节缓冲区
+    //! \param group 缓冲区组
+    //! \param base 第一个缓冲区地址
+    //! \param size 每个缓冲区的字节数
+    //! \param count 缓冲区个数
+    //! \param first 第一个缓冲区的序号
+    //! \return
+    //! \note 缓冲区被Recv选取后不再属于组，使用完需要重新提供
+    //!
+    bool provide_buffers(int group, void *base, int64 size, int count, int first = 0);
+
 public:
     //!
     //! \brief system_limit 当前系统的句柄限制
@@ -151,6 +199,12 @@ protected:
     //! \return 注册的id, -1无可用
     //!
     int peek_wake()const;
+    //!
+    //! \brief fetch_done 取出一个异步IO完成
+    //! \param e 完成事件
+    //! \return false无可用
+    //!
+    bool fetch_done(ky_io_event &e)const;
 
 protected:
     explicit event_poll(ky_thread *self);
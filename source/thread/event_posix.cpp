@@ -1,7 +1,6 @@
 
 #include "ky_lock.h"
 #include "ky_vector.h"
-#include "ky_map.h"
 #include "ky_queue.h"
 #include "ky_debug.h"
 
@@ -10,6 +9,7 @@
 #include "signal_posix.h"
 #include "timer_posix.h"
 #include "pipe_posix.h"
+#include "poll_slots.h"
 
 #include <sys/types.h>
 #include <unistd.h>
@@ -29,6 +29,9 @@
 #  include <sys/timerfd.h>
 #  include <sys/eventfd.h>
 #  include <sys/resource.h>
+#  if defined(kyHasIoUring)
+#    include "uring_posix.h"
+#  endif
 
 //!
 //! \brief system_limit 当前系统的句柄限制
@@ -60,53 +63,108 @@ typedef enum
     Mode_Poll,
     Mode_PPoll,
     Mode_EPoll,
+    Mode_URing,
     Mode_Auto
 } ePollModes;
 
+//! io_uring中异步IO的user_data标志，其余为就绪检测(序号 << 32 | fd)
+#define kyURingOpFlag (uint64(1) << 63)
+
+//!
+//! \brief The poll_entry struct 注册表中的项
+//! \note 套接字直接存放在表内，注册和注销不分配内存；
+//!       管道、定时器和信号为派生对象，单独分配后记录在ext中。
+//!       表扩容时io的地址会改变，因此表外只保存注册id
+//!
+struct poll_entry
+{
+    posix_fd  io;     ///< 套接字的轮询对象
+    posix_fd *ext;    ///< 派生的轮询对象[0 使用io]
+
+    poll_entry():
+        io(),
+        ext(0)
+    {
+    }
+    posix_fd *get() {return ext ? ext : &io;}
+};
+
 struct poll_priv
 {
     ePollModes        mode;            ///< 轮询模式
     ky_mutex          mutex;           ///< 轮询锁
 
     ky_atomic<int>    always;
-    ky_atomic<int>    rebuild;         ///< 是否需要重新激活轮询
-    ky_atomic<int>    pending;         ///< 唤醒记录
+    ky_atomic<int>    rebuild;         ///< 是否需要重建轮询数组(只用于poll/select模式)
+    ky_atomic<int>    pending;         ///< 唤醒请求数(轮询返回后清零)
+    ky_atomic<int>    sleeping;        ///< 轮询线程是否阻塞在系统等待中
     ky_atomic<int>    waiting;         ///< 等待数量
     ky_atomic<int>    flushing;        ///< 完成退出
 
-    ky_map<intptr, posix_fd*> inactive;   ///< 未激活列表
-    ky_list<posix_fd*>   active;         ///< 被激活的轮询
-    ky_list<posix_fd*>   actalw;         ///< 总是激活列表
-    ky_list<posix_fd*>   inremove;       ///< 需要被删除的轮询
+    poll_slots<poll_entry> inactive;   ///< 以句柄为下标的注册列表
+    int                  sockets;        ///< 加入轮询的句柄数量
+    ky_vector<int>       actalw;         ///< 总是激活的注册id
     ky_queue<posix_fd>   wake;           ///< 被唤醒列表
     ky_vector<PollFd>  inl_active;     ///< 用于存储激活的轮询对象
     ky_thread         *inl_thread;     ///< 所属线程
 
     pipe_posix        *pipe;
     int                epoll;
+#  if defined(kyHasIoUring)
+    uring_posix       *uring;
+    uint32             poll_seq;       ///< 就绪检测的提交序号
+    ky_vector<int>     rearm;          ///< 就绪检测已完成需要重新提交的注册id
+#  endif
+    ky_queue<ky_io_event> done;        ///< 异步IO的完成列表
 
     poll_priv():
         mode(Mode_Auto),
         mutex(),
         always(0),
-        rebuild(1),
+        rebuild(0),
         pending(0),
+        sleeping(0),
         waiting(0),
         flushing(0),
         inactive(),
-        active(),
+        sockets(0),
         actalw(),
-        inremove(),
         wake(),
         inl_thread(ky_thread::current()),
         pipe(kyNew(pipe_posix())),
         epoll(-1)
     {
+#  if defined(kyHasIoUring)
+        uring = 0;
+        poll_seq = 0;
+#  endif
         if (pipe->is_valid())
         {
-            inactive[pipe->get()] = pipe;
+            poll_entry e;
+            e.ext = pipe;
+            pipe->id = inactive.insert(pipe->get(), e);
             mode = choose_mode (-1);
 
+#  if defined(kyHasIoUring)
+            if (mode == Mode_URing)
+            {
+                uring = kyNew(uring_posix());
+                // 内核不支持或被禁用时退回epoll
+                if (!uring->is_valid() || !uring->has_op(IORING_OP_POLL_ADD) ||
+                        !uring->has_op(IORING_OP_POLL_REMOVE))
+                {
+                    log_warn ("io_uring_setup fail!");
+                    kyDelete(uring);
+                    uring = 0;
+#    if defined(kyHasEPoll)
+                    mode = Mode_EPoll;
+#    else
+                    mode = Mode_PPoll;
+#    endif
+                }
+            }
+#  endif
+
 #  if defined(kyHasEPoll)
             if (mode == Mode_EPoll)
             {
@@ -119,6 +177,9 @@ struct poll_priv
                 }
             }
 #  endif
+            // 模式确定后才能将唤醒句柄加入轮询
+            if (pipe->id >= 0)
+                attach(pipe);
         }
         else
             log_err ("can't create pipe!");
@@ -128,103 +189,240 @@ struct poll_priv
     {
         if ((mode == Mode_EPoll) && (epoll >=0 ))
             ::close(epoll);
+#  if defined(kyHasIoUring)
+        if (uring)
+            kyDelete(uring);
+#  endif
 
-        foreach (posix_fd *fd, inactive)
-            kyDelete(fd);
+        for (int fd = 0; fd < inactive.limit(); ++fd)
+        {
+            poll_entry *slot = inactive.at(fd);
+            if (slot && slot->ext)
+                kyDelete(slot->ext);
+        }
     }
 
-    void wait_prepare()
+    //!
+    //! \brief poll_events 以唤醒标签计算poll的事件
+    //!
+    static short poll_events(eNotifyFlags ion)
     {
-        // 删除句柄
-        foreach (posix_fd *var, inremove)
-        {
-            // 删除socket
-            if ((var->ion & Notify_Socket) && (mode == Mode_EPoll))
-            {
-                epoll_event ev;
-                epoll_ctl (epoll, EPOLL_CTL_DEL, var->hd.fd, &ev);
-            }
+        short events = 0;
+        if (ion & Notify_Close)
+            events |= POLLHUP;//POLLRDHUP;
+        if ((ion & Notify_Read) || (ion & Notify_Accept))
+            events |= (POLLIN | POLLPRI/*带外数据*/);
+        if (ion & Notify_Write)
+            events |= POLLOUT;
+        return events;
+    }
+    //! 是否需要加入系统轮询
+    static bool is_polled(eNotifyFlags ion)
+    {
+        return (ion & Notify_Socket) && !(ion & Notify_Always);
+    }
 
-            // 在列表中将内存删除
-            inactive.remove(var->get());
-            kyDelete(var);
+#  if defined(kyHasEPoll)
+    //!
+    //! \brief epoll_update 提交一个句柄的epoll变化
+    //! \param op EPOLL_CTL_ADD/EPOLL_CTL_MOD/EPOLL_CTL_DEL
+    //! \note 除唤醒句柄外都是单次触发，修改时重新提交即可再次激活
+    //!
+    void epoll_update(posix_fd *pt, int op)
+    {
+        epoll_event ev;
+        ky_memory::zero(&ev, sizeof(ev));
+        ev.data.fd = pt->hd.fd;
+        if (op != EPOLL_CTL_DEL)
+        {
+            ev.events |= (/*EPOLLET | */EPOLLHUP | EPOLLERR);
+            // 唤醒句柄需要一直有效
+            if (pt != pipe)
+                ev.events |= EPOLLONESHOT;
+
+            //EPOLLRDHUP ;-检测EPOLLRDHUP就可以知道是对方关闭(检测不到时读写会产生EPOLLERR)
+            if (pt->ion & Notify_Close)
+                ev.events |= EPOLLRDHUP;
+            if ((pt->ion & Notify_Read) || (pt->ion & Notify_Accept))
+                ev.events |= (EPOLLIN | EPOLLPRI/*带外数据*/);
+            if (pt->ion & Notify_Write)
+                ev.events |= EPOLLOUT;
         }
+        epoll_ctl (epoll, op, ev.data.fd, &ev);
+    }
+#  endif
 
-        // 将删除列表清空
-        inremove.clear();
-        active.clear ();
-        actalw.clear ();
-        inl_active.clear ();
-        always.store (0);
+    //!
+    //! \brief poll_add 将句柄加入系统轮询
+    //! \note epoll和io_uring模式只提交这一个句柄，其他模式在下一次等待前重建轮询数组
+    //!
+    void poll_add(posix_fd *pt)
+    {
+        pt->hd.events = poll_events(pt->ion);
+        pt->hd.revents = 0;
+        pt->flag = true;
+        ++sockets;
 
-        // 处理套接字关联
-        ky_map<intptr, posix_fd*>::iterator ite = inactive.begin();
-        for (;ite != inactive.end(); ++ite)
+        switch ((int)mode)
         {
-            posix_fd* pt = *ite;
+#  if defined(kyHasEPoll)
+        case Mode_EPoll:
+            epoll_update(pt, EPOLL_CTL_ADD);
+            break;
+#  endif
+#  if defined(kyHasIoUring)
+        case Mode_URing:
+            uring_arm(pt);
+            break;
+#  endif
+        default:
+            rebuild.store(1);
+            break;
+        }
+    }
+    //!
+    //! \brief poll_mod 修改已在系统轮询中的句柄
+    //!
+    void poll_mod(posix_fd *pt)
+    {
+        const short old_events = pt->hd.events;
+        pt->hd.events = poll_events(pt->ion);
 
-            // 设置为非阻塞
-            const int old_flags = ::fcntl(pt->get(), F_GETFL);
-            ::fcntl(pt->get(), F_SETFL, old_flags | O_NONBLOCK);
+        switch ((int)mode)
+        {
+#  if defined(kyHasEPoll)
+        case Mode_EPoll:
+            epoll_update(pt, EPOLL_CTL_MOD);
+            break;
+#  endif
+#  if defined(kyHasIoUring)
+        case Mode_URing:
+            // 监听的事件变化时先删除之前的检测
+            if (pt->armed && old_events != pt->hd.events)
+                uring_disarm(pt);
+            if (!pt->armed)
+                uring_arm(pt);
+            break;
+#  endif
+        default:
+            (void)old_events;
+            rebuild.store(1);
+            break;
+        }
+    }
+    //!
+    //! \brief poll_del 将句柄移出系统轮询
+    //! \note 句柄可能已被调用者关闭，此时内核已自动删除，忽略错误
+    //!
+    void poll_del(posix_fd *pt)
+    {
+        switch ((int)mode)
+        {
+#  if defined(kyHasEPoll)
+        case Mode_EPoll:
+            epoll_update(pt, EPOLL_CTL_DEL);
+            break;
+#  endif
+#  if defined(kyHasIoUring)
+        case Mode_URing:
+            uring_disarm(pt);
+            break;
+#  endif
+        default:
+            rebuild.store(1);
+            break;
+        }
+        pt->flag = false;
+        --sockets;
+    }
 
-            if (!(pt->ion & Notify_Always))
-                pt->index = active.count();
+    //!
+    //! \brief attach 注册后加入轮询
+    //! \note 只在此处设置一次非阻塞
+    //!
+    void attach(posix_fd *pt)
+    {
+        const int old_flags = ::fcntl(pt->get(), F_GETFL);
+        if (old_flags >= 0 && !(old_flags & O_NONBLOCK))
+            ::fcntl(pt->get(), F_SETFL, old_flags | O_NONBLOCK);
 
-            if (pt->ion & Notify_Always)
-            {
-                pt->always = actalw.count();
-                actalw.append(pt);
-                always.increase();
-            }
-            // 不为消息对象，并且未被激活[修改也是如此]
-            else if (pt->ion & Notify_Socket)
+        if (pt->ion & Notify_Always)
+        {
+            actalw.append(pt->id);
+            always.increase();
+        }
+        else if (is_polled(pt->ion))
+            poll_add(pt);
+    }
+    //!
+    //! \brief detach 注销前移出轮询
+    //!
+    void detach(posix_fd *pt)
+    {
+        if (pt->ion & Notify_Always)
+        {
+            for (int i = 0; i < actalw.count(); ++i)
             {
-                pt->hd.events = 0;
-                pt->hd.revents = 0;
-                if (pt->ion & Notify_Close)
-                    pt->hd.events |= POLLHUP;//POLLRDHUP;
-                if ((pt->ion & Notify_Read) || (pt->ion & Notify_Accept))
-                    pt->hd.events |= (POLLIN | POLLPRI/*带外数据*/);
-                if (pt->ion & Notify_Write)
-                    pt->hd.events |= POLLOUT;
-
-                if (mode == Mode_EPoll)
+                if (actalw[i] == pt->id)
                 {
-                    epoll_event ev;
-                    ky_memory::zero(&ev, sizeof(ev));
-                    ev.data.fd = pt->hd.fd;
-                    ev.events |= (/*EPOLLET | */EPOLLHUP | EPOLLERR | EPOLLONESHOT);
-
-                    //EPOLLRDHUP ;-检测EPOLLRDHUP就可以知道是对方关闭(检测不到时读写会产生EPOLLERR)
-                    if (pt->ion & Notify_Close)
-                        ev.events |= EPOLLRDHUP;
-                    if ((pt->ion & Notify_Read) || (pt->ion & Notify_Accept))
-                        ev.events |= (EPOLLIN | EPOLLPRI/*带外数据*/);
-                    if (pt->ion & Notify_Write)
-                        ev.events |= EPOLLOUT;
-
-                    if (pt->flag)
-                        epoll_ctl (epoll, EPOLL_CTL_MOD, ev.data.fd, &ev);
-                    else
-                    {
-                        pt->flag = true;
-
-                        epoll_ctl (epoll, EPOLL_CTL_ADD, ev.data.fd, &ev);
-                        active.append(pt);
-                    }
-                }
-                else
-                {
-                    active.append(pt);
-                    inl_active.append (pt->hd);
+                    actalw.remove(i);
+                    --always;
+                    break;
                 }
             }
         }
+        else if (pt->flag)
+            poll_del(pt);
+    }
+    //!
+    //! \brief reattach 唤醒标签修改后更新轮询
+    //! \param old 修改前的标签
+    //!
+    void reattach(posix_fd *pt, eNotifyFlags old)
+    {
+        // 切换总是通知很少见，按移出后重新加入处理
+        if (!(old & Notify_Always) != !(pt->ion & Notify_Always))
+        {
+            const eNotifyFlags ion = pt->ion;
+            pt->ion = old;
+            detach(pt);
+            pt->ion = ion;
+            if (pt->ion & Notify_Always)
+            {
+                actalw.append(pt->id);
+                always.increase();
+            }
+            else if (is_polled(pt->ion))
+                poll_add(pt);
+        }
+        else if (pt->flag)
+        {
+            if (is_polled(pt->ion))
+                poll_mod(pt);
+            else
+                poll_del(pt);
+        }
+        else if (is_polled(pt->ion))
+            poll_add(pt);
+    }
+
+    //!
+    //! \brief wait_prepare 重建poll/select模式的轮询数组
+    //!
+    void wait_prepare()
+    {
+        inl_active.clear ();
+        for (int fd = 0; fd < inactive.limit(); ++fd)
+        {
+            poll_entry *slot = inactive.at(fd);
+            if (slot && slot->get()->flag)
+                inl_active.append (slot->get()->hd);
+        }
     }
 
     int wait_epoll(int64 timeout)
     {
-        const int fd_size = active.count ();
+        const int fd_size = sockets;
         struct epoll_event events[fd_size];
         ky_memory::zero(events, sizeof(events));
         int   wake_count = 0;
@@ -233,9 +431,10 @@ struct poll_priv
         for (int i = 0; i < res; ++i)
         {
             const int fd = events[i].data.fd;
-            if (inactive.contains ((intptr)fd))
+            poll_entry *slot = inactive.at(fd);
+            if (slot)
             {
-                posix_fd* pt = inactive[(intptr)fd];
+                posix_fd* pt = slot->get();
 
                 pt->hd.revents = 0;
                 pt->wake = 0;
@@ -266,7 +465,122 @@ struct poll_priv
 
                 pt->despatch();
 
-                // 加入唤醒列表中
+                // 加入唤醒列表中(内部唤醒句柄不需要派遣)
+                if (pt != pipe)
+                {
+                    wake.push(*pt);
+                    wake_count++;
+                }
+            }
+        }
+        return wake_count;
+    }
+
+#  if defined(kyHasIoUring)
+    //!
+    //! \brief uring_arm 以单次的POLL_ADD提交就绪检测
+    //! \note 完成后在下一次等待前重新提交，与poll模式一样为水平触发，
+    //!       重新提交和等待在同一次io_uring_enter中
+    //!       提交队列满时放入rearm，下一次等待前重试
+    //!
+    void uring_arm(posix_fd *pt)
+    {
+        io_uring_sqe *s = uring->sqe();
+        if (!s)
+        {
+            rearm.append(pt->id);
+            return ;
+        }
+        if (++poll_seq >= uring_posix::Internal)
+            poll_seq = 1;
+
+        uint32 events = pt->hd.events;
+        if (pt->ion & Notify_Close)
+            events |= POLLRDHUP;
+#    if __BYTE_ORDER == __BIG_ENDIAN
+        events = (events << 16) | (events >> 16);
+#    endif
+        pt->armed = (uint64(poll_seq) << 32) | uint32(pt->hd.fd);
+        s->opcode = IORING_OP_POLL_ADD;
+        s->fd = pt->hd.fd;
+        s->poll32_events = events;
+        s->user_data = pt->armed;
+    }
+    void uring_disarm(posix_fd *pt)
+    {
+        if (!pt->armed)
+            return ;
+        io_uring_sqe *s = uring->sqe();
+        if (s)
+        {
+            s->opcode = IORING_OP_POLL_REMOVE;
+            s->addr = pt->armed;
+            s->user_data = uring_posix::internal(uring_posix::PollRemove);
+        }
+        pt->armed = 0;
+    }
+
+    int wait_uring(int64 timeout)
+    {
+        // 重试时失败的id会追加到末尾，只处理之前的部分
+        const int rearm_count = rearm.count();
+        for (int i = 0; i < rearm_count; ++i)
+        {
+            // 已注销的id不再匹配
+            poll_entry *slot = inactive.find(rearm[i]);
+            if (slot && slot->get()->flag && !slot->get()->armed)
+                uring_arm(slot->get());
+        }
+        if (rearm_count)
+            rearm.remove(0, rearm_count);
+
+        // 提交本轮的所有请求并等待，已有完成项或仍有未提交的检测时不阻塞
+        if (uring->ready() || !rearm.empty())
+            timeout = 0;
+        uring->submit(true, timeout);
+
+        int wake_count = 0;
+        io_uring_cqe *cqe = 0;
+        while ((cqe = uring->peek()) != 0)
+        {
+            const uint64 data = cqe->user_data;
+            const int    res = cqe->res;
+            const uint32 flags = cqe->flags;
+            uring->seen();
+
+            if (data & kyURingOpFlag)
+            {
+                ky_io_event e(int(data & 0x7fffffff));
+                e.result = res;
+                e.buffer = (flags & IORING_CQE_F_BUFFER) ? int(flags >> IORING_CQE_BUFFER_SHIFT) : -1;
+                e.more = (flags & IORING_CQE_F_MORE) != 0;
+                done.push(e);
+                continue;
+            }
+
+            poll_entry *slot = inactive.at(intptr(int(uint32(data))));
+            if (!slot)
+                continue;
+            posix_fd *pt = slot->get();
+            // 已删除或已重新提交的检测
+            if (pt->armed != data)
+                continue;
+            pt->armed = 0;
+            rearm.append(pt->id);
+
+            const int revents = res < 0 ? POLLERR : res;
+            pt->hd.revents = revents;
+            pt->wake = 0;
+            if (revents & (POLLIN | POLLPRI))
+                pt->wake |= Notify_Read | Notify_Accept;
+            if (revents & POLLOUT)
+                pt->wake |= Notify_Write;
+            if (revents & (POLLHUP | POLLRDHUP))
+                pt->wake |= Notify_Close;
+
+            pt->despatch();
+            if (pt != pipe)
+            {
                 wake.push(*pt);
                 wake_count++;
             }
@@ -274,6 +588,88 @@ struct poll_priv
         return wake_count;
     }
 
+    bool uring_submit(int id, const ky_io_request &req)
+    {
+        int opcode = -1;
+        switch ((int)req.op)
+        {
+        case IoOp_Read:
+            opcode = req.buffer >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            break;
+        case IoOp_Write:
+            opcode = req.buffer >= 0 ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+            break;
+        case IoOp_Recv: opcode = IORING_OP_RECV; break;
+        case IoOp_Send: opcode = IORING_OP_SEND; break;
+        case IoOp_Accept: opcode = IORING_OP_ACCEPT; break;
+        case IoOp_Fsync: opcode = IORING_OP_FSYNC; break;
+        }
+        if (opcode < 0 || !uring->has_op(opcode))
+        {
+            errno = ENOSYS;
+            return false;
+        }
+        // 多次接收需要从缓冲区组中选取
+        if (req.multishot && (req.op != IoOp_Accept) && (req.op != IoOp_Recv || req.group < 0))
+        {
+            errno = EINVAL;
+            return false;
+        }
+
+        io_uring_sqe *s = uring->sqe();
+        if (!s)
+        {
+            errno = EAGAIN;
+            return false;
+        }
+        s->opcode = (uint8)opcode;
+        s->fd = (int)req.fd;
+        s->addr = (uint64)(uintptr)req.data;
+        s->len = (uint32)req.length;
+        if (req.fixed)
+            s->flags |= IOSQE_FIXED_FILE;
+
+        switch ((int)req.op)
+        {
+        case IoOp_Read:
+        case IoOp_Write:
+            s->off = (uint64)req.offset;
+            if (req.buffer >= 0)
+                s->buf_index = (uint16)req.buffer;
+            break;
+        case IoOp_Recv:
+            if (req.group >= 0)
+            {
+                s->addr = 0;
+                s->flags |= IOSQE_BUFFER_SELECT;
+                s->buf_group = (uint16)req.group;
+            }
+#    ifdef IORING_RECV_MULTISHOT
+            if (req.multishot)
+                s->ioprio |= IORING_RECV_MULTISHOT;
+#    endif
+            break;
+        case IoOp_Send:
+            s->msg_flags = MSG_NOSIGNAL;
+            break;
+        case IoOp_Accept:
+            s->addr = 0;
+            s->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+#    ifdef IORING_ACCEPT_MULTISHOT
+            if (req.multishot)
+                s->ioprio |= IORING_ACCEPT_MULTISHOT;
+#    endif
+            break;
+        case IoOp_Fsync:
+            s->addr = 0;
+            s->len = 0;
+            break;
+        }
+        s->user_data = kyURingOpFlag | uint32(id);
+        return true;
+    }
+#  endif
+
     bool is_wakeup()
     {
         if (pipe->is_active())
@@ -300,21 +696,22 @@ struct poll_priv
 
     //!
     //! \brief raise_wakeup 提出唤醒
+    //! \note 只有第一个请求者并且轮询线程已经阻塞时才写入唤醒句柄。
+    //!       请求者先增加pending再读取sleeping，轮询线程先设置sleeping再读取pending，
+    //!       两者都是完整内存栅，因此至少有一方能看到对方，不会丢失唤醒。
     //! \return
     //!
     bool raise_wakeup ()
     {
-        bool result = true;
-
-        // 未提出唤醒则提出唤醒
-        if (pending.load () == 0)
-            result = wake_event ();
+        // 已有未处理的唤醒请求，轮询线程返回后会一起处理
+        if (pending.fetch_add (1) > 0)
+            return true;
 
-        // 已经提出唤醒则将待唤醒数加一
-        if (result)
-            ++pending;
+        // 轮询线程未阻塞，进入等待前会检查到唤醒请求
+        if (sleeping.load (Fence_Acquire) == 0)
+            return true;
 
-        return result;
+        return wake_event ();
     }
     //!
     //! \brief release_wakeup 释放唤醒
@@ -322,41 +719,44 @@ struct poll_priv
     //!
     bool release_wakeup ()
     {
-        bool result = false;
-
-        if (pending.load () > 0)
-        {
-            if (pending.load () == 1)
-                result = release_event ();
-            else
-                result = true;
-
-            if (result)
-                --pending;
-            else
-                errno = EWOULDBLOCK;
-        }
+        if (pending.fetch_store (0) > 0)
+            return true;
 
-        return result;
+        errno = EWOULDBLOCK;
+        return false;
     }
 
     //!
     //! \brief release_all_wakeup 释放所有唤醒
+    //! \note 唤醒句柄被激活时已在despatch中读空
     //! \return
     //!
     int release_all_wakeup ()
     {
-        int old = -1;
+        return pending.fetch_store (0);
+    }
 
-        if ((old = pending.load ()) > 0)
-        {
-            if (release_event ())
-                pending.store (0);
-            else
-                old = 0;
-        }
+    //!
+    //! \brief enter_sleep 准备进入系统等待
+    //! \param timeout
+    //! \return 有未处理的唤醒请求时返回0，否则返回timeout
+    //!
+    int64 enter_sleep (int64 timeout)
+    {
+        if (timeout == 0)
+            return 0;
 
-        return old;
+        sleeping.fetch_store (1);
+        if (pending.load (Fence_Acquire) > 0)
+            return 0;
+        return timeout;
+    }
+    //!
+    //! \brief leave_sleep 退出系统等待
+    //!
+    void leave_sleep ()
+    {
+        sleeping.store (0, Fence_Release);
     }
 
     // 非epoll模式的fd转换
@@ -368,9 +768,9 @@ struct poll_priv
         FD_ZERO (writefds);
         FD_ZERO (errorfds);
 
-        for (int i = 0; i < active.count (); ++i)
+        for (int i = 0; i < inl_active.count (); ++i)
         {
-            PollFd &pfd = (active[i])->hd;
+            PollFd &pfd = inl_active[i];
             if (pfd.fd < FD_SETSIZE)
             {
                 if (pfd.events & POLLIN)
@@ -389,9 +789,9 @@ struct poll_priv
     // 非epoll模式的fd转换,是否可读已经设置
     void fd_conv_pollfd (fd_set * readfds, fd_set * writefds, fd_set * errorfds)
     {
-        for (int i = 0; i < active.count (); ++i)
+        for (int i = 0; i < inl_active.count (); ++i)
         {
-            PollFd &pfd = active[i]->hd;
+            PollFd &pfd = inl_active[i];
             if (pfd.fd < FD_SETSIZE)
             {
                 pfd.revents = 0;
@@ -410,7 +810,9 @@ struct poll_priv
     {
         if (mode == Mode_Auto)
         {
-#  if defined(kyHasEPoll)
+#  if defined(kyHasIoUring)
+            return Mode_URing;
+#  elif defined(kyHasEPoll)
             return Mode_EPoll;
 #  elif defined(kyHasPPoll)
             return Mode_PPoll;
@@ -438,10 +840,9 @@ struct poll_priv
     bool selectable_fds ()
     {
         mutex.lock();
-        for (int i = 0; i< inactive.count (); ++i)
+        for (int i = 0; i< inl_active.count (); ++i)
         {
-            PollFd *pfd = &active[i];
-            if (pfd->pfd.fd >= FD_SETSIZE)
+            if (inl_active[i].fd >= FD_SETSIZE)
             {
                 mutex.unlock();
                 return false;
@@ -492,50 +893,59 @@ int event_poll::registered (intptr fd, eNotifyFlags im)
         log_warn("event_poll: Not thread safe operation.");
         return -1;
     }
-    // 已经注册，但是通知标志不同，则修改
-    if ((im & Notify_Socket) && priv->inactive.contains(fd))
+    // 已经注册，但是通知标志不同，则修改(epoll下同时重新激活单次触发)
+    poll_entry *slot = (im & Notify_Socket) ? priv->inactive.at(fd) : 0;
+    if (slot)
     {
-        posix_fd *pt = priv->inactive[fd];
-        if (pt->ion != im)
-            pt->ion = im;
-        wakeup();
-        return pt->hd.fd;
+        posix_fd *pt = slot->get();
+        const eNotifyFlags old = pt->ion;
+        pt->ion = im;
+        priv->reattach(pt, old);
+        return pt->id;
     }
 
-    posix_fd *pfd = 0;
+    // 套接字直接存放在注册表内
+    poll_entry e;
     if (im & Notify_Timer)
     {
         timer_posix *timer = kyNew(timer_posix());
         timer->start((int64)fd);
-        pfd = timer;
+        e.ext = timer;
     }
     else if (im & Notify_Socket)
-        pfd = kyNew(posix_fd(fd, im));
+        e.io.set(fd, im);
     else if (im & Notify_Signal)
     {
         signal_posix *signal = kyNew(signal_posix());
         signal->addset(fd);
-        pfd = signal;
+        e.ext = signal;
     }
-
-    if (!pfd)
+    else
     {
         log_err("event_poll: Can't register.");
         return -1;
     }
 
     // 注册一个通知
-    priv->inactive[pfd->get()] = pfd;
-    priv->rebuild.store(1);
-    wakeup();
-
-    return pfd->get();
+    const int id = priv->inactive.insert(e.get()->get(), e);
+    if (id < 0)
+    {
+        log_err("event_poll: Can't register, fd out of range.");
+        if (e.ext)
+            kyDelete(e.ext);
+        return -1;
+    }
+    posix_fd *pt = priv->inactive.find(id)->get();
+    pt->id = id;
+    priv->attach(pt);
+    return id;
 }
 
 //!
 //! \brief unregister 注销轮询的对象
-//! \param id 句柄
+//! \param id 注册的id
 //! \return
+//! \note 立即从列表和系统轮询中删除，已在唤醒队列中的id不再匹配
 //!
 bool event_poll::unregister (int id)
 {
@@ -547,18 +957,22 @@ bool event_poll::unregister (int id)
         return false;
     }
 
-    if (!priv->inactive.contains((intptr)id))
+    poll_entry *slot = priv->inactive.find(id);
+    if (!slot)
         return false;
 
-    posix_fd *fd = priv->inactive.value((intptr)id);
-    priv->inremove.append(fd);
-    wakeup();
+    posix_fd *ext = slot->ext;
+    priv->detach(slot->get());
+    priv->inactive.remove(id);
+    // 唤醒队列中保存的是副本，派生对象可以立即释放
+    if (ext)
+        kyDelete(ext);
     return true;
 }
 
 //!
 //! \brief modify 修改轮询对象唤醒标签
-//! \param fd 句柄
+//! \param id 注册的id
 //! \param im 唤醒的标签-eIoModes
 //! \return
 //!
@@ -572,25 +986,20 @@ bool event_poll::modify(int id, eNotifyFlags im, bool active)
         return false;
     }
 
-    if (!priv->inactive.contains((intptr)id))
+    poll_entry *slot = priv->inactive.find(id);
+    if (!slot)
+        return false;
+    posix_fd *pt = slot->get();
+    if (!(pt->ion & Notify_Io))
         return false;
-    posix_fd *pt = priv->inactive.value((intptr)id);
-
-    if (pt && pt->get() == id)
-    {
-        if (!(pt->ion & Notify_Io))
-            return false;
 
-        if (active)
-            pt->ion |= im;
-        else
-            pt->ion &= ~im;
-        pt->flag = false;
-        priv->rebuild.store(1);
-        wakeup();
-        return true;
-    }
-    return false;
+    const eNotifyFlags old = pt->ion;
+    if (active)
+        pt->ion |= im;
+    else
+        pt->ion &= ~im;
+    priv->reattach(pt, old);
+    return true;
 }
 
 //!
@@ -599,38 +1008,34 @@ bool event_poll::modify(int id, eNotifyFlags im, bool active)
 //!
 bool event_poll::can_exit()
 {
-    return priv->active.is_empty() || (priv->flushing.load() > 0);
+    return (priv->sockets == 0) || (priv->flushing.load() > 0);
 }
 
 //!
 //! \brief can_error 检测是否被错误唤醒
-//! \param fd 句柄
+//! \param id 注册的id
 //! \return
 //!
 bool event_poll::can_error (int id)
 {
-    foreach (posix_fd *pfd, priv->active)
-    {
-        if (id == pfd->hd.fd)
-            return (pfd->hd.revents & (POLLERR | POLLNVAL)) != 0;
-    }
-    return false;
+    poll_entry *slot = priv->inactive.find(id);
+    if (!slot)
+        return false;
+    return (slot->get()->hd.revents & (POLLERR | POLLNVAL)) != 0;
 }
 
 //!
 //! \brief can_wake 是否被唤醒
-//! \param fd 句柄
+//! \param id 注册的id
 //! \param im 检测的唤醒标签-eIoModes
 //! \return
 //!
 bool event_poll::can_wake(int id, eNotifyFlags im)
 {
-    foreach (posix_fd *var, priv->active)
-    {
-        if (var->hd.fd == id)
-            return var->flag && (var->wake & im);
-    }
-    return false;
+    poll_entry *slot = priv->inactive.find(id);
+    if (!slot)
+        return false;
+    return slot->get()->flag && (slot->get()->wake & im);
 }
 
 //!
@@ -658,9 +1063,7 @@ int event_poll::wait (int64 timeout)
         return -1;
     }
 
-    priv->release_all_wakeup();
-
-    // 重新构建
+    // poll/select模式重建轮询数组
     if (priv->rebuild.compare_exchange (1, 0))
         priv->wait_prepare();
 
@@ -668,7 +1071,10 @@ int event_poll::wait (int64 timeout)
     if (priv->always.load () > 0)
         timeout = 0;
 
-    if (!priv->active.is_empty ())
+    // 有唤醒请求时不进入阻塞，否则标记为阻塞状态
+    timeout = priv->enter_sleep (timeout);
+
+    if (priv->sockets > 0)
     {
         switch ((int)priv->mode)
         {
@@ -680,6 +1086,13 @@ int event_poll::wait (int64 timeout)
             priv->wait_epoll(timeout);
             break;
         }
+        case Mode_URing:
+        {
+#  if defined(kyHasIoUring)
+            priv->wait_uring(timeout);
+#  endif
+            break;
+        }
         case Mode_PPoll:
         {
 #  ifdef kyHasPPoll
@@ -757,14 +1170,16 @@ int event_poll::wait (int64 timeout)
         }
         }
 
-        if (priv->mode != Mode_EPoll)
+        if (priv->mode != Mode_EPoll && priv->mode != Mode_URing)
         {
             foreach (const PollFd &var, priv->inl_active)
             {
-                if (var.revents != 0 && priv->inactive.contains(var.fd))
+                poll_entry *slot = var.revents != 0 ? priv->inactive.at(var.fd) : 0;
+                if (slot)
                 {
-                    posix_fd *pt = priv->inactive[var.fd];
+                    posix_fd *pt = slot->get();
                     pt->hd.revents = var.revents;
+                    pt->wake = 0;
                     if (var.revents & POLLIN)
                         pt->wake |= Notify_Read | Notify_Accept;
                     if (var.revents & POLLPRI)
@@ -775,15 +1190,22 @@ int event_poll::wait (int64 timeout)
                         pt->wake |= Notify_Close;
 
                     pt->despatch();
-                    priv->wake.push(*pt);
+                    if (pt != priv->pipe)
+                        priv->wake.push(*pt);
                 }
             }
         }
     }
 
-    foreach (posix_fd *var, priv->actalw)
+    priv->leave_sleep ();
+    // 轮询返回后清除唤醒请求，之后到来的请求会让下一次等待立即返回
+    priv->release_all_wakeup ();
+
+    for (int i = 0; i < priv->actalw.count(); ++i)
     {
-        if (var->ion & Notify_Always)
+        poll_entry *slot = priv->inactive.find(priv->actalw[i]);
+        posix_fd *var = slot ? slot->get() : 0;
+        if (var && (var->ion & Notify_Always))
         {
             var->wake |= Notify_Always;
             var->despatch();
@@ -792,7 +1214,7 @@ int event_poll::wait (int64 timeout)
     }
 
     --priv->waiting;
-    return priv->wake.count();
+    return priv->wake.count() + priv->done.count();
 }
 
 void event_poll::restart ()
@@ -829,7 +1251,7 @@ bool event_poll::is_wakeup()
 int event_poll::fetch_wake()const
 {
     if (!priv->wake.is_empty ())
-        return priv->wake.pop ().get();
+        return priv->wake.pop ().id;
     return -1;
 }
 //!
@@ -839,9 +1261,133 @@ int event_poll::fetch_wake()const
 int event_poll::peek_wake()const
 {
     if (!priv->wake.is_empty ())
-        return priv->wake.front ().get();
+        return priv->wake.front ().id;
     return -1;
 }
+//!
+//! \brief fetch_done 取出一个异步IO完成
+//! \param e 完成事件，操作类型由提交者填写
+//! \return false无可用
+//!
+bool event_poll::fetch_done(ky_io_event &e)const
+{
+    if (priv->done.is_empty ())
+        return false;
+    e = priv->done.pop ();
+    return true;
+}
+
+bool event_poll::is_async()const
+{
+    return priv->mode == Mode_URing;
+}
+
+bool event_poll::submit(int id, const ky_io_request &req)
+{
+    if (id < 0)
+    {
+        errno = EINVAL;
+        return false;
+    }
+    if (ky_thread::current() != priv->inl_thread)
+    {
+        log_warn("event_poll: Not thread safe operation.");
+        errno = EPERM;
+        return false;
+    }
+#  if defined(kyHasIoUring)
+    if (priv->mode == Mode_URing)
+        return priv->uring_submit(id, req);
+#  endif
+    (void)req;
+    errno = ENOSYS;
+    return false;
+}
+
+bool event_poll::cancel(int id)
+{
+#  if defined(kyHasIoUring)
+    if (priv->mode == Mode_URing && id >= 0 && ky_thread::current() == priv->inl_thread &&
+            priv->uring->has_op(IORING_OP_ASYNC_CANCEL))
+    {
+        io_uring_sqe *s = priv->uring->sqe();
+        if (s)
+        {
+            s->opcode = IORING_OP_ASYNC_CANCEL;
+            s->addr = kyURingOpFlag | uint32(id);
+            s->user_data = uring_posix::internal(uring_posix::Cancel);
+            return true;
+        }
+    }
+#  endif
+    (void)id;
+    errno = ENOSYS;
+    return false;
+}
+
+bool event_poll::register_files(const int *fds, int count)
+{
+#  if defined(kyHasIoUring)
+    if (priv->mode == Mode_URing && ky_thread::current() == priv->inl_thread)
+        return priv->uring->register_files(fds, count);
+#  endif
+    (void)fds; (void)count;
+    errno = ENOSYS;
+    return false;
+}
+
+bool event_poll::register_buffers(void *const *data, const int64 *size, int count)
+{
+#  if defined(kyHasIoUring)
+    if (priv->mode == Mode_URing && ky_thread::current() == priv->inl_thread)
+    {
+        if (count <= 0)
+            return priv->uring->register_buffers(0, 0);
+
+        iovec *vec = (iovec *)kyMalloc(sizeof(iovec) * count);
+        if (!vec)
+            return false;
+        for (int i = 0; i < count; ++i)
+        {
+            vec[i].iov_base = data[i];
+            vec[i].iov_len = (size_t)size[i];
+        }
+        const bool ret = priv->uring->register_buffers(vec, count);
+        kyFree(vec);
+        return ret;
+    }
+#  endif
+    (void)data; (void)size; (void)count;
+    errno = ENOSYS;
+    return false;
+}
+
+bool event_poll::provide_buffers(int group, void *base, int64 size, int count, int first)
+{
+#  if defined(kyHasIoUring)
+    if (priv->mode == Mode_URing && ky_thread::current() == priv->inl_thread &&
+            priv->uring->has_op(IORING_OP_PROVIDE_BUFFERS))
+    {
+        io_uring_sqe *s = priv->uring->sqe();
+        if (!s)
+        {
+            errno = EAGAIN;
+            return false;
+        }
+        s->opcode = IORING_OP_PROVIDE_BUFFERS;
+        s->fd = count;
+        s->addr = (uint64)(uintptr)base;
+        s->len = (uint32)size;
+        s->off = (uint64)first;
+        s->buf_group = (uint16)group;
+        s->user_data = uring_posix::internal(uring_posix::Provide);
+        return true;
+    }
+#  endif
+    (void)group; (void)base; (void)size; (void)count; (void)first;
+    errno = ENOSYS;
+    return false;
+}
 
 
 #endif
@@ -705,6 +705,36 @@ int ky_event_poll::peek_wake()const
     return pt->id;
 }
 
+// Windows下暂不支持异步IO提交，使用就绪通知
+bool ky_event_poll::fetch_done(ky_io_event &)const
+{
+    return false;
+}
+bool ky_event_poll::is_async()const
+{
+    return false;
+}
+bool ky_event_poll::submit(int , const ky_io_request &)
+{
+    return false;
+}
+bool ky_event_poll::cancel(int )
+{
+    return false;
+}
+bool ky_event_poll::register_files(const int *, int )
+{
+    return false;
+}
+bool ky_event_poll::register_buffers(void *const *, const int64 *, int )
+{
+    return false;
+}
+bool ky_event_poll::provide_buffers(int , void *, int64 , int , int )
+{
+    return false;
+}
+
 LRESULT CALLBACK inl_window_proc (HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
     if (message == WM_NCCREATE)
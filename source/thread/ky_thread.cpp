@@ -704,6 +704,62 @@ void ky_thread::quit()
 {
     exit(0);
 }
+void ky_thread::set_post_budget(int n)
+{
+    dispatch->mutex.lock ();
+    dispatch->post_budget = n;
+    dispatch->mutex.unlock ();
+}
+int ky_thread::post_budget()const
+{
+    return dispatch->post_budget;
+}
+bool ky_thread::is_async_io()const
+{
+    return dispatch->is_async();
+}
+bool ky_thread::register_io_files(const int *fds, int count)
+{
+    return dispatch->register_files(fds, count);
+}
+bool ky_thread::register_io_buffers(void *const *data, const int64 *size, int count)
+{
+    return dispatch->register_buffers(data, size, count);
+}
+bool ky_thread::provide_io_buffers(int group, void *base, int64 size, int count, int first)
+{
+    return dispatch->provide_buffers(group, base, size, count, first);
+}
+bool ky_thread::post_call(ky_thread_call *c)
+{
+    if (!c || !c->call || !dispatch)
+        return false;
+    // 与exec退出时的清理互斥，入队的回调一定会被执行
+    dispatch->mutex.lock ();
+    const bool running = dispatch->running;
+    if (running)
+        dispatch->post_queue.push(c);
+    dispatch->mutex.unlock ();
+    if (running)
+        dispatch->wakeup();
+    return running;
+}
+int ky_thread::start_call(int64 ms, ky_thread_call *c)
+{
+    return dispatch->timer_call(ms, c);
+}
+void ky_thread::stop_call(int id)
+{
+    dispatch->timer_stop(0, id);
+}
+bool ky_thread::wait_call(intptr fd, int ion, ky_thread_call *c)
+{
+    return dispatch->wait_call(fd, (eNotifyFlags)ion, c);
+}
+void ky_thread::cancel_wait(intptr fd)
+{
+    dispatch->unregister(fd);
+}
 void ky_thread::exit(int code)
 {
     dispatch->mutex.lock ();
@@ -727,6 +783,7 @@ int ky_thread::exec()
     }
     dispatch->exited = false;
     dispatch->exit_code = 0;
+    dispatch->running = true;
     dispatch->mutex.unlock ();
 
     // 进行派遣
@@ -736,8 +793,12 @@ int ky_thread::exec()
     dispatch->mutex.lock ();
     dispatch->exited = true;
     dispatch->exit_code = 0;
+    dispatch->running = false;
     dispatch->mutex.unlock ();
 
+    // 执行退出前已接受的回调，之后的post_call都会失败
+    dispatch->post_drain(0);
+
     return ret_code;
 }
 
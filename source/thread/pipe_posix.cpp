@@ -1,5 +1,10 @@
 #include "pipe_posix.h"
 #include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#if kyOSIsLinux
+#include <sys/eventfd.h>
+#endif
 
 enum
 {
@@ -8,23 +13,45 @@ enum
     IPC_Pipe,
     IPC_Fifo,
     IPC_Socket,
+    IPC_EventFd,
 };
 pipe_posix::pipe_posix():
     posix_fd()
 {
     inl_priv[0] = -1;
     inl_priv[1] = -1;
-    inl_flag = IPC_UnixSP;
-    if (::socketpair (PF_UNIX, SOCK_STREAM, 0, inl_priv) < 0)
+    inl_flag = IPC_Error;
+
+#if kyOSIsLinux
+    // linux下使用eventfd，读写都是同一个句柄，多次写入只需一次读取
+    const int efd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (efd >= 0)
     {
-        if (::pipe(inl_priv) < 0)
+        inl_priv[0] = efd;
+        inl_priv[1] = efd;
+        inl_flag = IPC_EventFd;
+    }
+#endif
+
+    if (inl_flag == IPC_Error)
+    {
+        inl_flag = IPC_UnixSP;
+        if (::socketpair (PF_UNIX, SOCK_STREAM, 0, inl_priv) < 0)
+        {
+            if (::pipe(inl_priv) < 0)
+            {
+                inl_flag = IPC_Error;
+                inl_priv[0] = -1;
+                inl_priv[1] = -1;
+            }
+            else
+                inl_flag = IPC_Pipe;
+        }
+        if (inl_flag != IPC_Error)
         {
-            inl_flag = IPC_Error;
-            inl_priv[0] = -1;
-            inl_priv[1] = -1;
+            ::fcntl(inl_priv[0], F_SETFL, ::fcntl(inl_priv[0], F_GETFL) | O_NONBLOCK);
+            ::fcntl(inl_priv[1], F_SETFL, ::fcntl(inl_priv[1], F_GETFL) | O_NONBLOCK);
         }
-        else
-            inl_flag = IPC_Pipe;
     }
 
     if (inl_flag != IPC_Error)
@@ -35,29 +62,55 @@ pipe_posix::~pipe_posix()
 {
     if (inl_priv[0] >= 0)
         ::close(inl_priv[0]);
-    if (inl_priv[1] >= 0)
+    if (inl_priv[1] >= 0 && inl_priv[1] != inl_priv[0])
         ::close(inl_priv[1]);
 }
 bool pipe_posix::active()
 {
     ssize_t written;
+#if kyOSIsLinux
+    if (inl_flag == IPC_EventFd)
+    {
+        const uint64_t one = 1;
+        while ((written = ::write (inl_priv[1], &one, sizeof(one))) != sizeof(one))
+        {
+            // 计数器已满说明还未读取，同样处于激活状态
+            if (written == -1 && errno == EAGAIN)
+                return true;
+            if (written == -1 && errno != EINTR)
+                return false;
+        }
+        return true;
+    }
+#endif
     while ((written = ::write (inl_priv[1], "W", 1)) != 1)
     {
-        if (written == -1 && errno != EAGAIN && errno != EINTR)
+        // 管道已满说明还未读取，同样处于激活状态
+        if (written == -1 && errno == EAGAIN)
+            return true;
+        if (written == -1 && errno != EINTR)
             return false;
     }
     return true;
 }
 bool pipe_posix::cancel()
 {
-    char buf[1] = {'\0'};
+    // 一次读空所有的激活，无激活时立即返回(非阻塞)
+    char buf[64];
     ssize_t readten;
-    while ((readten = ::read (inl_priv[0], buf, 1)) != 1)
+    bool result = false;
+    forever ((readten = ::read (inl_priv[0], buf, sizeof(buf))) != 0)
     {
-        if (readten == -1 && errno != EAGAIN && errno != EINTR)
-            return false;
+        if (readten > 0)
+        {
+            result = true;
+            if (inl_flag == IPC_EventFd || readten < (ssize_t)sizeof(buf))
+                break;
+        }
+        else if (errno != EINTR)
+            break;
     }
-    return true;
+    return result;
 }
 bool pipe_posix::is_active()const
 {
@@ -65,14 +118,6 @@ bool pipe_posix::is_active()const
 }
 void pipe_posix::despatch()
 {
-    char buf[1] = {'\0'};
-    ssize_t readten;
     if (wake & Notify_Read)
-    {
-        while ((readten = ::read (inl_priv[0], buf, 1)) != 1)
-        {
-            if (readten == -1 && errno != EAGAIN && errno != EINTR)
-                return ;
-        }
-    }
+        cancel();
 }
@@ -0,0 +1,185 @@
+#ifndef POLL_SLOTS_H
+#define POLL_SLOTS_H
+
+#include "ky_define.h"
+
+//!
+//! \brief The poll_slots class 以句柄为下标的注册表，id带有代数
+//! \note id = 代数 << FdBits | 句柄，注销后代数加一，之前的id(如已在唤醒队列中)不再匹配
+//!       注册、注销、查找都是O(1)，只在句柄超过容量时按倍数扩容
+//!       T需要可按内存复制(指针、简单结构或只含虚表的结构)，新的位置以默认构造初始化
+//!
+template <typename T>
+class poll_slots
+{
+public:
+    enum
+    {
+        FdBits = 22,                          ///< 支持的最大句柄为4M
+        FdMask = (1 << FdBits) - 1,
+        GenMask = (1 << (31 - FdBits)) - 1,
+        InitCapacity = 64
+    };
+
+    static int fd_of(int id) {return id & FdMask;}
+    static int gen_of(int id) {return (id >> FdBits) & GenMask;}
+
+public:
+    poll_slots():
+        slots(0),
+        capacity(0),
+        counts(0),
+        top(0)
+    {
+    }
+    ~poll_slots()
+    {
+        if (slots)
+            kyFree(slots);
+    }
+
+    //!
+    //! \brief insert 在句柄处注册，已注册的句柄覆盖值并保持id
+    //! \param fd 句柄[0, FdMask]
+    //! \param v
+    //! \return id，句柄超出范围或扩容失败返回-1
+    //!
+    int insert(intptr fd, const T &v)
+    {
+        if (fd < 0 || fd > FdMask || !reserve(int(fd) + 1))
+            return -1;
+
+        slot &s = slots[fd];
+        if (s.id < 0)
+        {
+            s.id = (int(s.gen) << FdBits) | int(fd);
+            ++counts;
+            if (int(fd) >= top)
+                top = int(fd) + 1;
+        }
+        s.value = v;
+        return s.id;
+    }
+    //!
+    //! \brief bind 以其他表返回的id注册，两个表的id保持一致
+    //! \param id
+    //! \param v
+    //! \return
+    //!
+    bool bind(int id, const T &v)
+    {
+        if (id < 0 || !reserve(fd_of(id) + 1))
+            return false;
+
+        const int fd = fd_of(id);
+        slot &s = slots[fd];
+        if (s.id < 0)
+        {
+            ++counts;
+            if (fd >= top)
+                top = fd + 1;
+        }
+        s.id = id;
+        s.gen = uint16(gen_of(id));
+        s.value = v;
+        return true;
+    }
+    //!
+    //! \brief remove 注销id，代数加一
+    //! \return false为过期或未注册的id
+    //!
+    bool remove(int id)
+    {
+        slot *s = find_slot(id);
+        if (!s)
+            return false;
+        s->id = -1;
+        s->gen = (s->gen + 1) & GenMask;
+        s->value = T();
+        --counts;
+        while (top > 0 && slots[top - 1].id < 0)
+            --top;
+        return true;
+    }
+
+    //!
+    //! \brief find 以id查找，过期的id返回0
+    //!
+    T *find(int id)const
+    {
+        slot *s = find_slot(id);
+        return s ? &s->value : 0;
+    }
+    //!
+    //! \brief at 以句柄查找，未注册返回0
+    //!
+    T *at(intptr fd)const
+    {
+        if (fd < 0 || fd >= top || slots[fd].id < 0)
+            return 0;
+        return &slots[fd].value;
+    }
+    //!
+    //! \brief id_of 句柄当前的id，未注册返回-1
+    //!
+    int id_of(intptr fd)const
+    {
+        if (fd < 0 || fd >= top)
+            return -1;
+        return slots[fd].id;
+    }
+
+    //! 已注册的数量
+    int count()const {return counts;}
+    bool is_empty()const {return counts == 0;}
+    //! 最大已注册句柄加一，遍历时以at跳过空位
+    int limit()const {return top;}
+
+private:
+    struct slot
+    {
+        int    id;    ///< [-1 未注册]
+        uint16 gen;   ///< 下一次注册的代数
+        T      value;
+    };
+
+    slot *find_slot(int id)const
+    {
+        if (id < 0)
+            return 0;
+        const int fd = fd_of(id);
+        if (fd >= top || slots[fd].id != id)
+            return 0;
+        return &slots[fd];
+    }
+
+    bool reserve(int n)
+    {
+        if (n <= capacity)
+            return true;
+
+        int cap = capacity ? capacity : InitCapacity;
+        while (cap < n)
+            cap *= 2;
+        slot *ns = (slot *)kyRealloc(slots, sizeof(slot) * cap);
+        if (!ns)
+            return false;
+        for (int i = capacity; i < cap; ++i)
+        {
+            ns[i].id = -1;
+            ns[i].gen = 0;
+            new (&ns[i].value) T();
+        }
+        slots = ns;
+        capacity = cap;
+        return true;
+    }
+
+private:
+    slot *slots;
+    int   capacity;
+    int   counts;
+    int   top;
+};
+
+#endif // POLL_SLOTS_H
@@ -28,6 +28,8 @@ struct posix_fd
         flag = false;
         index = -1;
         always = -1;
+        armed = 0;
+        id = -1;
     }
     posix_fd(int fd, eNotifyFlags m)
     {
@@ -39,6 +41,8 @@ struct posix_fd
         flag = false;
         index = -1;
         always = -1;
+        armed = 0;
+        id = -1;
     }
 
     void set(int fd, eNotifyFlags m) {hd.fd = fd; ion = m;}
@@ -61,6 +65,8 @@ struct posix_fd
     bool         flag;    ///< 是否被激活
     int          index;   ///< 内部索引id
     int          always;  ///< 总是通知索引id
+    uint64       armed;   ///< io_uring中等待的就绪检测[0 未提交]
+    int          id;      ///< 注册id(带代数)[-1 未注册]
 };
 
 inline bool operator == (const posix_fd &p1, const posix_fd &p2)
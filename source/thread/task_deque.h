@@ -0,0 +1,141 @@
+#ifndef TASK_DEQUE_H
+#define TASK_DEQUE_H
+
+#include "ky_define.h"
+#include "arch/ky_atomic.h"
+#include "thread/ky_task.h"
+
+//!
+//! \brief The task_deque class 工作窃取双端队列(Chase-Lev)
+//! \note push/pop只能在所属的工作线程调用，steal可在任意线程调用
+//!       扩容后旧的环形数组保留到队列销毁，窃取者可能仍在读取
+//!
+class task_deque
+{
+    struct ring
+    {
+        int64                 mask;
+        ring                 *prev;             ///< 扩容前的数组
+        ky_atomic<ky_task*>   slot[1];
+
+        ky_task *get(int64 i) {return slot[i & mask].load(Fence_Acquire);}
+        void put(int64 i, ky_task *t) {slot[i & mask].store(t, Fence_Release);}
+
+        static ring *create(int64 cap, ring *prev)
+        {
+            ring *r = (ring *)kyMalloc(sizeof(ring) + (cap -1) * sizeof(ky_atomic<ky_task*>));
+            r->mask = cap -1;
+            r->prev = prev;
+            return r;
+        }
+    };
+
+public:
+    enum {InitCapacity = 256};
+
+    task_deque():
+        top(0),
+        bottom(0),
+        array(ring::create(InitCapacity, 0))
+    {
+    }
+    ~task_deque()
+    {
+        ring *r = array.load(Fence_Acquire);
+        while (r)
+        {
+            ring *p = r->prev;
+            kyFree(r);
+            r = p;
+        }
+    }
+
+    //!
+    //! \brief push 在底部入队(所属线程)
+    //! \param t
+    //!
+    void push(ky_task *t)
+    {
+        const int64 b = bottom.load(Fence_Relaxed);
+        const int64 tp = top.load(Fence_Acquire);
+        ring *a = array.load(Fence_Relaxed);
+        if (b - tp > a->mask)
+            a = grow(a, b, tp);
+        a->put(b, t);
+        bottom.store(b +1, Fence_Release);
+    }
+
+    //!
+    //! \brief pop 从底部出队(所属线程)
+    //! \return 队列为空时返回0
+    //!
+    ky_task *pop()
+    {
+        const int64 b = bottom.load(Fence_Relaxed) -1;
+        ring *a = array.load(Fence_Relaxed);
+        // 交换带完整屏障，保证写bottom先于读top
+        bottom.fetch_store(b);
+        int64 tp = top.load(Fence_Acquire);
+        if (tp > b)
+        {
+            bottom.store(b +1, Fence_Relaxed);
+            return 0;
+        }
+
+        ky_task *t = a->get(b);
+        if (tp == b)
+        {
+            // 最后一个元素，和窃取者竞争
+            if (!top.compare_exchange(tp, tp +1))
+                t = 0;
+            bottom.store(b +1, Fence_Relaxed);
+        }
+        return t;
+    }
+
+    //!
+    //! \brief steal 从顶部窃取(任意线程)
+    //! \return 队列为空或竞争失败时返回0
+    //!
+    ky_task *steal()
+    {
+        // 原子加0带完整屏障，保证读top先于读bottom
+        int64 tp = top.fetch_add(0);
+        const int64 b = bottom.load(Fence_Acquire);
+        if (tp >= b)
+            return 0;
+
+        ring *a = array.load(Fence_Acquire);
+        ky_task *t = a->get(tp);
+        if (!top.compare_exchange(tp, tp +1))
+            return 0;
+        return t;
+    }
+
+    //!
+    //! \brief is_empty 队列是否为空(近似值)
+    //!
+    bool is_empty()
+    {
+        return bottom.load(Fence_Acquire) <= top.load(Fence_Acquire);
+    }
+
+private:
+    ring *grow(ring *a, int64 b, int64 tp)
+    {
+        ring *n = ring::create((a->mask +1) * 2, a);
+        for (int64 i = tp; i < b; ++i)
+            n->put(i, a->get(i));
+        array.store(n, Fence_Release);
+        return n;
+    }
+
+private:
+    ky_atomic<int64> top;
+    char pad0[kyCpuCacheLineSize - sizeof(ky_atomic<int64>)];
+    ky_atomic<int64> bottom;
+    ky_atomic<ring*> array;
+    char pad1[kyCpuCacheLineSize - sizeof(ky_atomic<int64>) - sizeof(ky_atomic<ring*>)];
+};
+
+#endif // TASK_DEQUE_H
@@ -0,0 +1,232 @@
+#include "thread/ky_task.h"
+#include "thread/ky_thread.h"
+#include "thread/ky_lock.h"
+#include "arch/ky_cpu.h"
+#include "task_deque.h"
+
+class task_worker;
+
+struct task_pool_priv
+{
+    enum {SpinRounds = 64};
+
+    task_worker     **workers;
+    int               count;
+    ky_atomic<bool>   stop;
+
+    ky_mutex          mutex;         ///< 外部队列和休眠使用
+    ky_condition      cond;
+    ky_task          *inject_head;   ///< 外部线程投递的任务
+    ky_task          *inject_tail;
+    ky_atomic<int>    queued;        ///< 已投递还未取出的任务数
+    ky_atomic<int>    sleepers;      ///< 休眠中的工作线程数
+
+    task_pool_priv():
+        workers(0),
+        count(0),
+        stop(false),
+        inject_head(0),
+        inject_tail(0),
+        queued(0),
+        sleepers(0)
+    {
+    }
+
+    //!
+    //! \brief inject 投递到外部队列
+    //!
+    void inject(ky_task *t)
+    {
+        ky_scopelock lock(mutex);kyUnused2(lock);
+        t->next = 0;
+        if (inject_tail)
+            inject_tail->next = t;
+        else
+            inject_head = t;
+        inject_tail = t;
+    }
+    //!
+    //! \brief take 从外部队列取出
+    //!
+    ky_task *take()
+    {
+        if (inject_head == 0)
+            return 0;
+        ky_scopelock lock(mutex);kyUnused2(lock);
+        ky_task *t = inject_head;
+        if (t)
+        {
+            inject_head = t->next;
+            if (inject_head == 0)
+                inject_tail = 0;
+        }
+        return t;
+    }
+
+    //!
+    //! \brief notify 有新任务时唤醒一个休眠的工作线程
+    //!
+    void notify()
+    {
+        // queued和sleepers都使用带完整屏障的原子操作，唤醒不会丢失
+        queued.fetch_add(1);
+        if (sleepers.fetch_add(0) > 0)
+        {
+            ky_scopelock lock(mutex);kyUnused2(lock);
+            cond.wake_one();
+        }
+    }
+
+    ky_task *find(task_worker *self);
+    void execute(ky_task *t)
+    {
+        queued.fetch_add(-1);
+        t->run();
+        kyDelete(t);
+    }
+};
+
+class task_worker : public ky_thread
+{
+public:
+    task_worker(task_pool_priv *p, int i):
+        pool(p),
+        index(i)
+    {
+    }
+
+    virtual void run();
+
+    task_pool_priv *pool;
+    int             index;
+    task_deque      deque;
+
+    static __thread task_worker *current;
+};
+__thread task_worker *task_worker::current = 0;
+
+ky_task *task_pool_priv::find(task_worker *self)
+{
+    ky_task *t = 0;
+    if (self && self->pool == this && (t = self->deque.pop()))
+        return t;
+    if ((t = take()))
+        return t;
+
+    // 从其他工作线程的队列顶部窃取
+    const int from = self && self->pool == this ? self->index +1 : 0;
+    for (int i = 0; i < count; ++i)
+    {
+        task_worker *w = workers[(from + i) % count];
+        if (w == self)
+            continue;
+        if ((t = w->deque.steal()))
+            return t;
+    }
+    return 0;
+}
+
+void task_worker::run()
+{
+    current = this;
+    int idle = 0;
+    while (!pool->stop.load(Fence_Acquire))
+    {
+        ky_task *t = pool->find(this);
+        if (t)
+        {
+            pool->execute(t);
+            idle = 0;
+            continue;
+        }
+        if (++idle < task_pool_priv::SpinRounds)
+        {
+            ky_thread::yield();
+            continue;
+        }
+
+        ky_scopelock lock(pool->mutex);kyUnused2(lock);
+        pool->sleepers.fetch_add(1);
+        while (!pool->stop.load(Fence_Acquire) && pool->queued.fetch_add(0) <= 0)
+            pool->cond.wait(pool->mutex);
+        pool->sleepers.fetch_add(-1);
+        idle = 0;
+    }
+    current = 0;
+}
+
+ky_task_pool::ky_task_pool(int workers, bool pinned):
+    impl(kyNew(task_pool_priv))
+{
+    const int cpus = ky_cpu::count() > 0 ? ky_cpu::count() : 1;
+    impl->count = workers > 0 ? workers : cpus;
+    impl->workers = (task_worker **)kyMalloc(sizeof(task_worker *) * impl->count);
+    for (int i = 0; i < impl->count; ++i)
+    {
+        impl->workers[i] = kyNew(task_worker(impl, i));
+        if (pinned && impl->workers[i]->has_affinity())
+            impl->workers[i]->set_affinity((uint)(i % cpus) +1);
+    }
+    for (int i = 0; i < impl->count; ++i)
+        impl->workers[i]->start();
+}
+
+ky_task_pool::~ky_task_pool()
+{
+    // 先执行完剩余任务再退出
+    while (run_one())
+        ;
+
+    {
+        ky_scopelock lock(impl->mutex);kyUnused2(lock);
+        impl->stop.store(true, Fence_Release);
+        impl->cond.wake_all();
+    }
+    for (int i = 0; i < impl->count; ++i)
+    {
+        while (impl->workers[i]->is_running())
+            ky_thread::yield();
+        kyDelete(impl->workers[i]);
+    }
+    kyFree(impl->workers);
+    kyDelete(impl);
+}
+
+ky_task_pool *ky_task_pool::global()
+{
+    static ky_task_pool pool;
+    return &pool;
+}
+
+int ky_task_pool::count() const
+{
+    return impl->count;
+}
+
+void ky_task_pool::post(ky_task *t)
+{
+    task_worker *w = task_worker::current;
+    if (w && w->pool == impl)
+        w->deque.push(t);
+    else
+        impl->inject(t);
+    impl->notify();
+}
+
+bool ky_task_pool::run_one()
+{
+    ky_task *t = impl->find(task_worker::current);
+    if (t == 0)
+        return false;
+    impl->execute(t);
+    return true;
+}
+
+void ky_task_pool::wait_until(ky_atomic<int> &flag, int value)
+{
+    while (flag.load(Fence_Acquire) != value)
+    {
+        if (!run_one())
+            ky_thread::yield();
+    }
+}
@@ -33,10 +33,21 @@ thread_dispatch::thread_dispatch(ky_thread *self):
     exited = false;
     exit_code = 0;
     req_quit = false;
+    running = false;
+    post_budget = PostBatch;
     mutex.unlock ();
 }
 thread_dispatch::~thread_dispatch()
 {
+    ky_mpsc_node *n = 0;
+    while ((n = post_queue.pop()) != 0)
+    {
+        // 未执行的回调节点由调用者持有
+        if (!((ky_thread_call*)n)->call)
+            kyDelete ((ky_post*)n);
+    }
+    for (int i = 0; i < timer_list.count(); ++i)
+        kyDelete (timer_list[i]);
 }
 
 bool thread_dispatch::posted (ievent *e, ky_object *o)
@@ -50,9 +61,7 @@ bool thread_dispatch::posted (ievent *e, ky_object *o)
         {
             ky_thread* thr = ite.value ();
 
-            thr->dispatch->mutex.lock ();
-            thr->dispatch->post_queue.push(ky_post(e, o));
-            thr->dispatch->mutex.unlock ();
+            thr->dispatch->post_queue.push(kyNew (ky_post(e, o)));
             thr->dispatch->wakeup ();
         }
         return true;
@@ -62,9 +71,7 @@ bool thread_dispatch::posted (ievent *e, ky_object *o)
     ky_thread *othr = o->thread ();
     if (othr && othr->dispatch)
     {
-        othr->dispatch->mutex.lock ();
-        othr->dispatch->post_queue.push(ky_post(e, o));
-        othr->dispatch->mutex.unlock ();
+        othr->dispatch->post_queue.push(kyNew (ky_post(e, o)));
         othr->dispatch->wakeup ();
         return true;
     }
@@ -78,89 +85,423 @@ void thread_dispatch::registered(intptr fd, eNotifyFlags ion, ky_object *o)
         log_err("ky_object: Non-thread safe operation");
         return ;
     }
-    const int id = ky_event_poll::registered(fd, ion);
-    if (id >= 0)
+    // 定时器放入本线程的时间轮，不再为每个定时器创建内核对象
+    if (ion & Notify_Timer)
     {
-        object_list[id] = ky_pair(id, fd, o);
+        timer_start(o, fd, true, fd);
+        return ;
     }
+    const int id = event_poll::registered(fd, ion);
+    if (id < 0)
+        return ;
+
+    // 已注册的句柄修改标签时id不变
+    const bool exists = object_list.find(id) != 0;
+    object_list.bind(id, ky_pair(id, fd, o));
+    if (!exists && poll_slots<ky_pair>::fd_of(id) != fd)
+        indirect_list.append(id);
+}
+
+int thread_dispatch::find_id(intptr fd)const
+{
+    const ky_pair *pair = object_list.at(fd);
+    if (pair && pair->hd == fd)
+        return pair->id;
+
+    for (int i = 0; i < indirect_list.count(); ++i)
+    {
+        pair = object_list.find(indirect_list[i]);
+        if (pair && pair->hd == fd)
+            return pair->id;
+    }
+    return -1;
 }
 
 void thread_dispatch::unregister(intptr fd)
 {
-    int id = -1;
-    ky_map<int, ky_pair>::iterator ite = object_list.begin();
-    for (;ite != object_list.end(); ++ite)
+    const int id = find_id(fd);
+    if (id >= 0)
+    {
+        event_poll::unregister(id);
+        object_list.remove(id);
+        for (int i = 0; i < indirect_list.count(); ++i)
+        {
+            if (indirect_list[i] == id)
+            {
+                indirect_list.remove(i);
+                break;
+            }
+        }
+        return ;
+    }
+    for (int i = 0; i < timer_list.count(); ++i)
     {
-        if (ite.value().hd == fd)
+        if (timer_list[i]->object && timer_list[i]->hd == fd)
         {
-            id = ite.key();
+            timer_stop(timer_list[i]->object, i);
             break;
         }
     }
-    if (id >= 0)
+}
+
+int thread_dispatch::timer_start(ky_object *o, int64 ms, bool repeat, intptr hd)
+{
+    if (!o || o->thread() != ky_thread::current())
     {
-        ky_event_poll::unregister(id);
-        object_list.remove(id);
+        log_err("ky_object: Non-thread safe operation");
+        return -1;
     }
+
+    ky_timer_pair *tp = timer_alloc();
+    tp->hd = hd;
+    tp->timeout = ms;
+    tp->object = o;
+    timers.start(tp, ms, repeat ? ms : 0);
+    return tp->id;
 }
-#include "ky_datetime.h"
-int thread_dispatch::dispatcher()
+
+int thread_dispatch::timer_call(int64 ms, ky_thread_call *c)
 {
-    do
+    if (!c || ky_thread::current()->dispatch != this)
     {
-        const bool is_lave_posted = !post_queue.is_empty();
+        log_err("ky_thread: Non-thread safe operation");
+        return -1;
+    }
+
+    ky_timer_pair *tp = timer_alloc();
+    tp->hd = -1;
+    tp->timeout = ms;
+    tp->call = c;
+    timers.start(tp, ms);
+    return tp->id;
+}
+
+ky_timer_pair *thread_dispatch::timer_alloc()
+{
+    ky_timer_pair *tp = 0;
+    if (!timer_free.is_empty())
+    {
+        const int last = (int)timer_free.count() - 1;
+        tp = timer_list[timer_free[last]];
+        timer_free.remove(last);
+    }
+    else
+    {
+        tp = kyNew (ky_timer_pair());
+        tp->id = (int)timer_list.count();
+        timer_list.append(tp);
+    }
+    return tp;
+}
+
+bool thread_dispatch::timer_restart(const ky_object *o, int id, int64 ms)
+{
+    // 只能重启自己的定时器，id回收后可能已被其他对象复用
+    if (!o || id < 0 || id >= timer_list.count() || timer_list[id]->object != o)
+        return false;
+
+    ky_timer_pair *tp = timer_list[id];
+    if (tp->object->thread() != ky_thread::current())
+    {
+        log_err("ky_object: Non-thread safe operation");
+        return false;
+    }
+    if (ms >= 0)
+        tp->timeout = ms;
+    timers.start(tp, tp->timeout, tp->interval > 0 ? tp->timeout : 0);
+    return true;
+}
+
+void thread_dispatch::timer_stop(const ky_object *o, int id)
+{
+    if (id < 0 || id >= timer_list.count() || !timer_list[id]->is_used())
+        return ;
+
+    ky_timer_pair *tp = timer_list[id];
+    if (tp->object != o)
+        return ;
+    if (ky_thread::current()->dispatch != this)
+    {
+        log_err("ky_object: Non-thread safe operation");
+        return ;
+    }
+    timers.stop(tp);
+    tp->object = 0;
+    tp->call = 0;
+    timer_free.append(id);
+}
+
+void thread_dispatch::timer_dispatch(int64 stamp)
+{
+    if (timers.is_empty() || !timers.advance(ky_timer_wheel::now()))
+        return ;
 
-        // 本线程内有事件需要寄送
-        if (is_lave_posted)
+    ky_timer_node *t = 0;
+    while ((t = timers.fetch()) != 0)
+    {
+        ky_timer_pair *tp = static_cast<ky_timer_pair*>(t);
+        const int id = tp->id;
+        // 回调定时器为单次，先回收id再执行，回调内可以再次启动
+        if (tp->call)
+        {
+            ky_thread_call *c = tp->call;
+            tp->call = 0;
+            timer_free.append(id);
+            c->call(c);
+            continue;
+        }
+        // 以Notify_Timer注册的保持原来按句柄的通知
+        if (tp->hd >= 0)
         {
-            // 取出需要寄送的事件
-            ky_post ep = post_queue.pop();
+            ky_event notify = ky_event::make_notify(tp->hd, stamp);
+            tp->object->event(&notify);
+        }
+        else
+        {
+            ky_timer_event te(id, stamp);
+            tp->object->event(&te);
+        }
+        // 单次定时器在事件处理中没有重新启动或停止，则回收id
+        if (tp->object && !ky_timer_wheel::is_active(tp))
+        {
+            tp->object = 0;
+            timer_free.append(id);
+        }
+    }
+}
 
-            // 寄送到指定目标
-            if (ep.target)
-                ep.target->event (ep.event);
-            // 无寄送目标，则事件不为空，需要寄送本线程内所有对象
-            else if (ep.event)
+int thread_dispatch::io_submit(ky_object *o, const ky_io_request &req)
+{
+    if (!o || o->thread() != ky_thread::current())
+    {
+        log_err("ky_object: Non-thread safe operation");
+        return -1;
+    }
+
+    int id = -1;
+    if (!io_free.is_empty())
+    {
+        const int last = (int)io_free.count() - 1;
+        id = io_free[last];
+        io_free.remove(last);
+    }
+    else
+    {
+        id = (int)io_list.count();
+        io_list.append(ky_io_pair());
+    }
+    if (!this->submit(id, req))
+    {
+        io_free.append(id);
+        return -1;
+    }
+    io_list[id].object = o;
+    io_list[id].op = req.op;
+    return id;
+}
+
+bool thread_dispatch::io_cancel(const ky_object *o, int id)
+{
+    if (!o || id < 0 || id >= io_list.count() || io_list[id].object != o)
+        return false;
+    if (io_list[id].object->thread() != ky_thread::current())
+    {
+        log_err("ky_object: Non-thread safe operation");
+        return false;
+    }
+    return this->cancel(id);
+}
+
+void thread_dispatch::io_dispatch(int64 stamp)
+{
+    ky_io_event done;
+    while (this->fetch_done(done))
+    {
+        if (done.id < 0 || done.id >= io_list.count())
+            continue;
+        // 对象已析构，最后一次完成后回收id
+        if (io_list[done.id].released)
+        {
+            if (!done.more)
             {
-                ky_map<int, ky_pair>::iterator ite = object_list.begin();
-                for (;ite != object_list.end(); ++ite)
-                {
-                    ky_pair &pair = *ite;
-                    pair.object->event(ep.event);
-                }
+                io_list[done.id].released = false;
+                io_free.append(done.id);
             }
-            // 若本线程内无对象，请求退出派遣
-            else
+            continue;
+        }
+        if (!io_list[done.id].object)
+            continue;
+
+        const ky_io_pair pair = io_list[done.id];
+        // 最后一次完成先回收id，事件处理中可以继续提交
+        if (!done.more)
+        {
+            io_list[done.id].object = 0;
+            io_free.append(done.id);
+        }
+        done.op = pair.op;
+        done.timestamp() = stamp;
+        pair.object->event(&done);
+    }
+}
+
+void thread_dispatch::release(ky_object *o)
+{
+    // 没有定时器和异步IO的对象可以在其他线程析构
+    ky_thread *cur = ky_thread::current();
+    const bool owner = cur && cur->dispatch == this;
+    for (int i = 0; i < timer_list.count(); ++i)
+    {
+        if (timer_list[i]->object != o)
+            continue;
+        if (!owner)
+        {
+            log_err("ky_object: Non-thread safe operation");
+            return ;
+        }
+        timer_stop(o, i);
+    }
+    for (int i = 0; i < io_list.count(); ++i)
+    {
+        if (io_list[i].object == o)
+        {
+            if (!owner)
             {
-                req_quit = object_list.is_empty();
+                log_err("ky_object: Non-thread safe operation");
+                return ;
             }
+            io_list[i].object = 0;
+            io_list[i].released = true;
+            this->cancel(i);
         }
+    }
+}
+
+bool thread_dispatch::wait_call(intptr fd, eNotifyFlags ion, ky_thread_call *c)
+{
+    if (!c || ky_thread::current()->dispatch != this)
+    {
+        log_err("ky_thread: Non-thread safe operation");
+        return false;
+    }
+    // 一个句柄只能有一个等待者
+    if (find_id(fd) >= 0)
+        return false;
 
-        // 还有事件寄送时，则检查是否有新事件到来。无对象事件寄送，则进入等待
-        const int64 timeout = is_lave_posted ? 0 : -1;
+    const int id = event_poll::registered(fd, ion);
+    if (id < 0)
+        return false;
+    object_list.bind(id, ky_pair(id, fd, 0, c));
+    if (poll_slots<ky_pair>::fd_of(id) != fd)
+        indirect_list.append(id);
+    return true;
+}
+
+void thread_dispatch::modify(intptr fd, eNotifyFlags ion, bool active)
+{
+    const int id = find_id(fd);
+    if (id >= 0)
+        event_poll::modify(id, ion, active);
+}
+
+void thread_dispatch::post_dispatch(const ky_post *ep)
+{
+    // 寄送到指定目标
+    if (ep->target)
+        ep->target->event (ep->event);
+    // 无寄送目标，则事件不为空，需要寄送本线程内所有对象
+    else if (ep->event)
+    {
+        for (int i = 0; i < object_list.limit(); ++i)
+        {
+            const ky_pair *pair = object_list.at(i);
+            if (pair && pair->object)
+                pair->object->event(ep->event);
+        }
+    }
+    // 若本线程内无对象，请求退出派遣
+    else
+    {
+        req_quit = object_list.is_empty();
+    }
+}
+
+int thread_dispatch::post_drain(int budget)
+{
+    // 本批到此节点为止，避免事件处理中不断寄送的事件饿死IO
+    // 哨兵正在重新入队时last为0但队列可能不为空，此时只按budget限制
+    ky_mpsc_node *const last = post_queue.last();
+    int count = 0;
+    ky_mpsc_node *n = 0;
+    while ((budget <= 0 || count < budget) && (n = post_queue.pop()) != 0)
+    {
+        const bool is_last = n == last;
+        ky_thread_call *c = (ky_thread_call*)n;
+        // 回调节点由调用者持有，执行后可能已被释放
+        if (c->call)
+            c->call(c);
+        else
+        {
+            ky_post *ep = (ky_post*)c;
+            post_dispatch(ep);
+            kyDelete (ep);
+        }
+        ++count;
+        if (is_last)
+            break;
+    }
+    return count;
+}
+
+#include "ky_datetime.h"
+int thread_dispatch::dispatcher()
+{
+    do
+    {
+        // 批量寄送本线程内的事件
+        post_drain(post_budget);
+        const bool is_lave_posted = !post_queue.is_empty();
+
+        // 还有事件寄送时，每批只做一次零超时的检查。无对象事件寄送，则等待到下一个定时器
+        const int64 timeout = is_lave_posted ? 0 : timers.next_timeout(ky_timer_wheel::now());
         // 论巡是否需要寄送事件
         int num = this->wait (timeout);
+        // 同一次唤醒的通知使用同一个时间戳
+        const int64 stamp = ky_datetime::millisec();
         // 检测到事件需要派遣
         if (num > 0)
         {
             // 取出需要派遣的对象
-            while ((num = this->fetch_wake()) >= 0 && object_list.contains (num))
+            while ((num = this->fetch_wake()) >= 0)
             {
-                const ky_pair pair = object_list.value(num);
-                ky_event notify = ky_event::make_notify(pair.hd, ky_datetime::millisec());
+                // 已注销或句柄被复用的id代数不同，不再派遣
+                const ky_pair *found = object_list.find(num);
+                if (!found)
+                    continue;
+                const ky_pair pair = *found;
+                // 回调等待只就绪一次
+                if (pair.call)
+                {
+                    unregister(pair.hd);
+                    pair.call->call(pair.call);
+                    continue;
+                }
+                ky_event notify = ky_event::make_notify(pair.hd, stamp);
                 pair.object->event(&notify);
             }
+            io_dispatch(stamp);
         }
         // 出错
         else if (num == -1)
         {
-            req_quit = this->can_exit();
+            req_quit = this->can_exit() && timers.is_empty();
         }
         // 多个线程轮询了
         else if (num == -2)
         {
 
         }
+        timer_dispatch(stamp);
     }while (!req_quit);
 
     return exit_code;
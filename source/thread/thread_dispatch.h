@@ -1,13 +1,16 @@
 #ifndef THREAD_DISPATCH_H
 #define THREAD_DISPATCH_H
 
-#include "tools/ky_queue.h"
 #include "tools/ky_map.h"
 #include "ky_object.h"
 #include "ky_lock.h"
+#include "ky_mpsc.h"
+#include "ky_timer_wheel.h"
 #include "event_poll.h"
+#include "poll_slots.h"
 
-struct ky_post
+//! 寄送的事件(call为空)，与调用者持有的回调节点共用一个队列
+struct ky_post : ky_thread_call
 {
     ky_object *target; ///< 目标对象[=0 线程内全部对象]
     ievent    *event;  ///< 邮寄的事件
@@ -28,17 +31,49 @@ struct ky_pair
     int        id;
     intptr     hd;
     ky_object* object;
+    ky_thread_call *call; ///< 以wait_call注册时就绪一次的回调
     ky_pair()
     {
         id = 0;
         hd = 0;
         object = 0;
+        call = 0;
     }
-    ky_pair(int a, intptr b, ky_object *o)
+    ky_pair(int a, intptr b, ky_object *o, ky_thread_call *c = 0)
     {
         id = a;
         hd = b;
         object = o;
+        call = c;
+    }
+};
+struct ky_timer_pair : ky_timer_node
+{
+    int        id;
+    intptr     hd;      ///< 以Notify_Timer注册时的句柄[-1 由start_timer启动]
+    int64      timeout; ///< 启动时的超时(毫秒)
+    ky_object* object;  ///< 所属对象
+    ky_thread_call *call; ///< 以start_call启动时的回调[与object都为0时id空闲]
+    ky_timer_pair()
+    {
+        id = -1;
+        hd = -1;
+        timeout = 0;
+        object = 0;
+        call = 0;
+    }
+    bool is_used()const {return object || call;}
+};
+struct ky_io_pair
+{
+    ky_object* object;  ///< 接收完成的对象[=0 id空闲]
+    eIoOps     op;
+    bool       released; ///< 对象已析构，等待最后一次完成后回收id
+    ky_io_pair()
+    {
+        object = 0;
+        op = IoOp_Read;
+        released = false;
     }
 };
 
@@ -55,9 +90,22 @@ private:
     bool                 exited;      ///< 标志已经退出
     int                  exit_code;   ///< 退出时的代码
     bool                 req_quit;    ///< 请求退出
+    bool                 running;     ///< 派遣循环是否在运行[mutex保护]
+
+    poll_slots<ky_pair>  object_list; ///< 本线程的所有对象，与event_poll的id一致
+    ky_array<int>        indirect_list; ///< 句柄不是下标的注册id(如信号)
+    ky_mpsc_queue        post_queue;  ///< 本线程内所有需要寄送的事件(无锁)
+
+    //! 每批默认最多寄送的事件数，超过后先检查一次IO再继续
+    enum {PostBatch = 64};
+    int                  post_budget; ///< 每批最多寄送的事件数[<=0 不限制]
+
+    ky_timer_wheel       timers;      ///< 本线程的定时器
+    ky_array<ky_timer_pair*> timer_list; ///< 按id索引的定时器节点
+    ky_array<int>        timer_free;  ///< 可复用的定时器id
 
-    ky_map<int, ky_pair> object_list; ///< 本线程的所有对象
-    ky_queue<ky_post>    post_queue;  ///< 本线程内所有需要寄送的事件
+    ky_array<ky_io_pair> io_list;     ///< 按id索引的未完成异步IO
+    ky_array<int>        io_free;     ///< 可复用的异步IO id
 
     //! 全局线程列表，整个系统只存在一份列表
     static ky_map<thread_id, ky_thread*> global_thread_list;
@@ -78,6 +126,28 @@ private:
     //! \param fd
     //!
     void unregister(intptr fd);
+    //!
+    //! \brief modify 修改对象的唤醒标签
+    //! \param fd
+    //! \param ion [eIoNotifys]
+    //! \param active
+    //!
+    void modify(intptr fd, eNotifyFlags ion, bool active);
+    //!
+    //! \brief find_id 句柄注册的id
+    //! \param fd
+    //! \return -1未注册
+    //! \note 套接字的句柄即下标为O(1)，其他注册遍历indirect_list
+    //!
+    int find_id(intptr fd)const;
+    //!
+    //! \brief wait_call 注册句柄，就绪一次后注销并执行回调
+    //! \param fd
+    //! \param ion [eNotifyFlags]
+    //! \param c
+    //! \return
+    //!
+    bool wait_call(intptr fd, eNotifyFlags ion, ky_thread_call *c);
 
     //!
     //! \brief posted 事件邮寄
@@ -92,6 +162,86 @@ private:
     //! \return
     //!
     int dispatcher();
+
+    //!
+    //! \brief post_dispatch 寄送一个事件到目标
+    //! \param ep
+    //!
+    void post_dispatch(const ky_post *ep);
+    //!
+    //! \brief post_drain 批量取出并寄送事件
+    //! \param budget 最多寄送的事件数[<=0 不限制]
+    //! \return 寄送的事件数
+    //! \note 只取出开始时已入队的事件，寄送中新入队的留给下一批
+    //!
+    int post_drain(int budget);
+
+    //!
+    //! \brief timer_start 在本线程的时间轮上启动定时器
+    //! \param o 接收超时事件的对象
+    //! \param ms 超时时间(毫秒)
+    //! \param repeat 是否周期触发
+    //! \param hd 以Notify_Timer注册时的句柄，超时时按句柄通知
+    //! \return 定时器id，失败返回-1
+    //!
+    int timer_start(ky_object *o, int64 ms, bool repeat, intptr hd = -1);
+    //!
+    //! \brief timer_call 启动单次的回调定时器
+    //! \param ms
+    //! \param c
+    //! \return 定时器id，失败返回-1
+    //!
+    int timer_call(int64 ms, ky_thread_call *c);
+    //!
+    //! \brief timer_alloc 取得空闲的定时器节点，优先复用回收的id
+    //!
+    ky_timer_pair *timer_alloc();
+    //!
+    //! \brief timer_restart 从当前重新计时
+    //! \param o 定时器所属对象，id不属于该对象时失败
+    //! \param id
+    //! \param ms 新的超时时间[<0 使用原来的超时]
+    //! \return
+    //!
+    bool timer_restart(const ky_object *o, int id, int64 ms);
+    //!
+    //! \brief timer_stop 停止定时器并回收id
+    //! \param o 定时器所属对象[=0 回调定时器]，id不属于该对象时忽略
+    //! \param id
+    //!
+    void timer_stop(const ky_object *o, int id);
+    //!
+    //! \brief timer_dispatch 推进时间轮并派遣到期的定时器
+    //! \param stamp 本次唤醒的时间戳
+    //!
+    void timer_dispatch(int64 stamp);
+
+    //!
+    //! \brief io_submit 提交异步IO，在下一次轮询时与其他请求一起进入内核
+    //! \param o 接收完成事件的对象
+    //! \param req
+    //! \return 请求id，失败返回-1
+    //!
+    int io_submit(ky_object *o, const ky_io_request &req);
+    //!
+    //! \brief io_cancel 取消未完成的异步IO，id在取消的完成派遣后回收
+    //! \param o 提交IO的对象，id不属于该对象时失败
+    //! \param id
+    //! \return
+    //!
+    bool io_cancel(const ky_object *o, int id);
+    //!
+    //! \brief io_dispatch 派遣本次轮询完成的异步IO
+    //! \param stamp 本次唤醒的时间戳
+    //!
+    void io_dispatch(int64 stamp);
+
+    //!
+    //! \brief release 对象析构时停止其定时器并取消未完成的异步IO
+    //! \param o
+    //! \note 取消的IO的id在最后一次完成后回收，完成不再派遣到对象
+    //!
+    void release(ky_object *o);
 };
 
 class main_thread : public ky_thread
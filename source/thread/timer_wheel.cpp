@@ -0,0 +1,283 @@
+#include "thread/ky_timer_wheel.h"
+#include "arch/ky_timer.h"
+
+namespace
+{
+//! 最低的置位，v不能为0
+inline int first_bit(uint64 v)
+{
+#if kyCompilerIsGNUC || kyCompilerIsCLANG
+    return __builtin_ctzll(v);
+#else
+    int n = 0;
+    while (!(v & 1))
+    {
+        v >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+//! 从from开始(含)循环查找置位，返回距离from的格数，v不能为0
+inline int rotate_bit(uint64 v, int from)
+{
+    const uint64 r = from ? (v >> from) | (v << (64 - from)) : v;
+    return first_bit(r);
+}
+
+inline void list_init(ky_timer_node *head)
+{
+    head->prev = head->next = head;
+}
+inline void list_append(ky_timer_node *head, ky_timer_node *t)
+{
+    t->next = head;
+    t->prev = head->prev;
+    head->prev->next = t;
+    head->prev = t;
+}
+
+//! 超过最高层范围的按最远一格放置，下放时重新计算
+const int64 MaxDelta = (int64(1) << (ky_timer_wheel::RootBits +
+                                     ky_timer_wheel::Levels * ky_timer_wheel::LevelBits)) - 1;
+
+inline int level_shift(int level)
+{
+    return ky_timer_wheel::RootBits + level * ky_timer_wheel::LevelBits;
+}
+}
+
+ky_timer_wheel::ky_timer_wheel(int64 now):
+    base(now + 1),
+    counts(0),
+    wheel_counts(0)
+{
+    for (int i = 0; i < Slots; ++i)
+        list_init(&wheel[i]);
+    list_init(&expired);
+    for (int i = 0; i < RootSize / 64; ++i)
+        root_map[i] = 0;
+    for (int i = 0; i < Levels; ++i)
+        level_map[i] = 0;
+}
+ky_timer_wheel::~ky_timer_wheel()
+{
+}
+
+int64 ky_timer_wheel::now()
+{
+    return int64(ky_timer::nanosec(ky_timer::Monotonic) / 1000000);
+}
+
+void ky_timer_wheel::place(ky_timer_node *t)
+{
+    int64 at = t->expire < base ? base : t->expire;
+    int64 delta = at - base;
+    int slot = 0;
+    if (delta < RootSize)
+    {
+        slot = int(at & (RootSize - 1));
+        root_map[slot >> 6] |= uint64(1) << (slot & 63);
+    }
+    else
+    {
+        if (delta > MaxDelta)
+        {
+            delta = MaxDelta;
+            at = base + MaxDelta;
+        }
+        int level = 0;
+        while (level < Levels - 1 && delta >= (int64(1) << level_shift(level + 1)))
+            ++level;
+        const int index = int((at >> level_shift(level)) & (LevelSize - 1));
+        slot = RootSize + level * LevelSize + index;
+        level_map[level] |= uint64(1) << index;
+    }
+    t->slot = slot;
+    list_append(&wheel[slot], t);
+    ++wheel_counts;
+}
+
+void ky_timer_wheel::unlink(ky_timer_node *t)
+{
+    t->prev->next = t->next;
+    t->next->prev = t->prev;
+    if (t->slot >= Slots)
+        return ;
+
+    --wheel_counts;
+    ky_timer_node *head = &wheel[t->slot];
+    if (head->next != head)
+        return ;
+    if (t->slot < RootSize)
+        root_map[t->slot >> 6] &= ~(uint64(1) << (t->slot & 63));
+    else
+    {
+        const int s = t->slot - RootSize;
+        level_map[s / LevelSize] &= ~(uint64(1) << (s & (LevelSize - 1)));
+    }
+}
+
+void ky_timer_wheel::start(ky_timer_node *t, int64 timeout, int64 interval)
+{
+    if (is_active(t))
+        unlink(t);
+    else
+        ++counts;
+
+    // 以最近一次推进的时间为起点，与同一次唤醒内的其他定时保持一致
+    t->expire = base - 1 + (timeout > 0 ? timeout : 0);
+    t->interval = interval;
+    place(t);
+}
+
+void ky_timer_wheel::stop(ky_timer_node *t)
+{
+    if (!is_active(t))
+        return ;
+    unlink(t);
+    t->slot = -1;
+    --counts;
+}
+
+void ky_timer_wheel::cascade(int level, int index)
+{
+    ky_timer_node *head = &wheel[RootSize + level * LevelSize + index];
+    if (head->next == head)
+        return ;
+
+    ky_timer_node *t = head->next;
+    head->prev->next = 0;
+    list_init(head);
+    level_map[level] &= ~(uint64(1) << index);
+    while (t)
+    {
+        ky_timer_node *next = t->next;
+        --wheel_counts;
+        place(t);
+        t = next;
+    }
+}
+
+void ky_timer_wheel::expire_root(int index)
+{
+    ky_timer_node *head = &wheel[index];
+    if (head->next == head)
+        return ;
+
+    for (ky_timer_node *t = head->next; t != head; t = t->next)
+    {
+        t->slot = Slots;
+        --wheel_counts;
+    }
+    // 整格接到到期列表尾部
+    head->next->prev = expired.prev;
+    expired.prev->next = head->next;
+    head->prev->next = &expired;
+    expired.prev = head->prev;
+    list_init(head);
+    root_map[index >> 6] &= ~(uint64(1) << (index & 63));
+}
+
+int64 ky_timer_wheel::next_tick()const
+{
+    int64 tick = -1;
+
+    // 根轮内的节点都在[base, base + RootSize)范围
+    const int root = int(base & (RootSize - 1));
+    for (int k = 0; k <= RootSize / 64; ++k)
+    {
+        // 先查找root之后，再回绕查找root之前
+        const int word = ((root >> 6) + k) & (RootSize / 64 - 1);
+        uint64 bits = root_map[word];
+        if (k == 0)
+            bits &= ~uint64(0) << (root & 63);
+        else if (k == RootSize / 64)
+            bits &= (uint64(1) << (root & 63)) - 1;
+        if (bits)
+        {
+            const int slot = word * 64 + first_bit(bits);
+            tick = base - root + slot + (slot < root ? RootSize : 0);
+            break;
+        }
+    }
+
+    // 各层在低位全为0的时间点下放，取最近一个非空格的下放时间
+    for (int level = 0; level < Levels; ++level)
+    {
+        if (!level_map[level])
+            continue;
+        const int shift = level_shift(level);
+        const int64 mask = (int64(1) << shift) - 1;
+        const int64 first = (base + mask) & ~mask;
+        const int index = int((first >> shift) & (LevelSize - 1));
+        const int64 at = first + (int64(rotate_bit(level_map[level], index)) << shift);
+        if (tick < 0 || at < tick)
+            tick = at;
+    }
+    return tick;
+}
+
+int ky_timer_wheel::advance(int64 now)
+{
+    while (base <= now)
+    {
+        // 跳过没有节点需要处理的时间点
+        const int64 tick = wheel_counts ? next_tick() : -1;
+        if (tick < 0 || tick > now)
+        {
+            base = now + 1;
+            break;
+        }
+        base = tick;
+
+        const int root = int(base & (RootSize - 1));
+        if (root == 0)
+        {
+            for (int level = 0; level < Levels; ++level)
+            {
+                const int index = int((base >> level_shift(level)) & (LevelSize - 1));
+                cascade(level, index);
+                if (index != 0)
+                    break;
+            }
+        }
+        expire_root(root);
+        ++base;
+    }
+    return counts - wheel_counts;
+}
+
+ky_timer_node *ky_timer_wheel::fetch()
+{
+    ky_timer_node *t = expired.next;
+    if (t == &expired)
+        return 0;
+
+    unlink(t);
+    if (t->interval > 0)
+    {
+        // 周期按原定的到期时间累加，落后超过一个周期则从当前重新计时
+        t->expire += t->interval;
+        if (t->expire < base)
+            t->expire = base - 1 + t->interval;
+        place(t);
+    }
+    else
+    {
+        t->slot = -1;
+        --counts;
+    }
+    return t;
+}
+
+int64 ky_timer_wheel::next_timeout(int64 now)const
+{
+    if (expired.next != &expired)
+        return 0;
+    if (!wheel_counts)
+        return -1;
+    const int64 tick = next_tick();
+    return tick > now ? tick - now : 0;
+}
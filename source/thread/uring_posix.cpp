@@ -0,0 +1,309 @@
+#include "ky_define.h"
+
+#if kyOSIsLinux && defined(kyHasIoUring)
+#include "uring_posix.h"
+#include "arch/ky_atomic.h"
+#include "arch/ky_memory.h"
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+
+namespace
+{
+inline int sys_setup(uint32 entries, io_uring_params *p)
+{
+    return (int)::syscall(__NR_io_uring_setup, entries, p);
+}
+inline int sys_enter(int fd, uint32 submit, uint32 complete, uint32 flags, void *arg, size_t size)
+{
+    return (int)::syscall(__NR_io_uring_enter, fd, submit, complete, flags, arg, size);
+}
+inline int sys_register(int fd, uint32 op, const void *arg, uint32 count)
+{
+    return (int)::syscall(__NR_io_uring_register, fd, op, arg, count);
+}
+inline volatile uint32 *ring_at(void *ring, uint32 off)
+{
+    return (volatile uint32 *)((char *)ring + off);
+}
+}
+
+uring_posix::uring_posix(uint32 entries):
+    ring_fd(-1),
+    features(0),
+    sq_head(0),
+    sq_tail(0),
+    sq_flags(0),
+    sq_mask(0),
+    sq_entries(0),
+    sq_array(0),
+    sqes(0),
+    sq_pending(0),
+    cq_head(0),
+    cq_tail(0),
+    cq_mask(0),
+    cqes(0),
+    sq_ring(MAP_FAILED),
+    sq_ring_size(0),
+    cq_ring(MAP_FAILED),
+    cq_ring_size(0),
+    sqes_size(0),
+    timeout_armed(false)
+{
+    ops[0] = ops[1] = ops[2] = ops[3] = 0;
+
+    io_uring_params p;
+    ky_memory::zero(&p, sizeof(p));
+    // 完成队列加倍，就绪检测和IO完成同时到达时不易溢出
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = entries * 2;
+    int fd = sys_setup(entries, &p);
+    if (fd < 0 && errno == EINVAL)
+    {
+        ky_memory::zero(&p, sizeof(p));
+        fd = sys_setup(entries, &p);
+    }
+    if (fd < 0)
+        return ;
+
+    sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(uint32);
+    cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        sq_ring_size = cq_ring_size = sq_ring_size > cq_ring_size ? sq_ring_size : cq_ring_size;
+
+    sq_ring = ::mmap(0, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED)
+    {
+        ::close(fd);
+        return ;
+    }
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        cq_ring = sq_ring;
+    else
+    {
+        cq_ring = ::mmap(0, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         fd, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED)
+        {
+            ::munmap(sq_ring, sq_ring_size);
+            sq_ring = MAP_FAILED;
+            ::close(fd);
+            return ;
+        }
+    }
+    sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+    sqes = (io_uring_sqe *)::mmap(0, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        sqes = 0;
+        if (cq_ring != sq_ring)
+            ::munmap(cq_ring, cq_ring_size);
+        ::munmap(sq_ring, sq_ring_size);
+        sq_ring = cq_ring = MAP_FAILED;
+        ::close(fd);
+        return ;
+    }
+
+    sq_head = ring_at(sq_ring, p.sq_off.head);
+    sq_tail = ring_at(sq_ring, p.sq_off.tail);
+    sq_flags = ring_at(sq_ring, p.sq_off.flags);
+    sq_mask = *ring_at(sq_ring, p.sq_off.ring_mask);
+    sq_entries = *ring_at(sq_ring, p.sq_off.ring_entries);
+    sq_array = (uint32 *)ring_at(sq_ring, p.sq_off.array);
+    // 提交项与索引一一对应，之后只需移动尾部
+    for (uint32 i = 0; i < sq_entries; ++i)
+        sq_array[i] = i;
+
+    cq_head = ring_at(cq_ring, p.cq_off.head);
+    cq_tail = ring_at(cq_ring, p.cq_off.tail);
+    cq_mask = *ring_at(cq_ring, p.cq_off.ring_mask);
+    cqes = (io_uring_cqe *)ring_at(cq_ring, p.cq_off.cqes);
+
+    ring_fd = fd;
+    features = p.features;
+
+    // 查询支持的操作码，旧内核不支持查询时按5.1的基本操作处理
+    const size_t probe_size = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    io_uring_probe *probe = (io_uring_probe *)kyMalloc(probe_size);
+    if (probe)
+    {
+        ky_memory::zero(probe, probe_size);
+        if (sys_register(ring_fd, IORING_REGISTER_PROBE, probe, 256) >= 0)
+        {
+            for (int i = 0; i < probe->ops_len && i < 256; ++i)
+                if (probe->ops[i].flags & IO_URING_OP_SUPPORTED)
+                    ops[probe->ops[i].op >> 6] |= uint64(1) << (probe->ops[i].op & 63);
+        }
+        else
+        {
+            for (int op = IORING_OP_NOP; op <= IORING_OP_POLL_REMOVE; ++op)
+                ops[op >> 6] |= uint64(1) << (op & 63);
+        }
+        kyFree(probe);
+    }
+}
+
+uring_posix::~uring_posix()
+{
+    if (ring_fd < 0)
+        return ;
+    ::munmap(sqes, sqes_size);
+    if (cq_ring != sq_ring)
+        ::munmap(cq_ring, cq_ring_size);
+    ::munmap(sq_ring, sq_ring_size);
+    ::close(ring_fd);
+}
+
+bool uring_posix::has_op(int op)const
+{
+    if (op < 0 || op >= 256)
+        return false;
+    return (ops[op >> 6] >> (op & 63)) & 1;
+}
+
+io_uring_sqe *uring_posix::sqe()
+{
+    if (ring_fd < 0)
+        return 0;
+
+    uint32 tail = *sq_tail;
+    if (tail - atomic_base::load(*sq_head, Fence_Acquire) >= sq_entries)
+    {
+        submit(false);
+        if (tail - atomic_base::load(*sq_head, Fence_Acquire) >= sq_entries)
+            return 0;
+    }
+    io_uring_sqe *s = &sqes[tail & sq_mask];
+    ky_memory::zero(s, sizeof(io_uring_sqe));
+    // 内核只在io_uring_enter时读取，调用者在此之前填写完成即可
+    atomic_base::store(*sq_tail, tail + 1, Fence_Release);
+    ++sq_pending;
+    return s;
+}
+
+int uring_posix::submit(bool wait, int64 timeout)
+{
+    if (ring_fd < 0)
+        return -EBADF;
+
+    uint32 flags = 0;
+    uint32 complete = 0;
+    io_uring_getevents_arg arg;
+    void *argp = 0;
+    size_t arg_size = 0;
+    __kernel_timespec ts;
+
+    // 等待时总是带GETEVENTS，内核会同时把溢出的完成项放回完成队列
+    if (wait)
+        flags |= IORING_ENTER_GETEVENTS;
+    if (wait && timeout != 0)
+    {
+        complete = 1;
+        if (timeout > 0)
+        {
+            ts.tv_sec = timeout / 1000;
+            ts.tv_nsec = (timeout % 1000) * 1000000;
+            if (features & IORING_FEAT_EXT_ARG)
+            {
+                ky_memory::zero(&arg, sizeof(arg));
+                arg.sigmask_sz = _NSIG / 8;
+                arg.ts = (uint64)(uintptr)&ts;
+                argp = &arg;
+                arg_size = sizeof(arg);
+                flags |= IORING_ENTER_EXT_ARG;
+            }
+            else
+            {
+                // 以超时请求唤醒，上一次未到期的先删除
+                if (timeout_armed)
+                {
+                    io_uring_sqe *r = sqe();
+                    if (r)
+                    {
+                        r->opcode = IORING_OP_TIMEOUT_REMOVE;
+                        r->addr = internal(Timeout);
+                        r->user_data = internal(TimeoutRemove);
+                    }
+                }
+                io_uring_sqe *t = sqe();
+                if (t)
+                {
+                    timeout_ts = ts;
+                    t->opcode = IORING_OP_TIMEOUT;
+                    t->addr = (uint64)(uintptr)&timeout_ts;
+                    t->len = 1;
+                    t->user_data = internal(Timeout);
+                    timeout_armed = true;
+                }
+            }
+        }
+    }
+    // 无提交、不阻塞且没有溢出的完成项时不需要进入内核
+    const bool overflow = (atomic_base::load(*sq_flags, Fence_Acquire) & IORING_SQ_CQ_OVERFLOW) != 0;
+    if (!sq_pending && !complete && !(wait && overflow))
+        return 0;
+
+    int res = 0;
+    do
+    {
+        res = sys_enter(ring_fd, sq_pending, complete, flags, argp, arg_size);
+    } while (res < 0 && errno == EINTR && !complete);
+
+    const int err = errno;
+    // 等待超时或被中断时已提交的项不会体现在返回值中，以内核的头部为准
+    sq_pending = *sq_tail - atomic_base::load(*sq_head, Fence_Acquire);
+    return res < 0 ? -err : res;
+}
+
+uint32 uring_posix::ready()const
+{
+    if (ring_fd < 0)
+        return 0;
+    return atomic_base::load(*cq_tail, Fence_Acquire) - *cq_head;
+}
+
+io_uring_cqe *uring_posix::peek()
+{
+    while (ready())
+    {
+        io_uring_cqe *c = &cqes[*cq_head & cq_mask];
+        if (!is_internal(c->user_data))
+            return c;
+        if (c->user_data == internal(Timeout))
+            timeout_armed = false;
+        seen();
+    }
+    return 0;
+}
+
+void uring_posix::seen()
+{
+    atomic_base::store(*cq_head, *cq_head + 1, Fence_Release);
+}
+
+bool uring_posix::register_files(const int *fds, int count)
+{
+    if (ring_fd < 0)
+        return false;
+    // 重新注册前先注销旧的
+    sys_register(ring_fd, IORING_UNREGISTER_FILES, 0, 0);
+    if (count <= 0)
+        return true;
+    return sys_register(ring_fd, IORING_REGISTER_FILES, fds, (uint32)count) >= 0;
+}
+
+bool uring_posix::register_buffers(const iovec *vec, int count)
+{
+    if (ring_fd < 0)
+        return false;
+    sys_register(ring_fd, IORING_UNREGISTER_BUFFERS, 0, 0);
+    if (count <= 0)
+        return true;
+    return sys_register(ring_fd, IORING_REGISTER_BUFFERS, vec, (uint32)count) >= 0;
+}
+
+#endif
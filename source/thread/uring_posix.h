@@ -0,0 +1,92 @@
+#ifndef URING_POSIX_H
+#define URING_POSIX_H
+
+#include "ky_define.h"
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+//!
+//! \brief The uring_posix struct io_uring的提交和完成队列(直接使用系统调用)
+//! \note 只能在一个线程内使用，不使用SQPOLL，提交项在io_uring_enter时才被内核读取
+//!
+struct uring_posix
+{
+    //! 内部使用的user_data(高32位为Internal)，完成时自动跳过
+    enum
+    {
+        Internal = 0x7fffffff,
+        Timeout = 1,
+        TimeoutRemove,
+        Cancel,
+        Provide,
+        PollRemove
+    };
+    static uint64 internal(int kind) {return (uint64(Internal) << 32) | uint64(kind);}
+    static bool is_internal(uint64 data) {return (data >> 32) == uint64(Internal);}
+
+    explicit uring_posix(uint32 entries = 256);
+    ~uring_posix();
+
+    bool is_valid()const {return ring_fd >= 0;}
+    //!
+    //! \brief has_op 内核是否支持操作码
+    //!
+    bool has_op(int op)const;
+
+    //!
+    //! \brief sqe 取得一个清零的提交项，队列满时先提交一次
+    //! \return 0队列满且提交失败
+    //!
+    io_uring_sqe *sqe();
+    //!
+    //! \brief submit 提交所有未提交的项，并可等待完成
+    //! \param wait 是否等待至少一个完成
+    //! \param timeout 等待的超时(毫秒)[-1 一直等待]
+    //! \return 内核接受的提交项数，失败返回-errno
+    //!
+    int submit(bool wait, int64 timeout = -1);
+    //!
+    //! \brief peek 查看一个完成项，内部项会被跳过
+    //! \return 0无可用
+    //!
+    io_uring_cqe *peek();
+    //!
+    //! \brief seen 释放peek返回的完成项
+    //!
+    void seen();
+    //! 可取出的完成项数
+    uint32 ready()const;
+
+    bool register_files(const int *fds, int count);
+    bool register_buffers(const iovec *vec, int count);
+
+    int               ring_fd;
+    uint32            features;
+    uint64            ops[4];        ///< 支持的操作码
+
+    volatile uint32  *sq_head;
+    volatile uint32  *sq_tail;
+    volatile uint32  *sq_flags;
+    uint32            sq_mask;
+    uint32            sq_entries;
+    uint32           *sq_array;
+    io_uring_sqe     *sqes;
+    uint32            sq_pending;    ///< 未提交的项数
+
+    volatile uint32  *cq_head;
+    volatile uint32  *cq_tail;
+    uint32            cq_mask;
+    io_uring_cqe     *cqes;
+
+    void             *sq_ring;
+    size_t            sq_ring_size;
+    void             *cq_ring;
+    size_t            cq_ring_size;
+    size_t            sqes_size;
+
+    //! 不支持EXT_ARG的内核以超时请求实现等待超时
+    __kernel_timespec timeout_ts;
+    bool              timeout_armed;
+};
+
+#endif // URING_POSIX_H
@@ -1,6 +1,12 @@
 #include "ky_algorlthm.h"
+#include <string.h>
+#include <time.h>
+#if kyOSIsUnix || kyOSIsLinux
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
-namespace __hash_
+namespace __hash__
 {
     // RS Hash Function
     u32 RS (char *str, i64 len)
@@ -139,7 +145,7 @@ namespace __hash_
         }
         return fnv_prime;
     }
-    u64 FNV64(char* str, size_t len)
+    u64 FNV64(char* str, i64 len)
     {
         u64 fnv_prime = 0xcbf29ce484222325;
         for(i64 i = 0; i < len; i++)
@@ -149,7 +155,7 @@ namespace __hash_
         }
         return fnv_prime;
     }
-    u32 H64(u64 v)
+    u64 H64(u64 v)
     {
         v = (~v) + (v << 18); // v = (v << 18) - v - 1;
         v = v ^ (v >> 31);
@@ -157,6 +163,248 @@ namespace __hash_
         v = v ^ (v >> 11);
         v = v + (v << 6);
         v = v ^ (v >> 22);
-        return (u32) v;
+        return v;
+    }
+
+    ///< wyhash 默认的秘钥
+    static const u64 wyp[4] =
+    {
+        0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+        0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+    };
+    ///< 长数据通道的秘钥和初始值
+    static const u64 wys[8] =
+    {
+        0xbe4ba423396cfeb8ull, 0x1cad21f72c81017cull,
+        0xdb979083e96dd4deull, 0x1f67b3b7a4a44072ull,
+        0x78e5c0cc4ee679cbull, 0x2172ffcc7dd05a82ull,
+        0x8e2443f7744608b8ull, 0x4c263a81e69035e0ull
+    };
+    static const u64 wyacc[8] =
+    {
+        0x00000000c2b2ae3dull, 0x9e3779b185ebca87ull,
+        0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull,
+        0x85ebca77c2b2ae63ull, 0x0000000085ebca77ull,
+        0x27d4eb2f165667c5ull, 0x000000009e3779b1ull
+    };
+
+    enum
+    {
+        WyStripe = 64,          ///< 长数据每次处理的字节数
+        WyBlock = 16,           ///< 每多少个stripe打乱一次通道
+        WyLong = 256            ///< 使用长数据通道的最小字节数
+    };
+
+    static inline void wy_mum(u64 *a, u64 *b)
+    {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t r = *a;
+        r *= *b;
+        *a = (u64)r;
+        *b = (u64)(r >> 64);
+#else
+        const u64 ha = *a >> 32, hb = *b >> 32, la = (u32)*a, lb = (u32)*b;
+        const u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        const u64 t = rl + (rm0 << 32);
+        u64 c = t < rl;
+        const u64 lo = t + (rm1 << 32);
+        c += lo < t;
+        *a = lo;
+        *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+    }
+    static inline u64 wy_mix(u64 a, u64 b) {wy_mum(&a, &b); return a ^ b;}
+    static inline u64 wy_r8(const u8 *p) {u64 v; ::memcpy(&v, p, 8); return v;}
+    static inline u64 wy_r4(const u8 *p) {u32 v; ::memcpy(&v, p, 4); return v;}
+    static inline u64 wy_r3(const u8 *p, i64 k)
+    {
+        return (((u64)p[0]) << 16) | (((u64)p[k >> 1]) << 8) | p[k - 1];
+    }
+
+    //!
+    //! \brief wy_short wyhash的主体，按48字节分三路混合
+    //!
+    static u64 wy_short(const u8 *p, i64 len, u64 seed)
+    {
+        u64 a, b;
+        seed ^= wy_mix(seed ^ wyp[0], wyp[1]);
+        if (kyLikely(len <= 16))
+        {
+            if (kyLikely(len >= 4))
+            {
+                a = (wy_r4(p) << 32) | wy_r4(p + ((len >> 3) << 2));
+                b = (wy_r4(p + len - 4) << 32) | wy_r4(p + len - 4 - ((len >> 3) << 2));
+            }
+            else if (kyLikely(len > 0))
+            {
+                a = wy_r3(p, len);
+                b = 0;
+            }
+            else
+                a = b = 0;
+        }
+        else
+        {
+            i64 i = len;
+            if (kyUnLikely(i >= 48))
+            {
+                u64 see1 = seed, see2 = seed;
+                do
+                {
+                    seed = wy_mix(wy_r8(p) ^ wyp[1], wy_r8(p + 8) ^ seed);
+                    see1 = wy_mix(wy_r8(p + 16) ^ wyp[2], wy_r8(p + 24) ^ see1);
+                    see2 = wy_mix(wy_r8(p + 32) ^ wyp[3], wy_r8(p + 40) ^ see2);
+                    p += 48;
+                    i -= 48;
+                } while (kyLikely(i >= 48));
+                seed ^= see1 ^ see2;
+            }
+            while (kyUnLikely(i > 16))
+            {
+                seed = wy_mix(wy_r8(p) ^ wyp[1], wy_r8(p + 8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+            a = wy_r8(p + i - 16);
+            b = wy_r8(p + i - 8);
+        }
+        a ^= wyp[1];
+        b ^= seed;
+        wy_mum(&a, &b);
+        return wy_mix(a ^ wyp[0] ^ (u64)len, b ^ wyp[1]);
+    }
+
+    //!
+    //! \brief wy_accumulate 8路64位通道累加stripes个64字节块
+    //!        acc[i] += lo32(d^k) * hi32(d^k), acc[i^1] += d
+    //!
+#if kyHAS_SSE2
+    static void wy_accumulate(u64 *acc, const u8 *p, i64 stripes, const u64 *key)
+    {
+        __m128i va[4], vk[4];
+        for (int j = 0; j < 4; ++j)
+        {
+            va[j] = _mm_loadu_si128((const __m128i*)(acc + j * 2));
+            vk[j] = _mm_loadu_si128((const __m128i*)(key + j * 2));
+        }
+        for (i64 s = 0; s < stripes; ++s, p += WyStripe)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                const __m128i dv = _mm_loadu_si128((const __m128i*)(p + j * 16));
+                const __m128i dk = _mm_xor_si128(dv, vk[j]);
+                const __m128i dh = _mm_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1));
+                const __m128i pr = _mm_mul_epu32(dk, dh);
+                const __m128i sw = _mm_shuffle_epi32(dv, _MM_SHUFFLE(1, 0, 3, 2));
+                va[j] = _mm_add_epi64(_mm_add_epi64(va[j], sw), pr);
+            }
+        }
+        for (int j = 0; j < 4; ++j)
+            _mm_storeu_si128((__m128i*)(acc + j * 2), va[j]);
+    }
+#elif kyHAS_NEON
+    static void wy_accumulate(u64 *acc, const u8 *p, i64 stripes, const u64 *key)
+    {
+        uint64x2_t va[4], vk[4];
+        for (int j = 0; j < 4; ++j)
+        {
+            va[j] = vld1q_u64(acc + j * 2);
+            vk[j] = vld1q_u64(key + j * 2);
+        }
+        for (i64 s = 0; s < stripes; ++s, p += WyStripe)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                const uint64x2_t dv = vreinterpretq_u64_u8(vld1q_u8(p + j * 16));
+                const uint64x2_t dk = veorq_u64(dv, vk[j]);
+                const uint64x2_t pr = vmull_u32(vmovn_u64(dk), vshrn_n_u64(dk, 32));
+                va[j] = vaddq_u64(vaddq_u64(va[j], vextq_u64(dv, dv, 1)), pr);
+            }
+        }
+        for (int j = 0; j < 4; ++j)
+            vst1q_u64(acc + j * 2, va[j]);
+    }
+#else
+    static void wy_accumulate(u64 *acc, const u8 *p, i64 stripes, const u64 *key)
+    {
+        for (i64 s = 0; s < stripes; ++s, p += WyStripe)
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                const u64 dv = wy_r8(p + i * 8);
+                const u64 dk = dv ^ key[i];
+                acc[i ^ 1] += dv;
+                acc[i] += (u64)(u32)dk * (dk >> 32);
+            }
+        }
+    }
+#endif
+    static inline void wy_scramble(u64 *acc, const u64 *key)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            u64 a = acc[i];
+            a ^= a >> 47;
+            a ^= key[i];
+            acc[i] = a * 0x9e3779b1ull;
+        }
+    }
+
+    //!
+    //! \brief wy_long 长数据先并行累加，再将通道和最后一个stripe混合
+    //!
+    static u64 wy_long(const u8 *p, i64 len, u64 seed)
+    {
+        const u8 *const start = p;
+        u64 key[8], acc[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            key[i] = wys[i] + seed;
+            acc[i] = wyacc[i];
+        }
+
+        i64 stripes = (len - 1) / WyStripe;
+        while (stripes >= WyBlock)
+        {
+            wy_accumulate(acc, p, WyBlock, key);
+            wy_scramble(acc, key);
+            p += WyBlock * WyStripe;
+            stripes -= WyBlock;
+        }
+        wy_accumulate(acc, p, stripes, key);
+
+        u64 h = seed ^ ((u64)len * wyp[0]);
+        for (int i = 0; i < 8; i += 2)
+            h = wy_mix(acc[i] ^ key[i], acc[i + 1] ^ key[i + 1] ^ h);
+        return wy_short(start + len - WyStripe, WyStripe, h);
+    }
+
+    u64 WY(const void *data, i64 len, u64 seed)
+    {
+        if (len >= WyLong)
+            return wy_long((const u8*)data, len, seed);
+        return wy_short((const u8*)data, len, seed);
+    }
+
+    static u64 seed_init()
+    {
+        u64 s = 0;
+#if kyOSIsUnix || kyOSIsLinux
+        const int fd = ::open("/dev/urandom", O_RDONLY);
+        if (fd >= 0)
+        {
+            if (::read(fd, &s, sizeof(s)) != (ssize_t)sizeof(s))
+                s = 0;
+            ::close(fd);
+        }
+#endif
+        // 没有随机设备时使用地址(ASLR)和时间
+        s ^= (u64)::time(0) ^ (u64)(uintptr)&s ^ ((u64)(uintptr)&seed_init << 21);
+        return wy_mix(s ^ wyp[0], wyp[1]);
+    }
+    u64 seed()
+    {
+        static const u64 process_seed = seed_init();
+        return process_seed;
     }
 }
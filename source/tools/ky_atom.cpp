@@ -0,0 +1,193 @@
+#include "tools/ky_atom.h"
+#include "thread/ky_lock.h"
+
+namespace
+{
+enum
+{
+    ShardBits = 4,
+    ShardCount = 1 << ShardBits,    ///< 分片数，按散列高位选择
+    InitCapacity = 64               ///< 分片初始槽数(2的幂)
+};
+
+//!
+//! \brief The atom_shard struct 驻留池的一个分片
+//! \note 开放寻址，线性探测，槽内只存项的地址，比较时先比较缓存的散列
+//!       持有自旋锁时只查找和放置，项和槽表都在锁外申请
+//!
+struct atom_shard
+{
+    ky_spinlock      lock;
+    ky_atom::entry **slots;
+    int64            capacity;
+    int64            count;
+
+    atom_shard():slots(0), capacity(0), count(0){}
+
+    ky_atom::entry *find(const ky_string_view &s, u64 h)const
+    {
+        if (capacity == 0)
+            return 0;
+        for (int64 i = int64(h) & (capacity -1); slots[i]; i = (i +1) & (capacity -1))
+        {
+            if (slots[i]->hash == h && slots[i]->str.view() == s)
+                return slots[i];
+        }
+        return 0;
+    }
+    void place(ky_atom::entry **tab, int64 cap, ky_atom::entry *e)
+    {
+        int64 i = int64(e->hash) & (cap -1);
+        while (tab[i])
+            i = (i +1) & (cap -1);
+        tab[i] = e;
+    }
+    //! 再放入一项时装载率是否超过3/4
+    bool is_full()const {return (count +1) * 4 > capacity * 3;}
+    int64 grown()const {return capacity ? capacity * 2 : InitCapacity;}
+
+    //!
+    //! \brief rehash 把所有项移入新的槽表tab
+    //! \return 旧的槽表，由调用者在锁外释放
+    //!
+    ky_atom::entry **rehash(ky_atom::entry **tab, int64 cap)
+    {
+        for (int64 i = 0; i < capacity; ++i)
+        {
+            if (slots[i])
+                place(tab, cap, slots[i]);
+        }
+        ky_atom::entry **old = slots;
+        slots = tab;
+        capacity = cap;
+        return old;
+    }
+    void insert(ky_atom::entry *e)
+    {
+        place(slots, capacity, e);
+        ++count;
+    }
+};
+
+ky_atom::entry **alloc_slots(int64 cap)
+{
+    ky_atom::entry **tab = (ky_atom::entry **)kyMalloc(cap * sizeof(ky_atom::entry *));
+    if (tab)
+        ky_memory::zero(tab, cap * sizeof(ky_atom::entry *));
+    return tab;
+}
+
+//! 驻留池不释放，进程结束时其它静态对象可能仍持有原子
+atom_shard *shards()
+{
+    static atom_shard *pool = kyNew(atom_shard[ShardCount]);
+    return pool;
+}
+inline atom_shard &shard_of(u64 h)
+{
+    return shards()[h >> (64 - ShardBits)];
+}
+}
+
+ky_atom::ky_atom(const ky_string_view &s):
+    d(intern(s).d)
+{
+}
+ky_atom::ky_atom(const ky_string &s):
+    d(intern(s.view()).d)
+{
+}
+ky_atom::ky_atom(const char *latin1):
+    d(0)
+{
+    const ky_string s(latin1);
+    d = intern(s.view()).d;
+}
+
+ky_atom ky_atom::intern(const ky_string_view &s)
+{
+    const u64 h = ky_hash_f(s);
+    atom_shard &sh = shard_of(h);
+    sh.lock.lock();
+    entry *e = sh.find(s, h);
+    sh.lock.unlock();
+    if (e)
+        return ky_atom(e);
+
+    // 新项和扩容的槽表在锁外申请，放入前在锁内重新查找
+    entry *n = kyNew(entry);
+    n->hash = h;
+    n->str = s.to_string();
+    entry **tab = 0;
+    entry **old = 0;
+    int64 cap = 0;
+
+    sh.lock.lock();
+    for (;;)
+    {
+        e = sh.find(s, h);
+        if (e)
+            break;
+        if (sh.is_full())
+        {
+            if (tab == 0 || cap != sh.grown())
+            {
+                // 其它线程可能在解锁期间扩容，重新按当前容量申请
+                cap = sh.grown();
+                sh.lock.unlock();
+                if (tab)
+                    kyFree(tab);
+                tab = alloc_slots(cap);
+                if (tab == 0)
+                {
+                    kyDelete(n);
+                    return ky_atom();
+                }
+                sh.lock.lock();
+                continue;
+            }
+            old = sh.rehash(tab, cap);
+            tab = 0;
+        }
+        sh.insert(n);
+        e = n;
+        n = 0;
+        break;
+    }
+    sh.lock.unlock();
+
+    if (n)
+        kyDelete(n);
+    if (tab)
+        kyFree(tab);
+    if (old)
+        kyFree(old);
+    return ky_atom(e);
+}
+ky_atom ky_atom::find(const ky_string_view &s)
+{
+    const u64 h = ky_hash_f(s);
+    atom_shard &sh = shard_of(h);
+    sh.lock.lock();
+    entry *e = sh.find(s, h);
+    sh.lock.unlock();
+    return ky_atom(e);
+}
+int64 ky_atom::count()
+{
+    int64 n = 0;
+    for (int i = 0; i < ShardCount; ++i)
+    {
+        atom_shard &sh = shards()[i];
+        sh.lock.lock();
+        n += sh.count;
+        sh.lock.unlock();
+    }
+    return n;
+}
+
+const ky_string &ky_atom::to_string()const
+{
+    static const ky_string empty;
+    return d ? d->str : empty;
+}
@@ -1,6 +1,10 @@
 #include "tools/ky_hash.h"
 
-const _ky_hash_ _ky_hash_::shared_nul = {};
+const _hash_header _hash_header::shared_nul;
 
-f32 _ky_hash_::sMaxUsageRate = .9f;        ///< 桶的最大使用率
-f32 _ky_hash_::sGrowRate     = 1.7312543f; ///< 桶的增长率
+f32 _hash_header::sMaxUsageRate = .9f;        ///< 桶的最大使用率
+f32 _hash_header::sGrowRate     = 1.7312543f; ///< 桶的增长率
+
+#include "tools/ky_flathash.h"
+
+_flathash_header _flathash_header::shared_nul;
@@ -455,6 +455,7 @@ uchar *ky_image::create(int w, int h, int d, eImagePixels f, eImageFlags flag)
     d = d<1 ? 1 : d;
     const int64 bs = !(flag & Image_Ref) ? impl::pixelbyte(w, h, d, f) : sizeof(uchar **);
     impl::pixel_image_io *phd = (impl::pixel_image_io *)kyMalloc (bs + sizeof(impl::pixel_image_io));
+    kyMemoryAlloc(ky_memory_stats::Image, bs + sizeof(impl::pixel_image_io));
     phd->set (ky_ref::refShareable);
     phd->depth = phd->rawd = d;
     phd->empty = true;
@@ -479,6 +480,10 @@ void ky_image::destroy()
             else if ((h->flag & Image_RefDel) == Image_RefDel)
                 kyDelete(bits ());
         }
+        // 和create计算相同的字节数
+        kyMemoryFree(ky_memory_stats::Image,
+                     sizeof(impl::pixel_image_io) + ((h->flag & Image_Ref) ? (int64)sizeof(uchar **) :
+                             impl::pixelbyte(h->raww, h->rawh, h->rawd, h->format)));
         kyFree (h);
     }
     data = (uchar*)impl::pixel_image_io::null ();
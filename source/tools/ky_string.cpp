@@ -6,6 +6,137 @@
 #include "ky_number_integer.h"
 #include "ky_debug.h"
 
+/////////////////////////ky_string_view////////////////////////////////
+ky_string_view::ky_string_view(const ky_string &s):
+    str(s.data()),
+    len(s.length())
+{
+}
+
+ky_string_view ky_string_view::extract(int64 pos, int64 count)const
+{
+    if (pos < 0)
+        pos = 0;
+    if (pos > len)
+        pos = len;
+    if (count < 0 || pos + count > len)
+        count = len - pos;
+    return ky_string_view(str + pos, count);
+}
+ky_string_view ky_string_view::trimmed()const
+{
+    int64 b = 0;
+    int64 e = len;
+    while (b < e && str[b].is_space())
+        ++b;
+    while (e > b && (str[e -1].is_space() || str[e -1].unicode() == 0))
+        --e;
+    return ky_string_view(str + b, e - b);
+}
+ky_string ky_string_view::to_string()const
+{
+    return ky_string(str, (int)len);
+}
+
+int64 ky_string_view::find(const ky_string_view &s, int64 from)const
+{
+    if (from < 0 || from > len)
+        return -1;
+    const int64 i = findString(str + from, len - from, s.str, s.len);
+    return i < 0 ? -1 : i + from;
+}
+int64 ky_string_view::find(const char *latin1, int64 from)const
+{
+    return find(latin1, -1, from);
+}
+int64 ky_string_view::find(const char *latin1, int64 n, int64 from)const
+{
+    if (latin1 == 0 || from < 0 || from > len)
+        return -1;
+    if (n < 0)
+        n = (int64)strlen(latin1);
+    const int64 i = findLatin1(str + from, len - from, latin1, n);
+    return i < 0 ? -1 : i + from;
+}
+int64 ky_string_view::find(ky_char c, int64 from)const
+{
+    for (int64 i = from < 0 ? 0 : from; i < len; ++i)
+    {
+        if (str[i] == c)
+            return i;
+    }
+    return -1;
+}
+
+bool ky_string_view::starts_with(const ky_string_view &s)const
+{
+    return s.len <= len && ucstrncmp(str, s.str, (int)s.len) == 0;
+}
+bool ky_string_view::starts_with(const char *latin1)const
+{
+    const int64 n = latin1 ? (int64)strlen(latin1) : 0;
+    return n <= len && ucstrcmp_latin1(str, n, latin1, n) == 0;
+}
+bool ky_string_view::ends_with(const ky_string_view &s)const
+{
+    return s.len <= len && ucstrncmp(str + len - s.len, s.str, (int)s.len) == 0;
+}
+bool ky_string_view::ends_with(const char *latin1)const
+{
+    const int64 n = latin1 ? (int64)strlen(latin1) : 0;
+    return n <= len && ucstrcmp_latin1(str + len - n, n, latin1, n) == 0;
+}
+
+template <typename C>
+ky_string_view_list ky_string_view::split_helper(const C *sep, int64 n)const
+{
+    ky_string_view_list substr;
+    if (len == 0)
+        return substr;
+    if (n <= 0)
+    {
+        substr.append(*this);
+        return substr;
+    }
+
+    int64 back = 0;
+    int64 i = 0;
+    while ((i = find_units(str + back, len - back, sep, n)) != -1)
+    {
+        substr.append(ky_string_view(str + back, i));
+        back += i + n;
+    }
+    substr.append(ky_string_view(str + back, len - back));
+    return substr;
+}
+ky_string_view_list ky_string_view::split(const ky_string_view &sep)const
+{
+    return split_helper(sep.str, sep.len);
+}
+ky_string_view_list ky_string_view::split(const char *latin1, int64 n)const
+{
+    if (latin1 && n < 0)
+        n = (int64)strlen(latin1);
+    return split_helper(latin1, latin1 ? n : 0);
+}
+
+int ky_string_view::compare(const ky_string_view &s)const
+{
+    const int64 l = ky_min(len, s.len);
+    const int cmp = ucstrncmp(str, s.str, (int)l);
+    if (cmp)
+        return cmp;
+    return len < s.len ? -1 : (len > s.len ? 1 : 0);
+}
+int ky_string_view::compare(const char *latin1, int64 n)const
+{
+    if (latin1 == 0)
+        return len ? 1 : 0;
+    if (n < 0)
+        n = (int64)strlen(latin1);
+    return ucstrcmp_latin1(str, len, latin1, n);
+}
+
 /////////////////////////ky_string////////////////////////////////
 ky_string::ky_string():
     ky_utf16()
@@ -119,7 +250,7 @@ ky_string::operator wchar_t* () const
 
 int64 ky_string::length() const
 {
-    return this->size();
+    return ky_utf16::count();
 }
 int ky_string::count() const
 {
@@ -440,9 +571,37 @@ ky_string ky_string::trimmed()const
 }
 
 /////////////////////////find/////////////////////////////////////////
+ky_string_matcher::ky_string_matcher()
+{
+}
+ky_string_matcher::ky_string_matcher(const ky_string_view &p)
+{
+    set_pattern(p);
+}
+void ky_string_matcher::set_pattern(const ky_string_view &p)
+{
+    needle = p.to_string();
+    if (needle.length() >= ky_strsearch::LongNeedle)
+        ky_strsearch::table((const uint16 *)needle.data(), needle.length(), skip);
+}
+int64 ky_string_matcher::find(const ky_string_view &s, int64 from)const
+{
+    if (from < 0 || from > s.length())
+        return -1;
+    const uint16 *str = (const uint16 *)s.data() + from;
+    const uint16 *pat = (const uint16 *)needle.data();
+    const int64 slen = s.length() - from;
+    const int64 plen = needle.length();
+
+    const int64 i = plen >= ky_strsearch::LongNeedle ?
+                ky_strsearch::horspool(str, slen, pat, plen, skip) :
+                ky_strsearch::find(str, slen, pat, plen);
+    return i < 0 ? -1 : i + from;
+}
+
 int ky_string::find(const char* str) const
 {
-    return find(ky_string(str));
+    return (int)view().find(str);
 }
 int ky_string::find(const wchar_t*str) const
 {
@@ -450,11 +609,11 @@ int ky_string::find(const wchar_t*str) const
 }
 int ky_string::find(const ky_string& str) const
 {
-    return findString((ky_char*)data(),length(), (ky_char*)str.data (), str.length ());
+    return (int)findString(data(), length(), str.data (), str.length ());
 }
 int ky_string::find(const std::string &str) const
 {
-    return find(ky_string(str));
+    return (int)view().find(str.data(), (int64)str.length(), 0);
 }
 int ky_string::find(const std::wstring &str) const
 {
@@ -462,9 +621,18 @@ int ky_string::find(const std::wstring &str) const
 }
 
 //////////////////////////////////////////////////////////////
+// 分割结果需要持有数据，这里只是避免构造分隔符的临时字符串
+static ky_string_list split_owned(const ky_string_view_list &views)
+{
+    ky_string_list substr;
+    for (ky_string_view_list::const_iterator it = views.begin(); it != views.end(); ++it)
+        substr.append(it->to_string());
+    return substr;
+}
+
 ky_string_list ky_string::split(const char*str)const
 {
-    return split(ky_string(str));
+    return split_owned(view().split(str));
 }
 ky_string_list ky_string::split(const wchar_t*str)const
 {
@@ -473,23 +641,11 @@ ky_string_list ky_string::split(const wchar_t*str)const
 
 ky_string_list ky_string::split(const ky_string&rhs)const
 {
-    ky_string_list substr;
-    int i = 0;
-    int back_i = 0;
-    int len = length();
-    while ((i = findString((ky_char*)data()+back_i, len-back_i, (ky_char*)rhs.data(), rhs.length())) != -1)
-    {
-        substr.append(ky_string(data()+back_i, i));
-
-        back_i += i + rhs.length ();
-    }
-    if (len)
-        substr.append(ky_string(data()+back_i, len - back_i));
-    return substr;
+    return split_owned(view().split(rhs.view()));
 }
 ky_string_list ky_string::split(const std::string &str)const
 {
-    return split(ky_string(str));
+    return split_owned(view().split(str.data(), (int64)str.length()));
 }
 ky_string_list ky_string::split(const std::wstring &str)const
 {
@@ -501,7 +657,7 @@ ky_string_list ky_string::split(const std::wstring &str)const
 ///////////////////////////compare////////////////////////
 int ky_string::compare(const char*str)const
 {
-    return compare(ky_string(str));
+    return view().compare(str);
 }
 int ky_string::compare(const wchar_t*str)const
 {
@@ -513,7 +669,7 @@ int ky_string::compare(const ky_string&str)const
 }
 int ky_string::compare(const std::string &str)const
 {
-    return compare(ky_string(str));
+    return view().compare(str.data(), (int64)str.length());
 }
 int ky_string::compare(const std::wstring &str)const
 {
@@ -728,7 +884,6 @@ bool ky_string::from_wchar(const wchar_t*str)
 }
 bool ky_string::from_utf8(const uint8 *utf8, int len)
 {
-    uint16 utf16[len+1];
     int64 rc = 0;
     uint error_status = 0;
     uint error_mask = 0xFFFFFFFF;
@@ -737,6 +892,10 @@ bool ky_string::from_utf8(const uint8 *utf8, int len)
     if (!utf8 || len < 1)
         return false;
 
+    // 大文本不能放在栈上
+    ky_utf16 buffer;
+    buffer.resize(len + 1);
+    uint16 *utf16 = buffer.data();
     rc = ky_unicode::convert_UTF8_UTF16(false, utf8, len, utf16, len,
                                 &error_status, error_mask, error_code_point, &p1);
 
@@ -792,19 +951,12 @@ bool ky_string::from_utf32(const uint32*utf32, int len )
 /////////////////////////////////////////////////////////////////
 ky_utf8 ky_string::to_utf8s(uint16* utf16, int len)
 {
-    static uchar tempbuf[6] = {0};
-    int f16_byte = 0;
     if (len <= 0)
         return ky_utf8();
-    for (int i = 0; i < len; ++i)
-    {
-        int bytes = ky_unicode::encode_UTF8(utf16[i], tempbuf);
-        if (f16_byte < bytes)
-            f16_byte = bytes;
-    }
 
+    // 每个UTF-16码元最多3字节(代理对两个码元4字节)，不再逐个预先编码求最大长度
     ky_utf8 oututf8;
-    oututf8.resize(len * f16_byte, '\0');
+    oututf8.resize(len * 3 + 1, '\0');
     int64 rc = 0;
     uint error_status = 0;
     uint error_mask = 0xFFFFFFFF;
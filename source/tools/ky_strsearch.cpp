@@ -0,0 +1,208 @@
+#include "ky_strsearch.h"
+#include "arch/ky_cpu.h"
+#include <string.h>
+
+#define Have_VectorSearch (kyArchIsX86 && kyArchIs64Bit && (kyCompilerIsGNUC || kyCompilerIsCLANG))
+
+#if Have_VectorSearch
+#  include <immintrin.h>
+#  define kyTargetAVX2    __attribute__((target("avx2")))
+#endif
+
+namespace
+{
+inline uint16 unit(uint16 c) {return c;}
+inline uint16 unit(uchar c) {return c;}
+
+//! 比较中间部分，首尾字符已经由过滤确定相等
+inline bool equal_units(const uint16 *s, const uint16 *n, int64 len)
+{
+    return len <= 0 || ::memcmp(s, n, len * sizeof(uint16)) == 0;
+}
+inline bool equal_units(const uint16 *s, const uchar *n, int64 len)
+{
+    for (int64 i = 0; i < len; ++i)
+    {
+        if (s[i] != n[i])
+            return false;
+    }
+    return true;
+}
+
+//! 逐个位置比较首尾字符，也用于向量循环剩余的部分
+template <typename C>
+int64 scalar_find(const uint16 *s, int64 from, int64 last, const C *n, int64 nlen)
+{
+    const uint16 first = unit(n[0]);
+    const uint16 tail = unit(n[nlen -1]);
+    for (int64 i = from; i <= last; ++i)
+    {
+        if (s[i] == first && s[i + nlen -1] == tail &&
+                equal_units(s + i +1, n +1, nlen -2))
+            return i;
+    }
+    return -1;
+}
+
+#if Have_VectorSearch
+//!
+//! \brief sse2_find 一次检查8个位置
+//! \note 同时比较候选位置的首字符和尾字符，两者都相等时才比较中间部分，
+//!       movemask每个码元占两位
+//!
+template <typename C>
+int64 sse2_find(const uint16 *s, int64 slen, const C *n, int64 nlen)
+{
+    const int64 last = slen - nlen;
+    const __m128i first = _mm_set1_epi16(short(unit(n[0])));
+    const __m128i tail = _mm_set1_epi16(short(unit(n[nlen -1])));
+    int64 i = 0;
+    for (; i + 7 <= last; i += 8)
+    {
+        const __m128i a = _mm_loadu_si128((const __m128i *)(s + i));
+        const __m128i b = _mm_loadu_si128((const __m128i *)(s + i + nlen -1));
+        uint mask = (uint)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi16(a, first),
+                                                          _mm_cmpeq_epi16(b, tail)));
+        while (mask)
+        {
+            const int bit = __builtin_ctz(mask);
+            const int64 k = i + (bit >> 1);
+            if (equal_units(s + k +1, n +1, nlen -2))
+                return k;
+            mask &= ~(3u << bit);
+        }
+    }
+    return scalar_find(s, i, last, n, nlen);
+}
+
+template <typename C>
+kyTargetAVX2 int64 avx2_find(const uint16 *s, int64 slen, const C *n, int64 nlen)
+{
+    const int64 last = slen - nlen;
+    const __m256i first = _mm256_set1_epi16(short(unit(n[0])));
+    const __m256i tail = _mm256_set1_epi16(short(unit(n[nlen -1])));
+    int64 i = 0;
+    for (; i + 15 <= last; i += 16)
+    {
+        const __m256i a = _mm256_loadu_si256((const __m256i *)(s + i));
+        const __m256i b = _mm256_loadu_si256((const __m256i *)(s + i + nlen -1));
+        uint mask = (uint)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi16(a, first),
+                                                                _mm256_cmpeq_epi16(b, tail)));
+        while (mask)
+        {
+            const int bit = __builtin_ctz(mask);
+            const int64 k = i + (bit >> 1);
+            if (equal_units(s + k +1, n +1, nlen -2))
+                return k;
+            mask &= ~(3u << bit);
+        }
+    }
+    return scalar_find(s, i, last, n, nlen);
+}
+#endif
+
+template <typename C>
+int64 generic_find(const uint16 *s, int64 slen, const C *n, int64 nlen)
+{
+    return scalar_find(s, 0, slen - nlen, n, nlen);
+}
+
+//! 查找函数表，首次使用时按cpu能力选择
+struct search_ops
+{
+    int64 (*find16)(const uint16 *s, int64 slen, const uint16 *n, int64 nlen);
+    int64 (*find8)(const uint16 *s, int64 slen, const uchar *n, int64 nlen);
+};
+
+const search_ops generic_ops = {generic_find<uint16>, generic_find<uchar>};
+#if Have_VectorSearch
+const search_ops sse2_ops = {sse2_find<uint16>, sse2_find<uchar>};
+const search_ops avx2_ops = {avx2_find<uint16>, avx2_find<uchar>};
+#endif
+
+const search_ops *current_ops = 0;
+
+const search_ops *select_ops()
+{
+    const search_ops *ops = &generic_ops;
+#if Have_VectorSearch
+    ops = &sse2_ops;
+    if (ky_cpu::has(CPU_OSE) && ky_cpu::has(CPU_AVX2))
+        ops = &avx2_ops;
+#endif
+    current_ops = ops;
+    return ops;
+}
+
+inline const search_ops *ops()
+{
+    const search_ops *o = current_ops;
+    return kyLikely(o != 0) ? o : select_ops();
+}
+
+template <typename C>
+void table_helper(const C *n, int64 nlen, int32 *skip)
+{
+    for (int i = 0; i < ky_strsearch::TableSize; ++i)
+        skip[i] = int32(nlen);
+    // 只用到nlen-1之前的字符，低字节相同的码元取较小的跳转距离
+    for (int64 i = 0; i < nlen -1; ++i)
+        skip[unit(n[i]) & 0xff] = int32(nlen -1 - i);
+}
+
+template <typename C>
+int64 horspool_helper(const uint16 *s, int64 slen, const C *n, int64 nlen, const int32 *skip)
+{
+    const uint16 tail = unit(n[nlen -1]);
+    const int64 last = slen - nlen;
+    for (int64 i = 0; i <= last; )
+    {
+        const uint16 c = s[i + nlen -1];
+        if (c == tail && equal_units(s + i, n, nlen -1))
+            return i;
+        i += skip[c & 0xff];
+    }
+    return -1;
+}
+
+template <typename C>
+int64 find_helper(const uint16 *s, int64 slen, const C *n, int64 nlen,
+                  int64 (*kernel)(const uint16 *, int64, const C *, int64))
+{
+    if (nlen <= 0)
+        return nlen == 0 ? 0 : -1;
+    if (s == 0 || n == 0 || nlen > slen)
+        return -1;
+    // 长模式在长文本中跳转更远，短文本不值得建表
+    if (nlen >= ky_strsearch::LongNeedle && slen >= nlen * 8)
+    {
+        int32 skip[ky_strsearch::TableSize];
+        table_helper(n, nlen, skip);
+        return horspool_helper(s, slen, n, nlen, skip);
+    }
+    return kernel(s, slen, n, nlen);
+}
+}
+
+int64 ky_strsearch::find(const uint16 *s, int64 slen, const uint16 *n, int64 nlen)
+{
+    return find_helper(s, slen, n, nlen, ops()->find16);
+}
+int64 ky_strsearch::find(const uint16 *s, int64 slen, const uchar *n, int64 nlen)
+{
+    return find_helper(s, slen, n, nlen, ops()->find8);
+}
+
+void ky_strsearch::table(const uint16 *n, int64 nlen, int32 *skip)
+{
+    table_helper(n, nlen, skip);
+}
+int64 ky_strsearch::horspool(const uint16 *s, int64 slen, const uint16 *n, int64 nlen,
+                             const int32 *skip)
+{
+    if (nlen <= 0)
+        return nlen == 0 ? 0 : -1;
+    if (s == 0 || nlen > slen)
+        return -1;
+    return horspool_helper(s, slen, n, nlen, skip);
+}
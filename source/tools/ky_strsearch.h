@@ -0,0 +1,29 @@
+#ifndef KY_STRSEARCH_H
+#define KY_STRSEARCH_H
+
+#include "ky_define.h"
+
+//! UTF-16子串查找，模式可以是UTF-16或latin1
+//! \note 1.短模式使用首尾字符过滤(AVX2/SSE2)，按cpu能力在首次调用时选择
+//!       2.长模式使用Horspool跳转表，跳转表按码元低字节建立
+//!       3.返回第一次出现的位置，未找到时返回-1
+namespace ky_strsearch
+{
+enum
+{
+    LongNeedle = 64,      ///< 模式长度不小于此值时使用跳转表
+    TableSize = 256       ///< 跳转表项数
+};
+
+int64 find(const uint16 *s, int64 slen, const uint16 *n, int64 nlen);
+int64 find(const uint16 *s, int64 slen, const uchar *n, int64 nlen);
+
+//!
+//! \brief table 建立Horspool跳转表
+//! \param skip TableSize项
+//!
+void  table(const uint16 *n, int64 nlen, int32 *skip);
+int64 horspool(const uint16 *s, int64 slen, const uint16 *n, int64 nlen, const int32 *skip);
+}
+
+#endif // KY_STRSEARCH_H
@@ -1,6 +1,7 @@
 
 #include "tools/ky_string.h"
 #include "ky_unicode.h"
+#include "ky_strsearch.h"
 
 void from_latin1(const char *str, int size, uint16 *buf)
 {
@@ -457,13 +458,39 @@ int findChar(ky_char *str,int slen, const ky_char &ch)
     }
     return -1;
 }
-int findString(ky_char *str,int slen, ky_char* dst, int dlen)
+//!
+//! \brief findString 在str中查找dst第一次出现的位置
+//! \note 由ky_strsearch按cpu能力选择实现，latin1的dst不需要先转换
+//!
+inline int64 findString(const ky_char *str, int64 slen, const ky_char* dst, int64 dlen)
 {
-    int bpos = -1;
-    if (!dst)
-        return -1;
-    if ((bpos = findChar (str, slen, dst[0])) != -1)
-        for (int i = 1; i < dlen && ((bpos+i) < slen); ++i)
-            bpos = str[bpos+i] == dst[i] ? bpos : -1;
-    return bpos;
+    return ky_strsearch::find(reinterpret_cast<const uint16 *>(str), slen,
+                              reinterpret_cast<const uint16 *>(dst), dlen);
+}
+inline int64 findLatin1(const ky_char *str, int64 slen, const char* dst, int64 dlen)
+{
+    return ky_strsearch::find(reinterpret_cast<const uint16 *>(str), slen,
+                              reinterpret_cast<const uchar *>(dst), dlen);
+}
+//! 分割等模板按分隔符类型选择
+inline int64 find_units(const ky_char *str, int64 slen, const ky_char* dst, int64 dlen)
+{
+    return findString(str, slen, dst, dlen);
+}
+inline int64 find_units(const ky_char *str, int64 slen, const char* dst, int64 dlen)
+{
+    return findLatin1(str, slen, dst, dlen);
+}
+
+//! Unicode区分大小写的比较一个Unicode字符串和一个latin1字符串
+static int ucstrcmp_latin1(const ky_char *a, int64 alen, const char *b, int64 blen)
+{
+    const int64 l = ky_min(alen, blen);
+    for (int64 i = 0; i < l; ++i)
+    {
+        const int diff = int(a[i].unicode()) - int((uchar)b[i]);
+        if (diff)
+            return diff;
+    }
+    return alen < blen ? -1 : (alen > blen ? 1 : 0);
 }
@@ -86,6 +86,206 @@ static int IsUTF8ByteOrderMark(const uint8* sUTF8, int sUTF8_count)
     return (0xEF == sUTF8[0] && 0xBB == sUTF8[1] && 0xBF == sUTF8[2]);
 }
 
+//! 以下为批量转换的快速路径，只处理不可能出错的码元，
+//! 遇到其它字符时返回已处理的个数，由逐字符解码处理错误
+//! d 为0时只计数
+
+//! 转换开头连续的ASCII字节到UTF-16
+static inline int ascii_to_utf16(const uint8* s, int n, uint16* d)
+{
+    int i = 0;
+#ifdef kyHAS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; i + 16 <= n; i += 16 )
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        if ( _mm_movemask_epi8(v) )
+            break;
+        if ( d )
+        {
+            _mm_storeu_si128((__m128i*)(d + i), _mm_unpacklo_epi8(v, zero));
+            _mm_storeu_si128((__m128i*)(d + i + 8), _mm_unpackhi_epi8(v, zero));
+        }
+    }
+#endif
+    for ( ; i < n && s[i] < 0x80; ++i )
+    {
+        if ( d )
+            d[i] = s[i];
+    }
+    return i;
+}
+
+//! 转换开头连续的ASCII字节到UTF-32
+static inline int ascii_to_utf32(const uint8* s, int n, uint32* d)
+{
+    int i = 0;
+#ifdef kyHAS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; i + 16 <= n; i += 16 )
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        if ( _mm_movemask_epi8(v) )
+            break;
+        if ( d )
+        {
+            const __m128i lo = _mm_unpacklo_epi8(v, zero);
+            const __m128i hi = _mm_unpackhi_epi8(v, zero);
+            _mm_storeu_si128((__m128i*)(d + i), _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128((__m128i*)(d + i + 4), _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128((__m128i*)(d + i + 8), _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128((__m128i*)(d + i + 12), _mm_unpackhi_epi16(hi, zero));
+        }
+    }
+#endif
+    for ( ; i < n && s[i] < 0x80; ++i )
+    {
+        if ( d )
+            d[i] = s[i];
+    }
+    return i;
+}
+
+//! 转换开头连续的ASCII码元(UTF-16)到UTF-8
+static inline int ascii_from_utf16(const uint16* s, int n, uint8* d)
+{
+    int i = 0;
+#ifdef kyHAS_SSE2
+    const __m128i high = _mm_set1_epi16(short(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; i + 16 <= n; i += 16 )
+    {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(s + i));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(s + i + 8));
+        const __m128i h = _mm_and_si128(_mm_or_si128(a, b), high);
+        if ( 0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi16(h, zero)) )
+            break;
+        if ( d )
+            _mm_storeu_si128((__m128i*)(d + i), _mm_packus_epi16(a, b));
+    }
+#endif
+    for ( ; i < n && s[i] < 0x80; ++i )
+    {
+        if ( d )
+            d[i] = (uint8)s[i];
+    }
+    return i;
+}
+
+//! 转换开头连续的非代理码元(UTF-16)到UTF-32
+static inline int bmp_to_utf32(const uint16* s, int n, uint32* d)
+{
+    int i = 0;
+#ifdef kyHAS_SSE2
+    // (u - 0xD800) < 0x800 为代理码元，SSE2没有无符号比较，翻转符号位后比较
+    const __m128i base = _mm_set1_epi16(short(0xD800));
+    const __m128i sign = _mm_set1_epi16(short(0x8000));
+    const __m128i limit = _mm_set1_epi16(short(0x8800));
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; i + 8 <= n; i += 8 )
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        const __m128i t = _mm_xor_si128(_mm_sub_epi16(v, base), sign);
+        if ( _mm_movemask_epi8(_mm_cmplt_epi16(t, limit)) )
+            break;
+        if ( d )
+        {
+            _mm_storeu_si128((__m128i*)(d + i), _mm_unpacklo_epi16(v, zero));
+            _mm_storeu_si128((__m128i*)(d + i + 4), _mm_unpackhi_epi16(v, zero));
+        }
+    }
+#endif
+    for ( ; i < n && (s[i] < 0xD800 || s[i] >= 0xE000); ++i )
+    {
+        if ( d )
+            d[i] = s[i];
+    }
+    return i;
+}
+
+//!
+//! \brief utf8_to_utf16_bmp 转换开头连续的有效2-3字节UTF-8序列
+//! \note 与decode_UTF8的快速分支接受的序列相同(不含0xD800)，其余交给逐字符解码
+//! \param n 输入字节数
+//! \param m 输出空间
+//! \param used 返回使用的输入字节数
+//! \return 输出码元数
+//!
+static inline int utf8_to_utf16_bmp(const uint8* s, int n, uint16* d, int m, int* used)
+{
+    int i = 0, k = 0;
+    while ( k < m )
+    {
+        const uint8 c = s[i];
+        uint32 u;
+        if ( 0xC0 == (0xE0 & c) && i + 2 <= n && 0x80 == (0xC0 & s[i+1]) )
+        {
+            u = ((0x1F & c) << 6) | (0x3F & s[i+1]);
+            if ( u <= 0x7F )
+                break;
+            i += 2;
+        }
+        else if ( 0xE0 == (0xF0 & c) && i + 3 <= n && 0x80 == (0xC0 & s[i+1]) && 0x80 == (0xC0 & s[i+2]) )
+        {
+            u = ((0x0F & c) << 12) | ((0x3F & s[i+1]) << 6) | (0x3F & s[i+2]);
+            if ( u < 0x0800 || (u >= 0xD800 && u < 0xE000) )
+                break;
+            i += 3;
+        }
+        else
+            break;
+        if ( d )
+            d[k] = (uint16)u;
+        ++k;
+        if ( i >= n )
+            break;
+    }
+    *used = i;
+    return k;
+}
+
+//!
+//! \brief utf16_bmp_to_utf8 转换开头连续的非代理、非ASCII码元为2-3字节UTF-8
+//! \param m 输出空间(字节)
+//! \param used 返回使用的输入码元数
+//! \return 输出字节数
+//!
+static inline int utf16_bmp_to_utf8(const uint16* s, int n, uint8* d, int m, int* used)
+{
+    int i = 0, k = 0;
+    for ( ; i < n; ++i )
+    {
+        const uint32 u = s[i];
+        if ( u < 0x80 || (u >= 0xD800 && u < 0xE000) )
+            break;
+        if ( u < 0x800 )
+        {
+            if ( k + 2 > m )
+                break;
+            if ( d )
+            {
+                d[k] = (uint8)(0xC0 | (u >> 6));
+                d[k+1] = (uint8)(0x80 | (u & 0x3F));
+            }
+            k += 2;
+        }
+        else
+        {
+            if ( k + 3 > m )
+                break;
+            if ( d )
+            {
+                d[k] = (uint8)(0xE0 | (u >> 12));
+                d[k+1] = (uint8)(0x80 | ((u >> 6) & 0x3F));
+                d[k+2] = (uint8)(0x80 | (u & 0x3F));
+            }
+            k += 3;
+        }
+    }
+    *used = i;
+    return k;
+}
+
 int ky_unicode::encode_UTF8(uint32 u, uint8 sUTF8[6])
 {
     uint32 c;
@@ -565,8 +765,10 @@ int ky_unicode::decode_UTF8(const uint8* sUTF8, int sUTF8_count, ErrorParameters
                 }
             }
             *unicode_code_point = e->m_error_code_point;
+            return i0;
         }
-        return i0;
+        // m_error_code_point is not valid, this error is not masked
+        return 0;
     }
 
     if ( is_valid_code_point(u0) && 8 == error_status )
@@ -821,7 +1023,7 @@ int ky_unicode::convert_UTF8_UTF16(int bTestByteOrder,
                                 uint32* error_status, uint32 error_mask, uint32 error_code_point,
                                 const uint8** sNextUTF8)
 {
-    int i, j, k, output_count;
+    int i, j, k, output_count, room;
     uint32 u;
     uint16 w[2];
     struct ErrorParameters e;
@@ -875,6 +1077,27 @@ int ky_unicode::convert_UTF8_UTF16(int bTestByteOrder,
 
     for ( i = 0; i < sUTF8_count; i += j )
     {
+        // 连续的ASCII和有效的2-3字节序列批量转换，其余逐字符解码
+        room = sUTF16_count - output_count;
+        if ( sUTF8[i] < 0x80 )
+        {
+            j = ascii_to_utf16(sUTF8+i, (sUTF8_count-i < room) ? sUTF8_count-i : room,
+                               sUTF16 ? sUTF16+output_count : 0);
+            if ( 0 == j )
+            {
+                e.m_error_status |= 2;
+                break;
+            }
+            output_count += j;
+            continue;
+        }
+        k = utf8_to_utf16_bmp(sUTF8+i, sUTF8_count-i, sUTF16 ? sUTF16+output_count : 0, room, &j);
+        if ( k > 0 )
+        {
+            output_count += k;
+            continue;
+        }
+
         j = decode_UTF8(sUTF8+i,sUTF8_count-i,&e,&u);
         if ( j <= 0 )
             break;
@@ -909,7 +1132,7 @@ int ky_unicode::convert_UTF8_UTF32(int bTestByteOrder,
                                 uint32* error_status,uint32 error_mask,uint32 error_code_point,
                                 const uint8** sNextUTF8)
 {
-    int i, j, output_count;
+    int i, j, output_count, room;
     uint32 u;
     ErrorParameters e;
 
@@ -962,6 +1185,16 @@ int ky_unicode::convert_UTF8_UTF32(int bTestByteOrder,
 
     for ( i = 0; i < sUTF8_count; i += j )
     {
+        // 连续的ASCII批量转换
+        if ( sUTF8[i] < 0x80 && output_count < sUTF32_count )
+        {
+            room = sUTF32_count - output_count;
+            j = ascii_to_utf32(sUTF8+i, (sUTF8_count-i < room) ? sUTF8_count-i : room,
+                               sUTF32 ? sUTF32+output_count : 0);
+            output_count += j;
+            continue;
+        }
+
         j = decode_UTF8(sUTF8+i,sUTF8_count-i,&e,&u);
         if ( j <= 0 )
             break;
@@ -993,7 +1226,7 @@ int ky_unicode::convert_UTF16_UTF8(int bTestByteOrder,
                                 uint32* error_status, uint32 error_mask, uint32 error_code_point,
                                 const uint16** sNextUTF16)
 {
-    int i, j, k, output_count, bSwapBytes;
+    int i, j, k, output_count, bSwapBytes, room;
     uint32 u;
     uint8 s[6];
     ErrorParameters e;
@@ -1080,6 +1313,27 @@ int ky_unicode::convert_UTF16_UTF8(int bTestByteOrder,
     {
         for ( i = 0; i < sUTF16_count; i += j )
         {
+            // 连续的ASCII和非代理码元批量转换，其余逐字符处理
+            room = sUTF8_count - output_count;
+            if ( sUTF16[i] < 0x80 )
+            {
+                j = ascii_from_utf16(sUTF16+i, (sUTF16_count-i < room) ? sUTF16_count-i : room,
+                                     sUTF8 ? sUTF8+output_count : 0);
+                if ( 0 == j )
+                {
+                    e.m_error_status |= 2;
+                    break;
+                }
+                output_count += j;
+                continue;
+            }
+            k = utf16_bmp_to_utf8(sUTF16+i, sUTF16_count-i, sUTF8 ? sUTF8+output_count : 0, room, &j);
+            if ( j > 0 )
+            {
+                output_count += k;
+                continue;
+            }
+
             j = decode_UTF16(sUTF16+i,sUTF16_count-i,&e,&u);
             if ( j <= 0 )
                 break;
@@ -1112,7 +1366,7 @@ int ky_unicode::convert_UTF16_UTF32(int bTestByteOrder,
                                  uint32* error_status, uint32 error_mask, uint32 error_code_point,
                                  const uint16** sNextUTF16)
 {
-    int i, j, output_count, bSwapBytes;
+    int i, j, output_count, bSwapBytes, room;
     uint32 u;
     ErrorParameters e;
 
@@ -1197,6 +1451,16 @@ int ky_unicode::convert_UTF16_UTF32(int bTestByteOrder,
     {
         for ( i = 0; i < sUTF16_count; i += j )
         {
+            // 连续的非代理码元批量转换
+            if ( (sUTF16[i] < 0xD800 || sUTF16[i] >= 0xE000) && output_count < sUTF32_count )
+            {
+                room = sUTF32_count - output_count;
+                j = bmp_to_utf32(sUTF16+i, (sUTF16_count-i < room) ? sUTF16_count-i : room,
+                                 sUTF32 ? sUTF32+output_count : 0);
+                output_count += j;
+                continue;
+            }
+
             j = decode_UTF16(sUTF16+i,sUTF16_count-i,&e,&u);
             if ( j <= 0 )
                 break;
@@ -9,236 +9,288 @@ static ky_variant_math *s_veci = 0;
 static ky_variant_math *s_vecf = 0;
 static ky_variant_math *s_str = 0;
 
-ky_variant::~ky_variant()
+//!
+//! \brief variant_release 释放共享布局
+//!
+static void variant_release(ky_variant &v)
 {
-    if (mem && mem->lessref())
+    if (!v.is_inline() && v.mem->lessref())
     {
-        kyFree(mem->data);
-        kyDelete(mem);
+        v.mem->~layout();
+        kyFree(v.mem);
     }
+    v.byte = -1;
+}
+
+ky_variant::~ky_variant()
+{
+    variant_release(*this);
 }
 ky_variant::ky_variant():
-    mem(0)
+    code(0),
+    byte(-1),
+    math(0)
 {
 
 }
 ky_variant::ky_variant(fourwd_int v):
-    mem(0)
+    code(0),
+    byte(-1),
+    math(0)
 {
     set(kyIntCode, s_int, &v, sizeof(fourwd_int));
 }
 ky_variant::ky_variant(fourwd_flt v):
-    mem(0)
+    code(0),
+    byte(-1),
+    math(0)
 {
     set(kyFltCode, s_flt, &v, sizeof(fourwd_flt));
 }
 ky_variant::ky_variant(const fourwd_str &v):
-    mem(0)
+    code(0),
+    byte(-1),
+    math(0)
 {
     set(kyStrCode, s_str, v.data(), v.bytecount());
 }
 
 ky_variant::ky_variant(const fourwd_veci &v):
-    mem(kyNew(layout))
+    code(0),
+    byte(-1),
+    math(0)
 {
-    mem->code = kyVecIntCode;
-    mem->math = s_veci;
-    mem->byte = v.bytecount();
-    mem->data = (uint8*)kyMalloc(mem->byte);
-
-    ky_memory::copy(mem->data, v.data(), mem->byte);
+    set(kyVecIntCode, s_veci, v.data(), v.bytecount());
 }
 ky_variant::ky_variant(const fourwd_vecf &v):
-    mem(kyNew(layout))
+    code(0),
+    byte(-1),
+    math(0)
 {
-    mem->code = kyVecFltCode;
-    mem->math = s_vecf;
-    mem->byte = v.bytecount();
-    mem->data = (uint8*)kyMalloc(mem->byte);
-    ky_memory::copy(mem->data, v.data(), mem->byte);
+    set(kyVecFltCode, s_vecf, v.data(), v.bytecount());
 }
 
-ky_variant::ky_variant(const fourwd_t code, struct ky_variant_math *math, void *data, int byte):
-    mem(0)
+ky_variant::ky_variant(const fourwd_t code, struct ky_variant_math *math, const void *data, int byte):
+    code(0),
+    byte(-1),
+    math(0)
 {
     set(code, math, data, byte);
 }
 ky_variant::ky_variant(const ky_variant &pd):
-    mem(0)
+    code(0),
+    byte(-1),
+    math(0)
 {
-    mem = pd.mem;
-    mem->addref();
+    *this = pd;
 }
 ky_variant &ky_variant::operator = (const ky_variant &pd)
 {
-    if (mem && mem->lessref())
+    if (this == &pd)
+        return *this;
+
+    variant_release(*this);
+    code = pd.code;
+    math = pd.math;
+    byte = pd.byte;
+    if (pd.is_inline())
+        ky_memory::copy(local, pd.local, InlineByte);
+    else
     {
-        kyFree(mem->data);
-        kyDelete(mem);
+        mem = pd.mem;
+        mem->addref();
     }
-    mem = pd.mem;
-    mem->addref();
     return *this;
 }
 
-void ky_variant::set(const fourwd_t code, ky_variant_math *math, void *data, int len)
+void ky_variant::swap(ky_variant &b)
 {
-    if (mem && mem->lessref())
+    // 对象内没有指向自身的指针，内联数据和共享布局指针一起交换即可
+    uint8 tmp[InlineByte];
+    ky_memory::copy(tmp, local, InlineByte);
+    ky_memory::copy(local, b.local, InlineByte);
+    ky_memory::copy(b.local, tmp, InlineByte);
+
+    const fourwd_t tc = code; code = b.code; b.code = tc;
+    const int tb = byte; byte = b.byte; b.byte = tb;
+    ky_variant_math *tm = math; math = b.math; b.math = tm;
+}
+
+void ky_variant::set(const fourwd_t code, ky_variant_math *math, const void *data, int len)
+{
+    variant_release(*this);
+
+    uint8 *dst = local;
+    if (len > InlineByte)
     {
-        kyFree(mem->data);
-        kyDelete(mem);
+        mem = (layout *)kyMalloc(sizeof(layout) + len);
+        new (mem) layout();
+        mem->set(ky_ref::ShareableDetach);
+        dst = mem->data();
     }
-    mem = kyNew(layout);
-
-    mem->code = code;
-    mem->math = math;
-    mem->byte = len;
-    mem->data = (uint8*)kyMalloc(mem->byte);
-    ky_memory::copy(mem->data, data, mem->byte);
+    this->code = code;
+    this->math = math;
+    this->byte = len;
+    if (len > 0)
+        ky_memory::copy(dst, data, len);
 }
 
 bool ky_variant::is_set(const fourwd_t code) const
 {
     if (is_valid())
-        return mem->code == code;
+        return this->code == code;
     return false;
 }
 bool ky_variant::is_valid()const
 {
-    return mem != 0;
+    return byte >= 0;
 }
 
 fourwd_str ky_variant::dump()const
 {
-    if (mem && mem->math)
-        return mem->math->dump(*this);
+    if (is_valid() && math)
+        return math->dump(*this);
     return fourwd_str();
 }
 
 ky_variant::operator bool() const
 {
-    if (mem && mem->math)
-        return mem->math->to_bool(*this);
+    if (is_valid() && math)
+        return math->to_bool(*this);
     return false;
 }
 fourwd_str ky_variant::to_str()const
 {
-    if (!mem || kyStrCode != mem->code)
+    if (!is_valid() || kyStrCode != code)
         return fourwd_str();
 
-    return fourwd_str((char*)mem->data, mem->byte);
+    return fourwd_str((char*)data(), byte);
 }
 fourwd_veci ky_variant::to_veci()const
 {
-    if (!mem || kyVecIntCode != mem->code)
+    if (!is_valid() || kyVecIntCode != code)
         return fourwd_veci();
-    return fourwd_veci((fourwd_int*)mem->data, mem->byte);
+    return fourwd_veci((fourwd_int*)data(), byte);
 }
 fourwd_vecf ky_variant::to_vecf()const
 {
-    if (!mem || kyVecFltCode != mem->code)
+    if (!is_valid() || kyVecFltCode != code)
         return fourwd_vecf();
-    return fourwd_vecf((fourwd_flt*)mem->data, mem->byte);
+    return fourwd_vecf((fourwd_flt*)data(), byte);
+}
+
+//!
+//! \brief variant_same 无运算对象时比较两个变种是否为同一数据
+//!
+static bool variant_same(const ky_variant &v, const ky_variant &v1)
+{
+    if (!v.is_valid() || !v1.is_valid())
+        return v.is_valid() == v1.is_valid();
+    if (v.code != v1.code || v.byte != v1.byte)
+        return false;
+    if (!v.is_inline() && v.mem == v1.mem)
+        return true;
+    return ky_memory::compare(v.data(), v1.data(), v.byte) == 0;
 }
 // 关系运算
 ky_variant operator==(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->equal(v, v1);
-    return ky_variant(bool(v.mem == v1.mem));
+    if (v.is_valid() && v.math)
+        return v.math->equal(v, v1);
+    return ky_variant(variant_same(v, v1));
 }
 ky_variant operator!=(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->not_equal(v, v1);
-    return ky_variant(bool(v.mem != v1.mem));
+    if (v.is_valid() && v.math)
+        return v.math->not_equal(v, v1);
+    return ky_variant(!variant_same(v, v1));
 }
 ky_variant operator<(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->less(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->less(v, v1);
     return ky_variant(false);
 }
 ky_variant operator<=(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->less_equal(v, v1);
-    return ky_variant(bool(v.mem == v1.mem));
+    if (v.is_valid() && v.math)
+        return v.math->less_equal(v, v1);
+    return ky_variant(variant_same(v, v1));
 }
 ky_variant operator>=(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->greater_equal(v, v1);
-    return ky_variant(bool(v.mem == v1.mem));
+    if (v.is_valid() && v.math)
+        return v.math->greater_equal(v, v1);
+    return ky_variant(variant_same(v, v1));
 }
 ky_variant operator>(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->greater(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->greater(v, v1);
     return ky_variant(false);
 }
 
 // 算术运算
 ky_variant operator+(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->plus(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->plus(v, v1);
     return ky_variant();
 }
 ky_variant operator-(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->minus(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->minus(v, v1);
     return ky_variant();
 }
 ky_variant operator*(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->multiply(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->multiply(v, v1);
     return ky_variant();
 }
 ky_variant operator/(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->division(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->division(v, v1);
     return ky_variant();
 }
 ky_variant operator%(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->modulo(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->modulo(v, v1);
     return ky_variant();
 }
 ky_variant operator-(const ky_variant &v)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->invert(v);
+    if (v.is_valid() && v.math)
+        return v.math->invert(v);
     return v;
 }
 
 // 位运算
 ky_variant operator&(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->bit_and(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->bit_and(v, v1);
     return ky_variant();
 }
 ky_variant operator|(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->bit_or(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->bit_or(v, v1);
     return ky_variant();
 }
 ky_variant operator^(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->bit_xor(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->bit_xor(v, v1);
     return ky_variant();
 }
 ky_variant operator~(const ky_variant &v)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->bit_negate(v);
+    if (v.is_valid() && v.math)
+        return v.math->bit_negate(v);
     return v;
 }
 
@@ -246,110 +298,110 @@ ky_variant operator~(const ky_variant &v)
 // 逻辑运算
 ky_variant operator!(const ky_variant &v)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->logic_not(v);
+    if (v.is_valid() && v.math)
+        return v.math->logic_not(v);
     return v;
 }
 ky_variant operator&&(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->logic_and(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->logic_and(v, v1);
     return ky_variant();
 }
 ky_variant operator||(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->logic_or(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->logic_or(v, v1);
     return ky_variant();
 }
 
 ky_variant operator<<(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->shift_left(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->shift_left(v, v1);
     return ky_variant();
 }
 ky_variant operator>>(const ky_variant &v, const ky_variant &v1)
 {
-    if (v.mem && v.mem->math)
-        return v.mem->math->shift_right(v, v1);
+    if (v.is_valid() && v.math)
+        return v.math->shift_right(v, v1);
     return ky_variant();
 }
 
 #define intMathLogic(Ope) \
-    const fourwd_int tmp = (*(fourwd_int*)v1.mem->data);\
-    if (!(v2.mem && v2.mem->math))\
+    const fourwd_int tmp = (*(fourwd_int*)v1.data());\
+    if (!(v2.is_valid() && v2.math))\
         return ky_variant(tmp);\
 \
-    const int part = v2.mem->math->component(v2);\
+    const int part = v2.math->component(v2);\
     fourwd_int vi[part] = {0};\
     fourwd_flt vf[part] = {0};\
     int byte = part;\
-    if (v2.mem->math->code() == kyIntCode)\
+    if (v2.math->code() == kyIntCode)\
     {\
         byte *= sizeof(fourwd_int);\
-        fourwd_int *elem = (fourwd_int*)v2.mem->data;\
+        fourwd_int *elem = (fourwd_int*)v2.data();\
         for (int i = 0; i < part; ++i, ++elem)\
             vi[i] = tmp Ope *elem;\
     }\
-    else if (v2.mem->math->code() == kyFltCode)\
+    else if (v2.math->code() == kyFltCode)\
     {\
         byte *= sizeof(fourwd_flt);\
-        fourwd_flt *elem = (fourwd_flt*)v2.mem->data;\
+        fourwd_flt *elem = (fourwd_flt*)v2.data();\
         for (int i = 0; i < part; ++i, ++elem)\
             vf[i] = tmp Ope *elem;\
     }\
     else\
         kyASSERT(true, "And unknown type operations");\
 \
-    if (v2.mem->code == kyIntCode)\
-        return ky_variant(v2.mem->code, v2.mem->math, vi, byte);\
-    return ky_variant(v2.mem->code, v2.mem->math, vf, byte);
+    if (v2.code == kyIntCode)\
+        return ky_variant(v2.code, v2.math, vi, byte);\
+    return ky_variant(v2.code, v2.math, vf, byte);
 
 #define intMathBit(Ope) \
-    const fourwd_int tmp = (*(fourwd_int*)v1.mem->data);\
-    if (!(v2.mem && v2.mem->math))\
+    const fourwd_int tmp = (*(fourwd_int*)v1.data());\
+    if (!(v2.is_valid() && v2.math))\
         return ky_variant(tmp);\
 \
-    const int part = v2.mem->math->component(v2);\
+    const int part = v2.math->component(v2);\
     fourwd_int vi[part] = {0};\
     fourwd_flt vf[part] = {0};\
     int byte = part;\
-    if (v2.mem->math->code() == kyIntCode)\
+    if (v2.math->code() == kyIntCode)\
     {\
         byte *= sizeof(fourwd_int);\
-        fourwd_int *elem = (fourwd_int*)v2.mem->data;\
+        fourwd_int *elem = (fourwd_int*)v2.data();\
         for (int i = 0; i < part; ++i, ++elem)\
             vi[i] = tmp Ope *elem;\
     }\
-    else if (v2.mem->math->code() == kyFltCode)\
+    else if (v2.math->code() == kyFltCode)\
     {\
         kyASSERT(true, "Float type cannot be bitwise operation");\
     }\
     else\
         kyASSERT(true, "And unknown type operations");\
 \
-    return ky_variant(v2.mem->code, v2.mem->math, vi, byte);
+    return ky_variant(v2.code, v2.math, vi, byte);
 
 #define intMathComp(Ope) \
-    const fourwd_int tmp = (*(fourwd_int*)v1.mem->data);\
-    if (!(v2.mem && v2.mem->math))\
+    const fourwd_int tmp = (*(fourwd_int*)v1.data());\
+    if (!(v2.is_valid() && v2.math))\
         return ky_variant(false);\
     \
-    const int part = v2.mem->math->component(v2);\
+    const int part = v2.math->component(v2);\
     bool comp = 0;\
-    if (v2.mem->math->code() == kyIntCode)\
+    if (v2.math->code() == kyIntCode)\
     {\
         fourwd_int suto = 0;\
-        fourwd_int *elem = (fourwd_int*)v2.mem->data;\
+        fourwd_int *elem = (fourwd_int*)v2.data();\
         for (int i = 0; i < part; ++i, ++elem)\
             suto += *elem;\
         comp = (tmp - suto) Ope 0 ? true : false;\
     }\
-    else if (v2.mem->math->code() == kyFltCode)\
+    else if (v2.math->code() == kyFltCode)\
     {\
          fourwd_flt suto = 0;\
-         fourwd_flt *elem = (fourwd_flt*)v2.mem->data;\
+         fourwd_flt *elem = (fourwd_flt*)v2.data();\
          for (int i = 0; i < part; ++i, ++elem)\
              suto += *elem;\
         comp = (tmp - suto) Ope 0 ? true : false;\
@@ -367,13 +419,13 @@ static struct math_int : ky_variant_math
     virtual fourwd_str dump(const ky_variant &v)
     {
         ky_string pm("int[");
-        pm += ky_string::number(*(fourwd_int*)v.mem->data);
+        pm += ky_string::number(*(fourwd_int*)v.data());
         pm += "]";
         return fourwd_str(pm.to_latin1(), pm.count());
     }
     virtual bool to_bool(const ky_variant &v)
     {
-        return *(fourwd_int*)v.mem->data;
+        return *(fourwd_int*)v.data();
     }
     virtual int component(const ky_variant &) {return 1;}
     virtual fourwd_t code() {return kyIntCode;}
@@ -381,7 +433,7 @@ static struct math_int : ky_variant_math
     // 逻辑运算
     virtual ky_variant logic_not  (const ky_variant &v)
     {
-        const fourwd_int tmp = !(*(fourwd_int*)v.mem->data);
+        const fourwd_int tmp = !(*(fourwd_int*)v.data());
         return ky_variant(tmp);
     }
     virtual ky_variant logic_and  (const ky_variant &v1, const ky_variant &v2)
@@ -408,25 +460,25 @@ static struct math_int : ky_variant_math
     }
     virtual ky_variant bit_negate (const ky_variant &v)
     {
-        const fourwd_int tmp = ~(*(fourwd_int*)v.mem->data);
+        const fourwd_int tmp = ~(*(fourwd_int*)v.data());
         return ky_variant(tmp);
     }
     virtual ky_variant shift_left (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_int tmp = (*(fourwd_int*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_int tmp = (*(fourwd_int*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(tmp);
 
-        kyASSERT(v2.mem->math->component(v2) != component(v1),
+        kyASSERT(v2.math->component(v2) != component(v1),
                  "Shift operation does not support multi-component operations");
         int byte = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             byte = sizeof(fourwd_int);
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             return ky_variant(fourwd_int(tmp << *elem));
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             kyASSERT(true, "Float type cannot be shift operations");
         }
@@ -437,20 +489,20 @@ static struct math_int : ky_variant_math
     }
     virtual ky_variant shift_right (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_int tmp = (*(fourwd_int*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_int tmp = (*(fourwd_int*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(tmp);
 
-        kyASSERT(v2.mem->math->component(v2) != component(v1),
+        kyASSERT(v2.math->component(v2) != component(v1),
                  "Shift operation does not support multi-component operations");
         int byte = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             byte = sizeof(fourwd_int);
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             return ky_variant(fourwd_int(tmp >> *elem));
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             kyASSERT(true, "Float type cannot be shift operations");
         }
@@ -471,34 +523,34 @@ static struct math_int : ky_variant_math
     }
     virtual ky_variant modulo  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_int tmp = (*(fourwd_int*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_int tmp = (*(fourwd_int*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(tmp);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         fourwd_int vi[part] = {0};
         fourwd_flt vf[part] = {0};
         int byte = part;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             byte *= sizeof(fourwd_int);
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vi[i] = tmp % *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             byte *= sizeof(fourwd_flt);
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vf[i] = ky_fmod(tmp , *elem);
         }
         else
             kyASSERT(true, "And unknown type operations");
 
-        if (v2.mem->code == kyIntCode)
-            return ky_variant(v2.mem->code, v2.mem->math, vi, byte);
-        return ky_variant(v2.mem->code, v2.mem->math, vf, byte);
+        if (v2.code == kyIntCode)
+            return ky_variant(v2.code, v2.math, vi, byte);
+        return ky_variant(v2.code, v2.math, vf, byte);
     }
     virtual ky_variant plus  (const ky_variant &v1, const ky_variant &v2)
     {
@@ -510,7 +562,7 @@ static struct math_int : ky_variant_math
     }
     virtual ky_variant invert  (const ky_variant &v)
     {
-        const fourwd_int tmp = -(*(fourwd_int*)v.mem->data);
+        const fourwd_int tmp = -(*(fourwd_int*)v.data());
         return ky_variant(tmp);
     }
 
@@ -529,24 +581,24 @@ static struct math_int : ky_variant_math
     }
     virtual ky_variant not_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_int tmp = (*(fourwd_int*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_int tmp = (*(fourwd_int*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(true);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) != 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
              fourwd_flt suto = 0;
-             fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+             fourwd_flt *elem = (fourwd_flt*)v2.data();
              for (int i = 0; i < part; ++i, ++elem)
                  suto += *elem;
             comp = (tmp - suto) != 0 ? true : false;
@@ -575,13 +627,13 @@ static struct math_flt : ky_variant_math
     virtual ky_array<char> dump(const ky_variant &v)
     {
         ky_string pm("flt[");
-        pm += ky_string::number(*(fourwd_flt*)v.mem->data);
+        pm += ky_string::number(*(fourwd_flt*)v.data());
         pm += "]";
         return ky_array<char>(pm.to_latin1(), pm.count());
     }
     virtual bool to_bool(const ky_variant &v)
     {
-        return *(fourwd_flt*)v.mem->data;
+        return *(fourwd_flt*)v.data();
     }
     virtual int component(const ky_variant &) {return 1;}
     virtual fourwd_t code() {return kyFltCode;}
@@ -589,27 +641,27 @@ static struct math_flt : ky_variant_math
     // 逻辑运算
     virtual ky_variant logic_not  (const ky_variant &v)
     {
-        const fourwd_flt tmp = !(*(fourwd_flt*)v.mem->data);
+        const fourwd_flt tmp = !(*(fourwd_flt*)v.data());
         return ky_variant(tmp);
     }
     virtual ky_variant logic_and  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(tmp);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         const int byte = part * sizeof(fourwd_flt);
         fourwd_flt vec[part];
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = tmp && *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = tmp && *elem;
         }
@@ -620,22 +672,22 @@ static struct math_flt : ky_variant_math
     }
     virtual ky_variant logic_or  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(tmp);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         const int byte = part * sizeof(fourwd_flt);
         fourwd_flt vec[part];
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = tmp || *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = tmp || *elem;
         }
@@ -680,22 +732,22 @@ static struct math_flt : ky_variant_math
     // 算术运算
     virtual ky_variant multiply  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(tmp);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         const int byte = part * sizeof(fourwd_flt);
         fourwd_flt vec[part];
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = tmp * *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = tmp * *elem;
         }
@@ -706,22 +758,22 @@ static struct math_flt : ky_variant_math
     }
     virtual ky_variant division  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(tmp);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         const int byte = part * sizeof(fourwd_flt);
         fourwd_flt vec[part];
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = tmp / *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = tmp / *elem;
         }
@@ -732,22 +784,22 @@ static struct math_flt : ky_variant_math
     }
     virtual ky_variant modulo  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(tmp);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         const int byte = part * sizeof(fourwd_flt);
         fourwd_flt vec[part];
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = ky_fmod(tmp, *elem);
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = ky_fmod(tmp, *elem);
         }
@@ -758,22 +810,22 @@ static struct math_flt : ky_variant_math
     }
     virtual ky_variant plus  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(tmp);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         const int byte = part * sizeof(fourwd_flt);
         fourwd_flt vec[part];
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = tmp + *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = tmp + *elem;
         }
@@ -784,22 +836,22 @@ static struct math_flt : ky_variant_math
     }
     virtual ky_variant minus  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(tmp);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         const int byte = part * sizeof(fourwd_flt);
         fourwd_flt vec[part];
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = tmp - *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 vec[i] = tmp - *elem;
         }
@@ -810,31 +862,31 @@ static struct math_flt : ky_variant_math
     }
     virtual ky_variant invert  (const ky_variant &v)
     {
-        const fourwd_flt tmp = -(*(fourwd_flt*)v.mem->data);
+        const fourwd_flt tmp = -(*(fourwd_flt*)v.data());
         return ky_variant(tmp);
     }
 
     // 关系运算
     virtual ky_variant less  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_flt suto = 0;
-            int64 *elem = (int64*)v2.mem->data;
+            int64 *elem = (int64*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) < 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) < 0 ? true : false;
@@ -846,24 +898,24 @@ static struct math_flt : ky_variant_math
     }
     virtual ky_variant less_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_flt suto = 0;
-            int64 *elem = (int64*)v2.mem->data;
+            int64 *elem = (int64*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) <= 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) <= 0 ? true : false;
@@ -875,24 +927,24 @@ static struct math_flt : ky_variant_math
     }
     virtual ky_variant equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_flt suto = 0;
-            int64 *elem = (int64*)v2.mem->data;
+            int64 *elem = (int64*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) == 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) == 0 ? true : false;
@@ -904,24 +956,24 @@ static struct math_flt : ky_variant_math
     }
     virtual ky_variant not_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(true);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_flt suto = 0;
-            int64 *elem = (int64*)v2.mem->data;
+            int64 *elem = (int64*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) != 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) != 0 ? true : false;
@@ -933,24 +985,24 @@ static struct math_flt : ky_variant_math
     }
     virtual ky_variant greater_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_flt suto = 0;
-            int64 *elem = (int64*)v2.mem->data;
+            int64 *elem = (int64*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) >= 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) >= 0 ? true : false;
@@ -962,24 +1014,24 @@ static struct math_flt : ky_variant_math
     }
     virtual ky_variant greater  (const ky_variant &v1, const ky_variant &v2)
     {
-        const fourwd_flt tmp = (*(fourwd_flt*)v1.mem->data);
-        if (!(v2.mem && v2.mem->math))
+        const fourwd_flt tmp = (*(fourwd_flt*)v1.data());
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part = v2.mem->math->component(v2);
+        const int part = v2.math->component(v2);
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_flt suto = 0;
-            int64 *elem = (int64*)v2.mem->data;
+            int64 *elem = (int64*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) > 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part; ++i, ++elem)
                 suto += *elem;
             comp = (tmp - suto) > 0 ? true : false;
@@ -1001,8 +1053,8 @@ static struct math_veci : ky_variant_math
     virtual ky_array<char> dump(const ky_variant &v)
     {
         ky_string pm("veci[");
-        const int count = v.mem->math->component(v);
-        fourwd_int *vd = (fourwd_int *)v.mem->data;
+        const int count = v.math->component(v);
+        fourwd_int *vd = (fourwd_int *)v.data();
         for (int i = 0; i < count; ++i)
         {
             pm += ky_string::number(vd[i]);
@@ -1015,50 +1067,50 @@ static struct math_veci : ky_variant_math
     }
     virtual bool to_bool(const ky_variant &v)
     {
-        const int count = v.mem->math->component(v);
-        fourwd_int *vd = (fourwd_int *)v.mem->data;
+        const int count = v.math->component(v);
+        fourwd_int *vd = (fourwd_int *)v.data();
         fourwd_int retusl = 0;
         for (int i = 0; i < count; ++i)
             retusl += vd[i];
         return retusl;
     }
-    virtual int component(const ky_variant &v) {return v.mem->byte / sizeof(fourwd_int);}
+    virtual int component(const ky_variant &v) {return v.byte / sizeof(fourwd_int);}
     virtual fourwd_t code() {return kyIntCode;}
 
     // 逻辑运算
     virtual ky_variant logic_not  (const ky_variant &v)
     {
-        fourwd_veci veci;veci.resize(v.mem->math->component(v));
-        fourwd_int *vd = (fourwd_int *)v.mem->data;
-        for (int i = 0; i < v.mem->math->component(v); ++i)
+        fourwd_veci veci;veci.resize(v.math->component(v));
+        fourwd_int *vd = (fourwd_int *)v.data();
+        for (int i = 0; i < v.math->component(v); ++i)
             veci[i] = !vd[i];
         return ky_variant(veci);
     }
     virtual ky_variant logic_and  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_veci retusli;retusli.resize(part_max);
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retusli.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retusli.data(), v1.data(), v1.byte);
 
         fourwd_t code = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             code = kyVecIntCode;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retusli[i] = retusli[i] && *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             code = kyVecFltCode;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retusli[i] && *elem;
         }
@@ -1070,29 +1122,29 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant logic_or  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_veci retusli;retusli.resize(part_max);
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retusli.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retusli.data(), v1.data(), v1.byte);
 
         fourwd_t code = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             code = kyVecIntCode;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retusli[i] = retusli[i] || *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             code = kyVecFltCode;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retusli[i] || *elem;
         }
@@ -1106,23 +1158,23 @@ static struct math_veci : ky_variant_math
     // 位运算
     virtual ky_variant bit_and  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_veci retusli;retusli.resize(part_max);
-        ky_memory::copy(retusli.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retusli.data(), v1.data(), v1.byte);
 
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retusli[i] = retusli[i] & *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             kyASSERT(true, "Float type cannot be bitwise operation");
         }
@@ -1132,23 +1184,23 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant bit_or  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_veci retusli;retusli.resize(part_max);
-        ky_memory::copy(retusli.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retusli.data(), v1.data(), v1.byte);
 
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retusli[i] = retusli[i] | *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             kyASSERT(true, "Float type cannot be bitwise operation");
         }
@@ -1158,23 +1210,23 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant bit_xor  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_veci retusli;retusli.resize(part_max);
-        ky_memory::copy(retusli.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retusli.data(), v1.data(), v1.byte);
 
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retusli[i] = retusli[i] ^ *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             kyASSERT(true, "Float type cannot be bitwise operation");
         }
@@ -1184,9 +1236,9 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant bit_negate (const ky_variant &v)
     {
-        fourwd_veci veci;veci.resize(v.mem->math->component(v));
-        fourwd_int *vd = (fourwd_int *)v.mem->data;
-        for (int i = 0; i < v.mem->math->component(v); ++i)
+        fourwd_veci veci;veci.resize(v.math->component(v));
+        fourwd_int *vd = (fourwd_int *)v.data();
+        for (int i = 0; i < v.math->component(v); ++i)
             veci[i] = ~vd[i];
         return ky_variant(veci);
     }
@@ -1204,29 +1256,29 @@ static struct math_veci : ky_variant_math
     // 算术运算
     virtual ky_variant multiply  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_veci retusli;retusli.resize(part_max);
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retusli.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retusli.data(), v1.data(), v1.byte);
 
         fourwd_t code = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             code = kyVecIntCode;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retusli[i] = retusli[i] * *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             code = kyVecFltCode;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retusli[i] * *elem;
         }
@@ -1238,29 +1290,29 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant division  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_veci retusli;retusli.resize(part_max);
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retusli.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retusli.data(), v1.data(), v1.byte);
 
         fourwd_t code = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             code = kyVecIntCode;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retusli[i] = retusli[i] / *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             code = kyVecFltCode;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retusli[i] / *elem;
         }
@@ -1272,29 +1324,29 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant modulo  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_veci retusli;retusli.resize(part_max);
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retusli.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retusli.data(), v1.data(), v1.byte);
 
         fourwd_t code = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             code = kyVecIntCode;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retusli[i] = retusli[i] % *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             code = kyVecFltCode;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = ky_fmod(retusli[i], *elem);
         }
@@ -1306,29 +1358,29 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant plus  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_veci retusli;retusli.resize(part_max);
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retusli.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retusli.data(), v1.data(), v1.byte);
 
         fourwd_t code = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             code = kyVecIntCode;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retusli[i] = retusli[i] + *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             code = kyVecFltCode;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retusli[i] + *elem;
         }
@@ -1340,29 +1392,29 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant minus  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_veci retusli;retusli.resize(part_max);
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retusli.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retusli.data(), v1.data(), v1.byte);
 
         fourwd_t code = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             code = kyVecIntCode;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retusli[i] = retusli[i] - *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             code = kyVecFltCode;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retusli[i] - *elem;
         }
@@ -1374,9 +1426,9 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant invert  (const ky_variant &v)
     {
-        fourwd_veci veci;veci.resize(v.mem->math->component(v));
-        fourwd_int *vd = (fourwd_int *)v.mem->data;
-        for (int i = 0; i < v.mem->math->component(v); ++i)
+        fourwd_veci veci;veci.resize(v.math->component(v));
+        fourwd_int *vd = (fourwd_int *)v.data();
+        for (int i = 0; i < v.math->component(v); ++i)
             veci[i] = -vd[i];
         return ky_variant(veci);
     }
@@ -1384,30 +1436,30 @@ static struct math_veci : ky_variant_math
     // 关系运算
     virtual ky_variant less  (const ky_variant &v1, const ky_variant &v2)
     {;
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
-        fourwd_int *tmp = (fourwd_int*)v1.mem->data;
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
+        fourwd_int *tmp = (fourwd_int*)v1.data();
         fourwd_int sutx = 0;
         for (int i = 0; i < part1; ++i, ++tmp)
             sutx += *tmp;
 
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
 
             comp = (sutx - suto) < 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
             comp = (sutx - suto) < 0 ? true : false;
@@ -1419,30 +1471,30 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant less_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
-        fourwd_int *tmp = (fourwd_int*)v1.mem->data;
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
+        fourwd_int *tmp = (fourwd_int*)v1.data();
         fourwd_int sutx = 0;
         for (int i = 0; i < part1; ++i, ++tmp)
             sutx += *tmp;
 
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
 
             comp = (sutx - suto) <= 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
             comp = (sutx - suto) <= 0 ? true : false;
@@ -1454,30 +1506,30 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
-        fourwd_int *tmp = (fourwd_int*)v1.mem->data;
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
+        fourwd_int *tmp = (fourwd_int*)v1.data();
         fourwd_int sutx = 0;
         for (int i = 0; i < part1; ++i, ++tmp)
             sutx += *tmp;
 
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
 
             comp = (sutx - suto) == 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
             comp = (sutx - suto) == 0 ? true : false;
@@ -1489,30 +1541,30 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant not_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(true);
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
-        fourwd_int *tmp = (fourwd_int*)v1.mem->data;
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
+        fourwd_int *tmp = (fourwd_int*)v1.data();
         fourwd_int sutx = 0;
         for (int i = 0; i < part1; ++i, ++tmp)
             sutx += *tmp;
 
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
 
             comp = (sutx - suto) != 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
             comp = (sutx - suto) != 0 ? true : false;
@@ -1524,30 +1576,30 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant greater_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
-        fourwd_int *tmp = (fourwd_int*)v1.mem->data;
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
+        fourwd_int *tmp = (fourwd_int*)v1.data();
         fourwd_int sutx = 0;
         for (int i = 0; i < part1; ++i, ++tmp)
             sutx += *tmp;
 
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
 
             comp = (sutx - suto) >= 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
             comp = (sutx - suto) >= 0 ? true : false;
@@ -1559,30 +1611,30 @@ static struct math_veci : ky_variant_math
     }
     virtual ky_variant greater  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
-        fourwd_int *tmp = (fourwd_int*)v1.mem->data;
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
+        fourwd_int *tmp = (fourwd_int*)v1.data();
         fourwd_int sutx = 0;
         for (int i = 0; i < part1; ++i, ++tmp)
             sutx += *tmp;
 
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
 
             comp = (sutx - suto) > 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
             comp = (sutx - suto) > 0 ? true : false;
@@ -1604,8 +1656,8 @@ static struct math_vecf : ky_variant_math
     virtual ky_array<char> dump(const ky_variant &v)
     {
         ky_string pm("vecf[");
-        const int count = v.mem->math->component(v);
-        fourwd_flt *vd = (fourwd_flt*)v.mem->data;
+        const int count = v.math->component(v);
+        fourwd_flt *vd = (fourwd_flt*)v.data();
         for (int i = 0; i < count; ++i)
         {
             pm += ky_string::number(vd[i]);
@@ -1618,46 +1670,46 @@ static struct math_vecf : ky_variant_math
     }
     virtual bool to_bool(const ky_variant &v)
     {
-        const int count = v.mem->math->component(v);
-        fourwd_flt *vd = (fourwd_flt*)v.mem->data;
+        const int count = v.math->component(v);
+        fourwd_flt *vd = (fourwd_flt*)v.data();
         fourwd_flt retusl = 0;
         for (int i = 0; i < count; ++i)
             retusl += vd[i];
         return retusl;
     }
-    virtual int component(const ky_variant &v) {return v.mem->byte / sizeof(fourwd_int);}
+    virtual int component(const ky_variant &v) {return v.byte / sizeof(fourwd_int);}
     virtual fourwd_t code() {return kyFltCode;}
 
     // 逻辑运算
     virtual ky_variant logic_not  (const ky_variant &v)
     {
-        fourwd_vecf vecf;vecf.resize(v.mem->math->component(v));
-        fourwd_int *vd = (fourwd_int*)v.mem->data;
-        for (int i = 0; i < v.mem->math->component(v); ++i)
+        fourwd_vecf vecf;vecf.resize(v.math->component(v));
+        fourwd_int *vd = (fourwd_int*)v.data();
+        for (int i = 0; i < v.math->component(v); ++i)
             vecf[i] = !vd[i];
         return ky_variant(vecf);
     }
     virtual ky_variant logic_and  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retuslf.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retuslf.data(), v1.data(), v1.byte);
 
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retuslf[i] && *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retuslf[i] && *elem;
         }
@@ -1667,25 +1719,25 @@ static struct math_vecf : ky_variant_math
     }
     virtual ky_variant logic_or  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retuslf.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retuslf.data(), v1.data(), v1.byte);
 
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retuslf[i] || *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retuslf[i] || *elem;
         }
@@ -1729,25 +1781,25 @@ static struct math_vecf : ky_variant_math
     // 算术运算
     virtual ky_variant multiply  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retuslf.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retuslf.data(), v1.data(), v1.byte);
 
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retuslf[i] * *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retuslf[i] * *elem;
         }
@@ -1757,25 +1809,25 @@ static struct math_vecf : ky_variant_math
     }
     virtual ky_variant division  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retuslf.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retuslf.data(), v1.data(), v1.byte);
 
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retuslf[i] / *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retuslf[i] / *elem;
         }
@@ -1785,25 +1837,25 @@ static struct math_vecf : ky_variant_math
     }
     virtual ky_variant modulo  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retuslf.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retuslf.data(), v1.data(), v1.byte);
 
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = ky_fmod(retuslf[i], *elem);
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = ky_fmod(retuslf[i], *elem);
         }
@@ -1813,25 +1865,25 @@ static struct math_vecf : ky_variant_math
     }
     virtual ky_variant plus  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retuslf.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retuslf.data(), v1.data(), v1.byte);
 
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retuslf[i] + *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retuslf[i] + *elem;
         }
@@ -1841,25 +1893,25 @@ static struct math_vecf : ky_variant_math
     }
     virtual ky_variant minus  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return v1;
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
         const int part_max = part1 > part2 ? part1 : part2;
 
         fourwd_vecf retuslf;retuslf.resize(part_max);
-        ky_memory::copy(retuslf.data(), v1.mem->data, v1.mem->byte);
+        ky_memory::copy(retuslf.data(), v1.data(), v1.byte);
 
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retuslf[i] - *elem;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 retuslf[i] = retuslf[i] - *elem;
         }
@@ -1869,9 +1921,9 @@ static struct math_vecf : ky_variant_math
     }
     virtual ky_variant invert  (const ky_variant &v)
     {
-        fourwd_vecf vecf;vecf.resize(v.mem->math->component(v));
-        fourwd_flt *vd = (fourwd_flt*)v.mem->data;
-        for (int i = 0; i < v.mem->math->component(v); ++i)
+        fourwd_vecf vecf;vecf.resize(v.math->component(v));
+        fourwd_flt *vd = (fourwd_flt*)v.data();
+        for (int i = 0; i < v.math->component(v); ++i)
             vecf[i] = -vd[i];
         return ky_variant(vecf);
     }
@@ -1879,30 +1931,30 @@ static struct math_vecf : ky_variant_math
     // 关系运算
     virtual ky_variant less  (const ky_variant &v1, const ky_variant &v2)
     {;
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
-        fourwd_flt *tmp = (fourwd_flt*)v1.mem->data;
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
+        fourwd_flt *tmp = (fourwd_flt*)v1.data();
         fourwd_flt sutx = 0;
         for (int i = 0; i < part1; ++i, ++tmp)
             sutx += *tmp;
 
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
 
             comp = (sutx - suto) < 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
             comp = (sutx - suto) < 0 ? true : false;
@@ -1914,30 +1966,30 @@ static struct math_vecf : ky_variant_math
     }
     virtual ky_variant less_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
-        fourwd_flt *tmp = (fourwd_flt*)v1.mem->data;
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
+        fourwd_flt *tmp = (fourwd_flt*)v1.data();
         fourwd_flt sutx = 0;
         for (int i = 0; i < part1; ++i, ++tmp)
             sutx += *tmp;
 
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
 
             comp = (sutx - suto) <= 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
             comp = (sutx - suto) <= 0 ? true : false;
@@ -1949,30 +2001,30 @@ static struct math_vecf : ky_variant_math
     }
     virtual ky_variant equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
-        fourwd_flt *tmp = (fourwd_flt*)v1.mem->data;
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
+        fourwd_flt *tmp = (fourwd_flt*)v1.data();
         fourwd_flt sutx = 0;
         for (int i = 0; i < part1; ++i, ++tmp)
             sutx += *tmp;
 
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
 
             comp = (sutx - suto) == 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
             comp = (sutx - suto) == 0 ? true : false;
@@ -1984,30 +2036,30 @@ static struct math_vecf : ky_variant_math
     }
     virtual ky_variant not_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(true);
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
-        fourwd_flt *tmp = (fourwd_flt*)v1.mem->data;
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
+        fourwd_flt *tmp = (fourwd_flt*)v1.data();
         fourwd_flt sutx = 0;
         for (int i = 0; i < part1; ++i, ++tmp)
             sutx += *tmp;
 
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
 
             comp = (sutx - suto) != 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
             comp = (sutx - suto) != 0 ? true : false;
@@ -2019,30 +2071,30 @@ static struct math_vecf : ky_variant_math
     }
     virtual ky_variant greater_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
-        fourwd_flt *tmp = (fourwd_flt*)v1.mem->data;
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
+        fourwd_flt *tmp = (fourwd_flt*)v1.data();
         fourwd_flt sutx = 0;
         for (int i = 0; i < part1; ++i, ++tmp)
             sutx += *tmp;
 
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
 
             comp = (sutx - suto) >= 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
             comp = (sutx - suto) >= 0 ? true : false;
@@ -2054,30 +2106,30 @@ static struct math_vecf : ky_variant_math
     }
     virtual ky_variant greater  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int part1 = v1.mem->math->component(v1);
-        const int part2 = v2.mem->math->component(v2);
-        fourwd_flt *tmp = (fourwd_flt*)v1.mem->data;
+        const int part1 = v1.math->component(v1);
+        const int part2 = v2.math->component(v2);
+        fourwd_flt *tmp = (fourwd_flt*)v1.data();
         fourwd_flt sutx = 0;
         for (int i = 0; i < part1; ++i, ++tmp)
             sutx += *tmp;
 
         bool comp = 0;
-        if (v2.mem->math->code() == kyIntCode)
+        if (v2.math->code() == kyIntCode)
         {
             fourwd_int suto = 0;
-            fourwd_int *elem = (fourwd_int*)v2.mem->data;
+            fourwd_int *elem = (fourwd_int*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
 
             comp = (sutx - suto) > 0 ? true : false;
         }
-        else if (v2.mem->math->code() == kyFltCode)
+        else if (v2.math->code() == kyFltCode)
         {
             fourwd_flt suto = 0;
-            fourwd_flt *elem = (fourwd_flt*)v2.mem->data;
+            fourwd_flt *elem = (fourwd_flt*)v2.data();
             for (int i = 0; i < part2; ++i, ++elem)
                 suto += *elem;
             comp = (sutx - suto) > 0 ? true : false;
@@ -2099,13 +2151,13 @@ static struct math_str : ky_variant_math
     virtual fourwd_str dump(const ky_variant &v)
     {
         ky_string pm("string[");
-        pm += (char*)v.mem->data;
+        pm += (char*)v.data();
         pm += "]";
         return fourwd_str(pm.to_latin1(), pm.count());
     }
     virtual bool to_bool(const ky_variant &v)
     {
-        return v.mem->byte;
+        return v.byte;
     }
     virtual int component(const ky_variant &v) {return 1;}
     virtual fourwd_t code() {return kyStrCode;}
@@ -2192,78 +2244,78 @@ static struct math_str : ky_variant_math
     // 关系运算
     virtual ky_variant less  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int len1 = v1.mem->byte;
-        const int len2 = v2.mem->byte;
+        const int len1 = v1.byte;
+        const int len2 = v2.byte;
         const int min = len1 - len2;
-        const int cmp = ky_memory::compare(v1.mem->data, v2.mem->data, min);
+        const int cmp = ky_memory::compare(v1.data(), v2.data(), min);
         if (cmp < 0 || (cmp == 0 && min < 0))
             return ky_variant(true);
         return ky_variant(false);
     }
     virtual ky_variant less_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int len1 = v1.mem->byte;
-        const int len2 = v2.mem->byte;
+        const int len1 = v1.byte;
+        const int len2 = v2.byte;
         const int min = len1 - len2;
-        const int cmp = ky_memory::compare(v1.mem->data, v2.mem->data, min);
+        const int cmp = ky_memory::compare(v1.data(), v2.data(), min);
         if (cmp <= 0 || (cmp == 0 && min <= 0))
             return ky_variant(true);
         return ky_variant(false);
     }
     virtual ky_variant equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int len1 = v1.mem->byte;
-        const int len2 = v2.mem->byte;
+        const int len1 = v1.byte;
+        const int len2 = v2.byte;
         const int min = len1 - len2;
-        const int cmp = ky_memory::compare(v1.mem->data, v2.mem->data, min);
+        const int cmp = ky_memory::compare(v1.data(), v2.data(), min);
         if (cmp == 0 && min == 0)
             return ky_variant(true);
         return ky_variant(false);
     }
     virtual ky_variant not_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(true);
 
-        const int len1 = v1.mem->byte;
-        const int len2 = v2.mem->byte;
+        const int len1 = v1.byte;
+        const int len2 = v2.byte;
         const int min = len1 - len2;
-        const int cmp = ky_memory::compare(v1.mem->data, v2.mem->data, min);
+        const int cmp = ky_memory::compare(v1.data(), v2.data(), min);
         if (cmp == 0 && min == 0)
             return ky_variant(false);
         return ky_variant(true);
     }
     virtual ky_variant greater_equal  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int len1 = v1.mem->byte;
-        const int len2 = v2.mem->byte;
+        const int len1 = v1.byte;
+        const int len2 = v2.byte;
         const int min = len1 - len2;
-        const int cmp = ky_memory::compare(v1.mem->data, v2.mem->data, min);
+        const int cmp = ky_memory::compare(v1.data(), v2.data(), min);
         if (cmp >= 0 || (cmp == 0 && min >= 0))
             return ky_variant(true);
         return ky_variant(false);
     }
     virtual ky_variant greater  (const ky_variant &v1, const ky_variant &v2)
     {
-        if (!(v2.mem && v2.mem->math))
+        if (!(v2.is_valid() && v2.math))
             return ky_variant(false);
 
-        const int len1 = v1.mem->byte;
-        const int len2 = v2.mem->byte;
+        const int len1 = v1.byte;
+        const int len2 = v2.byte;
         const int min = len1 - len2;
-        const int cmp = ky_memory::compare(v1.mem->data, v2.mem->data, min);
+        const int cmp = ky_memory::compare(v1.data(), v2.data(), min);
         if (cmp > 0 || (cmp == 0 && min > 0))
             return ky_variant(true);
         return ky_variant(false);